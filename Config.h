@@ -0,0 +1,42 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+/*
+ * Build switches. Kept apart from Global.h so the simulator core (MCS51.c,
+ * IntelHex.c, DeAsm.c) can be built without application settings.
+ */
+
+//#define NDEBUG
+#define USE_COLORS
+#define COMPACT_HANDLERS // shared handlers for opcodes with register in opcode
+//#define LOCKSTEP_FAULT // lazy ADD loses its carry, --lockstep has to catch it
+
+#ifndef NDEBUG
+#include "memleaks.h"
+#endif
+
+#endif /* CONFIG_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -18,6 +18,7 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include "Config.h"
 #include "DeAsm.h"
 #include "DeAsmTables.h"
 
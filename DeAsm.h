@@ -24,7 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "Global.h"
+#include "MCS51.h"
 
 /*
  * Code disassembler.
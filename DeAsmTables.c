@@ -18,96 +18,36 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include "DeAsmTables.h"
+
 /*
- * WYGENEROWANY KOD
+ * Opcode tables come from MCS51Opcodes.h.
  */
-
-const int BYTE_COUNT[] = {
-  1, 2, 3, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 3, 1, 1, 2, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1, 1,
-  2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 3, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
-  1, 1, 2, 2, 2, 3, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 3, 2, 2, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 2, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-  2, 1, 1, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 2, 1, 2, 2, 1, 1, 1, 1, 1, 1,
-  1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 3, 3,
-  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-  2, 2, 2, 1, 1, 3, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 2, 1, 1, 1, 1,
-  1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+const BYTE BYTE_COUNT[256] = {
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params) [code] = bytes,
+#include "MCS51Opcodes.h"
 };
 
-const char* MNEMONIC_TABLE[] = {
-  "nop  ", "ajmp ", "ljmp ", "rr   ", "inc  ", "inc  ", "inc  ", "inc  ",
-  "inc  ", "inc  ", "inc  ", "inc  ", "inc  ", "inc  ", "inc  ", "inc  ",
-  "jbc  ", "acall", "lcall", "rrc  ", "dec  ", "dec  ", "dec  ", "dec  ",
-  "dec  ", "dec  ", "dec  ", "dec  ", "dec  ", "dec  ", "dec  ", "dec  ",
-  "jb   ", "ajmp ", "ret  ", "rl   ", "add  ", "add  ", "add  ", "add  ",
-  "add  ", "add  ", "add  ", "add  ", "add  ", "add  ", "add  ", "add  ",
-  "jnb  ", "acall", "reti ", "rlc  ", "addc ", "addc ", "addc ", "addc ",
-  "addc ", "addc ", "addc ", "addc ", "addc ", "addc ", "addc ", "addc ",
-  "jc   ", "ajmp ", "orl  ", "orl  ", "orl  ", "orl  ", "orl  ", "orl  ",
-  "orl  ", "orl  ", "orl  ", "orl  ", "orl  ", "orl  ", "orl  ", "orl  ",
-  "jnc  ", "acall", "anl  ", "anl  ", "anl  ", "anl  ", "anl  ", "anl  ",
-  "anl  ", "anl  ", "anl  ", "anl  ", "anl  ", "anl  ", "anl  ", "anl  ",
-  "jz   ", "ajmp ", "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ",
-  "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ", "xrl  ",
-  "jnz  ", "acall", "orl  ", "jmp  ", "mov  ", "mov  ", "mov  ", "mov  ",
-  "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ",
-  "sjmp ", "ajmp ", "anl  ", "movc ", "div  ", "mov  ", "mov  ", "mov  ",
-  "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ",
-  "mov  ", "acall", "mov  ", "movc ", "subb ", "subb ", "subb ", "subb ",
-  "subb ", "subb ", "subb ", "subb ", "subb ", "subb ", "subb ", "subb ",
-  "orl  ", "ajmp ", "mov  ", "inc  ", "mul  ", "RESVD", "mov  ", "mov  ",
-  "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ",
-  "anl  ", "acall", "cpl  ", "cpl  ", "cjne ", "cjne ", "cjne ", "cjne ",
-  "cjne ", "cjne ", "cjne ", "cjne ", "cjne ", "cjne ", "cjne ", "cjne ",
-  "push ", "ajmp ", "clr  ", "clr  ", "swap ", "xch  ", "xch  ", "xch  ",
-  "xch  ", "xch  ", "xch  ", "xch  ", "xch  ", "xch  ", "xch  ", "xch  ",
-  "pop  ", "acall", "setb ", "setb ", "da   ", "djnz ", "xchd ", "xchd ",
-  "djnz ", "djnz ", "djnz ", "djnz ", "djnz ", "djnz ", "djnz ", "djnz ",
-  "movx ", "ajmp ", "movx ", "movx ", "clr  ", "mov  ", "mov  ", "mov  ",
-  "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ",
-  "movx ", "acall", "movx ", "movx ", "cpl  ", "mov  ", "mov  ", "mov  ",
-  "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  ", "mov  "
+const BYTE CYCLE_COUNT[256] = {
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params) [code] = cycles,
+#include "MCS51Opcodes.h"
 };
 
+const char* const MNEMONIC_TABLE[256] = {
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params) [code] = mnemonic,
+#include "MCS51Opcodes.h"
+};
 
-const char* MNEMONIC_PARAMS[] = {
-  "", "00N%1", "N%1N%2", "A", "A", "%1", "@R0", "@R1", "R0", "R1", "R2", "R3",
-  "R4", "R5", "R6", "R7", "0%1, O%2", "00N%1", "N%1N%2", "A", "A", "%1", "@R0",
-  "@R1", "R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7", "0%1, O%2", "01N%1",
-  "", "A", "A, #%1", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2",
-  "A, R3", "A, R4", "A, R5", "A, R6", "A, R7", "0%1, O%2", "01N%1", "", "A",
-  "A, #%1", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3",
-  "A, R4", "A, R5", "A, R6", "A, R7", "O%1", "02N%1", "%1, A", "%1, #%2",
-  "A, #%1", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3",
-  "A, R4", "A, R5", "A, R6", "A, R7", "O%1", "02N%1", "%1, A", "%1, #%2",
-  "A, #%1", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3",
-  "A, R4", "A, R5", "A, R6", "A, R7", "O%1", "03N%1", "%1, A", "%1, #%2",
-  "A, #%1", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3",
-  "A, R4", "A, R5", "A, R6", "A, R7", "O%1", "03N%1", "C, 0%1", "@A+DPTR",
-  "A, #%1", "%1, #%2", "@R0, #%1", "@R1, #%1", "R0, #%1", "R1, #%1", "R2, #%1",
-  "R3, #%1", "R4, #%1", "R5, #%1", "R6, #%1", "R7, #%1", "O%1", "04N%1",
-  "C, 0%1", "A, @A+PC", "AB", "%2, %1", "%1, @R0", "%1, @R1", "%1, R0",
-  "%1, R1", "%1, R2", "%1, R3", "%1, R4", "%1, R5", "%1, R6", "%1, R7",
-  "DPTR, #N%1N%2", "04N%1", "0%1, C", "A, @A+DPTR", "A, #%1", "A, %1",
-  "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3", "A, R4", "A, R5",
-  "A, R6", "A, R7", "C, /0%1", "05N%1", "C, 0%1", "DPTR", "AB", "", "@R0, %1",
-  "@R1, %1", "R0, %1", "R1, %1", "R2, %1", "R3, %1", "R4, %1", "R5, %1",
-  "R6, %1", "R7, %1", "C, /0%1", "05N%1", "0%1", "C", "A, #%1, O%2",
-  "A, %1, O%2", "@R0, #%1, O%2", "@R1, #%1, O%2", "R0, #%1, O%2",
-  "R1, #%1, O%2", "R2, #%1, O%2", "R3, #%1, O%2", "R4, #%1, O%2",
-  "R5, #%1, O%2", "R6, #%1, O%2", "R7, #%1, O%2", "%1", "06N%1", "0%1", "C",
-  "A", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2", "A, R3",
-  "A, R4", "A, R5", "A, R6", "A, R7", "%1", "06N%1", "0%1", "C", "A",
-  "%1, O%2", "A, @R0", "A, @R1", "R0, O%1", "R1, O%1", "R2, O%1", "R3, O%1",
-  "R4, O%1", "R5, O%1", "R6, O%1", "R7, O%1", "A, @DPTR", "07N%1", "A, @R0",
-  "A, @R1", "A", "A, %1", "A, @R0", "A, @R1", "A, R0", "A, R1", "A, R2",
-  "A, R3", "A, R4", "A, R5", "A, R6", "A, R7", "@DPTR, A", "07N%1", "@R0, A",
-  "@R1, A", "A", "%1, A", "@R0, A", "@R1, A", "R0, A", "R1, A", "R2, A",
-  "R3, A", "R4, A", "R5, A", "R6, A", "R7, A"
+const char* const MNEMONIC_PARAMS[256] = {
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params) [code] = params,
+#include "MCS51Opcodes.h"
 };
 
-const char* SFR_NAMES[] = {
+/*
+ * WYGENEROWANY KOD
+ */
+
+const char* const SFR_NAMES[256] = {
   "00h", "01h", "02h", "03h", "04h", "05h", "06h", "07h", "08h", "09h", "0Ah",
   "0Bh", "0Ch", "0Dh", "0Eh", "0Fh", "10h", "11h", "12h", "13h", "14h", "15h",
   "16h", "17h", "18h", "19h", "1Ah", "1Bh", "1Ch", "1Dh", "1Eh", "1Fh", "20h",
@@ -134,7 +74,7 @@ const char* SFR_NAMES[] = {
   "FCh", "FDh", "FEh", "FFh"
 };
 
-const char* SFR_BITS[] = {
+const char* const SFR_BITS[256] = {
   "20h.0", "20h.1", "20h.2", "20h.3", "20h.4", "20h.5", "20h.6", "20h.7",
   "21h.0", "21h.1", "21h.2", "21h.3", "21h.4", "21h.5", "21h.6", "21h.7",
   "22h.0", "22h.1", "22h.2", "22h.3", "22h.4", "22h.5", "22h.6", "22h.7",
@@ -21,8 +21,14 @@
 #ifndef DEASMTABLES_H_
 #define DEASMTABLES_H_
 
-extern const int BYTE_COUNT[];
-extern const char* MNEMONIC_TABLE[];
+#include "MCS51.h"
+
+/*
+ * Instruction set and SFR names, shared by all MCU instances.
+ */
+extern const BYTE BYTE_COUNT[256];
+extern const BYTE CYCLE_COUNT[256];
+extern const char* const MNEMONIC_TABLE[256];
 /*
  * [0ON]%[12]
  * 0 - bit
@@ -31,9 +37,9 @@ extern const char* MNEMONIC_TABLE[];
  * 1 - first bit
  * 2 - second bit
  */
-extern const char* MNEMONIC_PARAMS[];
-extern const char* SFR_NAMES[];
-extern const char* SFR_BITS[];
+extern const char* const MNEMONIC_PARAMS[256];
+extern const char* const SFR_NAMES[256];
+extern const char* const SFR_BITS[256];
 
 #endif /* DEASMTABLES_H_ */
 
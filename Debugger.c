@@ -29,6 +29,9 @@
 
 #include "DeAsm.h"
 #include "IntelHex.h"
+#include "Recompiler.h"
+#include "History.h"
+#include "Lockstep.h"
 #include "Utils.h"
 #include "Keyboard.h"
 
@@ -38,8 +41,22 @@ const char* g_unavailable  = "Unavailable when thread is running.\n";
 const char* g_tooFewArguments = "Too few arguments. Type help for more details.\n";
 const char* g_stoped = "Stoped at %.4Xh after execute %i instructions.\n";
 
+/* Liczba instrukcji wykonywanych przez moduł w jednym przebiegu pętli. */
+const unsigned long long MODULE_BATCH = 1000;
+
 pthread_t g_MCUThread;
 pthread_t g_keyEventLoop;
+
+/*
+ * Snapshots made by `snapshot save`, kept until exit.
+ */
+typedef struct {
+  char* name;
+  MCU* mcu;
+} Snapshot;
+
+Snapshot* g_snapshots = NULL;
+int g_numOfSnapshots = 0;
 bool g_MCUThreadRunning;
 bool g_keyEventLoopRunning;
 
@@ -210,12 +227,9 @@ void* runMCU(void* output(char))
   unsigned long long cyclesFromLastRefresh = AppSettings()->mcu->cycles;
   const unsigned long long titleRefreshInterval = CLOCKS_PER_SEC;
 
-  while (true) {
-    bool useOut = false;
-    bool needIn = false;
-    BYTE* in = AppSettings()->keyAvailable ? (BYTE*)&AppSettings()->lastKey : NULL;
-    BYTE out = '?';
+  beginHistory(AppSettings()->mcu);
 
+  while (true) {
     /* Przerwij pętle gdy z innego wątku ustanowiono falgę. */
     if (AppSettings()->stopThread) {
       AppSettings()->stopThread = false;
@@ -240,23 +254,66 @@ void* runMCU(void* output(char))
       break;
     }
 
-    if (!processMCUEx(AppSettings()->mcu, &out, in, &useOut, &needIn))
-      break;
+    /* Skompilowany program, gdy pasuje do pamięci kodu. */
+    if (isModuleUsable(AppSettings()->mcu)) {
+      bool useOut = false;
+      bool needIn = false;
+      BYTE* in = AppSettings()->keyAvailable ? (BYTE*)&AppSettings()->lastKey : NULL;
+      BYTE out = '?';
+      unsigned long long count = MODULE_BATCH;
 
-    if (useOut && output != NULL)
-      output(out);
-    if (needIn)
-      AppSettings()->keyAvailable = false;
+      /* Przewiń czas gdy procesor czeka (idle, `sjmp $`), najwyżej o 10ms
+         czasu mikrokontrolera. */
+      fastForwardMCU(AppSettings()->mcu, AppSettings()->mcu->oscillator / 1200);
 
-    /* Przerwij gdy program chce wyłączyć procesor... całkiem logiczne, co? */
-    if (checkRegister(AppSettings()->mcu, PCON_PD))
-      break;
+      /* Klawisz jest w odbiorniku przez całą paczkę. */
+      if (in != NULL)
+        inputHistory(AppSettings()->mcu, *in);
 
-    /* Przerwij przy nieskończonej pętli. */
-    if (!checkRegister(AppSettings()->mcu, IE_EA) &&
-        *ROM(AppSettings()->mcu, AppSettings()->mcu->PC) == 0x80 &&
-        *ROM(AppSettings()->mcu, AppSettings()->mcu->PC + 1) == 0xFE)
-      break;
+      if (!runModule(AppSettings()->mcu, &count, &out, in, &useOut, &needIn))
+        break;
+
+      if (useOut && output != NULL)
+        output(out);
+      if (needIn)
+        AppSettings()->keyAvailable = false;
+      else if (in != NULL)
+        inputHistory(AppSettings()->mcu, -1);
+
+      /* Przerwij gdy program chce wyłączyć procesor lub przy nieskończonej
+         pętli. */
+      if (isHaltedMCU(AppSettings()->mcu))
+        break;
+    } else {
+      MCUStopReason reason;
+      int out;
+
+      /* Ostatni klawisz czeka w odbiorniku uartu. */
+      if (AppSettings()->keyAvailable &&
+          AppSettings()->mcu->INPUT != AppSettings()->lastKey) {
+        AppSettings()->mcu->INPUT = AppSettings()->lastKey;
+        inputHistory(AppSettings()->mcu, AppSettings()->mcu->INPUT);
+      }
+
+      /* Paczka instrukcji, najwyżej 10ms czasu mikrokontrolera. Czas,
+         klawisze i tytuł są sprawdzane tylko między paczkami. */
+      runMCUBatch(AppSettings()->mcu, MCU_NO_LIMIT,
+                  AppSettings()->mcu->oscillator / 1200,
+                  STOP_ALL & ~STOP_INPUT, &reason);
+
+      out = takeOutputMCU(AppSettings()->mcu);
+      if (out != -1 && output != NULL)
+        output((char) out);
+      if (AppSettings()->keyAvailable && AppSettings()->mcu->INPUT == -1)
+        AppSettings()->keyAvailable = false;
+
+      /* Przerwij na pułapce, przy błędzie, gdy program chce wyłączyć procesor
+         lub przy nieskończonej pętli. */
+      if (reason != STOP_BUDGET && reason != STOP_OUTPUT)
+        break;
+    }
+
+    tickHistory(AppSettings()->mcu);
 
     /* Tytuł okna konsoli. */
     if (clock() - lastTitleRefresh > titleRefreshInterval) {
@@ -282,6 +339,12 @@ void* runMCU(void* output(char))
   if (AppSettings()->mcu->errid != E_NOERRORS && AppSettings()->pauseOnError)
     fprintf(AppSettings()->errorOut, getError(AppSettings()->mcu));
 
+  /* Nieodebrany klawisz zostaje w keyAvailable. */
+  if (AppSettings()->mcu->INPUT != -1)
+    inputHistory(AppSettings()->mcu, -1);
+  AppSettings()->mcu->INPUT = -1;
+  endHistory(AppSettings()->mcu);
+
   /* Zapaiętaj czas działania, aby go uzyć go przy ponownym uruchomieniu */
   AppSettings()->simSyncTimeBeforeStop = AppSettings()->simSec;
   AppSettings()->simTimeBeforeStop = AppSettings()->simSec;
@@ -299,6 +362,7 @@ bool step(bool memory)
   char* asmCode = disassembler(AppSettings()->mcu,
                                AppSettings()->mcu->PC, AppSettings()->format, NULL);
   ret = processMCUEx(AppSettings()->mcu, &outByte, NULL, &outSth, NULL);
+  syncMCU(AppSettings()->mcu);
 
   if (memory) {
     print("%s"
@@ -324,7 +388,7 @@ bool step(bool memory)
           AppSettings()->mcu->changedIntRAM,
           AppSettings()->mcu->idata[AppSettings()->mcu->changedIntRAM],
           AppSettings()->mcu->changedExtRAM,
-          AppSettings()->mcu->xdata[AppSettings()->mcu->changedExtRAM],
+          getMemoryMCU(AppSettings()->mcu, XDATA, AppSettings()->mcu->changedExtRAM),
           AppSettings()->mcu->SFRNames[AppSettings()->mcu->changedSFR],
           AppSettings()->mcu->sfr[AppSettings()->mcu->changedSFR - 0x80],
           *AppSettings()->mcu->ACC,
@@ -339,7 +403,7 @@ bool step(bool memory)
           (*AppSettings()->mcu->PSW & 0x02) > 0 ? 1 : 0,
           (*AppSettings()->mcu->PSW & 0x01) > 0 ? 1 : 0,
           *AppSettings()->mcu->DPTR,
-          AppSettings()->mcu->xdata[*AppSettings()->mcu->DPTR],
+          getMemoryMCU(AppSettings()->mcu, XDATA, *AppSettings()->mcu->DPTR),
           *AppSettings()->mcu->SBUF,
           AppSettings()->mcu->OUTPUT == -1 ? 0 : AppSettings()->mcu->OUTPUT);
 
@@ -392,6 +456,18 @@ void hex(void* memory, WORD start, WORD stop, int offset)
   }
 }
 
+/*
+ * hex() of xdata or code memory, it is in pages.
+ */
+void hexMemory(MemoryType type, WORD start, WORD stop)
+{
+  BYTE* memory = malloc(MAX_ROM_SIZE);
+
+  readMemoryMCU(AppSettings()->mcu, type, 0, memory, MAX_ROM_SIZE);
+  hex(memory, start, stop, 0);
+  free(memory);
+}
+
 void cmd_stop(int argc, char** argv)
 {
   if (g_MCUThreadRunning) {
@@ -407,10 +483,53 @@ void cmd_run(int argc, char** argv)
   if (argc >= 2) {
     int i = 0;
     int n = atoi(argv[1]);
-    for (i = 0; i < n; ++i)
-      if (!processMCUEx(AppSettings()->mcu, NULL, NULL, NULL, NULL))
-        break;
 
+    beginHistory(AppSettings()->mcu);
+
+    /* Paczki, aby historia dostała punkty kontrolne. */
+    if (AppSettings()->lockstep) {
+      MCUStopReason reason = STOP_BUDGET;
+
+      while (i < n && reason == STOP_BUDGET) {
+        unsigned long long count;
+        bool same = runLockstepMCU(AppSettings()->mcu, n - i, HISTORY_INTERVAL,
+                                   STOP_BREAKPOINT | STOP_ERROR, &count, &reason,
+                                   AppSettings()->errorOut);
+        i += count;
+        tickHistory(AppSettings()->mcu);
+        if (!same || count == 0)
+          break;
+      }
+    } else if (isModuleUsable(AppSettings()->mcu)) {
+      while (i < n) {
+        unsigned long long count;
+        bool ret;
+
+        i += fastForwardMCU(AppSettings()->mcu, n - i);
+        if (i == n)
+          break;
+
+        count = n - i < HISTORY_STEPS ? n - i : HISTORY_STEPS;
+        ret = runModule(AppSettings()->mcu, &count, NULL, NULL, NULL, NULL);
+        i += count;
+        tickHistory(AppSettings()->mcu);
+        if (!ret)
+          break;
+      }
+    } else {
+      MCUStopReason reason = STOP_BUDGET;
+
+      while (i < n && reason == STOP_BUDGET) {
+        unsigned long long count = runMCUBatch(AppSettings()->mcu, n - i, HISTORY_INTERVAL,
+                                               STOP_BREAKPOINT | STOP_ERROR, &reason);
+        i += count;
+        tickHistory(AppSettings()->mcu);
+        if (count == 0)
+          break;
+      }
+    }
+
+    endHistory(AppSettings()->mcu);
     printf(g_stoped, AppSettings()->mcu->PC, i);
   } else {
     pthread_create(&g_MCUThread, NULL, (void*)(void*)runMCU, NULL);
@@ -453,9 +572,15 @@ void cmd_trace(int argc, char** argv)
 
   int i = 0;
   int n = atoi(argv[1]);
-  for (i = 0; i < n; ++i)
+
+  beginHistory(AppSettings()->mcu);
+  for (i = 0; i < n; ++i) {
     if (!step(moreInfo))
       break;
+    if (i % 0x10000 == 0)
+      tickHistory(AppSettings()->mcu);
+  }
+  endHistory(AppSettings()->mcu);
 
   print(g_stoped, AppSettings()->mcu->PC, i);
 }
@@ -479,7 +604,9 @@ void cmd_oscillator(int argc, char** argv)
 void cmd_step(int argc, char** argv)
 {
   STOP_IF_THREAD_RUN(return);
+  beginHistory(AppSettings()->mcu);
   step(true);
+  endHistory(AppSettings()->mcu);
 }
 
 void cmd_reset(int argc, char** argv)
@@ -559,6 +686,20 @@ void cmd_state(int argc, char** argv)
   print("Available XDATA memory: " C_BOLD C_FWHITE "%.2f kB" C_RESET "\n",
         (double) AppSettings()->mcu->xdataMemorySize / 1024);
 
+  print("Allocated memory pages: " C_BOLD C_FWHITE "%u (%.2f kB)" C_RESET "\n",
+        memoryPagesMCU(AppSettings()->mcu),
+        (double) memoryPagesMCU(AppSettings()->mcu) * sizeof(MCUPage) / 1024);
+
+  // Run with the same --poison gives the same memory.
+  if (AppSettings()->mcu->poison == POISON_ZERO)
+    print("Memory poison: " C_BOLD C_FWHITE "zero" C_RESET "\n");
+  else if (AppSettings()->mcu->poison == POISON_PATTERN)
+    print("Memory poison: " C_BOLD C_FWHITE "pattern:%.2X" C_RESET "\n",
+          AppSettings()->mcu->poisonValue);
+  else
+    print("Memory poison: " C_BOLD C_FWHITE "random:%u" C_RESET "\n",
+          AppSettings()->mcu->poisonValue);
+
   if (checkRegister(AppSettings()->mcu, PCON_IDL))
     print("Microcontroller state: " C_BOLD C_FWHITE "IDLE" C_RESET "");
   else if (checkRegister(AppSettings()->mcu, PCON_PD))
@@ -581,20 +722,25 @@ void cmd_load(int argc, char** argv)
   if (memType == IROM) {
     resetMCU(AppSettings()->mcu);
 
-    loadIntelHexFile(argv[2], AppSettings()->mcu->irom,
-                     0, AppSettings()->mcu->iromMemorySize - 1, &valid, &highestAddress);
+    loadIntelHexMCU(argv[2], AppSettings()->mcu, IROM,
+                    0, AppSettings()->mcu->iromMemorySize - 1, &valid, &highestAddress,
+                    AppSettings()->errorOut);
 
     /* load to int ram if no memory */
     if (highestAddress >= AppSettings()->mcu->iromMemorySize) {
-      loadIntelHexFile(argv[2], AppSettings()->mcu->xrom,
-                       AppSettings()->mcu->iromMemorySize, AppSettings()->mcu->xromMemorySize - 1, &valid, NULL);
+      loadIntelHexMCU(argv[2], AppSettings()->mcu, XROM,
+                      AppSettings()->mcu->iromMemorySize, AppSettings()->mcu->xromMemorySize - 1, &valid, NULL,
+                      AppSettings()->errorOut);
     }
 
     AppSettings()->simTimeBeforeStop = 0;
+    invalidatePredecodedMCU(AppSettings()->mcu);
   } else if (memType == XROM) {
     resetMCU(AppSettings()->mcu);
-    loadIntelHexFile(argv[2], AppSettings()->mcu->xrom, 0, AppSettings()->mcu->xromMemorySize - 1, &valid, NULL);
+    loadIntelHexMCU(argv[2], AppSettings()->mcu, XROM, 0, AppSettings()->mcu->xromMemorySize - 1, &valid, NULL,
+                    AppSettings()->errorOut);
     AppSettings()->simTimeBeforeStop = 0;
+    invalidatePredecodedMCU(AppSettings()->mcu);
   } else {
     fprintf(AppSettings()->errorOut, "Specify memory type. Choose `%s` or `%s`!\n",
             memoryToString(IROM), memoryToString(XROM));
@@ -657,6 +803,7 @@ void cmd_byte(int argc, char** argv)
   bool valid;
   char* memory;
   BYTE* byte = NULL;
+  BYTE paged; // copy of byte from paged memory, written back
   WORD address = 0;
 
   if (memType == IDATA) {
@@ -670,7 +817,8 @@ void cmd_byte(int argc, char** argv)
     }
   } else if (memType == XDATA) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->xdata[address];
+    paged = getMemoryMCU(AppSettings()->mcu, XDATA, address);
+    byte = &paged;
     memory = "XDATA";
 
     if (!valid) {
@@ -679,7 +827,8 @@ void cmd_byte(int argc, char** argv)
     }
   } else if (memType == IROM) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->irom[address];
+    paged = getMemoryMCU(AppSettings()->mcu, IROM, address);
+    byte = &paged;
     memory = "IROM";
 
     if (!valid) {
@@ -688,7 +837,8 @@ void cmd_byte(int argc, char** argv)
     }
   } else if (memType == XROM) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->xrom[address];
+    paged = getMemoryMCU(AppSettings()->mcu, XROM, address);
+    byte = &paged;
     memory = "XROM";
 
     if (!valid) {
@@ -728,6 +878,12 @@ void cmd_byte(int argc, char** argv)
       }
 
       *byte = value;
+
+      if (byte == &paged)
+        setMemoryMCU(AppSettings()->mcu, memType, address, paged);
+
+      if (memType == IROM || memType == XROM)
+        invalidatePredecodedMCU(AppSettings()->mcu);
     } else {
       print("%s[%.2X] = %.2X\n", memory, address, *byte);
     }
@@ -744,6 +900,7 @@ void cmd_bit(int argc, char** argv)
   bool valid;
   char* memory;
   BYTE* byte = NULL;
+  BYTE paged; // copy of byte from paged memory, written back
   WORD address = 0;
 
   if (memType == IDATA) {
@@ -757,7 +914,8 @@ void cmd_bit(int argc, char** argv)
     }
   } else if (memType == XDATA) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->xdata[address];
+    paged = getMemoryMCU(AppSettings()->mcu, XDATA, address);
+    byte = &paged;
     memory = "XDATA";
 
     if (!valid) {
@@ -766,7 +924,8 @@ void cmd_bit(int argc, char** argv)
     }
   } else if (memType == IROM) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->irom[address];
+    paged = getMemoryMCU(AppSettings()->mcu, IROM, address);
+    byte = &paged;
     memory = "ROM";
 
     if (!valid) {
@@ -775,7 +934,8 @@ void cmd_bit(int argc, char** argv)
     }
   } else if (memType == XROM) {
     address = hextoi(argv[2], 0x0, 0xFFFF, 0x0, &valid);
-    byte = &AppSettings()->mcu->xrom[address];
+    paged = getMemoryMCU(AppSettings()->mcu, XROM, address);
+    byte = &paged;
     memory = "ROM";
 
     if (!valid) {
@@ -816,6 +976,12 @@ void cmd_bit(int argc, char** argv)
           *byte |= bit;
         else
           *byte &= ~bit;
+
+        if (byte == &paged)
+          setMemoryMCU(AppSettings()->mcu, memType, address, paged);
+
+        if (memType == IROM || memType == XROM)
+          invalidatePredecodedMCU(AppSettings()->mcu);
       }
     } else {
       print("%s[%.2X.%i] = ", memory, address, atoi(argv[3]));
@@ -844,17 +1010,17 @@ void cmd_hex(int argc, char** argv)
     start = argc >= 3 ? hextoi(argv[2], 0x0, 0xFFFF, 0x0, NULL) : 0x0;
     stop = argc >= 4 ? hextoi(argv[3], start, 0xFFFF, start, NULL) : 0xFFFF;
 
-    hex(AppSettings()->mcu->xdata, start, stop, 0);
+    hexMemory(XDATA, start, stop);
   } else if (memType == IROM) {
     start = argc >= 3 ? hextoi(argv[2], 0x0, 0xFFFF, 0x0, NULL) : 0x0;
     stop = argc >= 4 ? hextoi(argv[3], start, 0xFFFF, start, NULL) : 0xFFFF;
 
-    hex(AppSettings()->mcu->irom, start, stop, 0);
+    hexMemory(IROM, start, stop);
   } else if (memType == XROM) {
     start = argc >= 3 ? hextoi(argv[2], 0x0, 0xFFFF, 0x0, NULL) : 0x0;
     stop = argc >= 4 ? hextoi(argv[3], start, 0xFFFF, start, NULL) : 0xFFFF;
 
-    hex(AppSettings()->mcu->xrom, start, stop, 0);
+    hexMemory(XROM, start, stop);
   } else if (memType == SFR) {
     start = argc >= 3 ? hextoi(argv[2], 0x80, 0xFF, 0x0, NULL) : 0x80;
     stop = argc >= 4 ? hextoi(argv[3], start, 0xFF, start, NULL) : 0xFF;
@@ -898,7 +1064,7 @@ void cmd_fill(int argc, char** argv)
       return;
     }
 
-    memset(AppSettings()->mcu->xdata + start, address, stop - start);
+    fillMemoryMCU(AppSettings()->mcu, XDATA, start, address, stop - start);
   } else if (memType == IROM) {
     start = argc >= 4 ? hextoi(argv[3], 0x0, 0xFFFF, 0x0, &valid1) : 0x0;
     stop = argc >= 5 ? hextoi(argv[4], start, 0xFFFF, start, &valid2) : 0xFFFF;
@@ -909,7 +1075,8 @@ void cmd_fill(int argc, char** argv)
       return;
     }
 
-    memset(AppSettings()->mcu->irom + start, address, stop - start);;
+    fillMemoryMCU(AppSettings()->mcu, IROM, start, address, stop - start);
+    invalidatePredecodedMCU(AppSettings()->mcu);
   } else if (memType == XROM) {
     start = argc >= 4 ? hextoi(argv[3], 0x0, 0xFFFF, 0x0, &valid1) : 0x0;
     stop = argc >= 5 ? hextoi(argv[4], start, 0xFFFF, start, &valid2) : 0xFFFF;
@@ -920,7 +1087,8 @@ void cmd_fill(int argc, char** argv)
       return;
     }
 
-    memset(AppSettings()->mcu->xrom + start, address, stop - start);;
+    fillMemoryMCU(AppSettings()->mcu, XROM, start, address, stop - start);
+    invalidatePredecodedMCU(AppSettings()->mcu);
   } else if (memType == SFR) {
     start = argc >= 4 ? hextoi(argv[3], 0x80, 0xFF, 0x0, &valid1) : 0x80;
     stop = argc >= 5 ? hextoi(argv[4], start, 0xFF, start, &valid2) : 0xFF;
@@ -1196,12 +1364,119 @@ void cmd_ea(int argc, char** argv)
   bool valid, state;
   state = boolQuestion(argv[1], "1", "0", &valid);
 
-  if (valid)
+  if (valid) {
     AppSettings()->mcu->EA = state;
+    mapMemoryMCU(AppSettings()->mcu);
+  } else
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+}
+
+void cmd_predecode(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+  STOP_IF_THREAD_RUN(return);
+
+  bool valid;
+  bool answer = boolQuestion(argv[1], "y", "n", &valid);
+
+  if (valid) {
+    AppSettings()->mcu->usePredecoded = answer;
+    if (!answer)
+      AppSettings()->mcu->useBlocks = false;
+    invalidatePredecodedMCU(AppSettings()->mcu);
+  } else
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+}
+
+void cmd_blocks(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+  STOP_IF_THREAD_RUN(return);
+
+  bool valid;
+  bool answer = boolQuestion(argv[1], "y", "n", &valid);
+
+  if (!valid) {
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+    return;
+  }
+
+  if (argc >= 3) {
+    int threshold = atoi(argv[2]);
+
+    if (threshold < 1 || threshold > 0xFFFF) {
+      fprintf(AppSettings()->errorOut, "Threshold should be between 1 and 65535.\n");
+      return;
+    }
+
+    AppSettings()->mcu->hotBlockThreshold = threshold;
+  }
+
+  // Blocks are part of predecoded engine.
+  AppSettings()->mcu->useBlocks = answer;
+  if (answer)
+    AppSettings()->mcu->usePredecoded = true;
+  invalidatePredecodedMCU(AppSettings()->mcu);
+}
+
+void cmd_lazyflags(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+  STOP_IF_THREAD_RUN(return);
+
+  bool valid;
+  bool answer = boolQuestion(argv[1], "y", "n", &valid);
+
+  if (valid) {
+    syncFlagsMCU(AppSettings()->mcu);
+    AppSettings()->mcu->lazyFlags = answer;
+  } else
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+}
+
+void cmd_lockstep(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+
+  bool valid;
+  bool answer = boolQuestion(argv[1], "y", "n", &valid);
+
+  if (valid)
+    AppSettings()->lockstep = answer;
   else
     fprintf(AppSettings()->errorOut, "Invalid argument.\n");
 }
 
+void cmd_turbo(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+  STOP_IF_THREAD_RUN(return);
+
+  bool valid;
+  bool answer = boolQuestion(argv[1], "y", "n", &valid);
+
+  if (valid)
+    AppSettings()->mcu->noDebug = answer;
+  else
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+}
+
+void cmd_loadmodule(int argc, char** argv)
+{
+  REQUIRED_ARGS(1, return);
+  STOP_IF_THREAD_RUN(return);
+
+  if (loadModule(AppSettings()->mcu, argv[1]) && !isModuleUsable(AppSettings()->mcu))
+    fprintf(AppSettings()->errorOut, "Module doesn't match loaded code. "
+            "It will be used after matching code is loaded.\n");
+}
+
+void cmd_unloadmodule(int argc, char** argv)
+{
+  STOP_IF_THREAD_RUN(return);
+  unloadModule(AppSettings()->mcu);
+}
+
 void cmd_connect_ea(int argc, char** argv)
 {
   REQUIRED_ARGS(2, return);
@@ -1230,6 +1505,156 @@ void cmd_connect_ea(int argc, char** argv)
     byte = 0xB0 | pin;
 
   AppSettings()->mcu->EAconnect = byte;
+  invalidatePredecodedMCU(AppSettings()->mcu);
+}
+
+Snapshot* findSnapshot(const char* name)
+{
+  for (int i = 0; i < g_numOfSnapshots; ++i) {
+    if (0 == strcmp(g_snapshots[i].name, name))
+      return &g_snapshots[i];
+  }
+
+  return NULL;
+}
+
+void cmd_snapshot(int argc, char** argv)
+{
+  STOP_IF_THREAD_RUN(return);
+
+  if (argc < 2 || 0 == stricmp(argv[1], "list")) {
+    for (int i = 0; i < g_numOfSnapshots; ++i)
+      print(C_BOLD C_FWHITE "%-16s" C_RESET " PC %.4Xh, %llu cycles\n",
+            g_snapshots[i].name, g_snapshots[i].mcu->PC, g_snapshots[i].mcu->cycles);
+    return;
+  }
+
+  REQUIRED_ARGS(2, return);
+
+  Snapshot* snapshot = findSnapshot(argv[2]);
+
+  if (0 == stricmp(argv[1], "save")) {
+    if (snapshot == NULL) {
+      g_snapshots = realloc(g_snapshots, (g_numOfSnapshots + 1) * sizeof(Snapshot));
+      snapshot = &g_snapshots[g_numOfSnapshots++];
+      snapshot->name = malloc(strlen(argv[2]) + 1);
+      strcpy(snapshot->name, argv[2]);
+      snapshot->mcu = malloc(sizeof(MCU));
+    } else
+      removeMCU(snapshot->mcu);
+
+    snapshotMCU(snapshot->mcu, AppSettings()->mcu);
+  } else if (snapshot == NULL) {
+    fprintf(AppSettings()->errorOut, "Snapshot '%s' doesn't exist.\n", argv[2]);
+  } else if (0 == stricmp(argv[1], "restore")) {
+    restoreMCU(AppSettings()->mcu, snapshot->mcu);
+    AppSettings()->simTimeBeforeStop = getMCUTime(AppSettings()->mcu);
+    AppSettings()->simSyncTimeBeforeStop = getMCUTime(AppSettings()->mcu);
+  } else if (0 == stricmp(argv[1], "delete")) {
+    removeMCU(snapshot->mcu);
+    free(snapshot->mcu);
+    free(snapshot->name);
+    *snapshot = g_snapshots[--g_numOfSnapshots];
+  } else
+    fprintf(AppSettings()->errorOut, "Invalid argument.\n");
+}
+
+void removeSnapshots(void)
+{
+  for (int i = 0; i < g_numOfSnapshots; ++i) {
+    removeMCU(g_snapshots[i].mcu);
+    free(g_snapshots[i].mcu);
+    free(g_snapshots[i].name);
+  }
+
+  free(g_snapshots);
+  g_snapshots = NULL;
+  g_numOfSnapshots = 0;
+}
+
+/*
+ * Wypisz miejsce w historii, w którym jest procesor.
+ */
+void printHistoryPosition(void)
+{
+  char* asmCode = disassembler(AppSettings()->mcu,
+                               AppSettings()->mcu->PC, AppSettings()->format, NULL);
+
+  AppSettings()->simTimeBeforeStop = getMCUTime(AppSettings()->mcu);
+  AppSettings()->simSyncTimeBeforeStop = getMCUTime(AppSettings()->mcu);
+
+  print("%s", asmCode);
+  print("cycles = %llu\n", AppSettings()->mcu->cycles);
+  free(asmCode);
+}
+
+void cmd_reversestep(int argc, char** argv)
+{
+  STOP_IF_THREAD_RUN(return);
+
+  if (!stepBackHistory(AppSettings()->mcu)) {
+    fprintf(AppSettings()->errorOut, "No history before current cycle.\n");
+    return;
+  }
+
+  printHistoryPosition();
+}
+
+void cmd_reversecontinue(int argc, char** argv)
+{
+  STOP_IF_THREAD_RUN(return);
+
+  if (!continueBackHistory(AppSettings()->mcu)) {
+    unsigned long long first, last;
+    unsigned checkpoints;
+
+    if (!rangeOfHistory(&first, &last, &checkpoints)) {
+      fprintf(AppSettings()->errorOut, "No history before current cycle.\n");
+      return;
+    }
+
+    print("No breakpoint in history, stopped at its start.\n");
+  }
+
+  printHistoryPosition();
+}
+
+void cmd_gotocycle(int argc, char** argv)
+{
+  STOP_IF_THREAD_RUN(return);
+  REQUIRED_ARGS(1, return);
+
+  char* end;
+  unsigned long long cycles = strtoull(argv[1], &end, 10);
+
+  if (*end != '\0') {
+    fprintf(AppSettings()->errorOut, "Invalid number of cycles.\n");
+    return;
+  }
+
+  if (!gotoHistory(AppSettings()->mcu, cycles)) {
+    fprintf(AppSettings()->errorOut, "Cycle %llu is out of history.\n", cycles);
+    return;
+  }
+
+  printHistoryPosition();
+}
+
+void cmd_history(int argc, char** argv)
+{
+  unsigned long long first, last;
+  unsigned checkpoints;
+
+  // Running thread adds checkpoints.
+  STOP_IF_THREAD_RUN(return);
+
+  if (argc >= 2 && 0 == stricmp(argv[1], "clear")) {
+    clearHistory();
+  } else if (!rangeOfHistory(&first, &last, &checkpoints))
+    print("History is empty.\n");
+  else
+    print("History from %llu to %llu cycles, %u checkpoints.\n",
+          first, last, checkpoints);
 }
 
 #ifndef NDEBUG
@@ -1467,6 +1892,60 @@ void runDebugger(void)
       "connect_ea", &cmd_connect_ea, "port pin",
       "Connect EA pin to another pin."
     },
+    {
+      "snapshot", &cmd_snapshot, "[save|restore|delete name]",
+      "Save state of microcontroller (memories, registers, breakpoints) "
+      "under name or restore it. Without arguments list snapshots."
+    },
+    {
+      "reverse-step", &cmd_reversestep, "",
+      "Go back to the state before the last executed instruction."
+    },
+    {
+      "reverse-continue", &cmd_reversecontinue, "",
+      "Go back to the last breakpoint or pause hit by running program."
+    },
+    {
+      "goto-cycle", &cmd_gotocycle, "cycles",
+      "Go to the instruction executed at given cycle of recorded history."
+    },
+    {
+      "history", &cmd_history, "[clear]",
+      "Show range of execution history used by reverse commands or clear it."
+    },
+    {
+      "loadModule", &cmd_loadmodule, "file",
+      "Load program recompiled with --recompile. It is used instead of "
+      "simulator while code memory matches it."
+    },
+    {
+      "unloadModule", &cmd_unloadmodule, "",
+      "Unload recompiled program."
+    },
+    {
+      "predecode", &cmd_predecode, "[y|n]",
+      "Run code predecoded with threaded dispatch. Faster, same results."
+    },
+    {
+      "blocks", &cmd_blocks, "[y|n] [n]",
+      "Run hot code blocks at once in 'run n'. Block is formed after n "
+      "visits (default 16). Enables 'predecode'."
+    },
+    {
+      "lazyFlags", &cmd_lazyflags, "[y|n]",
+      "Compute CY, AC, OV and P only when PSW is read. Faster, but access "
+      "pauses on PSW don't see arithmetic."
+    },
+    {
+      "lockstep", &cmd_lockstep, "[y|n]",
+      "Check engine of 'run n' against interpreter after every instruction "
+      "or block, stop with report at the first difference."
+    },
+    {
+      "turbo", &cmd_turbo, "[y|n]",
+      "Run on core without debugger: breakpoints, pauses and information "
+      "about used and changed memory are off."
+    },
 #ifndef NDEBUG
     {
       "setExitKey", &cmd_exitkey, "",
@@ -1570,6 +2049,12 @@ void runDebugger(void)
         }
       }
     } else {
+      /* Skrypt startowy serwera (--fork-server) wraca do main(). */
+      if (feof(AppSettings()->in) && AppSettings()->returnAtEnd) {
+        cmd_stop(0, NULL);
+        break;
+      }
+
       if (feof(AppSettings()->in))
         exit(EXIT_SUCCESS);
 
@@ -1701,6 +2186,11 @@ void runDebugger(void)
      * Wykonywanie komend.
      */
     bool find = false;
+
+    /* Komendy czytają SFR bezpośrednio. */
+    if (!g_MCUThreadRunning)
+      syncMCU(AppSettings()->mcu);
+
     for (i = 0; i < numOfParams; ++i) {
       if (0 == stricmp(argv[0], params[i].name)) {
         if (NULL == params[i].function)
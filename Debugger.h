@@ -25,6 +25,11 @@
 
 void runDebugger(void);
 
+/*
+ * Free snapshots made by `snapshot save`.
+ */
+void removeSnapshots(void);
+
 #endif // DEBUGGER_H
 
 /*
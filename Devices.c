@@ -0,0 +1,153 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "Global.h"
+
+#include "Devices.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+typedef bool (*DeviceInit)(const MCUDeviceApi* api, const char* args);
+typedef void (*DeviceExit)(void);
+
+/*
+ * Loaded plugin. Api is kept here, plugin can use it until exit.
+ */
+typedef struct {
+  void* handle;
+  DeviceExit exit;
+  MCUDeviceApi api;
+} DevicePlugin;
+
+struct {
+  DevicePlugin** plugins;
+  unsigned numOfPlugins;
+} g_devices;
+
+/*
+ * Callbacks.
+ */
+static void deviceMap(void* context, WORD first, WORD last, MCUDeviceRead read,
+                      MCUDeviceWrite write, void* device)
+{
+  if (first <= last)
+    mapDeviceMCU(context, first, last, read, write, device);
+}
+
+static unsigned long long deviceCycles(void* context)
+{
+  return ((MCU*) context)->cycles;
+}
+
+static void* deviceSymbol(void* handle, const char* name)
+{
+#ifdef _WIN32
+  return (void*) GetProcAddress((HMODULE) handle, name);
+#else
+  return dlsym(handle, name);
+#endif
+}
+
+static void deviceClose(void* handle)
+{
+#ifdef _WIN32
+  FreeLibrary((HMODULE) handle);
+#else
+  dlclose(handle);
+#endif
+}
+
+bool loadDevice(MCU* mcu, const char* file, const char* args)
+{
+  void* handle;
+
+#ifdef _WIN32
+  handle = LoadLibrary(file);
+#else
+  // Without slash dlopen searches library path only.
+  char* path = malloc(strlen(file) + 3);
+  sprintf(path, strchr(file, '/') == NULL ? "./%s" : "%s", file);
+  handle = dlopen(path, RTLD_NOW);
+  free(path);
+#endif
+
+  if (handle == NULL) {
+    fprintf(AppSettings()->errorOut, "Can't load device '%s'.\n", file);
+    return false;
+  }
+
+  const unsigned* version = deviceSymbol(handle, "s51dDeviceVersion");
+  DeviceInit init = (DeviceInit) deviceSymbol(handle, "s51dDeviceInit");
+
+  if (version == NULL || init == NULL || *version != DEVICE_API_VERSION) {
+    fprintf(AppSettings()->errorOut, "'%s' is not valid device.\n", file);
+    deviceClose(handle);
+    return false;
+  }
+
+  DevicePlugin* plugin = malloc(sizeof(DevicePlugin));
+  plugin->handle = handle;
+  plugin->exit = (DeviceExit) deviceSymbol(handle, "s51dDeviceExit");
+  plugin->api.context = mcu;
+  plugin->api.map = &deviceMap;
+  plugin->api.cycles = &deviceCycles;
+
+  g_devices.plugins = realloc(g_devices.plugins,
+                              (g_devices.numOfPlugins + 1) * sizeof(DevicePlugin*));
+  g_devices.plugins[g_devices.numOfPlugins++] = plugin;
+
+  if (!init(&plugin->api, args != NULL ? args : "")) {
+    fprintf(AppSettings()->errorOut, "Device '%s' failed to initialize.\n", file);
+    return false;
+  }
+
+  return true;
+}
+
+void unloadDevices(MCU* mcu)
+{
+  // Callbacks are gone with plugins.
+  unmapDevicesMCU(mcu);
+
+  for (unsigned i = 0; i < g_devices.numOfPlugins; ++i) {
+    DevicePlugin* plugin = g_devices.plugins[i];
+
+    if (plugin->exit != NULL)
+      plugin->exit();
+
+    deviceClose(plugin->handle);
+    free(plugin);
+  }
+
+  free(g_devices.plugins);
+  g_devices.plugins = NULL;
+  g_devices.numOfPlugins = 0;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,59 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DEVICES_H_
+#define DEVICES_H_
+
+#include "MCS51.h"
+
+/*
+ * Interface of device plugins. Plugin is shared object which exports
+ *
+ *   const unsigned s51dDeviceVersion = DEVICE_API_VERSION;
+ *   bool s51dDeviceInit(const MCUDeviceApi* api, const char* args);
+ *   void s51dDeviceExit(void);  (optional)
+ *
+ * Init maps device registers with api->map and returns false on failure.
+ * Api stays valid until exit, args is text after comma in --device option.
+ */
+#define DEVICE_API_VERSION 1
+
+typedef struct {
+  void* context;
+  void (*map)(void* context, WORD first, WORD last, MCUDeviceRead read,
+              MCUDeviceWrite write, void* device);
+  unsigned long long (*cycles)(void* context);
+} MCUDeviceApi;
+
+/*
+ * Load plugin from file and let it map its devices into mcu.
+ */
+bool loadDevice(MCU* mcu, const char* file, const char* args);
+
+/*
+ * Unmap devices of all plugins and unload them.
+ */
+void unloadDevices(MCU* mcu);
+
+#endif /* DEVICES_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
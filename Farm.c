@@ -0,0 +1,788 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// clock_gettime() isn't part of plain C99.
+#define _POSIX_C_SOURCE 200809L
+
+#include "Global.h"
+
+#include "Farm.h"
+#include "Sweep.h"
+#include "Lockstep.h"
+#include "IntelHex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define FARM_LINE_SIZE 1024
+
+typedef struct {
+  char* name;
+  char* hex;
+  char* mcu;
+  unsigned oscillator;
+  unsigned long long cycles;
+  BYTE* input;
+  size_t inputSize;
+  BYTE* expect;
+  size_t expectSize;
+  bool hasExpect;
+  int engine; // in g_farmEngines, -1 for settings
+} FarmJob;
+
+typedef struct {
+  bool passed;
+  const char* reason;
+  const char* error;
+  unsigned long long cycles;
+  unsigned long long instructions;
+  double wall;
+  size_t outputSize;
+  unsigned long digest;
+  FILE* divergence; // lockstep report, written out after workers end
+} FarmResult;
+
+/*
+ * Groups of jobs still waiting in queue of one worker. Owner takes them from tail,
+ * other workers steal from head when their own queue is empty.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  int head;
+  int tail;
+} FarmQueue;
+
+typedef struct {
+  MCU* mcu;
+  const FarmJob* job; // first job which uses it
+  bool initialized;
+  const char* error;  // NULL when loaded
+} FarmImage;
+
+typedef struct {
+  FarmJob* jobs;
+  FarmResult* results;
+  int* order;      // job indexes, jobs of every group are together
+  int* groupStart; // first job of every group in order, numOfGroups + 1 items
+  int numOfGroups;
+  FarmImage* images;
+  int* groupImage;   // image of every group
+  int numOfImages;
+  FarmQueue* queues;
+  int numOfQueues;
+  const MCU* settings;
+  bool lockstep;
+} Farm;
+
+typedef struct {
+  Farm* farm;
+  int id;
+} FarmWorker;
+
+/*
+ * Engines selectable by jobs.
+ */
+static const struct {
+  const char* name;
+  bool noDebug;
+  bool usePredecoded;
+  bool useBlocks;
+  bool lazyFlags;
+} g_farmEngines[] = {
+  { "interpreter", false, false, false, false },
+  { "predecoded", false, true, false, false },
+  { "blocks", false, true, true, false },
+  { "lazy", false, false, false, true },
+  { "turbo", true, true, true, true },
+};
+
+#define FARM_ENGINES ((int) (sizeof(g_farmEngines) / sizeof(g_farmEngines[0])))
+
+double farmTime(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return (double) count.QuadPart / frequency.QuadPart;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+int farmProcessors(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? n : 1;
+#endif
+}
+
+BYTE* farmReadFile(const char* file, size_t* size)
+{
+  FILE* in = fopen(file, "rb");
+  BYTE* data = NULL;
+  BYTE buffer[4096];
+  size_t n;
+
+  *size = 0;
+  if (in == NULL)
+    return NULL;
+
+  while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+    data = realloc(data, *size + n);
+    memcpy(data + *size, buffer, n);
+    *size += n;
+  }
+
+  fclose(in);
+
+  // Empty file is valid too.
+  if (data == NULL)
+    data = malloc(1);
+
+  return data;
+}
+
+static char* farmCopy(const char* text)
+{
+  char* copy = malloc(strlen(text) + 1);
+  strcpy(copy, text);
+  return copy;
+}
+
+static void farmFreeJobs(FarmJob* jobs, int numOfJobs)
+{
+  for (int i = 0; i < numOfJobs; ++i) {
+    free(jobs[i].name);
+    free(jobs[i].hex);
+    free(jobs[i].mcu);
+    free(jobs[i].input);
+    free(jobs[i].expect);
+  }
+
+  free(jobs);
+}
+
+/*
+ * Parse one key=value field of job, prints error and returns false when it
+ * is invalid.
+ */
+static bool farmParseField(FarmJob* job, char* field, const char* file, int line)
+{
+  char* value = strchr(field, '=');
+
+  if (value == NULL) {
+    fprintf(AppSettings()->errorOut, "%s:%i: '%s' is not key=value.\n", file, line, field);
+    return false;
+  }
+
+  *value++ = '\0';
+
+  if (0 == strcmp(field, "name")) {
+    free(job->name);
+    job->name = farmCopy(value);
+  } else if (0 == strcmp(field, "hex")) {
+    free(job->hex);
+    job->hex = farmCopy(value);
+  } else if (0 == strcmp(field, "mcu")) {
+    free(job->mcu);
+    job->mcu = farmCopy(value);
+  } else if (0 == strcmp(field, "osc")) {
+    job->oscillator = strtoul(value, NULL, 10);
+  } else if (0 == strcmp(field, "cycles")) {
+    job->cycles = strtoull(value, NULL, 10);
+  } else if (0 == strcmp(field, "engine")) {
+    job->engine = 0;
+    while (job->engine < FARM_ENGINES && 0 != strcmp(value, g_farmEngines[job->engine].name))
+      job->engine += 1;
+
+    if (job->engine == FARM_ENGINES) {
+      fprintf(AppSettings()->errorOut, "%s:%i: Unknown engine '%s'.\n", file, line, value);
+      return false;
+    }
+  } else if (0 == strcmp(field, "input") || 0 == strcmp(field, "expect")) {
+    bool input = field[0] == 'i';
+    size_t size;
+    BYTE* data = farmReadFile(value, &size);
+
+    if (data == NULL) {
+      fprintf(AppSettings()->errorOut, "%s:%i: Error while trying to open '%s': %s.\n",
+              file, line, value, strerror(errno));
+      return false;
+    }
+
+    if (input) {
+      free(job->input);
+      job->input = data;
+      job->inputSize = size;
+    } else {
+      free(job->expect);
+      job->expect = data;
+      job->expectSize = size;
+      job->hasExpect = true;
+    }
+  } else {
+    fprintf(AppSettings()->errorOut, "%s:%i: Unknown key '%s'.\n", file, line, field);
+    return false;
+  }
+
+  return true;
+}
+
+static bool farmParseJobs(const char* file, FarmJob** jobs, int* numOfJobs)
+{
+  FILE* in = fopen(file, "r");
+  char text[FARM_LINE_SIZE];
+  int line = 0;
+  bool valid = true;
+
+  *jobs = NULL;
+  *numOfJobs = 0;
+
+  if (in == NULL) {
+    fprintf(AppSettings()->errorOut, "Error while trying to open '%s': %s.\n", file,
+            strerror(errno));
+    return false;
+  }
+
+  while (valid && fgets(text, sizeof(text), in) != NULL) {
+    char* field = strtok(text, " \t\r\n");
+    line += 1;
+
+    if (field == NULL || field[0] == '#')
+      continue;
+
+    *jobs = realloc(*jobs, (*numOfJobs + 1) * sizeof(FarmJob));
+    FarmJob* job = &(*jobs)[(*numOfJobs)++];
+    memset(job, 0, sizeof(FarmJob));
+    job->oscillator = 11059200;
+    job->engine = -1;
+
+    for (; valid && field != NULL; field = strtok(NULL, " \t\r\n"))
+      valid = farmParseField(job, field, file, line);
+
+    if (valid && (job->hex == NULL || job->cycles == 0)) {
+      fprintf(AppSettings()->errorOut, "%s:%i: Job needs hex and cycles.\n", file, line);
+      valid = false;
+    }
+
+    if (job->name == NULL) {
+      char name[16];
+      sprintf(name, "%i", line);
+      job->name = farmCopy(name);
+    }
+  }
+
+  fclose(in);
+
+  if (!valid) {
+    farmFreeJobs(*jobs, *numOfJobs);
+    *jobs = NULL;
+    *numOfJobs = 0;
+  }
+
+  return valid;
+}
+
+/*
+ * FNV-1a, like hash of code in recompiled modules.
+ */
+static unsigned long farmDigest(unsigned long hash, BYTE byte)
+{
+  return ((hash ^ byte) * 16777619UL) & 0xFFFFFFFFUL;
+}
+
+/*
+ * Load image for jobs with the same hex and mcu, groups run on its copies.
+ */
+static void farmLoadImage(const FarmJob* job, const MCU* settings, FarmImage* image)
+{
+  MCU* mcu = malloc(sizeof(MCU));
+  bool valid = false;
+  WORD highestAddress = 0;
+
+  image->mcu = mcu;
+  image->error = NULL;
+  mcu->noDebug = job->engine < 0 ? settings->noDebug : g_farmEngines[job->engine].noDebug;
+  image->initialized = initNamedMCU(mcu, job->mcu != NULL ? job->mcu : "8052");
+
+  if (!image->initialized) {
+    image->error = "Invalid MCU type.";
+    return;
+  }
+
+  if (job->engine < 0) {
+    mcu->usePredecoded = settings->usePredecoded;
+    mcu->useBlocks = settings->useBlocks;
+    mcu->lazyFlags = settings->lazyFlags;
+  } else {
+    mcu->usePredecoded = g_farmEngines[job->engine].usePredecoded;
+    mcu->useBlocks = g_farmEngines[job->engine].useBlocks;
+    mcu->lazyFlags = g_farmEngines[job->engine].lazyFlags;
+  }
+  poisonMCU(mcu, settings->poison, settings->poisonValue);
+
+  // Like `load irom`.
+  loadIntelHexMCU(job->hex, mcu, IROM, 0, mcu->iromMemorySize - 1, &valid, &highestAddress,
+                  NULL);
+
+  if (highestAddress >= mcu->iromMemorySize)
+    loadIntelHexMCU(job->hex, mcu, XROM, mcu->iromMemorySize, mcu->xromMemorySize - 1,
+                    &valid, NULL, NULL);
+
+  invalidatePredecodedMCU(mcu);
+
+  if (!valid)
+    image->error = "Image not loaded correctly.";
+}
+
+/*
+ * Output of one lane, checked against expected output on the fly.
+ */
+typedef struct {
+  const FarmJob* job;
+  FarmResult* result;
+  bool matches;
+} FarmLane;
+
+static void farmOutput(void* context, BYTE out)
+{
+  FarmLane* lane = context;
+  const FarmJob* job = lane->job;
+  FarmResult* result = lane->result;
+
+  if (job->hasExpect && (result->outputSize >= job->expectSize ||
+                         job->expect[result->outputSize] != out))
+    lane->matches = false;
+
+  result->digest = farmDigest(result->digest, out);
+  result->outputSize += 1;
+}
+
+/*
+ * Run job alone, its engine is checked against the interpreter after every
+ * step (see runLockstepMCU). Uart is handled like by runSweepMCU(). Returns
+ * false when engines diverged, report is kept in *divergence.
+ */
+static bool farmRunLockstep(MCU* mcu, MCUSweepLane* lane, unsigned long long maxCycles,
+                            FILE** divergence)
+{
+  unsigned long long end = mcu->cycles + maxCycles;
+  MCUStopReason reason = STOP_BUDGET;
+  size_t position = 0;
+  bool same = true;
+
+  *divergence = tmpfile();
+
+  while (same && mcu->cycles < end) {
+    int stopMask = STOP_POWERDOWN | STOP_SELFLOOP | STOP_OUTPUT;
+    unsigned long long executed;
+
+    if (position < lane->inputSize)
+      stopMask |= STOP_INPUT;
+
+    same = runLockstepMCU(mcu, MCU_NO_LIMIT, end - mcu->cycles, stopMask, &executed, &reason,
+                          *divergence != NULL ? *divergence : AppSettings()->errorOut);
+
+    // Turbo engine doesn't stop on errors, but the last one can be seen.
+    if (mcu->errid != E_NOERRORS) {
+      reason = STOP_ERROR;
+      break;
+    }
+
+    if (reason == STOP_OUTPUT)
+      lane->output(lane->context, (BYTE) takeOutputMCU(mcu));
+    else if (reason == STOP_INPUT)
+      mcu->INPUT = lane->input[position++];
+    else if (reason != STOP_BUDGET || executed == 0)
+      break;
+  }
+
+  lane->reason = reason;
+  lane->errid = mcu->errid;
+  lane->cycles = mcu->cycles;
+  lane->instructions = mcu->instructions;
+
+  if (same && *divergence != NULL) {
+    fclose(*divergence);
+    *divergence = NULL;
+  }
+
+  return same;
+}
+
+/*
+ * Report of diverged job, reports of jobs run at once aren't mixed.
+ */
+static void farmPrintDivergence(const FarmJob* job, FILE* divergence)
+{
+  char text[FARM_LINE_SIZE];
+
+  fprintf(AppSettings()->errorOut, "Job %s: ", job->name);
+
+  rewind(divergence);
+  while (fgets(text, sizeof(text), divergence) != NULL)
+    fputs(text, AppSettings()->errorOut);
+
+  fclose(divergence);
+}
+
+/*
+ * Run jobs of one group, they differ only in input and expected output so
+ * image is loaded once and all of them run in one sweep.
+ */
+static void farmRunGroup(Farm* farm, int group)
+{
+  const int* members = &farm->order[farm->groupStart[group]];
+  int numOfMembers = farm->groupStart[group + 1] - farm->groupStart[group];
+  const FarmJob* first = &farm->jobs[members[0]];
+  FarmImage* image = &farm->images[farm->groupImage[group]];
+  MCU* mcu = malloc(sizeof(MCU));
+  MCUSweepLane* lanes = malloc(numOfMembers * sizeof(MCUSweepLane));
+  FarmLane* contexts = malloc(numOfMembers * sizeof(FarmLane));
+  const char* error = image->error;
+  double start = farmTime();
+  bool diverged = false;
+
+  for (int i = 0; i < numOfMembers; ++i) {
+    FarmResult* result = &farm->results[members[i]];
+
+    result->passed = false;
+    result->reason = "budget";
+    result->error = NULL;
+    result->cycles = 0;
+    result->instructions = 0;
+    result->outputSize = 0;
+    result->digest = 2166136261UL;
+    result->divergence = NULL;
+  }
+
+  if (error == NULL) {
+    // Code pages stay shared with the image.
+    cloneMCU(mcu, image->mcu);
+    mcu->oscillator = first->oscillator;
+
+    for (int i = 0; i < numOfMembers; ++i) {
+      const FarmJob* job = &farm->jobs[members[i]];
+
+      contexts[i].job = job;
+      contexts[i].result = &farm->results[members[i]];
+      contexts[i].matches = true;
+      lanes[i].input = job->input;
+      lanes[i].inputSize = job->inputSize;
+      lanes[i].output = &farmOutput;
+      lanes[i].context = &contexts[i];
+    }
+
+    // Groups have one job with lockstep.
+    if (farm->lockstep)
+      diverged = !farmRunLockstep(mcu, &lanes[0], first->cycles,
+                                  &farm->results[members[0]].divergence);
+    else
+      runSweepMCU(mcu, lanes, numOfMembers, first->cycles, STOP_POWERDOWN | STOP_SELFLOOP);
+
+    removeMCU(mcu);
+  }
+
+  for (int i = 0; i < numOfMembers; ++i) {
+    const FarmJob* job = &farm->jobs[members[i]];
+    FarmResult* result = &farm->results[members[i]];
+
+    result->wall = farmTime() - start;
+
+    if (error != NULL) {
+      result->reason = "error";
+      result->error = error;
+      continue;
+    }
+
+    if (lanes[i].errid != E_NOERRORS) {
+      // Start state isn't needed any more, it only gives the message.
+      mcu->errid = lanes[i].errid;
+      result->reason = "error";
+      result->error = getError(mcu);
+    } else if (diverged) {
+      result->reason = "lockstep";
+      result->error = "Engines diverged, see error output.";
+    } else if (lanes[i].reason == STOP_POWERDOWN) {
+      result->reason = "powerdown";
+    } else if (lanes[i].reason == STOP_SELFLOOP) {
+      result->reason = "halt";
+    }
+
+    if (job->hasExpect && result->outputSize != job->expectSize)
+      contexts[i].matches = false;
+
+    result->passed = lanes[i].errid == E_NOERRORS && contexts[i].matches && !diverged;
+    result->cycles = lanes[i].cycles;
+    result->instructions = lanes[i].instructions;
+  }
+
+  free(mcu);
+  free(lanes);
+  free(contexts);
+}
+
+static bool farmSameImage(const FarmJob* a, const FarmJob* b)
+{
+  const char* typeA = a->mcu != NULL ? a->mcu : "8052";
+  const char* typeB = b->mcu != NULL ? b->mcu : "8052";
+
+  return 0 == strcmp(a->hex, b->hex) && 0 == strcmp(typeA, typeB) && a->engine == b->engine;
+}
+
+static bool farmSameProgram(const FarmJob* a, const FarmJob* b)
+{
+  return farmSameImage(a, b) && a->oscillator == b->oscillator && a->cycles == b->cycles;
+}
+
+/*
+ * Put jobs into groups run together. Without sweep every job is alone.
+ */
+static void farmGroupJobs(Farm* farm, int numOfJobs, bool sweep)
+{
+  bool* grouped = calloc(numOfJobs > 0 ? numOfJobs : 1, sizeof(bool));
+  int count = 0;
+
+  farm->order = malloc((numOfJobs > 0 ? numOfJobs : 1) * sizeof(int));
+  farm->groupStart = malloc((numOfJobs + 1) * sizeof(int));
+  farm->numOfGroups = 0;
+
+  for (int i = 0; i < numOfJobs; ++i) {
+    if (grouped[i])
+      continue;
+
+    farm->groupStart[farm->numOfGroups++] = count;
+    farm->order[count++] = i;
+
+    for (int j = i + 1; sweep && j < numOfJobs; ++j) {
+      if (!grouped[j] && farmSameProgram(&farm->jobs[i], &farm->jobs[j])) {
+        grouped[j] = true;
+        farm->order[count++] = j;
+      }
+    }
+  }
+
+  farm->groupStart[farm->numOfGroups] = count;
+  free(grouped);
+}
+
+/*
+ * Every image is loaded once, before workers start.
+ */
+static void farmLoadImages(Farm* farm)
+{
+  farm->images = malloc((farm->numOfGroups > 0 ? farm->numOfGroups : 1) * sizeof(FarmImage));
+  farm->groupImage = malloc((farm->numOfGroups > 0 ? farm->numOfGroups : 1) * sizeof(int));
+  farm->numOfImages = 0;
+
+  for (int i = 0; i < farm->numOfGroups; ++i) {
+    const FarmJob* job = &farm->jobs[farm->order[farm->groupStart[i]]];
+    int image = 0;
+
+    while (image < farm->numOfImages && !farmSameImage(job, farm->images[image].job))
+      image += 1;
+
+    if (image == farm->numOfImages) {
+      farm->images[image].job = job;
+      farmLoadImage(job, farm->settings, &farm->images[image]);
+      farm->numOfImages += 1;
+    }
+
+    farm->groupImage[i] = image;
+  }
+}
+
+static void farmFreeImages(Farm* farm)
+{
+  for (int i = 0; i < farm->numOfImages; ++i) {
+    if (farm->images[i].initialized)
+      removeMCU(farm->images[i].mcu);
+
+    free(farm->images[i].mcu);
+  }
+
+  free(farm->images);
+  free(farm->groupImage);
+}
+
+static bool farmTake(FarmQueue* queue, bool steal, int* group)
+{
+  bool taken = false;
+
+  pthread_mutex_lock(&queue->lock);
+  if (queue->head < queue->tail) {
+    *group = steal ? queue->head++ : --queue->tail;
+    taken = true;
+  }
+  pthread_mutex_unlock(&queue->lock);
+
+  return taken;
+}
+
+static void* farmWorker(void* arg)
+{
+  FarmWorker* worker = arg;
+  Farm* farm = worker->farm;
+  int group;
+
+  while (true) {
+    bool taken = farmTake(&farm->queues[worker->id], false, &group);
+
+    // Nothing is queued later, so all empty queues mean the end.
+    for (int i = 1; !taken && i < farm->numOfQueues; ++i)
+      taken = farmTake(&farm->queues[(worker->id + i) % farm->numOfQueues], true, &group);
+
+    if (!taken)
+      break;
+
+    farmRunGroup(farm, group);
+  }
+
+  return NULL;
+}
+
+void farmPrintString(FILE* report, const char* text)
+{
+  fputc('"', report);
+  for (; *text != '\0'; ++text) {
+    if (*text == '"' || *text == '\\')
+      fprintf(report, "\\%c", *text);
+    else if ((unsigned char) *text < 0x20)
+      fprintf(report, "\\u%.4x", *text);
+    else
+      fputc(*text, report);
+  }
+  fputc('"', report);
+}
+
+bool runFarm(const char* jobsFile, int threads, bool sweep, bool lockstep,
+             const MCU* settings, FILE* report)
+{
+  Farm farm;
+  int numOfJobs;
+  int passed = 0;
+  double start = farmTime();
+
+  if (!farmParseJobs(jobsFile, &farm.jobs, &numOfJobs))
+    return false;
+
+  if (threads <= 0)
+    threads = farmProcessors();
+
+  farm.settings = settings;
+  farm.lockstep = lockstep;
+  farmGroupJobs(&farm, numOfJobs, sweep && !lockstep);
+  farmLoadImages(&farm);
+
+  if (threads > farm.numOfGroups)
+    threads = farm.numOfGroups > 0 ? farm.numOfGroups : 1;
+
+  farm.results = malloc((numOfJobs > 0 ? numOfJobs : 1) * sizeof(FarmResult));
+  farm.queues = malloc(threads * sizeof(FarmQueue));
+  farm.numOfQueues = threads;
+
+  // Every worker starts with continuous part of groups.
+  for (int i = 0; i < threads; ++i) {
+    pthread_mutex_init(&farm.queues[i].lock, NULL);
+    farm.queues[i].head = (long long) farm.numOfGroups * i / threads;
+    farm.queues[i].tail = (long long) farm.numOfGroups * (i + 1) / threads;
+  }
+
+  pthread_t* handles = malloc(threads * sizeof(pthread_t));
+  FarmWorker* workers = malloc(threads * sizeof(FarmWorker));
+
+  for (int i = 0; i < threads; ++i) {
+    workers[i].farm = &farm;
+    workers[i].id = i;
+    pthread_create(&handles[i], NULL, &farmWorker, &workers[i]);
+  }
+
+  for (int i = 0; i < threads; ++i)
+    pthread_join(handles[i], NULL);
+
+  for (int i = 0; i < numOfJobs; ++i) {
+    if (farm.results[i].divergence != NULL)
+      farmPrintDivergence(&farm.jobs[i], farm.results[i].divergence);
+  }
+
+  for (int i = 0; i < numOfJobs; ++i) {
+    FarmResult* result = &farm.results[i];
+
+    fprintf(report, "{\"job\": ");
+    farmPrintString(report, farm.jobs[i].name);
+    fprintf(report, ", \"result\": \"%s\", \"reason\": \"%s\", \"cycles\": %llu, "
+            "\"instructions\": %llu, \"wall\": %.6f, \"output\": %lu, "
+            "\"digest\": \"%.8lx\"",
+            result->passed ? "pass" : "fail", result->reason, result->cycles,
+            result->instructions, result->wall, (unsigned long) result->outputSize,
+            result->digest);
+
+    if (result->error != NULL) {
+      fprintf(report, ", \"error\": ");
+      farmPrintString(report, result->error);
+    }
+
+    fprintf(report, "}\n");
+
+    if (result->passed)
+      passed += 1;
+  }
+
+  fprintf(report, "{\"jobs\": %i, \"passed\": %i, \"failed\": %i, \"threads\": %i, "
+          "\"wall\": %.6f}\n", numOfJobs, passed, numOfJobs - passed, threads,
+          farmTime() - start);
+  fflush(report);
+
+  for (int i = 0; i < threads; ++i)
+    pthread_mutex_destroy(&farm.queues[i].lock);
+
+  free(handles);
+  free(workers);
+  free(farm.queues);
+  free(farm.results);
+  farmFreeImages(&farm);
+  free(farm.order);
+  free(farm.groupStart);
+  farmFreeJobs(farm.jobs, numOfJobs);
+
+  return passed == numOfJobs;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,77 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FARM_H_
+#define FARM_H_
+
+#include <stdio.h>
+#include "MCS51.h"
+
+/*
+ * Regression farm. Jobs file has one job per line, fields are key=value
+ * separated by spaces, empty lines and lines starting with # are skipped:
+ *
+ *   name=<text>     name in report (default: line number)
+ *   hex=<file>      Intel HEX image, loaded like `load irom` (required)
+ *   mcu=<type>      8031 8032 8051 8052 89S51 89S52 (default: 8052)
+ *   osc=<hz>        oscillator frequency (default: 11059200)
+ *   cycles=<n>      machine cycle budget (required)
+ *   input=<file>    bytes fed to uart receiver, one every time it waits
+ *   expect=<file>   expected uart output, job fails when output differs
+ *   engine=<name>   interpreter, predecoded, blocks, lazy (flags) or turbo
+ *                   (all of them without debugger), default: settings
+ *
+ * Job ends when budget is used, on power down or when program halts
+ * (`sjmp $`, idle with interrupts disabled). It fails on simulator error,
+ * unreadable image or output different from expected one.
+ */
+
+/*
+ * Run jobs on threads workers (0 means one per processor), every job with
+ * its own MCU. Every hex is loaded once per mcu type, jobs run on copies
+ * which share its code pages (cloneMCU). With sweep jobs with the same hex,
+ * mcu, osc, cycles and engine are run together by runSweepMCU(), shared
+ * part of their runs is simulated only once and wall time is the one of the
+ * whole group. Engine settings (noDebug, usePredecoded, lazyFlags,
+ * useBlocks) of jobs without engine are copied from settings, simulator
+ * errors are detected only without noDebug. With lockstep every job runs
+ * alone checked against the interpreter (runLockstepMCU), it fails when
+ * engines diverge and the difference is written into error output. Writes
+ * JSON object for every job in file order and summary object at the end
+ * into report, one per line. Returns true when all jobs passed.
+ */
+bool runFarm(const char* jobsFile, int threads, bool sweep, bool lockstep,
+             const MCU* settings, FILE* report);
+
+/*
+ * Helpers shared with other batch modes: monotonic time in seconds, number
+ * of processors, contents of file (NULL when it can't be read) and JSON
+ * string.
+ */
+double farmTime(void);
+int farmProcessors(void);
+BYTE* farmReadFile(const char* file, size_t* size);
+void farmPrintString(FILE* report, const char* text);
+
+#endif /* FARM_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
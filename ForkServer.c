@@ -0,0 +1,237 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// fdopen(), sigaction() and S_ISSOCK() aren't part of plain C99.
+#define _POSIX_C_SOURCE 200809L
+
+#include "Global.h"
+
+#include "ForkServer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#ifdef _WIN32
+
+void runForkServer(const char* socketFile)
+{
+  fprintf(AppSettings()->errorOut, "Fork server isn't available on this system.\n");
+  exit(EXIT_FAILURE);
+}
+
+#else
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+static volatile sig_atomic_t g_stopServer = 0;
+
+static void forkServerStop(int signal)
+{
+  g_stopServer = signal;
+}
+
+static void forkServerWrite(int fd, const char* data, size_t size)
+{
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+
+    if (n < 0 && errno == EINTR)
+      continue;
+
+    // Client is gone.
+    if (n <= 0)
+      return;
+
+    data += n;
+    size -= n;
+  }
+}
+
+/*
+ * Collect output of test, wait for its end and send both to client.
+ */
+static void forkServerAnswer(int connection, int output, pid_t test)
+{
+  char* buffer = NULL;
+  size_t size = 0;
+  size_t capacity = 0;
+  int status = 0;
+  char header[64];
+
+  for (;;) {
+    ssize_t n;
+
+    if (size == capacity) {
+      capacity = capacity > 0 ? capacity * 2 : 4096;
+      buffer = realloc(buffer, capacity);
+    }
+
+    n = read(output, buffer + size, capacity - size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+
+    size += n;
+  }
+
+  while (waitpid(test, &status, 0) < 0 && errno == EINTR)
+    ;
+
+  if (WIFSIGNALED(status))
+    snprintf(header, sizeof(header), "signal %d %zu\n", WTERMSIG(status), size);
+  else
+    snprintf(header, sizeof(header), "exit %d %zu\n", WEXITSTATUS(status), size);
+
+  forkServerWrite(connection, header, strlen(header));
+  forkServerWrite(connection, buffer, size);
+  free(buffer);
+}
+
+/*
+ * Process of one connection. Forks test process, there returns true, and
+ * answers when it ends.
+ */
+static bool forkServerConnection(int server, int connection)
+{
+  int output[2];
+  pid_t test;
+
+  close(server);
+  signal(SIGINT, SIG_DFL);
+  signal(SIGTERM, SIG_DFL);
+  signal(SIGCHLD, SIG_DFL);
+  signal(SIGPIPE, SIG_IGN);
+
+  if (pipe(output) != 0 || (test = fork()) < 0) {
+    fprintf(stderr, "Error while trying to start test: %s.\n", strerror(errno));
+    _exit(EXIT_FAILURE);
+  }
+
+  if (test == 0) {
+    signal(SIGPIPE, SIG_DFL);
+
+    close(output[0]);
+    dup2(output[1], STDOUT_FILENO);
+    dup2(output[1], STDERR_FILENO);
+    close(output[1]);
+
+    // Script ends when client shuts down writing.
+    AppSettings()->in = fdopen(connection, "r");
+    return true;
+  }
+
+  close(output[1]);
+  forkServerAnswer(connection, output[0], test);
+  close(output[0]);
+  close(connection);
+
+  return false;
+}
+
+void runForkServer(const char* socketFile)
+{
+  struct sockaddr_un address;
+  struct sigaction action;
+  struct stat info;
+  int server;
+
+  if (strlen(socketFile) >= sizeof(address.sun_path)) {
+    fprintf(AppSettings()->errorOut, "Socket name '%s' is too long.\n", socketFile);
+    exit(EXIT_FAILURE);
+  }
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socketFile);
+
+  // Socket left by previous server, other files are kept.
+  if (stat(socketFile, &info) == 0 && S_ISSOCK(info.st_mode))
+    unlink(socketFile);
+
+  server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0 ||
+      bind(server, (struct sockaddr*) &address, sizeof(address)) != 0 ||
+      listen(server, SOMAXCONN) != 0) {
+    fprintf(AppSettings()->errorOut, "Error while trying to listen on '%s': %s.\n",
+            socketFile, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+
+  // Without SA_RESTART, so accept() is interrupted.
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = forkServerStop;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  // Connection processes aren't waited for.
+  action.sa_handler = SIG_IGN;
+  sigaction(SIGCHLD, &action, NULL);
+
+  fprintf(AppSettings()->errorOut, "Fork server listening on '%s'.\n", socketFile);
+
+  while (!g_stopServer) {
+    int connection = accept(server, NULL, NULL);
+    pid_t process;
+
+    if (connection < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+
+      fprintf(AppSettings()->errorOut, "Error while trying to accept connection: %s.\n",
+              strerror(errno));
+      break;
+    }
+
+    // Buffered output of server would be written by tests too.
+    fflush(stdout);
+    fflush(stderr);
+
+    process = fork();
+    if (process == 0) {
+      if (forkServerConnection(server, connection))
+        return;
+      _exit(EXIT_SUCCESS);
+    }
+
+    if (process < 0)
+      fprintf(AppSettings()->errorOut, "Error while trying to fork: %s.\n", strerror(errno));
+
+    close(connection);
+  }
+
+  close(server);
+  unlink(socketFile);
+  exit(g_stopServer ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+#endif // _WIN32
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,47 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FORKSERVER_H_
+#define FORKSERVER_H_
+
+/*
+ * Fork server for scripted runs. Current state of AppSettings()->mcu (image
+ * loaded and booted by -e script) is kept by the server process which
+ * listens on Unix socket socketFile. Every connection is one test: client
+ * sends command script and shuts down writing, server forks test process
+ * which runs the script like `s51d -e script` from the kept state. When it
+ * ends client gets header line followed by everything test wrote to stdout
+ * and stderr, then connection is closed:
+ *
+ *   exit <status> <length>\n      test exited with status
+ *   signal <number> <length>\n    test was killed by signal
+ *
+ * Tests run in parallel, every one with its own copy of the process.
+ * Returns only in test process, with output redirected, which runs
+ * runDebugger() then. Server process exits on SIGINT or SIGTERM, or when
+ * socket can't be opened.
+ */
+void runForkServer(const char* socketFile);
+
+#endif /* FORKSERVER_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,730 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "Global.h"
+
+#include "Fuzz.h"
+#include "Farm.h"
+#include "IntelHex.h"
+#include "Utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define FUZZ_STOP (STOP_INPUT | STOP_BREAKPOINT | STOP_ERROR | STOP_POWERDOWN | STOP_SELFLOOP)
+#define FUZZ_STATUS_INTERVAL 10.0
+#define FUZZ_BYTE_CYCLES 1000 // byte at 9600 baud with 11.0592MHz
+#define FUZZ_POINTS 64
+#define FUZZ_POINT_CYCLES 100000 // run since the previous point worth a snapshot
+
+typedef enum {
+  FUZZ_DONE,
+  FUZZ_ERROR,
+  FUZZ_HANG
+} FuzzOutcome;
+
+typedef struct {
+  BYTE* data;
+  size_t size;
+} FuzzInput;
+
+typedef struct {
+  FuzzOutcome outcome;
+  WORD PC;
+  int errid;
+} FuzzFinding;
+
+typedef struct {
+  MCU* snapshot; // at the first uart read
+  const FuzzSettings* settings;
+  unsigned long long end;
+  FILE* report;
+  double start;
+
+  /*
+   * Shared by workers, changed under lock. Corpus inputs aren't changed
+   * after they are added.
+   */
+  pthread_mutex_t lock;
+  FuzzInput* corpus;
+  int numOfCorpus;
+  BYTE* virgin; // buckets of counters seen for every edge
+  unsigned edges;
+  FuzzFinding* findings;
+  int numOfFindings;
+
+  volatile unsigned long long executions; // taken by workers (atomic)
+  volatile int running;                   // workers (atomic)
+} Fuzz;
+
+/*
+ * Execution waiting for byte used of input, what follows depends only on
+ * the next bytes.
+ */
+typedef struct {
+  MCU mcu;
+  BYTE* coverage; // stays with the slot
+  BYTE input[FUZZ_MAX_INPUT];
+  size_t used;
+  unsigned long long lastUse;
+} FuzzPoint;
+
+typedef struct {
+  Fuzz* fuzz;
+  MCU* mcu;
+  BYTE* virgin; // like fuzz->virgin, checked without lock first
+  uint32_t random;
+
+  /*
+   * Points taken after long runs between two bytes. Input starting with
+   * the same bytes as a point is run from there, the work before (like
+   * redrawing screen) isn't done again. The least recently used one is
+   * replaced.
+   */
+  FuzzPoint points[FUZZ_POINTS];
+  int numOfPoints;
+  unsigned long long uses;
+} FuzzWorker;
+
+/*
+ * Bytes which often change path of command parsers.
+ */
+static const BYTE g_interesting[] = {
+  0x00, 0x01, 0x7F, 0x80, 0xFF, '\r', '\n', ' ', ',', '=', '?', '0', '9', 'A', 'Z', 'a', 'z'
+};
+
+static uint32_t fuzzRandom(FuzzWorker* worker)
+{
+  uint32_t x = worker->random;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  worker->random = x;
+
+  return x;
+}
+
+/*
+ * Hit counts are compared in buckets like 1, 2, 3, 4-7, 8-15, 16-31,
+ * 32-127 and 128+, so loops going one more time aren't new coverage.
+ */
+static BYTE fuzzBucket(BYTE count)
+{
+  if (count <= 2)
+    return count;
+  if (count == 3)
+    return 0x04;
+  if (count <= 7)
+    return 0x08;
+  if (count <= 15)
+    return 0x10;
+  if (count <= 31)
+    return 0x20;
+  if (count <= 127)
+    return 0x40;
+
+  return 0x80;
+}
+
+/*
+ * Merge trace into virgin, true when it has a bucket not seen before.
+ */
+static bool fuzzNewCoverage(BYTE* virgin, const BYTE* trace, unsigned* edges)
+{
+  bool found = false;
+
+  for (unsigned i = 0; i < COVERAGE_SIZE; i += sizeof(uint64_t)) {
+    uint64_t word;
+
+    // Most of the map is empty.
+    memcpy(&word, &trace[i], sizeof(word));
+    if (word == 0)
+      continue;
+
+    for (unsigned j = i; j < i + sizeof(uint64_t); ++j) {
+      BYTE bucket = fuzzBucket(trace[j]);
+
+      if (bucket & ~virgin[j]) {
+        if (virgin[j] == 0 && edges != NULL)
+          *edges += 1;
+
+        virgin[j] |= bucket;
+        found = true;
+      }
+    }
+  }
+
+  return found;
+}
+
+/*
+ * Point with the longest part of data, NULL when there is none.
+ */
+static FuzzPoint* fuzzFindPoint(FuzzWorker* worker, const BYTE* data, size_t size)
+{
+  FuzzPoint* found = NULL;
+
+  for (int i = 0; i < worker->numOfPoints; ++i) {
+    FuzzPoint* point = &worker->points[i];
+
+    if (point->used <= size && (found == NULL || point->used > found->used) &&
+        0 == memcmp(data, point->input, point->used))
+      found = point;
+  }
+
+  return found;
+}
+
+static void fuzzAddPoint(FuzzWorker* worker, const BYTE* data, size_t used)
+{
+  FuzzPoint* point;
+
+  if (worker->numOfPoints < FUZZ_POINTS) {
+    point = &worker->points[worker->numOfPoints++];
+    point->coverage = malloc(COVERAGE_SIZE);
+  } else {
+    point = &worker->points[0];
+    for (int i = 1; i < FUZZ_POINTS; ++i) {
+      if (worker->points[i].lastUse < point->lastUse)
+        point = &worker->points[i];
+    }
+
+    removeMCU(&point->mcu);
+  }
+
+  snapshotMCU(&point->mcu, worker->mcu);
+  memcpy(point->coverage, worker->mcu->coverage, COVERAGE_SIZE);
+  memcpy(point->input, data, used);
+  point->used = used;
+  point->lastUse = ++worker->uses;
+}
+
+/*
+ * One execution from the snapshot. Receiver waits already after RI is
+ * cleared, before SBUF is read, so byte comes FUZZ_BYTE_CYCLES after it
+ * waits, like on serial line.
+ */
+static FuzzOutcome fuzzRun(FuzzWorker* worker, const BYTE* data, size_t size)
+{
+  Fuzz* fuzz = worker->fuzz;
+  MCU* mcu = worker->mcu;
+  MCUStopReason reason;
+  unsigned long long limit;
+  unsigned long long arrival; // of the next byte, 0 when receiver doesn't wait
+  unsigned long long pointCycles;
+  size_t used = 0;
+  FuzzPoint* point = fuzzFindPoint(worker, data, size);
+
+  if (point != NULL) {
+    rewindMCU(mcu, &point->mcu);
+    memcpy(mcu->coverage, point->coverage, COVERAGE_SIZE);
+    used = point->used;
+    point->lastUse = ++worker->uses;
+
+    // Byte comes right away.
+    arrival = mcu->cycles;
+  } else {
+    rewindMCU(mcu, fuzz->snapshot);
+    memset(mcu->coverage, 0, COVERAGE_SIZE);
+
+    // Snapshot waits for the first byte.
+    arrival = mcu->cycles + FUZZ_BYTE_CYCLES;
+  }
+
+  pointCycles = mcu->cycles;
+
+  /*
+   * Breakpoint at untilPC (see fuzzInitWorker) is armed with the last byte,
+   * before that it would stop and slow down every busy-wait loop there.
+   */
+  mcu->numOfPCBreakpoints = 0;
+  if (fuzz->settings->untilPC >= 0 && size == 0)
+    mcu->numOfPCBreakpoints = 1;
+
+  for (;;) {
+    if (arrival != 0 && mcu->cycles >= arrival) {
+      // Program waited for the byte which doesn't come.
+      if (used == size)
+        return FUZZ_DONE;
+
+      if (used > 0 && mcu->cycles - pointCycles >= FUZZ_POINT_CYCLES) {
+        fuzzAddPoint(worker, data, used);
+        pointCycles = mcu->cycles;
+      }
+
+      mcu->INPUT = data[used++];
+      arrival = 0;
+
+      if (fuzz->settings->untilPC >= 0 && used == size)
+        mcu->numOfPCBreakpoints = 1;
+    }
+
+    if (mcu->cycles >= fuzz->end)
+      return FUZZ_HANG;
+
+    limit = fuzz->end;
+    if (arrival != 0 && arrival < limit)
+      limit = arrival;
+
+    runMCUBatch(mcu, MCU_NO_LIMIT, limit - mcu->cycles,
+                arrival != 0 ? FUZZ_STOP & ~STOP_INPUT : FUZZ_STOP, &reason);
+
+    if (mcu->errid != E_NOERRORS)
+      return FUZZ_ERROR;
+
+    if (reason == STOP_INPUT)
+      arrival = mcu->cycles + FUZZ_BYTE_CYCLES;
+    else if (reason == STOP_BREAKPOINT) {
+      // Until PC counts only after program took the byte (RI cleared).
+      if (mcu->INPUT == -1 && !(*mcu->SCON & 0x01))
+        return FUZZ_DONE;
+    } else if (reason != STOP_BUDGET)
+      return FUZZ_DONE;
+  }
+}
+
+static void fuzzAddInput(Fuzz* fuzz, const BYTE* data, size_t size)
+{
+  FuzzInput* input;
+
+  fuzz->corpus = realloc(fuzz->corpus, (fuzz->numOfCorpus + 1) * sizeof(FuzzInput));
+  input = &fuzz->corpus[fuzz->numOfCorpus++];
+  input->data = malloc(size > 0 ? size : 1);
+  input->size = size;
+  memcpy(input->data, data, size);
+}
+
+/*
+ * Copy random corpus input into data.
+ */
+static size_t fuzzPick(FuzzWorker* worker, BYTE* data)
+{
+  Fuzz* fuzz = worker->fuzz;
+  size_t size;
+
+  pthread_mutex_lock(&fuzz->lock);
+  FuzzInput* input = &fuzz->corpus[fuzzRandom(worker) % fuzz->numOfCorpus];
+  size = input->size;
+  memcpy(data, input->data, size);
+  pthread_mutex_unlock(&fuzz->lock);
+
+  return size;
+}
+
+/*
+ * Apply 1, 2, 4 or 8 random changes to input.
+ */
+static size_t fuzzMutate(FuzzWorker* worker, BYTE* data, size_t size)
+{
+  int changes = 1 << (fuzzRandom(worker) % 4);
+
+  for (int i = 0; i < changes; ++i) {
+    size_t at = size > 0 ? fuzzRandom(worker) % size : 0;
+    size_t n;
+
+    switch (fuzzRandom(worker) % 8) {
+    case 0: // flip bit
+      if (size > 0)
+        data[at] ^= 1 << (fuzzRandom(worker) % 8);
+      break;
+
+    case 1: // random byte
+      if (size > 0)
+        data[at] = fuzzRandom(worker);
+      break;
+
+    case 2: // interesting byte
+      if (size > 0)
+        data[at] = g_interesting[fuzzRandom(worker) % sizeof(g_interesting)];
+      break;
+
+    case 3: // small addition
+      if (size > 0)
+        data[at] += fuzzRandom(worker) % 17 - 8;
+      break;
+
+    case 4: // insert bytes
+      if (size == FUZZ_MAX_INPUT)
+        break;
+
+      at = fuzzRandom(worker) % (size + 1);
+      n = 1 + fuzzRandom(worker) % 8;
+      if (n > FUZZ_MAX_INPUT - size)
+        n = FUZZ_MAX_INPUT - size;
+
+      memmove(&data[at + n], &data[at], size - at);
+      for (size_t j = at; j < at + n; ++j)
+        data[j] = fuzzRandom(worker) % 2 ? fuzzRandom(worker) :
+                  g_interesting[fuzzRandom(worker) % sizeof(g_interesting)];
+      size += n;
+      break;
+
+    case 5: // delete bytes
+      if (size <= 1)
+        break;
+
+      n = 1 + fuzzRandom(worker) % (size - at < 8 ? size - at : 8);
+      memmove(&data[at], &data[at + n], size - at - n);
+      size -= n;
+      break;
+
+    case 6: // copy part of input over other part
+      if (size <= 1)
+        break;
+
+      n = 1 + fuzzRandom(worker) % (size - at);
+      memmove(&data[fuzzRandom(worker) % (size - n + 1)], &data[at], n);
+      break;
+
+    case 7: { // splice with other corpus input
+      BYTE other[FUZZ_MAX_INPUT];
+      size_t otherSize = fuzzPick(worker, other);
+      size_t from;
+
+      if (otherSize == 0)
+        break;
+
+      at = fuzzRandom(worker) % (size + 1);
+      from = fuzzRandom(worker) % otherSize;
+      n = otherSize - from;
+      if (n > FUZZ_MAX_INPUT - at)
+        n = FUZZ_MAX_INPUT - at;
+
+      memcpy(&data[at], &other[from], n);
+      size = at + n;
+      break;
+    }
+    }
+  }
+
+  return size;
+}
+
+static void fuzzPrintInput(FILE* report, const BYTE* data, size_t size)
+{
+  fputc('"', report);
+  for (size_t i = 0; i < size; ++i)
+    fprintf(report, "%.2x", data[i]);
+  fputc('"', report);
+}
+
+/*
+ * Report finding unless the same kind was found at the same PC before.
+ */
+static void fuzzFinding(Fuzz* fuzz, MCU* mcu, FuzzOutcome outcome, const BYTE* data,
+                        size_t size)
+{
+  int i;
+
+  pthread_mutex_lock(&fuzz->lock);
+
+  for (i = 0; i < fuzz->numOfFindings; ++i) {
+    const FuzzFinding* finding = &fuzz->findings[i];
+
+    if (finding->outcome == outcome && finding->PC == mcu->PC &&
+        finding->errid == mcu->errid)
+      break;
+  }
+
+  if (i == fuzz->numOfFindings) {
+    fuzz->findings = realloc(fuzz->findings, (fuzz->numOfFindings + 1) * sizeof(FuzzFinding));
+    fuzz->findings[fuzz->numOfFindings].outcome = outcome;
+    fuzz->findings[fuzz->numOfFindings].PC = mcu->PC;
+    fuzz->findings[fuzz->numOfFindings].errid = mcu->errid;
+    fuzz->numOfFindings += 1;
+
+    fprintf(fuzz->report, "{\"finding\": \"%s\", \"pc\": \"%.4X\", ",
+            outcome == FUZZ_ERROR ? "error" : "hang", mcu->PC);
+
+    if (outcome == FUZZ_ERROR) {
+      fprintf(fuzz->report, "\"error\": ");
+      farmPrintString(fuzz->report, getError(mcu));
+      fprintf(fuzz->report, ", ");
+    }
+
+    fprintf(fuzz->report, "\"cycles\": %llu, \"wall\": %.6f, \"input\": ",
+            mcu->cycles - fuzz->snapshot->cycles, farmTime() - fuzz->start);
+    fuzzPrintInput(fuzz->report, data, size);
+    fprintf(fuzz->report, "}\n");
+    fflush(fuzz->report);
+  }
+
+  pthread_mutex_unlock(&fuzz->lock);
+}
+
+/*
+ * Look at result of execution, input with new coverage goes to corpus.
+ */
+static void fuzzCheck(FuzzWorker* worker, FuzzOutcome outcome, const BYTE* data, size_t size,
+                      bool always)
+{
+  Fuzz* fuzz = worker->fuzz;
+  MCU* mcu = worker->mcu;
+
+  if (outcome != FUZZ_DONE)
+    fuzzFinding(fuzz, mcu, outcome, data, size);
+
+  // Hangs would only slow down the next executions.
+  if (outcome == FUZZ_HANG && !always)
+    return;
+
+  if (!fuzzNewCoverage(worker->virgin, mcu->coverage, NULL) && !always)
+    return;
+
+  pthread_mutex_lock(&fuzz->lock);
+  if (fuzzNewCoverage(fuzz->virgin, mcu->coverage, &fuzz->edges) || always)
+    fuzzAddInput(fuzz, data, size);
+  pthread_mutex_unlock(&fuzz->lock);
+}
+
+static void fuzzInitWorker(FuzzWorker* worker, Fuzz* fuzz, int id)
+{
+  worker->fuzz = fuzz;
+  worker->mcu = malloc(sizeof(MCU));
+  worker->virgin = calloc(COVERAGE_SIZE, 1);
+  worker->random = 0x9E3779B9u * (id + 1);
+  worker->numOfPoints = 0;
+  worker->uses = 0;
+
+  // Code pages stay shared with the snapshot.
+  cloneMCU(worker->mcu, fuzz->snapshot);
+  worker->mcu->coverage = malloc(COVERAGE_SIZE);
+
+  // Snapshot has none, so rewinding keeps this one without allocations.
+  if (fuzz->settings->untilPC >= 0)
+    setPCBreakpoint(worker->mcu, fuzz->settings->untilPC);
+}
+
+static void fuzzFreeWorker(FuzzWorker* worker)
+{
+  for (int i = 0; i < worker->numOfPoints; ++i) {
+    removeMCU(&worker->points[i].mcu);
+    free(worker->points[i].coverage);
+  }
+
+  free(worker->mcu->coverage);
+  removeMCU(worker->mcu);
+  free(worker->mcu);
+  free(worker->virgin);
+}
+
+static void* fuzzWorker(void* arg)
+{
+  FuzzWorker* worker = arg;
+  Fuzz* fuzz = worker->fuzz;
+  unsigned long long runs = fuzz->settings->runs;
+  BYTE data[FUZZ_MAX_INPUT];
+
+  while (runs == 0 || __sync_add_and_fetch(&fuzz->executions, 1) <= runs) {
+    size_t size = fuzzMutate(worker, data, fuzzPick(worker, data));
+
+    if (runs == 0)
+      __sync_add_and_fetch(&fuzz->executions, 1);
+
+    fuzzCheck(worker, fuzzRun(worker, data, size), data, size, false);
+  }
+
+  __sync_sub_and_fetch(&fuzz->running, 1);
+  return NULL;
+}
+
+/*
+ * Load image and run it until receiver waits for the first byte.
+ */
+static bool fuzzBoot(MCU* mcu, char* hexFile)
+{
+  bool valid = false;
+  WORD highestAddress = 0;
+  MCUStopReason reason;
+
+  // Like `load irom`.
+  resetMCU(mcu);
+  loadIntelHexMCU(hexFile, mcu, IROM, 0, mcu->iromMemorySize - 1, &valid, &highestAddress,
+                  AppSettings()->errorOut);
+
+  if (highestAddress >= mcu->iromMemorySize)
+    loadIntelHexMCU(hexFile, mcu, XROM, mcu->iromMemorySize, mcu->xromMemorySize - 1,
+                    &valid, NULL, AppSettings()->errorOut);
+
+  if (!valid) {
+    fprintf(AppSettings()->errorOut, "File not loaded corectly!\n");
+    return false;
+  }
+
+  invalidatePredecodedMCU(mcu);
+  mcu->noDebug = false;
+  mcu->usePredecoded = false;
+
+  runMCUBatch(mcu, MCU_NO_LIMIT, FUZZ_BOOT_CYCLES, FUZZ_STOP, &reason);
+
+  if (reason != STOP_INPUT) {
+    fprintf(AppSettings()->errorOut, "Program doesn't read uart, stopped at %.4Xh after "
+            "%llu cycles.\n", mcu->PC, mcu->cycles);
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Initial corpus, inputs are added even without new coverage.
+ */
+static bool fuzzSeed(Fuzz* fuzz, FuzzWorker* worker)
+{
+  const FuzzSettings* settings = fuzz->settings;
+
+  for (int i = 0; i < settings->numOfInputs; ++i) {
+    size_t size;
+    BYTE* data = farmReadFile(settings->inputs[i], &size);
+
+    if (data == NULL) {
+      fprintf(AppSettings()->errorOut, "Error while trying to open '%s': %s.\n",
+              settings->inputs[i], strerror(errno));
+      return false;
+    }
+
+    if (size > FUZZ_MAX_INPUT)
+      size = FUZZ_MAX_INPUT;
+
+    fuzzCheck(worker, fuzzRun(worker, data, size), data, size, true);
+    free(data);
+  }
+
+  // Command terminated by new line, when no input is given.
+  if (settings->numOfInputs == 0) {
+    const BYTE data[] = "\r";
+    fuzzCheck(worker, fuzzRun(worker, data, 1), data, 1, true);
+  }
+
+  return true;
+}
+
+/*
+ * Workers take one execution more than runs when they end.
+ */
+static unsigned long long fuzzExecutions(Fuzz* fuzz)
+{
+  unsigned long long executions = fuzz->executions;
+
+  if (fuzz->settings->runs != 0 && executions > fuzz->settings->runs)
+    executions = fuzz->settings->runs;
+
+  return executions;
+}
+
+static void fuzzStatus(Fuzz* fuzz, FILE* out)
+{
+  unsigned long long executions = fuzzExecutions(fuzz);
+  double wall = farmTime() - fuzz->start;
+
+  pthread_mutex_lock(&fuzz->lock);
+  fprintf(out, "fuzz: %llu executions (%.0f/s), corpus %i, edges %u, findings %i\n",
+          executions, wall > 0 ? executions / wall : 0.0, fuzz->numOfCorpus, fuzz->edges,
+          fuzz->numOfFindings);
+  pthread_mutex_unlock(&fuzz->lock);
+}
+
+bool runFuzz(MCU* mcu, char* hexFile, const FuzzSettings* settings, FILE* report)
+{
+  Fuzz fuzz;
+  FuzzWorker* workers;
+  pthread_t* handles;
+  int threads = settings->threads > 0 ? settings->threads : farmProcessors();
+  double status;
+  bool valid;
+
+  if (!fuzzBoot(mcu, hexFile))
+    return false;
+
+  fuzz.snapshot = malloc(sizeof(MCU));
+  snapshotMCU(fuzz.snapshot, mcu);
+  fuzz.settings = settings;
+  fuzz.end = mcu->cycles + settings->cycles;
+  fuzz.report = report;
+  fuzz.start = farmTime();
+  pthread_mutex_init(&fuzz.lock, NULL);
+  fuzz.corpus = NULL;
+  fuzz.numOfCorpus = 0;
+  fuzz.virgin = calloc(COVERAGE_SIZE, 1);
+  fuzz.edges = 0;
+  fuzz.findings = NULL;
+  fuzz.numOfFindings = 0;
+  fuzz.executions = 0;
+  fuzz.running = threads;
+
+  workers = malloc(threads * sizeof(FuzzWorker));
+  handles = malloc(threads * sizeof(pthread_t));
+
+  for (int i = 0; i < threads; ++i)
+    fuzzInitWorker(&workers[i], &fuzz, i);
+
+  valid = fuzzSeed(&fuzz, &workers[0]);
+
+  if (valid) {
+    for (int i = 0; i < threads; ++i)
+      pthread_create(&handles[i], NULL, &fuzzWorker, &workers[i]);
+
+    // Without limit of runs it works until it is killed.
+    status = fuzz.start;
+    while (fuzz.running > 0) {
+      msSleep(100);
+
+      if (farmTime() - status >= FUZZ_STATUS_INTERVAL) {
+        status = farmTime();
+        fuzzStatus(&fuzz, AppSettings()->errorOut);
+      }
+    }
+
+    for (int i = 0; i < threads; ++i)
+      pthread_join(handles[i], NULL);
+
+    fuzzStatus(&fuzz, AppSettings()->errorOut);
+    fprintf(report, "{\"executions\": %llu, \"corpus\": %i, \"edges\": %u, \"findings\": %i, "
+            "\"threads\": %i, \"wall\": %.6f}\n", fuzzExecutions(&fuzz), fuzz.numOfCorpus,
+            fuzz.edges, fuzz.numOfFindings, threads, farmTime() - fuzz.start);
+    fflush(report);
+  }
+
+  for (int i = 0; i < threads; ++i)
+    fuzzFreeWorker(&workers[i]);
+
+  for (int i = 0; i < fuzz.numOfCorpus; ++i)
+    free(fuzz.corpus[i].data);
+
+  pthread_mutex_destroy(&fuzz.lock);
+  free(workers);
+  free(handles);
+  free(fuzz.corpus);
+  free(fuzz.virgin);
+  free(fuzz.findings);
+  removeMCU(fuzz.snapshot);
+  free(fuzz.snapshot);
+
+  return valid && fuzz.numOfFindings == 0;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
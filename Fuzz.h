@@ -0,0 +1,72 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FUZZ_H_
+#define FUZZ_H_
+
+#include <stdio.h>
+#include "MCS51.h"
+
+/*
+ * Coverage guided fuzzing of uart input. Program is run from reset until
+ * uart receiver waits for the first byte, this state is kept with
+ * snapshotMCU(). Every execution restores it and feeds input one byte a
+ * byte time after receiver starts to wait, like a real line would. When
+ * program runs long between two bytes, the state waiting for the next one
+ * is kept too and executions of inputs starting with the same bytes are
+ * restored from there, with the same results. Execution ends when the
+ * byte after input would come, at untilPC reached after the last byte is
+ * taken, on power down or on halt. Inputs which give new edge coverage
+ * (see runMCUBatch) are added to corpus shared by all workers and mutated
+ * further.
+ *
+ * Simulator errors (see getError) are reported as "error" findings and
+ * executions which don't end in cycles budget as "hang" findings, one per
+ * kind and PC, with input which caused them.
+ */
+#define FUZZ_MAX_INPUT 1024
+#define FUZZ_BOOT_CYCLES 100000000ULL
+
+typedef struct {
+  int untilPC;                 // -1 for none
+  unsigned long long cycles;   // budget of one execution
+  unsigned long long runs;     // number of executions, 0 for no limit
+  char** inputs;               // files with initial inputs
+  int numOfInputs;
+  int threads;                 // 0 means one per processor
+} FuzzSettings;
+
+/*
+ * Load hexFile into mcu like `load irom` and fuzz it, mcu is left at the
+ * first uart read. Every worker runs its own copy, engine settings of mcu
+ * are used except predecoding (coverage is counted by interpreter) and
+ * noDebug. Devices aren't supported. Findings are written into report as
+ * JSON objects as soon as they are found, summary object is written at the
+ * end, one per line. Progress is printed to errorOut. Returns true when
+ * nothing was found.
+ */
+bool runFuzz(MCU* mcu, char* hexFile, const FuzzSettings* settings,
+             FILE* report);
+
+#endif /* FUZZ_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
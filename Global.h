@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include "Config.h"
 #include "MCS51.h"
 
 #define APP_NAME "S51D"
@@ -33,13 +34,6 @@
 #define APP_MINOR_VERSION 1
 #define APP_PATH_VERSION 0
 
-//#define NDEBUG
-#define USE_COLORS
-
-#ifndef NDEBUG
-#include "memleaks.h"
-#endif
-
 #ifdef USE_COLORS
 #define C_PROLOG "\033[0;33m"
 #define C_PROMPT "\033[m"
@@ -96,6 +90,8 @@ struct _settings {
   bool noColors;
   bool dontRemoveEscapeCodes;
   bool pauseOnError;
+  bool returnAtEnd; // runDebugger() returns at the end of input
+  bool lockstep;    // `run n` checks engine against interpreter
   double simTimeBeforeStop;
   double simSyncTimeBeforeStop;
   double mcuSec;
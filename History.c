@@ -0,0 +1,344 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Config.h"
+#include "History.h"
+
+/*
+ * INPUT set at cycle, applied in order of recording when history is run
+ * again.
+ */
+typedef struct {
+  unsigned long long cycles;
+  int input;
+} HistoryInput;
+
+static MCU** g_checkpoints = NULL;
+static unsigned g_numOfCheckpoints = 0;
+static HistoryInput* g_inputs = NULL;
+static unsigned g_numOfInputs = 0;
+
+/*
+ * State in which history left MCU (commands could change it since) and the
+ * last recorded cycle.
+ */
+static MCU* g_position = NULL;
+static unsigned long long g_end = 0;
+
+static MCU* historySnapshot(MCU* mcu)
+{
+  MCU* snapshot = malloc(sizeof(MCU));
+
+  snapshotMCU(snapshot, mcu);
+  return snapshot;
+}
+
+static void historyFree(MCU* snapshot)
+{
+  if (snapshot != NULL) {
+    removeMCU(snapshot);
+    free(snapshot);
+  }
+}
+
+static void historySetPosition(MCU* mcu)
+{
+  historyFree(g_position);
+  g_position = mcu != NULL ? historySnapshot(mcu) : NULL;
+}
+
+static void historyAddInput(unsigned long long cycles, int input)
+{
+  g_inputs = realloc(g_inputs, (g_numOfInputs + 1) * sizeof(HistoryInput));
+  g_inputs[g_numOfInputs].cycles = cycles;
+  g_inputs[g_numOfInputs].input = input;
+  g_numOfInputs += 1;
+}
+
+/*
+ * Drop moments after cycles, checkpoints at cycles too when the new one
+ * replaces them.
+ */
+static void historyTruncate(unsigned long long cycles, bool replace)
+{
+  while (g_numOfCheckpoints > 0) {
+    MCU* last = g_checkpoints[g_numOfCheckpoints - 1];
+
+    if (last->cycles < cycles || (last->cycles == cycles && !replace))
+      break;
+
+    historyFree(last);
+    g_numOfCheckpoints -= 1;
+  }
+
+  while (g_numOfInputs > 0 && g_inputs[g_numOfInputs - 1].cycles > cycles)
+    g_numOfInputs -= 1;
+
+  // Debugger doesn't leave byte in INPUT when MCU stops.
+  if (g_numOfInputs > 0 && g_inputs[g_numOfInputs - 1].input != -1)
+    historyAddInput(cycles, -1);
+
+  g_end = cycles;
+}
+
+static void historyCheckpoint(MCU* mcu)
+{
+  if (g_numOfCheckpoints == HISTORY_CHECKPOINTS) {
+    unsigned dropped = 0;
+
+    historyFree(g_checkpoints[0]);
+    g_numOfCheckpoints -= 1;
+    memmove(g_checkpoints, g_checkpoints + 1, g_numOfCheckpoints * sizeof(MCU*));
+
+    while (dropped < g_numOfInputs && g_inputs[dropped].cycles < g_checkpoints[0]->cycles)
+      dropped += 1;
+    g_numOfInputs -= dropped;
+    memmove(g_inputs, g_inputs + dropped, g_numOfInputs * sizeof(HistoryInput));
+  }
+
+  g_checkpoints = realloc(g_checkpoints, (g_numOfCheckpoints + 1) * sizeof(MCU*));
+  g_checkpoints[g_numOfCheckpoints++] = historySnapshot(mcu);
+
+  if (mcu->cycles > g_end)
+    g_end = mcu->cycles;
+}
+
+/*
+ * MCU changed by a command starts new history from its state.
+ */
+static void historySync(MCU* mcu)
+{
+  if (g_position != NULL && sameStateMCU(mcu, g_position))
+    return;
+
+  historyTruncate(mcu->cycles, true);
+  historyCheckpoint(mcu);
+  historySetPosition(mcu);
+}
+
+/*
+ * The last checkpoint at or before cycles, -1 when there is none.
+ */
+static int historyFind(unsigned long long cycles)
+{
+  for (int i = g_numOfCheckpoints; i-- > 0;) {
+    if (g_checkpoints[i]->cycles <= cycles)
+      return i;
+  }
+
+  return -1;
+}
+
+/*
+ * runMCUBatch() which gives recorded uart input to MCU. Breakpoints and
+ * errors stop batches regardless of stopMask, replay goes on past them
+ * unless they are in stopMask.
+ */
+static unsigned long long historyRun(MCU* mcu, unsigned long long steps,
+                                     unsigned long long end, int stopMask,
+                                     MCUStopReason* reason)
+{
+  unsigned long long executed = 0;
+  unsigned input = 0;
+
+  while (input < g_numOfInputs && g_inputs[input].cycles < mcu->cycles)
+    input += 1;
+
+  *reason = STOP_BUDGET;
+
+  while (executed < steps && mcu->cycles < end) {
+    unsigned long long stop = end;
+    unsigned long long done;
+
+    for (; input < g_numOfInputs && g_inputs[input].cycles <= mcu->cycles; ++input)
+      mcu->INPUT = g_inputs[input].input;
+
+    if (input < g_numOfInputs && g_inputs[input].cycles < stop)
+      stop = g_inputs[input].cycles;
+
+    done = runMCUBatch(mcu, steps - executed, stop - mcu->cycles, stopMask, reason);
+    executed += done;
+
+    if (done == 0 || (*reason != STOP_BUDGET && (*reason & stopMask)))
+      break;
+  }
+
+  return executed;
+}
+
+/*
+ * Restore checkpoint and run from it to cycles.
+ */
+static void historySeek(MCU* mcu, int checkpoint, unsigned long long cycles)
+{
+  MCUStopReason reason;
+
+  rewindMCU(mcu, g_checkpoints[checkpoint]);
+  historyRun(mcu, MCU_NO_LIMIT, cycles, 0, &reason);
+
+  mcu->INPUT = -1;
+  historySetPosition(mcu);
+}
+
+void beginHistory(MCU* mcu)
+{
+  historySync(mcu);
+  historyTruncate(mcu->cycles, false);
+  historySetPosition(NULL);
+}
+
+void tickHistory(MCU* mcu)
+{
+  if (g_numOfCheckpoints == 0 ||
+      mcu->cycles - g_checkpoints[g_numOfCheckpoints - 1]->cycles >= HISTORY_INTERVAL)
+    historyCheckpoint(mcu);
+
+  if (mcu->cycles > g_end)
+    g_end = mcu->cycles;
+}
+
+void endHistory(MCU* mcu)
+{
+  tickHistory(mcu);
+  g_end = mcu->cycles;
+  historySetPosition(mcu);
+}
+
+void inputHistory(MCU* mcu, int input)
+{
+  historyAddInput(mcu->cycles, input);
+}
+
+bool gotoHistory(MCU* mcu, unsigned long long cycles)
+{
+  int checkpoint;
+
+  historySync(mcu);
+
+  checkpoint = historyFind(cycles);
+  if (checkpoint < 0 || cycles > g_end)
+    return false;
+
+  historySeek(mcu, checkpoint, cycles);
+  return true;
+}
+
+bool stepBackHistory(MCU* mcu)
+{
+  unsigned long long cycles = mcu->cycles;
+  unsigned long long steps;
+  MCUStopReason reason;
+  int checkpoint;
+
+  historySync(mcu);
+
+  checkpoint = cycles > 0 ? historyFind(cycles - 1) : -1;
+  if (checkpoint < 0)
+    return false;
+
+  // Count steps to current cycle, then run one less.
+  rewindMCU(mcu, g_checkpoints[checkpoint]);
+  steps = historyRun(mcu, MCU_NO_LIMIT, cycles, 0, &reason);
+
+  rewindMCU(mcu, g_checkpoints[checkpoint]);
+  historyRun(mcu, steps > 0 ? steps - 1 : 0, cycles, 0, &reason);
+
+  mcu->INPUT = -1;
+  historySetPosition(mcu);
+  return true;
+}
+
+bool continueBackHistory(MCU* mcu)
+{
+  unsigned long long cycles = mcu->cycles;
+  int checkpoint;
+
+  historySync(mcu);
+
+  checkpoint = cycles > 0 ? historyFind(cycles - 1) : -1;
+  if (checkpoint < 0)
+    return false;
+
+  // Run checkpoints from the last one, the last stop wins.
+  for (int i = checkpoint; i >= 0; --i) {
+    unsigned long long end = cycles;
+    unsigned long long found = 0;
+    bool stopped = false;
+    MCUStopReason reason;
+
+    if (i + 1 < (int) g_numOfCheckpoints && g_checkpoints[i + 1]->cycles < end)
+      end = g_checkpoints[i + 1]->cycles;
+
+    rewindMCU(mcu, g_checkpoints[i]);
+
+    while (mcu->cycles < end) {
+      historyRun(mcu, MCU_NO_LIMIT, end, STOP_BREAKPOINT, &reason);
+      if (reason != STOP_BREAKPOINT || mcu->cycles >= cycles)
+        break;
+
+      found = mcu->cycles;
+      stopped = true;
+    }
+
+    if (stopped) {
+      historySeek(mcu, i, found);
+      return true;
+    }
+  }
+
+  historySeek(mcu, 0, g_checkpoints[0]->cycles);
+  return false;
+}
+
+bool rangeOfHistory(unsigned long long* first, unsigned long long* last,
+                    unsigned* checkpoints)
+{
+  *checkpoints = g_numOfCheckpoints;
+
+  if (g_numOfCheckpoints == 0)
+    return false;
+
+  *first = g_checkpoints[0]->cycles;
+  *last = g_end;
+  return true;
+}
+
+void clearHistory(void)
+{
+  for (unsigned i = 0; i < g_numOfCheckpoints; ++i)
+    historyFree(g_checkpoints[i]);
+
+  free(g_checkpoints);
+  free(g_inputs);
+  historyFree(g_position);
+
+  g_checkpoints = NULL;
+  g_numOfCheckpoints = 0;
+  g_inputs = NULL;
+  g_numOfInputs = 0;
+  g_position = NULL;
+  g_end = 0;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
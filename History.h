@@ -0,0 +1,95 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include "MCS51.h"
+
+/*
+ * Execution history of the debugged MCU for reverse execution. History
+ * keeps checkpoints (see snapshotMCU) made when MCU is run after its state
+ * was changed by a command and every HISTORY_INTERVAL cycles of running,
+ * together with uart input given to MCU. Earlier moment is reached by
+ * restoring the last checkpoint before it and running again, simulator is
+ * deterministic so it comes to the same state. Checkpoints share memory
+ * pages, each costs about the pages written since the previous one. Only
+ * the last HISTORY_CHECKPOINTS are kept. Breakpoints, pauses and execution
+ * settings of MCU aren't changed by going back, state of device plugins
+ * isn't part of history.
+ */
+#define HISTORY_INTERVAL 1000000
+#define HISTORY_CHECKPOINTS 256
+
+/*
+ * Loaded module (see Recompiler.h) can't stop after given cycles, it is run
+ * HISTORY_STEPS instructions (up to 4 cycles each) between tickHistory()
+ * calls, so its checkpoints come at most HISTORY_INTERVAL / 16 cycles late.
+ */
+#define HISTORY_STEPS (HISTORY_INTERVAL / 64)
+
+/*
+ * Called before MCU is run. Run starts new history after current cycle,
+ * recorded moments after it are dropped.
+ */
+void beginHistory(MCU* mcu);
+
+/*
+ * Called while MCU is run and after it stopped.
+ */
+void tickHistory(MCU* mcu);
+void endHistory(MCU* mcu);
+
+/*
+ * Uart byte put into INPUT by debugger, -1 when it was taken back.
+ */
+void inputHistory(MCU* mcu, int input);
+
+/*
+ * Go to the first instruction boundary at or after cycles. Fails when
+ * cycles is out of recorded history.
+ */
+bool gotoHistory(MCU* mcu, unsigned long long cycles);
+
+/*
+ * Go to the state before the last executed instruction (or idle cycle).
+ */
+bool stepBackHistory(MCU* mcu);
+
+/*
+ * Go back to the last moment when breakpoint or pause stopped MCU. When
+ * there is none, MCU is at the start of history and false is returned.
+ */
+bool continueBackHistory(MCU* mcu);
+
+/*
+ * Cycles of the first and the last recorded moment. Returns false when
+ * history is empty.
+ */
+bool rangeOfHistory(unsigned long long* first, unsigned long long* last,
+                    unsigned* checkpoints);
+
+void clearHistory(void);
+
+#endif /* HISTORY_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -20,11 +20,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "Utils.h"
+#include <errno.h>
+#include "Config.h"
 #include "IntelHex.h"
-#include "MCS51.h"
 
-void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* valid, WORD* highestAddress)
+void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* valid, WORD* highestAddress,
+                      FILE* errorOut)
 {
   memset(rom, 0, MAX_ROM_SIZE);
   *valid = true;
@@ -37,8 +38,8 @@ void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* val
     file = fopen (filename, "r");
 
   if (file == NULL) {
-    fprintf(AppSettings()->errorOut, "Error while trying to open '%s': %s.\n", filename,
-            strerror(errno));
+    if (errorOut != NULL)
+      fprintf(errorOut, "Error while trying to open '%s': %s.\n", filename, strerror(errno));
 
     rom = NULL;
     *valid = false;
@@ -48,12 +49,13 @@ void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* val
   char line[522];
   while (!feof(file)) {
     unsigned i;
-    char chrStartCode[2];
-    char chrByteCount[3];
-    char chrAddress[5];
-    char chrRecordType[3];
-    char chrChecksum[3];
-    char chrTempByte[3];
+    // %c doesn't terminate strings, %X would read garbage after them.
+    char chrStartCode[2] = {0};
+    char chrByteCount[3] = {0};
+    char chrAddress[5] = {0};
+    char chrRecordType[3] = {0};
+    char chrChecksum[3] = {0};
+    char chrTempByte[3] = {0};
     unsigned address = 0;
     unsigned byteCount = 0;
     unsigned recordType = 0;
@@ -117,6 +119,16 @@ void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* val
   fclose(file);
 }
 
+void loadIntelHexMCU(char* filename, MCU* mcu, MemoryType type, WORD start, WORD end,
+                     bool* valid, WORD* highestAddress, FILE* errorOut)
+{
+  BYTE* memory = malloc(MAX_ROM_SIZE);
+
+  loadIntelHexFile(filename, memory, start, end, valid, highestAddress, errorOut);
+  writeMemoryMCU(mcu, type, 0, memory, MAX_ROM_SIZE);
+  free(memory);
+}
+
 /*
 vi:ts=4:et:nowrap
 */
@@ -21,9 +21,22 @@
 #ifndef INTELHEX_H_
 #define INTELHEX_H_
 
-#include "Global.h"
+#include <stdio.h>
+#include "MCS51.h"
 
-void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* valid, WORD* highestAddress);
+/*
+ * Load bytes from start to end address of Intel HEX file into rom. Errors
+ * are written to errorOut (nothing is written if NULL).
+ */
+void loadIntelHexFile(char* filename, BYTE* rom, WORD start, WORD end, bool* valid, WORD* highestAddress,
+                      FILE* errorOut);
+
+/*
+ * The same for memory of mcu (IROM, XROM or XDATA). Only bytes which differ
+ * are written (see writeMemoryMCU), image loaded again keeps pages shared.
+ */
+void loadIntelHexMCU(char* filename, MCU* mcu, MemoryType type, WORD start, WORD end,
+                     bool* valid, WORD* highestAddress, FILE* errorOut);
 
 #endif /* INTELHEX_H_ */
 
@@ -0,0 +1,1036 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Config.h"
+#include "Lanes.h"
+
+/*
+ * Rows after 256 rows of IDATA. DATA is immediate operand of current
+ * instruction in every lane, JUMP tells which lanes take conditional
+ * jump.
+ */
+#define ROW_SP      0x100
+#define ROW_DPL     0x101
+#define ROW_DPH     0x102
+#define ROW_PSW     0x103
+#define ROW_ACC     0x104
+#define ROW_B       0x105
+#define ROW_SBUF    0x106
+#define ROW_PARITY  0x107 // parityACC
+#define ROW_PCL     0x108
+#define ROW_PCH     0x109
+#define ROW_DATA    0x10A
+#define ROW_JUMP    0x10B
+#define NUM_OF_ROWS 0x10C
+
+// Rows of lane state, the rest is scratch.
+#define NUM_OF_STATE_ROWS ROW_DATA
+
+#define CY (PSW_CY & 0xFF)
+#define AC (PSW_AC & 0xFF)
+#define OV (PSW_OV & 0xFF)
+#define P  (PSW_P & 0xFF)
+
+/*
+ * Result of one instruction.
+ */
+#define STEP_FAILED 0 // nothing was done
+#define STEP_NEXT   1 // all lanes at mcu->PC
+#define STEP_SPLIT  2 // every lane at its own PC
+
+static inline BYTE* lanesRow(MCULanes* lanes, unsigned row)
+{
+  return lanes->rows + row * lanes->capacity;
+}
+
+void initLanesMCU(MCULanes* lanes, MCU* mcu)
+{
+  lanes->mcu = mcu;
+  lanes->numOfLanes = 0;
+  lanes->capacity = 0;
+  lanes->rows = NULL;
+  lanes->first = NULL;
+  lanes->second = NULL;
+
+  // Lanes keep flags without lazy evaluation.
+  syncFlagsMCU(mcu);
+}
+
+void removeLanesMCU(MCULanes* lanes)
+{
+  free(lanes->rows);
+  free(lanes->first);
+  free(lanes->second);
+  lanes->rows = NULL;
+  lanes->first = NULL;
+  lanes->second = NULL;
+  lanes->numOfLanes = 0;
+  lanes->capacity = 0;
+}
+
+static void lanesGrow(MCULanes* lanes)
+{
+  unsigned capacity = lanes->capacity == 0 ? 8 : lanes->capacity * 2;
+  BYTE* rows = malloc(NUM_OF_ROWS * capacity);
+
+  for (unsigned row = 0; row < NUM_OF_ROWS; ++row)
+    memcpy(rows + row * capacity, lanesRow(lanes, row), lanes->numOfLanes);
+
+  free(lanes->rows);
+  lanes->rows = rows;
+  lanes->capacity = capacity;
+  lanes->first = realloc(lanes->first, capacity * sizeof(unsigned));
+  lanes->second = realloc(lanes->second, capacity * sizeof(unsigned));
+}
+
+static inline void lanesSet(MCULanes* lanes, unsigned row, unsigned lane, BYTE value)
+{
+  lanesRow(lanes, row)[lane] = value;
+}
+
+static inline BYTE lanesGet(MCULanes* lanes, unsigned row, unsigned lane)
+{
+  return lanesRow(lanes, row)[lane];
+}
+
+unsigned addLaneMCU(MCULanes* lanes, MCU* src)
+{
+  unsigned lane = lanes->numOfLanes;
+
+  syncFlagsMCU(src);
+
+  if (lane == lanes->capacity)
+    lanesGrow(lanes);
+
+  for (unsigned address = 0; address < INT_RAM_SIZE; ++address)
+    lanesSet(lanes, address, lane, src->idata[address]);
+
+  lanesSet(lanes, ROW_SP, lane, src->sfr[0x81 - 0x80]);
+  lanesSet(lanes, ROW_DPL, lane, src->sfr[0x82 - 0x80]);
+  lanesSet(lanes, ROW_DPH, lane, src->sfr[0x83 - 0x80]);
+  lanesSet(lanes, ROW_PSW, lane, src->sfr[0xD0 - 0x80]);
+  lanesSet(lanes, ROW_ACC, lane, src->sfr[0xE0 - 0x80]);
+  lanesSet(lanes, ROW_B, lane, src->sfr[0xF0 - 0x80]);
+  lanesSet(lanes, ROW_SBUF, lane, src->sfr[0x99 - 0x80]);
+  lanesSet(lanes, ROW_PARITY, lane, src->parityACC);
+  lanesSet(lanes, ROW_PCL, lane, src->PC & 0xFF);
+  lanesSet(lanes, ROW_PCH, lane, src->PC >> 8);
+
+  for (unsigned other = 0; other < lane; ++other) {
+    unsigned row = 0;
+
+    while (row < NUM_OF_STATE_ROWS &&
+           lanesGet(lanes, row, other) == lanesGet(lanes, row, lane))
+      row += 1;
+
+    if (row == NUM_OF_STATE_ROWS)
+      return other;
+  }
+
+  lanes->numOfLanes += 1;
+  return lane;
+}
+
+void getLaneMCU(MCULanes* lanes, unsigned lane, MCU* dst)
+{
+  BYTE psw = dst->sfr[0xD0 - 0x80];
+
+  for (unsigned address = 0; address < INT_RAM_SIZE; ++address)
+    dst->idata[address] = lanesGet(lanes, address, lane);
+
+  dst->sfr[0x81 - 0x80] = lanesGet(lanes, ROW_SP, lane);
+  dst->sfr[0x82 - 0x80] = lanesGet(lanes, ROW_DPL, lane);
+  dst->sfr[0x83 - 0x80] = lanesGet(lanes, ROW_DPH, lane);
+  dst->sfr[0xD0 - 0x80] = lanesGet(lanes, ROW_PSW, lane);
+  dst->sfr[0xE0 - 0x80] = lanesGet(lanes, ROW_ACC, lane);
+  dst->sfr[0xF0 - 0x80] = lanesGet(lanes, ROW_B, lane);
+  dst->sfr[0x99 - 0x80] = lanesGet(lanes, ROW_SBUF, lane);
+  dst->parityACC = lanesGet(lanes, ROW_PARITY, lane);
+  dst->PC = lanePCMCU(lanes, lane);
+
+  // Register bank.
+  if (dst->_sfrWrite[0xD0 - 0x80] != NULL)
+    dst->_sfrWrite[0xD0 - 0x80](dst, psw);
+}
+
+WORD lanePCMCU(MCULanes* lanes, unsigned lane)
+{
+  return (WORD) lanesGet(lanes, ROW_PCH, lane) << 8 | lanesGet(lanes, ROW_PCL, lane);
+}
+
+/*
+ * Row of direct address, -1 when it isn't kept by lanes. Write into SBUF
+ * sends byte.
+ */
+static inline int lanesDirect(BYTE address, bool write)
+{
+  if (address < 0x80)
+    return address;
+
+  switch (address) {
+  case 0x81:
+    return ROW_SP;
+  case 0x82:
+    return ROW_DPL;
+  case 0x83:
+    return ROW_DPH;
+  case 0x99:
+    return write ? -1 : ROW_SBUF;
+  case 0xD0:
+    return ROW_PSW;
+  case 0xE0:
+    return ROW_ACC;
+  case 0xF0:
+    return ROW_B;
+  }
+
+  return -1;
+}
+
+/*
+ * Operands of lanes, offset into rows for every lane.
+ */
+static void lanesUniform(MCULanes* lanes, unsigned* offsets, unsigned row)
+{
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane)
+    offsets[lane] = row * lanes->capacity + lane;
+}
+
+static bool lanesDirectOperand(MCULanes* lanes, unsigned* offsets, BYTE address, bool write)
+{
+  int row = lanesDirect(address, write);
+
+  if (row < 0)
+    return false;
+
+  lanesUniform(lanes, offsets, row);
+  return true;
+}
+
+static void lanesImmediate(MCULanes* lanes, unsigned* offsets, BYTE value)
+{
+  memset(lanesRow(lanes, ROW_DATA), value, lanes->numOfLanes);
+  lanesUniform(lanes, offsets, ROW_DATA);
+}
+
+static void lanesRegister(MCULanes* lanes, unsigned* offsets, BYTE index)
+{
+  BYTE* psw = lanesRow(lanes, ROW_PSW);
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane)
+    offsets[lane] = ((psw[lane] & 0x18) + index) * lanes->capacity + lane;
+}
+
+/*
+ * @Ri, false when address is outside of IDATA in some lane.
+ */
+static bool lanesIndirect(MCULanes* lanes, unsigned* offsets, BYTE index)
+{
+  lanesRegister(lanes, offsets, index);
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane) {
+    BYTE address = lanes->rows[offsets[lane]];
+
+    if (address >= lanes->mcu->idataMemorySize)
+      return false;
+
+    offsets[lane] = address * lanes->capacity + lane;
+  }
+
+  return true;
+}
+
+/*
+ * Second operand of arithmetic and logic instructions (#data, dir, @Ri, Rn
+ * by low nibble of opcode).
+ */
+static bool lanesSource(MCULanes* lanes, unsigned* offsets, BYTE opcode, BYTE op1, bool write)
+{
+  BYTE low = opcode & 0x0F;
+
+  if (low == 0x04) {
+    lanesImmediate(lanes, offsets, op1);
+    return true;
+  }
+
+  if (low == 0x05)
+    return lanesDirectOperand(lanes, offsets, op1, write);
+
+  if (low < 0x08)
+    return lanesIndirect(lanes, offsets, opcode & 0x01);
+
+  lanesRegister(lanes, offsets, opcode & 0x07);
+  return true;
+}
+
+/*
+ * Row and mask of bit, false when it isn't kept by lanes.
+ */
+static bool lanesBit(BYTE bit, unsigned* row, BYTE* mask)
+{
+  int byte = bit < 0x80 ? 0x20 + (bit >> 3) : lanesDirect(bit & 0xF8, true);
+
+  if (byte < 0)
+    return false;
+
+  *row = byte;
+  *mask = 1 << (bit & 0x07);
+  return true;
+}
+
+/*
+ * Stack addresses SP + 1 .. SP + count (count < 0: SP + count + 1 .. SP)
+ * are inside of IDATA in all lanes.
+ */
+static bool lanesStack(MCULanes* lanes, int count)
+{
+  BYTE* sp = lanesRow(lanes, ROW_SP);
+  int from = count > 0 ? 1 : count + 1;
+  int to = count > 0 ? count : 0;
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane) {
+    for (int i = from; i <= to; ++i) {
+      if ((BYTE) (sp[lane] + i) >= lanes->mcu->idataMemorySize)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static void lanesPush(MCULanes* lanes, WORD value)
+{
+  BYTE* sp = lanesRow(lanes, ROW_SP);
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane) {
+    sp[lane] += 1;
+    lanesSet(lanes, sp[lane], lane, value & 0xFF);
+    sp[lane] += 1;
+    lanesSet(lanes, sp[lane], lane, value >> 8);
+  }
+}
+
+static inline bool lanesParity(BYTE value)
+{
+  value ^= value >> 4;
+  value ^= value >> 2;
+  value ^= value >> 1;
+  return value & 0x01;
+}
+
+/*
+ * Parity flag, set when ACC was changed like after every instruction of the
+ * interpreter.
+ */
+static void lanesTrack(MCULanes* lanes)
+{
+  BYTE* acc = lanesRow(lanes, ROW_ACC);
+  BYTE* parity = lanesRow(lanes, ROW_PARITY);
+  BYTE* psw = lanesRow(lanes, ROW_PSW);
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane) {
+    if (acc[lane] != parity[lane]) {
+      parity[lane] = acc[lane];
+      psw[lane] = (psw[lane] & ~P) | (lanesParity(acc[lane]) ? P : 0);
+    }
+  }
+}
+
+static inline WORD lanesWrap(MCU* mcu, WORD address)
+{
+  return address >= mcu->codeSize ? address % mcu->codeSize : address;
+}
+
+/*
+ * PC of every lane is in its rows, STEP_NEXT when they are the same.
+ */
+static int lanesJoin(MCULanes* lanes)
+{
+  WORD pc = lanePCMCU(lanes, 0);
+
+  for (unsigned lane = 1; lane < lanes->numOfLanes; ++lane) {
+    if (lanePCMCU(lanes, lane) != pc)
+      return STEP_SPLIT;
+  }
+
+  lanes->mcu->PC = pc;
+  return STEP_NEXT;
+}
+
+static void lanesSetPC(MCULanes* lanes, unsigned lane, WORD pc)
+{
+  pc = lanesWrap(lanes->mcu, pc);
+  lanesSet(lanes, ROW_PCL, lane, pc & 0xFF);
+  lanesSet(lanes, ROW_PCH, lane, pc >> 8);
+}
+
+/*
+ * Conditional jump taken by lanes with JUMP row set.
+ */
+static int lanesBranch(MCULanes* lanes, WORD target, WORD follow)
+{
+  BYTE* jump = lanesRow(lanes, ROW_JUMP);
+  unsigned taken = 0;
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane)
+    taken += jump[lane] != 0;
+
+  if (taken == 0 || taken == lanes->numOfLanes) {
+    lanes->mcu->PC = lanesWrap(lanes->mcu, taken == 0 ? follow : target);
+    return STEP_NEXT;
+  }
+
+  for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane)
+    lanesSetPC(lanes, lane, jump[lane] ? target : follow);
+
+  return STEP_SPLIT;
+}
+
+/*
+ * Execute instruction at PC in all lanes, like handlers of the
+ * interpreter (see emitBody in Recompiler.c for the same semantics in C).
+ * Nothing is changed when it can't be done in lanes.
+ */
+static int lanesStep(MCULanes* lanes, BYTE opcode)
+{
+  MCU* mcu = lanes->mcu;
+  unsigned count = lanes->numOfLanes;
+  BYTE* rows = lanes->rows;
+  unsigned* a = lanes->first;
+  unsigned* b = lanes->second;
+  BYTE* acc = lanesRow(lanes, ROW_ACC);
+  BYTE* psw = lanesRow(lanes, ROW_PSW);
+  BYTE* regB = lanesRow(lanes, ROW_B);
+  BYTE* dpl = lanesRow(lanes, ROW_DPL);
+  BYTE* dph = lanesRow(lanes, ROW_DPH);
+  BYTE* sp = lanesRow(lanes, ROW_SP);
+  BYTE* jump = lanesRow(lanes, ROW_JUMP);
+  WORD address = mcu->PC;
+  BYTE op1 = *ROM(mcu, address + 1);
+  BYTE op2 = *ROM(mcu, address + 2);
+  WORD follow = address + mcu->byteCount[opcode];
+  WORD next = follow;
+  bool branch = false;
+  bool perLane = false;
+  bool dptr = mcu->DPL == &mcu->sfr[0x82 - 0x80];
+  unsigned row;
+  BYTE mask;
+  BYTE family = opcode;
+
+  // Rn and @Ri forms of instruction have one case.
+  if ((opcode & 0x0F) >= 0x08)
+    family = (opcode & 0xF0) | 0x08;
+  else if ((opcode & 0x0F) >= 0x06)
+    family = (opcode & 0xF0) | 0x06;
+
+  // ajmp, acall
+  if ((opcode & 0x1F) == 0x01) {
+    mcu->PC = lanesWrap(mcu, (WORD) (opcode >> 5) << 8 | op1);
+    return STEP_NEXT;
+  }
+
+  if ((opcode & 0x1F) == 0x11) {
+    if (!lanesStack(lanes, 2))
+      return STEP_FAILED;
+
+    lanesPush(lanes, follow);
+    mcu->PC = lanesWrap(mcu, (WORD) (opcode >> 5) << 8 | op1);
+    return STEP_NEXT;
+  }
+
+  switch (family) {
+  case 0x00: // nop
+    break;
+  case 0x02: // ljmp
+    next = (WORD) op1 << 8 | op2;
+    break;
+  case 0x80: // sjmp
+    // sjmp $ can halt program, runMCUBatch() checks it.
+    if (op1 == 0xFE)
+      return STEP_FAILED;
+
+    next = follow + (signed char) op1;
+    break;
+  case 0x12: // lcall
+    if (!lanesStack(lanes, 2))
+      return STEP_FAILED;
+
+    lanesPush(lanes, follow);
+    next = (WORD) op1 << 8 | op2;
+    break;
+  case 0x22: // ret
+    if (!lanesStack(lanes, -2))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      lanesSetPC(lanes, lane, (WORD) lanesGet(lanes, sp[lane], lane) << 8 |
+                              lanesGet(lanes, (BYTE) (sp[lane] - 1), lane));
+      sp[lane] -= 2;
+    }
+    perLane = true;
+    break;
+  case 0x73: // jmp @A+DPTR
+    if (!dptr)
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      lanesSetPC(lanes, lane, (WORD) (acc[lane] + ((WORD) dph[lane] << 8 | dpl[lane])));
+    perLane = true;
+    break;
+
+  /*
+   * Jumps.
+   */
+  case 0x10: // jbc
+    if (!lanesBit(op1, &row, &mask))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE* byte = &rows[row * lanes->capacity + lane];
+
+      jump[lane] = (*byte & mask) != 0;
+      *byte &= ~mask;
+    }
+    next = follow + (signed char) op2;
+    branch = true;
+    break;
+  case 0x20: // jb
+  case 0x30: // jnb
+    if (!lanesBit(op1, &row, &mask))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      jump[lane] = ((lanesGet(lanes, row, lane) & mask) != 0) == (opcode == 0x20);
+    next = follow + (signed char) op2;
+    branch = true;
+    break;
+  case 0x40: // jc
+  case 0x50: // jnc
+    for (unsigned lane = 0; lane < count; ++lane)
+      jump[lane] = ((psw[lane] & CY) != 0) == (opcode == 0x40);
+    next = follow + (signed char) op1;
+    branch = true;
+    break;
+  case 0x60: // jz
+  case 0x70: // jnz
+    for (unsigned lane = 0; lane < count; ++lane)
+      jump[lane] = (acc[lane] == 0) == (opcode == 0x60);
+    next = follow + (signed char) op1;
+    branch = true;
+    break;
+  case 0xB4: // cjne
+  case 0xB5:
+  case 0xB6:
+  case 0xB8:
+    if (opcode == 0xB4 || opcode == 0xB5)
+      lanesUniform(lanes, a, ROW_ACC);
+    else if (opcode < 0xB8 && !lanesIndirect(lanes, a, opcode & 0x01))
+      return STEP_FAILED;
+    else if (opcode >= 0xB8)
+      lanesRegister(lanes, a, opcode & 0x07);
+
+    if (opcode == 0xB5) {
+      if (!lanesDirectOperand(lanes, b, op1, false))
+        return STEP_FAILED;
+    } else {
+      lanesImmediate(lanes, b, op1);
+    }
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE x = rows[a[lane]];
+      BYTE y = rows[b[lane]];
+
+      psw[lane] = (psw[lane] & ~CY) | (x < y ? CY : 0);
+      jump[lane] = x != y;
+    }
+    next = follow + (signed char) op2;
+    branch = true;
+    break;
+  case 0xD5: // djnz dir
+  case 0xD8: // djnz Rn
+    if (opcode == 0xD5 && !lanesDirectOperand(lanes, a, op1, true))
+      return STEP_FAILED;
+    else if (opcode != 0xD5)
+      lanesRegister(lanes, a, opcode & 0x07);
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      rows[a[lane]] -= 1;
+      jump[lane] = rows[a[lane]] != 0;
+    }
+    next = follow + (signed char) (opcode == 0xD5 ? op2 : op1);
+    branch = true;
+    break;
+
+  /*
+   * Arithmetic and logic.
+   */
+  case 0x24: // add
+  case 0x25:
+  case 0x26:
+  case 0x28:
+  case 0x34: // addc
+  case 0x35:
+  case 0x36:
+  case 0x38:
+  case 0x94: // subb
+  case 0x95:
+  case 0x96:
+  case 0x98:
+    if (!lanesSource(lanes, a, opcode, op1, false))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE value = rows[a[lane]];
+      int carry = opcode >= 0x30 && (psw[lane] & CY) != 0;
+      bool subtract = opcode >= 0x90;
+
+      psw[lane] = (psw[lane] & ~(AC | CY | OV)) |
+                  arithmeticFlagsMCU(subtract, acc[lane], value, carry);
+      acc[lane] = subtract ? acc[lane] - value - carry : acc[lane] + value + carry;
+    }
+
+    // Interpreter skips one byte after subb A,@Ri.
+    if (opcode == 0x96 || opcode == 0x97)
+      next = follow + 1;
+    break;
+  case 0x44: // orl A,src
+  case 0x45:
+  case 0x46:
+  case 0x48:
+  case 0x54: // anl A,src
+  case 0x55:
+  case 0x56:
+  case 0x58:
+  case 0x64: // xrl A,src
+  case 0x65:
+  case 0x66:
+  case 0x68:
+    if (!lanesSource(lanes, a, opcode, op1, false))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      if (opcode < 0x50)
+        acc[lane] |= rows[a[lane]];
+      else if (opcode < 0x60)
+        acc[lane] &= rows[a[lane]];
+      else
+        acc[lane] ^= rows[a[lane]];
+    }
+    break;
+  case 0x42: // orl dir,A
+  case 0x52: // anl dir,A
+  case 0x62: // xrl dir,A
+  case 0x43: // orl dir,#data
+  case 0x53: // anl dir,#data
+  case 0x63: // xrl dir,#data
+    if (!lanesDirectOperand(lanes, a, op1, true))
+      return STEP_FAILED;
+
+    if (opcode & 0x01)
+      lanesImmediate(lanes, b, op2);
+    else
+      lanesUniform(lanes, b, ROW_ACC);
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      if (opcode < 0x50)
+        rows[a[lane]] |= rows[b[lane]];
+      else if (opcode < 0x60)
+        rows[a[lane]] &= rows[b[lane]];
+      else
+        rows[a[lane]] ^= rows[b[lane]];
+    }
+    break;
+  case 0x04: // inc A
+  case 0x14: // dec A
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] += opcode == 0x04 ? 1 : -1;
+    break;
+  case 0x05: // inc dir, @Ri, Rn
+  case 0x06:
+  case 0x08:
+  case 0x15: // dec dir, @Ri, Rn
+  case 0x16:
+  case 0x18:
+    if (!lanesSource(lanes, a, opcode, op1, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      rows[a[lane]] += opcode < 0x10 ? 1 : -1;
+    break;
+  case 0xA3: // inc DPTR
+    if (!dptr)
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      dpl[lane] += 1;
+      dph[lane] += dpl[lane] == 0;
+    }
+    break;
+  case 0x84: // div AB
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE t = acc[lane];
+
+      psw[lane] &= ~CY;
+      if (regB[lane] != 0) {
+        acc[lane] = t / regB[lane];
+        regB[lane] = t % regB[lane];
+      } else {
+        psw[lane] |= OV;
+      }
+    }
+    break;
+  case 0xA4: // mul AB
+    for (unsigned lane = 0; lane < count; ++lane) {
+      WORD w = (WORD) acc[lane] * (WORD) regB[lane];
+
+      psw[lane] = (psw[lane] & ~OV) | (w > 255 ? OV : 0);
+      regB[lane] = (BYTE) w >> 8;
+      acc[lane] = (BYTE) (w & 0xFF);
+    }
+    break;
+  case 0xD4: // da A
+    for (unsigned lane = 0; lane < count; ++lane) {
+      if ((psw[lane] & AC) || (acc[lane] & 0x0F) > 0x09) {
+        acc[lane] += 0x06;
+        if ((acc[lane] & 0x0F) > 0x0F)
+          psw[lane] |= CY;
+      }
+
+      if ((psw[lane] & CY) || (acc[lane] & 0xF0) > 0x90) {
+        acc[lane] += 0x60;
+        if ((acc[lane] & 0xF0) > 0xF0)
+          psw[lane] |= CY;
+      }
+    }
+    break;
+
+  /*
+   * Rotations and accumulator.
+   */
+  case 0x03: // rr A
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] = acc[lane] >> 1 | acc[lane] << 7;
+    break;
+  case 0x23: // rl A
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] = acc[lane] << 1 | acc[lane] >> 7;
+    break;
+  case 0x13: // rrc A
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE t = acc[lane];
+
+      acc[lane] = t >> 1 | ((psw[lane] & CY) != 0) << 7;
+      psw[lane] = (psw[lane] & ~CY) | (t & 0x01 ? CY : 0);
+    }
+    break;
+  case 0x33: // rlc A
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE t = acc[lane];
+
+      acc[lane] = t << 1 | ((psw[lane] & CY) != 0);
+      psw[lane] = (psw[lane] & ~CY) | (t & 0x80 ? CY : 0);
+    }
+    break;
+  case 0xC4: // swap A
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] = acc[lane] << 4 | acc[lane] >> 4;
+    break;
+  case 0xE4: // clr A
+    memset(acc, 0, count);
+    break;
+  case 0xF4: // cpl A
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] ^= 0xFF;
+    break;
+
+  /*
+   * Bits.
+   */
+  case 0xC3: // clr C
+  case 0xD3: // setb C
+  case 0xB3: // cpl C
+    for (unsigned lane = 0; lane < count; ++lane) {
+      if (opcode == 0xB3)
+        psw[lane] ^= CY;
+      else
+        psw[lane] = (psw[lane] & ~CY) | (opcode == 0xD3 ? CY : 0);
+    }
+    break;
+  case 0xC2: // clr bit
+  case 0xD2: // setb bit
+  case 0xB2: // cpl bit
+  case 0x92: // mov bit,C
+    if (!lanesBit(op1, &row, &mask))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE* byte = &rows[row * lanes->capacity + lane];
+      bool state = opcode == 0xD2 || (opcode == 0xB2 && !(*byte & mask)) ||
+                   (opcode == 0x92 && (psw[lane] & CY));
+
+      *byte = (*byte & ~mask) | (state ? mask : 0);
+    }
+    break;
+  case 0xA2: // mov C,bit
+  case 0x72: // orl C,bit
+  case 0xA0: // orl C,/bit
+  case 0x82: // anl C,bit
+  case 0xB0: // anl C,/bit
+    if (!lanesBit(op1, &row, &mask))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      bool bit = (lanesGet(lanes, row, lane) & mask) != 0;
+      bool carry = (psw[lane] & CY) != 0;
+
+      if (opcode == 0xA2)
+        carry = bit;
+      else if (opcode == 0x72 || opcode == 0xA0)
+        carry = carry || bit == (opcode == 0x72);
+      else
+        carry = carry && bit == (opcode == 0x82);
+
+      psw[lane] = (psw[lane] & ~CY) | (carry ? CY : 0);
+    }
+    break;
+
+  /*
+   * Moves.
+   */
+  case 0x74: // mov A,#data
+    memset(acc, op1, count);
+    break;
+  case 0xE5: // mov A,src
+  case 0xE6:
+  case 0xE8:
+    if (!lanesSource(lanes, a, opcode, op1, false))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      acc[lane] = rows[a[lane]];
+    break;
+  case 0x75: // mov dir,#data
+  case 0x76: // mov @Ri,#data
+  case 0x78: // mov Rn,#data
+    if (!lanesSource(lanes, a, opcode, op1, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      rows[a[lane]] = opcode == 0x75 ? op2 : op1;
+    break;
+  case 0x85: // mov dir,dir
+  case 0x86: // mov dir,@Ri
+  case 0x88: // mov dir,Rn
+    if (!lanesSource(lanes, b, opcode, op1, false))
+      return STEP_FAILED;
+
+    if (!lanesDirectOperand(lanes, a, opcode == 0x85 ? op2 : op1, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      rows[a[lane]] = rows[b[lane]];
+    break;
+  case 0x90: // mov DPTR,#data
+    if (!dptr)
+      return STEP_FAILED;
+
+    memset(dph, op1, count);
+    memset(dpl, op2, count);
+    break;
+  case 0xA6: // mov @Ri,dir
+  case 0xA8: // mov Rn,dir
+    if (!lanesDirectOperand(lanes, b, op1, false) ||
+        !lanesSource(lanes, a, opcode, 0, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      rows[a[lane]] = rows[b[lane]];
+    break;
+  case 0xF5: // mov dir,A
+  case 0xF6: // mov @Ri,A
+  case 0xF8: // mov Rn,A
+    if (!lanesSource(lanes, a, opcode, op1, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane)
+      rows[a[lane]] = acc[lane];
+    break;
+  case 0x83: // movc A,@A+PC
+  case 0x93: // movc A,@A+DPTR
+    if (opcode == 0x93 && !dptr)
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      WORD base = opcode == 0x83 ? address : (WORD) dph[lane] << 8 | dpl[lane];
+
+      acc[lane] = *ROM(mcu, (WORD) (acc[lane] + base));
+    }
+    break;
+
+  /*
+   * Stack and exchanges.
+   */
+  case 0xC0: // push dir
+    if (!lanesDirectOperand(lanes, a, op1, false) || !lanesStack(lanes, 1))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      sp[lane] += 1;
+      lanesSet(lanes, sp[lane], lane, rows[a[lane]]);
+    }
+    break;
+  case 0xD0: // pop dir
+    if (!lanesDirectOperand(lanes, a, op1, true) || !lanesStack(lanes, -1))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      rows[a[lane]] = lanesGet(lanes, sp[lane], lane);
+      sp[lane] -= 1;
+    }
+    break;
+  case 0xC5: // xch A,dir, @Ri, Rn
+  case 0xC6:
+  case 0xC8:
+    if (!lanesSource(lanes, a, opcode, op1, true))
+      return STEP_FAILED;
+
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE t = acc[lane];
+
+      acc[lane] = rows[a[lane]];
+      rows[a[lane]] = t;
+    }
+    break;
+  case 0xD6: // xchd A,@Ri
+    if (!lanesIndirect(lanes, a, opcode & 0x01))
+      return STEP_FAILED;
+
+    /*
+     * Like the interpreter, high nibbles are cleared and Ri is read again
+     * after the first write (it can point to itself).
+     */
+    lanesRegister(lanes, b, opcode & 0x01);
+    for (unsigned lane = 0; lane < count; ++lane) {
+      BYTE t = rows[a[lane]] & 0x0F;
+
+      rows[a[lane]] = t;
+      rows[rows[b[lane]] * lanes->capacity + lane] |= acc[lane] & 0x0F;
+      acc[lane] = (acc[lane] & 0x0F) | t;
+    }
+    break;
+
+  default:
+    // reti, movx, reserved.
+    return STEP_FAILED;
+  }
+
+  lanesTrack(lanes);
+
+  if (branch)
+    return lanesBranch(lanes, next, follow);
+
+  if (perLane)
+    return lanesJoin(lanes);
+
+  mcu->PC = lanesWrap(mcu, next);
+  return STEP_NEXT;
+}
+
+/*
+ * State in which lanes can run, the rest is checked by beginBlockMCU().
+ */
+static bool lanesQuiet(MCU* mcu)
+{
+  if (mcu->idle || mcu->powerDown || mcu->coverage != NULL)
+    return false;
+
+  // Receiver would take the byte after the next instruction.
+  if (mcu->autoWrite && mcu->INPUT != -1 && (*mcu->SCON & 0x11) == 0x10)
+    return false;
+
+  return true;
+}
+
+MCULanesStop runLanesMCU(MCULanes* lanes, unsigned long long end)
+{
+  MCU* mcu = lanes->mcu;
+  MCULanesStop stop = LANES_SINGLE;
+  bool running = true;
+
+  if (lanes->numOfLanes == 0 || lanesJoin(lanes) != STEP_NEXT)
+    return LANES_SPLIT;
+
+  // Shared state could be synced when lanes were packed.
+  settleMCU(mcu);
+
+  while (running && lanesQuiet(mcu)) {
+    unsigned budget = beginBlockMCU(mcu);
+    unsigned instructions = 0;
+    unsigned cycles = 0;
+
+    if (budget == 0)
+      break;
+
+    while (true) {
+      BYTE opcode = *ROM(mcu, mcu->PC);
+      int result;
+
+      if (mcu->cycles + cycles >= end) {
+        stop = LANES_BUDGET;
+        running = false;
+        break;
+      }
+
+      // The rest of budget is checked again.
+      if (cycles + mcu->cycleCount[opcode] > budget)
+        break;
+
+      result = lanesStep(lanes, opcode);
+      if (result == STEP_FAILED) {
+        running = false;
+        break;
+      }
+
+      instructions += 1;
+      cycles += mcu->cycleCount[opcode];
+
+      if (result == STEP_SPLIT) {
+        stop = LANES_SPLIT;
+        running = false;
+        break;
+      }
+    }
+
+    endBlockMCU(mcu, instructions, cycles, NULL, NULL, NULL, NULL);
+  }
+
+  if (stop != LANES_SPLIT) {
+    for (unsigned lane = 0; lane < lanes->numOfLanes; ++lane)
+      lanesSetPC(lanes, lane, mcu->PC);
+  }
+
+  return stop;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
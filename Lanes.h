@@ -0,0 +1,77 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LANES_H_
+#define LANES_H_
+
+#include "MCS51.h"
+
+/*
+ * Instances of one program which differ only in ACC, B, PSW, SP, DPL, DPH,
+ * SBUF and IDATA (see sameSharedStateMCU), run together. Everything else is
+ * kept once in mcu, the registers are kept in structure of arrays: one row
+ * of capacity bytes for every IDATA address and register, lane by lane.
+ * While lanes are at the same PC an instruction is executed by one loop
+ * over all of them. Loops are plain scalar C without SIMD code, lanes
+ * share fetching and decoding of the instruction.
+ */
+typedef struct {
+  MCU* mcu;       // shared state, its own copy of the registers isn't used
+  unsigned numOfLanes;
+  unsigned capacity;
+  BYTE* rows;
+  unsigned* first;  // operands of lanes, offsets into rows
+  unsigned* second;
+} MCULanes;
+
+typedef enum {
+  LANES_BUDGET,  // end was reached
+  LANES_SINGLE,  // next instruction has to run in every lane alone
+  LANES_SPLIT    // lanes went to different PC
+} MCULanesStop;
+
+/*
+ * initLanesMCU() makes empty lanes of shared state mcu, which belongs to
+ * the caller. addLaneMCU() adds registers and PC of src, which has to be
+ * in the same shared state (sameSharedStateMCU), and returns its lane. Lane
+ * with the same registers is shared. getLaneMCU() stores registers and PC
+ * of lane into dst, which has the shared state (cloneMCU of lanes->mcu).
+ */
+void initLanesMCU(MCULanes* lanes, MCU* mcu);
+void removeLanesMCU(MCULanes* lanes);
+unsigned addLaneMCU(MCULanes* lanes, MCU* src);
+void getLaneMCU(MCULanes* lanes, unsigned lane, MCU* dst);
+WORD lanePCMCU(MCULanes* lanes, unsigned lane);
+
+/*
+ * Run lanes while they are at the same PC, until instruction which starts
+ * at end cycle or later. Lanes run only quiet code like hot blocks (see
+ * beginBlockMCU): no timer event, interrupt, uart transfer, breakpoint,
+ * coverage or access outside of the registers above. Every lane gets the
+ * same result as it would get alone from runMCUBatch() without stop reasons
+ * other than budget, except of debugger information about accessed memory.
+ */
+MCULanesStop runLanesMCU(MCULanes* lanes, unsigned long long end);
+
+#endif /* LANES_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
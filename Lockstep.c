@@ -0,0 +1,226 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "Global.h"
+
+#include "Lockstep.h"
+#include "Recompiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOCKSTEP_MAX_BYTES 16 // different bytes listed per memory
+
+static const struct {
+  MemoryType type;
+  const char* name;
+} g_lockstepMemories[] = {
+  { XDATA, "XDATA" },
+  { IROM, "IROM" },
+  { XROM, "XROM" },
+};
+
+static void lockstepField(FILE* report, const char* name, const char* format,
+                          unsigned long long reference, unsigned long long checked)
+{
+  char a[32], b[32];
+
+  if (reference == checked)
+    return;
+
+  snprintf(a, sizeof(a), format, reference);
+  snprintf(b, sizeof(b), format, checked);
+  fprintf(report, "  %-16s %-12s %s\n", name, a, b);
+}
+
+static void lockstepReport(FILE* report, MCU* reference, MCU* mcu,
+                           const WORD* trail, int numOfTrail)
+{
+  char name[32];
+  MCU referenceView, checkedView;
+
+  // Registers are reported synced, mcu keeps its lazy state.
+  viewMCU(&referenceView, reference);
+  viewMCU(&checkedView, mcu);
+  reference = &referenceView;
+  mcu = &checkedView;
+
+  fprintf(report, "Engines diverged after %llu instructions.\n", reference->instructions);
+
+  fprintf(report, "Reference executed:\n");
+  for (int i = 0; i < numOfTrail; ++i) {
+    // Busy-wait loop is skipped in steps of one instruction.
+    if (i > 0 && trail[i] == trail[i - 1])
+      continue;
+
+    char* code = disassembler(reference, trail[i], "%a: %o  %m %p", NULL);
+    fprintf(report, "  %s\n", code);
+    free(code);
+  }
+
+  fprintf(report, "  %-16s %-12s %s\n", "", "reference", "checked");
+  lockstepField(report, "PC", "%.4llXh", reference->PC, mcu->PC);
+  lockstepField(report, "cycles", "%llu", reference->cycles, mcu->cycles);
+  lockstepField(report, "instructions", "%llu", reference->instructions, mcu->instructions);
+  lockstepField(report, "idle", "%llu", reference->idle, mcu->idle);
+  lockstepField(report, "power down", "%llu", reference->powerDown, mcu->powerDown);
+  lockstepField(report, "error", "%llu", reference->errid, mcu->errid);
+  lockstepField(report, "interrupts", "%.2llXh", reference->pendingInterrupts,
+                mcu->pendingInterrupts);
+  lockstepField(report, "in service", "%.2llXh", reference->interruptsInService,
+                mcu->interruptsInService);
+  lockstepField(report, "uart input", "%lld", (long long) reference->INPUT,
+                (long long) mcu->INPUT);
+  lockstepField(report, "uart output", "%lld", (long long) reference->OUTPUT,
+                (long long) mcu->OUTPUT);
+  lockstepField(report, "watchdog", "%llu", reference->WDTTimerValue, mcu->WDTTimerValue);
+
+  for (int i = 0; i < SFR_SIZE; ++i) {
+    snprintf(name, sizeof(name), "SFR %s", mcu->SFRNames[0x80 + i]);
+    lockstepField(report, name, "%.2llXh", reference->sfr[i], mcu->sfr[i]);
+  }
+
+  for (int i = 0; i < INT_RAM_SIZE; ++i) {
+    snprintf(name, sizeof(name), "IDATA %.2Xh", i);
+    lockstepField(report, name, "%.2llXh", reference->idata[i], mcu->idata[i]);
+  }
+
+  for (size_t m = 0; m < sizeof(g_lockstepMemories) / sizeof(g_lockstepMemories[0]); ++m) {
+    MemoryType type = g_lockstepMemories[m].type;
+    int different = 0;
+
+    for (int address = 0; address <= 0xFFFF; ++address) {
+      BYTE a = getMemoryMCU(reference, type, address);
+      BYTE b = getMemoryMCU(mcu, type, address);
+
+      if (a == b)
+        continue;
+
+      if (different++ < LOCKSTEP_MAX_BYTES) {
+        snprintf(name, sizeof(name), "%s %.4Xh", g_lockstepMemories[m].name, address);
+        lockstepField(report, name, "%.2llXh", a, b);
+      }
+    }
+
+    if (different > LOCKSTEP_MAX_BYTES)
+      fprintf(report, "  ... %d more different bytes in %s\n",
+              different - LOCKSTEP_MAX_BYTES, g_lockstepMemories[m].name);
+  }
+}
+
+/*
+ * Cycles left up to end, maxCycles for runMCUBatch().
+ */
+static unsigned long long lockstepBudget(MCU* mcu, unsigned long long end)
+{
+  if (end == MCU_NO_LIMIT)
+    return MCU_NO_LIMIT;
+
+  return mcu->cycles < end ? end - mcu->cycles : 0;
+}
+
+/*
+ * Steps of checked engine, 0 when none was done.
+ */
+static unsigned long long lockstepChecked(MCU* mcu, unsigned long long count,
+                                          unsigned long long end, int stopMask,
+                                          MCUStopReason* reason)
+{
+  unsigned long long done;
+
+  if (!isModuleUsable(mcu))
+    return runMCUBatch(mcu, count, lockstepBudget(mcu, end), stopMask, reason);
+
+  // Like `run n` with module.
+  *reason = STOP_BUDGET;
+  done = fastForwardMCU(mcu, count);
+  if (done > 0)
+    return done;
+
+  done = count;
+  if (!runModule(mcu, &done, NULL, NULL, NULL, NULL))
+    *reason = mcu->errid != E_NOERRORS ? STOP_ERROR : STOP_BREAKPOINT;
+
+  return done;
+}
+
+bool runLockstepMCU(MCU* mcu, unsigned long long count, unsigned long long maxCycles,
+                    int stopMask, unsigned long long* executed, MCUStopReason* reason,
+                    FILE* report)
+{
+  MCU reference;
+  WORD trail[MAX_BLOCK_LENGTH];
+  int numOfTrail = 0;
+  bool same = true;
+  unsigned long long end = MCU_NO_LIMIT;
+
+  if (maxCycles != MCU_NO_LIMIT && mcu->cycles + maxCycles > mcu->cycles)
+    end = mcu->cycles + maxCycles;
+
+  // Only the reference is synced, lazy flags, timer deadlines and pending
+  // interrupts of mcu are carried on to check them as well.
+  cloneMCU(&reference, mcu);
+  syncMCU(&reference);
+  reference.usePredecoded = false;
+  reference.useBlocks = false;
+  reference.lazyFlags = false;
+
+  *executed = 0;
+  *reason = STOP_BUDGET;
+
+  while (*executed < count && *reason == STOP_BUDGET && mcu->cycles < end) {
+    // Blocks are run only when the whole one fits in count.
+    unsigned long long chunk = mcu->useBlocks || isModuleUsable(mcu) ? MAX_BLOCK_LENGTH : 1;
+    unsigned long long done;
+    MCUStopReason referenceReason = STOP_BUDGET;
+
+    if (chunk > count - *executed)
+      chunk = count - *executed;
+
+    done = lockstepChecked(mcu, chunk, end, stopMask, reason);
+    if (done == 0)
+      break;
+
+    // Reference goes one step at a time to know what it executed.
+    numOfTrail = 0;
+    for (unsigned long long i = 0; i < done && referenceReason == STOP_BUDGET; ++i) {
+      trail[numOfTrail++] = reference.PC;
+      if (runMCUBatch(&reference, 1, lockstepBudget(&reference, end), stopMask,
+                      &referenceReason) == 0)
+        break;
+    }
+
+    *executed += done;
+    same = sameStateMCU(&reference, mcu);
+    if (!same) {
+      lockstepReport(report, &reference, mcu, trail, numOfTrail);
+      break;
+    }
+  }
+
+  removeMCU(&reference);
+
+  return same;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
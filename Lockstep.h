@@ -0,0 +1,54 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOCKSTEP_H_
+#define LOCKSTEP_H_
+
+#include <stdio.h>
+#include "MCS51.h"
+
+/*
+ * Lockstep check of execution engines. Reference copy of mcu (cloneMCU)
+ * runs on the interpreter, without predecoded code, blocks and lazy flags,
+ * next to mcu on its own engine: predecoded code, blocks, lazy flags or
+ * loaded module. Both get the same number of steps, after every
+ * instruction (every block with useBlocks) they are compared with
+ * sameStateMCU(), which compares only memory pages written since the copy
+ * was made. Comparison doesn't sync mcu, so its lazy flags, timer deadlines
+ * and pending interrupts go on from one step to the next as without check. Reference keeps noDebug of mcu. Device plugins see accesses of
+ * both copies, so they have to be stateless for the check.
+ *
+ * Runs up to count steps or maxCycles cycles like runMCUBatch() (loaded
+ * module isn't limited by cycles), number of executed steps is stored in
+ * *executed and the reason of stop in *reason.
+ * On the first difference disassembly of instructions executed by the
+ * reference since the last comparison and different registers and memory
+ * bytes are written into report, mcu stays in its diverged state and false
+ * is returned.
+ */
+bool runLockstepMCU(MCU* mcu, unsigned long long count, unsigned long long maxCycles,
+                    int stopMask, unsigned long long* executed, MCUStopReason* reason,
+                    FILE* report);
+
+#endif /* LOCKSTEP_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
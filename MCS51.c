@@ -23,13 +23,46 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "Config.h"
 #include "MCS51.h"
-#include "Utils.h"
+#include "DeAsmTables.h"
+
+/*
+ * Operations remembered in lazyOp.
+ */
+#define LAZY_NONE 0
+#define LAZY_ADD  1
+#define LAZY_SUB  2
+
+/*
+ * Interrupt sources have the same bits as in IE and IP, they are listed in
+ * order of polling. INT_DIRTY in pendingInterrupts means flags or enable
+ * bits could have changed since the last check.
+ */
+#define INT_IE0    0x01
+#define INT_TF0    0x02
+#define INT_IE1    0x04
+#define INT_TF1    0x08
+#define INT_SERIAL 0x10
+#define INT_TIMER2 0x20
+#define INT_DIRTY  0x80
+
+// interruptsInService
+#define INT_LOW    0x01
+#define INT_HIGH   0x02
+
+/*
+ * Access tracking done by memory wrappers. Changes of SFR are tracked also
+ * without debugger, write hooks and interrupts depend on them.
+ */
+#define TRACK_NONE 0 // debugger access
+#define TRACK_ALL  1 // instructions, with information for debugger
+#define TRACK_SFR  2 // instructions, SFR only
 
 /*
  * Default memory wrappers.
  */
-inline BYTE* _mcuIntRAM(MCU* mcu, BYTE address, bool direct, bool info)
+static inline BYTE* _mcuIntRAM(MCU* mcu, BYTE address, bool direct, int track)
 {
   if (address >= mcu->idataMemorySize && !direct) {
     address &= mcu->idataMemorySize - 1;
@@ -37,7 +70,7 @@ inline BYTE* _mcuIntRAM(MCU* mcu, BYTE address, bool direct, bool info)
   }
 
   if (address < 0x80) {
-    if (info) {
+    if (track == TRACK_ALL) {
       mcu->_beforeAccessedIntRAM = mcu->idata[address];
       mcu->accessedIntRAM = address;
     }
@@ -45,14 +78,38 @@ inline BYTE* _mcuIntRAM(MCU* mcu, BYTE address, bool direct, bool info)
     return &mcu->idata[address];
   } else {
     if (direct) {
-      if (info) {
+      switch (address) {
+      case 0xD0: // PSW
+        if (mcu->lazyOp != LAZY_NONE || mcu->lazyParity)
+          syncFlagsMCU(mcu);
+        break;
+      case 0x8A: // TL0
+      case 0x8B: // TL1
+      case 0x8C: // TH0
+      case 0x8D: // TH1
+      case 0xCC: // TL2
+      case 0xCD: // TH2
+        syncTimersMCU(mcu);
+        break;
+      case 0x88: // TCON
+      case 0x98: // SCON
+      case 0xA8: // IE
+      case 0xB0: // P3
+      case 0xB8: // IP
+      case 0xC8: // T2CON
+        if (track != TRACK_NONE)
+          mcu->pendingInterrupts |= INT_DIRTY;
+        break;
+      }
+
+      if (track != TRACK_NONE) {
         mcu->_beforeAccessedSFR = mcu->sfr[address - 0x80];
         mcu->accessedSFR = address;
       }
 
       return &mcu->sfr[address - 0x80];
     } else { // indirect
-      if (info) {
+      if (track == TRACK_ALL) {
         mcu->_beforeAccessedIntRAM = mcu->idata[address];
         mcu->accessedIntRAM = address;
       }
@@ -62,5233 +119,3154 @@ inline BYTE* _mcuIntRAM(MCU* mcu, BYTE address, bool direct, bool info)
   }
 }
 
-inline void _mcuSetIntRAM(MCU* mcu, BYTE address, bool direct, BYTE value, bool info)
+static inline void _mcuSetIntRAM(MCU* mcu, BYTE address, bool direct, BYTE value, int track)
 {
-  if (direct && address == 0x99)
-    mcu->OUTPUT = value;
-
-  *_mcuIntRAM(mcu, address, direct, info) = value;
-}
+  BYTE* byte = _mcuIntRAM(mcu, address, direct, track);
+  BYTE before = *byte;
 
-inline BYTE* _mcuExtRAM(MCU* mcu, WORD address, bool info)
-{
-  if (address >= mcu->xdataMemorySize) {
-    address %= mcu->xdataMemorySize == 0 ? 1 : mcu->xdataMemorySize;
-    mcu->errid = E_XRAMOUTSIDE;
-  }
+  *byte = value;
 
-  if (info) {
-    mcu->_beforeAccessedExtRAM = mcu->xdata[address];
-    mcu->accessedExtROM = address;
+  if (direct && address >= 0x80 && mcu->_sfrWrite[address - 0x80] != NULL) {
+    mcu->_sfrWrite[address - 0x80](mcu, before);
+    mcu->_writtenSFR = address;
   }
-
-  return &mcu->xdata[address];
 }
 
-inline BYTE* _mcuROM(MCU* mcu, WORD address, bool info)
-{
-  if (mcu->xromMemorySize != 0 && (address >= mcu->iromMemorySize || !mcu->EA)) {
-    if (address >= mcu->xromMemorySize) {
-      address %= mcu->xdataMemorySize == 0 ? 1 : mcu->xdataMemorySize;
-    }
-
-    if (info)
-      mcu->accessedExtROM = address;
-
-    return &mcu->xrom[address];
-
-  }
+/*
+ * Memory pages. Page without owner is freed, the last one can write to it.
+ */
+static const BYTE mcuZeroPage[256];
 
-  if (address >= mcu->iromMemorySize) {
-    address %= mcu->idataMemorySize == 0 ? 1 : mcu->idataMemorySize;
-  }
+static MCUPage* mcuNewPage(const BYTE* data)
+{
+  MCUPage* page = malloc(sizeof(MCUPage));
 
-  if (info)
-    mcu->accessedIntROM = address;
+  page->refs = 1;
+  if (data != NULL)
+    memcpy(page->data, data, sizeof(page->data));
+  else
+    memset(page->data, 0, sizeof(page->data));
 
-  return &mcu->irom[address];
+  return page;
 }
 
-inline BYTE* mcuIntRAM(MCU* mcu, BYTE address, bool direct)
+static void mcuReleasePage(MCUPage* page)
 {
-  return  _mcuIntRAM(mcu, address, direct, true);
+  if (page != NULL && __sync_sub_and_fetch(&page->refs, 1) == 0)
+    free(page);
 }
 
-inline void mcuSetIntRAM(MCU* mcu, BYTE address, bool direct, BYTE value)
+static void mcuSharePage(MCUPage* page)
 {
-  _mcuSetIntRAM(mcu, address, direct, value, true);
+  if (page != NULL)
+    __sync_add_and_fetch(&page->refs, 1);
 }
 
-inline BYTE* mcuExtRAM(MCU* mcu, WORD address)
+// Only the owner of the last reference can see 1, no race there.
+static inline bool mcuPageShared(const MCUPage* page)
 {
-  return _mcuExtRAM(mcu, address, true);
+  return page == NULL || page->refs > 1;
 }
 
-inline BYTE* mcuROM(MCU* mcu, WORD address)
+static inline BYTE* mcuPageData(MCUPage* page)
 {
-  return _mcuROM(mcu, address, true);
+  return page != NULL ? page->data : (BYTE*) mcuZeroPage;
 }
 
-inline bool mcuCheckBit(MCU* mcu, BYTE bit)
+static MCUPage** mcuPages(const MCU* mcu, MemoryType type)
 {
-  BYTE address;
-  BYTE bitToCheck;
-  address = bit & 0xF8;
-  bitToCheck = bit & 0x07;
-  if (bit >= 0x80) { // sfr
-    if (*mcuIntRAM(mcu, address, true) & 1 << bitToCheck) {
-      return true;
-    } else {
-      return false;
-    }
-  } else { // int ram
-    address = (address >> 3) + 32;
-    if (*mcuIntRAM(mcu, address, true) & 1 << bitToCheck) {
-      return true;
-    } else {
-      return false;
-    }
-  }
+  if (type == XDATA)
+    return (MCUPage**) mcu->xdata;
+  else if (type == IROM)
+    return (MCUPage**) mcu->irom;
+  else if (type == XROM)
+    return (MCUPage**) mcu->xrom;
+
+  return NULL;
 }
 
-inline void mcuSetBit(MCU* mcu, BYTE bit, bool state)
+static inline uint32_t mcuXorshift(uint32_t x)
 {
-  BYTE address;
-  BYTE bitToCheck;
-
-  address = bit & 0xF8;
-  bitToCheck = bit & 0x07;
-
-  if (bit >= 0x80) { // sfr
-    if (state)
-      *mcuIntRAM(mcu, address, true) |= 1 << bitToCheck;
-    else
-      *mcuIntRAM(mcu, address, true) &= ~(1 << bitToCheck);
-  } else { // int ram
-    address = (address >> 3) + 32;
-    if (state)
-      *mcuIntRAM(mcu, address, true) |= 1 << bitToCheck;
-    else
-      *mcuIntRAM(mcu, address, true) &= ~(1 << bitToCheck);
-  }
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
 }
 
-inline void mcuAdd(MCU* mcu, BYTE* a, BYTE* b)
+/*
+ * Poison of one byte, idata is page 256. Random byte is hash of seed and
+ * its address, so pages can be made in any order and single byte is read
+ * without making its page.
+ */
+static inline BYTE mcuPoisonByte(const MCU* mcu, unsigned page, unsigned offset)
 {
-  int temp1, temp2;
-  if (((0x0F & *a) + (0x0F & *b)) > 0x0F)
-    setRegister(mcu, PSW_AC, true);
-  else
-    setRegister(mcu, PSW_AC, false);
+  uint32_t x;
 
-  temp1 = ((0x7F & *a) + (0x7F & *b)) > 0x7F;
-  temp2 = *a + *b;
+  if (mcu->poison == POISON_ZERO)
+    return 0x00;
 
-  if (temp2 > 0xFF) {
-    setRegister(mcu, PSW_CY, true);
+  if (mcu->poison == POISON_PATTERN)
+    return mcu->poisonValue;
 
-    if (temp1)
-      setRegister(mcu, PSW_OV, false);
-    else
-      setRegister(mcu, PSW_OV, true);
-  } else {
-    setRegister(mcu, PSW_CY, false);
+  x = mcu->poisonValue ^ ((page << 8 | offset) + 1) * 0x9E3779B9u;
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35u;
+  x ^= x >> 16;
 
-    if (temp1)
-      setRegister(mcu, PSW_OV, true);
-    else
-      setRegister(mcu, PSW_OV, false);
-  }
-  *a = (BYTE) temp2 & 0xFF;
+  return x >> 24;
 }
 
-inline void mcuAddc(MCU* mcu, BYTE* a, BYTE* b)
+static void mcuPoisonPage(const MCU* mcu, unsigned page, BYTE* data)
 {
-  int temp1, temp2, c = checkRegister(mcu, PSW_CY);
-  if (((0x0F & *a) + (0x0F & (*b + c))) > 0x0F)
-    setRegister(mcu, PSW_AC, true);
-  else
-    setRegister(mcu, PSW_AC, false);
-
-  temp1 = ((0x7F & *a) + (0x7F & *b)) + c > 0x7F;
-  temp2 = *a + *b + c;
-
-  if (temp2 > 0xFF) {
-    setRegister(mcu, PSW_CY, true);
-
-    if (temp1)
-      setRegister(mcu, PSW_OV, false);
-    else
-      setRegister(mcu, PSW_OV, true);
+  if (mcu->poison == POISON_RANDOM) {
+    for (unsigned i = 0; i < 256; ++i)
+      data[i] = mcuPoisonByte(mcu, page, i);
   } else {
-    setRegister(mcu, PSW_CY, false);
-
-    if (temp1)
-      setRegister(mcu, PSW_OV, true);
-    else
-      setRegister(mcu, PSW_OV, false);
+    memset(data, mcuPoisonByte(mcu, page, 0), 256);
   }
-  *a = (BYTE) temp2 & 0xFF;
 }
 
-extern inline void mcuSub(MCU* mcu, BYTE* a, BYTE* b)
+/*
+ * Contents of page, page which isn't allocated is made in buffer.
+ */
+static const BYTE* mcuPageContents(const MCU* mcu, MemoryType type, unsigned page,
+                                   BYTE* buffer)
 {
-  int temp1, temp2, c = checkRegister(mcu, PSW_CY);
-  if (((char) (0x0F & *a) - (char) (0xF & *b) - c))
-    setRegister(mcu, PSW_AC, true);
-  else
-    setRegister(mcu, PSW_AC, false);
+  MCUPage* own = mcuPages(mcu, type)[page];
 
-  temp1 = ((char) (0x7F & *a) - (char) (0x7F & *b) - c) < 0;
-  temp2 = *a - *b - c;
+  if (own != NULL)
+    return own->data;
 
-  if (temp2 < 0) {
-    setRegister(mcu, PSW_CY, true);
-
-    if (temp1)
-      setRegister(mcu, PSW_OV, false);
-    else
-      setRegister(mcu, PSW_OV, true);
-  } else {
-    setRegister(mcu, PSW_CY, false);
+  if (type != XDATA || mcu->poison == POISON_ZERO)
+    return mcuZeroPage;
 
-    if (temp1)
-      setRegister(mcu, PSW_OV, true);
-    else
-      setRegister(mcu, PSW_OV, false);
-  }
-  *a = (BYTE) temp2 & 0xFF;
+  mcuPoisonPage(mcu, page, buffer);
+  return buffer;
 }
 
-// nop
-void nop_00(MCU* mcu)
+static BYTE* mcuOwnPage(MCU* mcu, MemoryType type, unsigned page)
 {
-  mcu->PC += 1;
-}
+  MCUPage** own = &mcuPages(mcu, type)[page];
 
-// mov a,#(byte)
-void mov_74(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  if (*own == NULL) {
+    *own = mcuNewPage(NULL);
+    if (type == XDATA)
+      mcuPoisonPage(mcu, page, (*own)->data);
+  } else if ((*own)->refs > 1) {
+    MCUPage* copy = mcuNewPage((*own)->data);
+    mcuReleasePage(*own);
+    *own = copy;
+  }
 
-// mov (adress),#(byte)
-void mov_75(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuROM(mcu, mcu->PC + 1));
-  mcu->PC += 2;
+  return (*own)->data;
 }
 
-// ljmp 16bit_adres
-void ljmp_02(MCU* mcu)
+/*
+ * Address mapping done by memory map. Used to build pages and for pages
+ * which don't map to continuous memory.
+ */
+static WORD mcuExtRAMAddress(MCU* mcu, WORD address, bool* outside)
 {
-  mcu->PC += 1;
-  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC) << 8 | *mcuROM(mcu, mcu->PC + 1);
-}
+  *outside = address >= mcu->xdataMemorySize;
 
-// sjmp offset
-void sjmp_80(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-}
+  if (*outside)
+    address %= mcu->xdataMemorySize == 0 ? 1 : mcu->xdataMemorySize;
 
-// mov (adress1),(ardess2)
-void mov_85(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC + 1), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true));
-  mcu->PC += 2;
+  return address;
 }
 
-// mov A,(adress)
-void mov_E5(MCU* mcu)
+static BYTE* mcuMapExtRAM(MCU* mcu, WORD address, bool* outside)
 {
-  mcu->PC += 1;
-  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
+  address = mcuExtRAMAddress(mcu, address, outside);
+  return mcuPageData(mcu->xdata[address >> 8]) + (address & 0xFF);
 }
 
-// mov (bit),C
-void mov_92(MCU* mcu)
+static WORD mcuROMAddress(MCU* mcu, WORD address, bool* ext)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY))
-    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
-  else
-    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
-  mcu->PC += 1;
-}
+  *ext = mcu->xromMemorySize != 0 && (address >= mcu->iromMemorySize || !mcu->EA);
 
-// inc a
-void inc_04(MCU* mcu)
-{
-  (*mcu->ACC)++;
-  mcu->PC += 1;
-}
+  if (*ext) {
+    if (address >= mcu->xromMemorySize)
+      address %= mcu->xromMemorySize;
+  } else if (address >= mcu->iromMemorySize) {
+    address %= mcu->iromMemorySize == 0 ? 1 : mcu->iromMemorySize;
+  }
 
-// inc (adress)
-void inc_05(MCU* mcu)
-{
-  mcu->PC += 1;
-  (*mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))++;
-  mcu->PC += 1;
+  return address;
 }
 
-// inc DPTR
-void inc_A3(MCU* mcu)
+static BYTE* mcuMapROM(MCU* mcu, WORD address)
 {
-  *mcu->DPTR = *mcu->DPTR + 1;
-  mcu->PC += 1;
-}
+  bool ext;
 
-// inc @R0
-void inc_06(MCU* mcu)
-{
-  (*mcuIntRAM(mcu, mcu->R[0], false))++;
-  mcu->PC += 1;
+  address = mcuROMAddress(mcu, address, &ext);
+  return mcuPageData((ext ? mcu->xrom : mcu->irom)[address >> 8]) + (address & 0xFF);
 }
 
-// inc @R1
-void inc_07(MCU* mcu)
+/*
+ * Pages mapped to whole memory page take fast path.
+ */
+static void mcuMapROMPage(MCU* mcu, unsigned page)
 {
-  (*mcuIntRAM(mcu, mcu->R[1], false))++;
-  mcu->PC += 1;
-}
+  bool firstExt, lastExt;
+  WORD first = mcuROMAddress(mcu, page << 8, &firstExt);
+  WORD last = mcuROMAddress(mcu, page << 8 | 0xFF, &lastExt);
 
-// inc R0
-void inc_08(MCU* mcu)
-{
-  mcu->R[0]++;
-  mcu->PC += 1;
+  mcu->romPages[page] = mcuMapROM(mcu, page << 8);
+  mcu->romPageFlags[page] = 0;
+  if ((first & 0xFF) != 0 || last != first + 0xFF || firstExt != lastExt)
+    mcu->romPageFlags[page] |= PAGE_SPLIT;
 }
 
-// inc R1
-void inc_09(MCU* mcu)
+static void mcuMapExtRAMPage(MCU* mcu, unsigned page)
 {
-  mcu->R[1]++;
-  mcu->PC += 1;
-}
+  bool firstOutside, lastOutside;
+  WORD first = mcuExtRAMAddress(mcu, page << 8, &firstOutside);
+  WORD last = mcuExtRAMAddress(mcu, page << 8 | 0xFF, &lastOutside);
+  BYTE flags = firstOutside ? PAGE_OUTSIDE : 0;
 
-// inc R2
-void inc_0A(MCU* mcu)
-{
-  mcu->R[2]++;
-  mcu->PC += 1;
-}
+  if ((first & 0xFF) != 0 || last != first + 0xFF || firstOutside != lastOutside)
+    flags |= PAGE_SPLIT | PAGE_COPY;
+  else if (mcuPageShared(mcu->xdata[first >> 8]))
+    flags |= PAGE_COPY;
 
-// inc R3
-void inc_0B(MCU* mcu)
-{
-  mcu->R[3]++;
-  mcu->PC += 1;
-}
+  // Split page may map to pages which aren't allocated.
+  if (mcu->poison != POISON_ZERO &&
+      (mcu->xdata[first >> 8] == NULL || (flags & PAGE_SPLIT)))
+    flags |= PAGE_LAZY;
 
-// inc R4
-void inc_0C(MCU* mcu)
-{
-  mcu->R[4]++;
-  mcu->PC += 1;
-}
+  for (unsigned i = 0; i < mcu->numOfDevices; ++i) {
+    if (page >= mcu->devices[i].first >> 8u && page <= mcu->devices[i].last >> 8u)
+      flags |= PAGE_MMIO;
+  }
 
-// inc R5
-void inc_0D(MCU* mcu)
-{
-  mcu->R[5]++;
-  mcu->PC += 1;
+  mcu->xdataPages[page] = mcuPageData(mcu->xdata[first >> 8]);
+  mcu->xdataPageFlags[page] = flags;
 }
 
-// inc R6
-void inc_0E(MCU* mcu)
+/*
+ * XDATA page was allocated, copied or shared, pages mapped to it are
+ * mapped again.
+ */
+static void mcuRemapExtRAM(MCU* mcu, unsigned page)
 {
-  mcu->R[6]++;
-  mcu->PC += 1;
-}
+  if (mcu->xdataMemorySize == MAX_EXT_RAM_SIZE) {
+    mcuMapExtRAMPage(mcu, page);
+    return;
+  }
 
-// inc R7
-void inc_0F(MCU* mcu)
-{
-  mcu->R[7]++;
-  mcu->PC += 1;
+  for (unsigned i = 0; i < 256; ++i)
+    mcuMapExtRAMPage(mcu, i);
 }
 
-// dec A
-void dec_14(MCU* mcu)
+void mapMemoryMCU(MCU* mcu)
 {
-  *mcu->ACC = *mcu->ACC - 1;
-  mcu->PC += 1;
-}
+  for (unsigned page = 0; page < 256; ++page) {
+    mcuMapROMPage(mcu, page);
+    mcuMapExtRAMPage(mcu, page);
+  }
 
-// dec (adress)
-void dec_15(MCU* mcu)
-{
-  mcu->PC += 1;
-  (*mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))--;
-  mcu->PC += 1;
-}
+  mcu->codeSize = mcu->iromMemorySize > mcu->xromMemorySize ?
+                  mcu->iromMemorySize : mcu->xromMemorySize;
+  if (mcu->codeSize == 0)
+    mcu->codeSize = 1;
 
-// dec @R0
-void dec_16(MCU* mcu)
-{
-  (*mcuIntRAM(mcu, mcu->R[0], false))--;
-  mcu->PC += 1;
+  // Decoded code follows the map.
+  mcu->decodedValid = false;
+  mcu->codeVersion += 1;
 }
 
-// dec @R1
-void dec_17(MCU* mcu)
+static inline BYTE* _mcuExtRAM(MCU* mcu, WORD address, bool info)
 {
-  (*mcuIntRAM(mcu, mcu->R[1], false))--;
-  mcu->PC += 1;
-}
+  BYTE flags = mcu->xdataPageFlags[address >> 8];
+  BYTE* byte;
 
-// dec R0
-void dec_18(MCU* mcu)
-{
-  mcu->R[0]--;
-  mcu->PC += 1;
-}
+  if (flags & PAGE_SPLIT) {
+    bool outside;
 
-// dec R1
-void dec_19(MCU* mcu)
-{
-  mcu->R[1]--;
-  mcu->PC += 1;
-}
+    byte = mcuMapExtRAM(mcu, address, &outside);
+    flags = outside ? PAGE_OUTSIDE : 0;
+  } else
+    byte = mcu->xdataPages[address >> 8] + (address & 0xFF);
 
-// dec R2
-void dec_1A(MCU* mcu)
-{
-  mcu->R[2]--;
-  mcu->PC += 1;
-}
+  if (flags & PAGE_OUTSIDE)
+    mcu->errid = E_XRAMOUTSIDE;
 
-// dec R3
-void dec_1B(MCU* mcu)
-{
-  mcu->R[3]--;
-  mcu->PC += 1;
-}
+  if (info) {
+    bool outside;
 
-// dec R4
-void dec_1C(MCU* mcu)
-{
-  mcu->R[4]--;
-  mcu->PC += 1;
-}
+    mcu->_beforeAccessedExtRAM = *byte;
+    mcu->accessedExtRAM = mcuExtRAMAddress(mcu, address, &outside);
+  }
 
-// dec R5
-void dec_1D(MCU* mcu)
-{
-  mcu->R[5]--;
-  mcu->PC += 1;
+  return byte;
 }
 
-// dec R6
-void dec_1E(MCU* mcu)
+/*
+ * Write to page which is shared or not allocated yet, page gets its own
+ * copy first. Page which isn't shared any more only loses PAGE_COPY.
+ */
+static BYTE* mcuWritableExtRAM(MCU* mcu, WORD address, bool info)
 {
-  mcu->R[6]--;
-  mcu->PC += 1;
-}
+  BYTE flags = mcu->xdataPageFlags[address >> 8];
 
-// dec R7
-void dec_1F(MCU* mcu)
-{
-  mcu->R[7]--;
-  mcu->PC += 1;
+  if (flags & PAGE_COPY) {
+    bool outside;
+    WORD physical = mcuExtRAMAddress(mcu, address, &outside);
+    MCUPage** page = &mcu->xdata[physical >> 8];
+
+    if (mcuPageShared(*page) || !(flags & PAGE_SPLIT)) {
+      mcuOwnPage(mcu, XDATA, physical >> 8);
+      mcuRemapExtRAM(mcu, physical >> 8);
+    }
+  }
+
+  return _mcuExtRAM(mcu, address, info);
 }
 
-// div AB
-void div_84(MCU* mcu)
+/*
+ * Read of page which gets poison, page is made first so its contents are
+ * the same for all later accesses.
+ */
+static BYTE* mcuPoisonedExtRAM(MCU* mcu, WORD address, bool info)
 {
-  BYTE tempB;
+  if (mcu->xdataPageFlags[address >> 8] & PAGE_LAZY) {
+    bool outside;
+    WORD physical = mcuExtRAMAddress(mcu, address, &outside);
 
-  setRegister(mcu, PSW_CY, false);
-  if (*mcu->B != 0) {
-    tempB = *mcu->ACC;
-    *mcu->ACC = tempB / *mcu->B;
-    *mcu->B = tempB % *mcu->B;
-  } else
-    setRegister(mcu, PSW_OV, true);
-  mcu->PC += 1;
+    if (mcu->xdata[physical >> 8] == NULL) {
+      mcuOwnPage(mcu, XDATA, physical >> 8);
+      mcuRemapExtRAM(mcu, physical >> 8);
+    }
+  }
+
+  return _mcuExtRAM(mcu, address, info);
 }
 
-// mul AB
-void mul_A4(MCU* mcu)
+static inline BYTE* _mcuROM(MCU* mcu, WORD address, bool info)
 {
-  WORD tempW;
+  BYTE* byte;
 
-  tempW = (WORD) *mcu->ACC * (WORD) *mcu->B;
-  if (tempW > 255)
-    setRegister(mcu, PSW_OV, true);
+  if (mcu->romPageFlags[address >> 8] & PAGE_SPLIT)
+    byte = mcuMapROM(mcu, address);
   else
-    setRegister(mcu, PSW_OV, false);
-  *mcu->B = (BYTE) tempW >> 8;
-  *mcu->ACC = (BYTE) (tempW & 0xFF);
-  mcu->PC += 1;
-}
+    byte = mcu->romPages[address >> 8] + (address & 0xFF);
 
-// rl A
-void rl_23(MCU* mcu)
-{
-  BYTE tempB;
+  if (info) {
+    bool ext;
+    WORD physical = mcuROMAddress(mcu, address, &ext);
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = tempB << 1 | tempB >> 7;
-  mcu->PC += 1;
+    if (ext)
+      mcu->accessedExtROM = physical;
+    else
+      mcu->accessedIntROM = physical;
+  }
+
+  return byte;
 }
 
-// rr A
-void rr_03(MCU* mcu)
+void mapDeviceMCU(MCU* mcu, WORD first, WORD last, MCUDeviceRead read,
+                  MCUDeviceWrite write, void* context)
 {
-  BYTE tempB;
+  MCUDevice device = {first, last, read, write, context};
+
+  mcu->devices = realloc(mcu->devices, (mcu->numOfDevices + 1) * sizeof(MCUDevice));
+  mcu->devices[mcu->numOfDevices++] = device;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = tempB >> 1 | tempB << 7;
-  mcu->PC += 1;
+  // Blocks are formed again without movx.
+  mapMemoryMCU(mcu);
 }
 
-// rlc A
-void rlc_33(MCU* mcu)
+void unmapDevicesMCU(MCU* mcu)
 {
-  BYTE tempB;
+  free(mcu->devices);
+  mcu->devices = NULL;
+  mcu->numOfDevices = 0;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = tempB << 1 | checkRegister(mcu, PSW_CY);
-  if (tempB & 0x80)
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  mapMemoryMCU(mcu);
 }
 
-// rrc A
-void rrc_13(MCU* mcu)
+/*
+ * movx on page with device registers. Addresses without device go to
+ * memory. Device access is reported as access of unchanged byte.
+ */
+static MCUDevice* mcuFindDevice(MCU* mcu, WORD address)
 {
-  BYTE tempB;
+  for (unsigned i = mcu->numOfDevices; i-- > 0;) {
+    if (address >= mcu->devices[i].first && address <= mcu->devices[i].last)
+      return &mcu->devices[i];
+  }
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = tempB >> 1 | checkRegister(mcu, PSW_CY) << 7;
-  if (tempB & 0x01)
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  return NULL;
 }
 
-// mov DPTR,#(16-bit data)
-void mov_90(MCU* mcu)
+static BYTE mcuReadDevice(MCU* mcu, WORD address, bool info)
 {
-  mcu->PC += 1;
-  *mcu->DPH = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-  *mcu->DPL = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  MCUDevice* device = mcuFindDevice(mcu, address);
 
-// mov (adress),A
-void mov_F5(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcu->ACC);
-  mcu->PC += 1;
-}
+  if (device == NULL)
+    return *mcuPoisonedExtRAM(mcu, address, info);
 
-// add A,#(data)
-void add_24(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuAdd(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
-  mcu->PC += 1;
-}
+  if (info) {
+    mcu->_beforeAccessedExtRAM = getMemoryMCU(mcu, XDATA, address);
+    mcu->accessedExtRAM = address;
+  }
 
-// add A,(adres)
-void add_25(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuAdd(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
-  mcu->PC += 1;
+  return device->read != NULL ? device->read(device->context, address) : 0xFF;
 }
 
-// add A,@R0
-void add_26(MCU* mcu)
+static void mcuWriteDevice(MCU* mcu, WORD address, BYTE value, bool info)
 {
-  mcuAdd(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[0], false));
-  mcu->PC += 1;
-}
+  MCUDevice* device = mcuFindDevice(mcu, address);
 
-// add A,@R1
-void add_27(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[1], false));
-  mcu->PC += 1;
-}
+  if (device == NULL) {
+    *mcuWritableExtRAM(mcu, address, info) = value;
+    return;
+  }
 
-// add A,R0
-void add_28(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[0]);
-  mcu->PC += 1;
-}
+  if (info) {
+    mcu->_beforeAccessedExtRAM = getMemoryMCU(mcu, XDATA, address);
+    mcu->accessedExtRAM = address;
+  }
 
-// add A,R1
-void add_29(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[1]);
-  mcu->PC += 1;
+  if (device->write != NULL)
+    device->write(device->context, address, value);
 }
 
-// add A,R2
-void add_2A(MCU* mcu)
+/*
+ * XDATA access of movx. Pages without devices take the memory path, writes
+ * to pages without own memory the copy path, reads of them the poison path.
+ */
+static inline BYTE _mcuReadExtRAM(MCU* mcu, WORD address, bool info)
 {
-  mcuAdd(mcu, mcu->ACC, &mcu->R[2]);
-  mcu->PC += 1;
-}
+  BYTE flags = mcu->xdataPageFlags[address >> 8];
 
-// add A,R3
-void add_2B(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[3]);
-  mcu->PC += 1;
-}
+  if (flags & (PAGE_MMIO | PAGE_LAZY)) {
+    if (flags & PAGE_MMIO)
+      return mcuReadDevice(mcu, address, info);
 
-// add A,R4
-void add_2C(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[4]);
-  mcu->PC += 1;
-}
+    return *mcuPoisonedExtRAM(mcu, address, info);
+  }
 
-// add A,R5
-void add_2D(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[5]);
-  mcu->PC += 1;
+  return *_mcuExtRAM(mcu, address, info);
 }
 
-// add A,R6
-void add_2E(MCU* mcu)
+static inline void _mcuWriteExtRAM(MCU* mcu, WORD address, BYTE value, bool info)
 {
-  mcuAdd(mcu, mcu->ACC, &mcu->R[6]);
-  mcu->PC += 1;
-}
+  BYTE flags = mcu->xdataPageFlags[address >> 8];
 
-// add A,R7
-void add_2F(MCU* mcu)
-{
-  mcuAdd(mcu, mcu->ACC, &mcu->R[7]);
-  mcu->PC += 1;
+  if (flags & PAGE_MMIO)
+    mcuWriteDevice(mcu, address, value, info);
+  else if (flags & PAGE_COPY)
+    *mcuWritableExtRAM(mcu, address, info) = value;
+  else
+    *_mcuExtRAM(mcu, address, info) = value;
 }
 
-// ADDC
-// addc A,#(data)
-void addc_34(MCU* mcu)
+inline BYTE* mcuIntRAM(MCU* mcu, BYTE address, bool direct)
 {
-  mcu->PC += 1;
-  mcuAddc(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
-  mcu->PC += 1;
+  return  _mcuIntRAM(mcu, address, direct, TRACK_ALL);
 }
 
-// addc A,(adres)
-void addc_35(MCU* mcu)
+inline void mcuSetIntRAM(MCU* mcu, BYTE address, bool direct, BYTE value)
 {
-  mcu->PC += 1;
-  mcuAddc(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
-  mcu->PC += 1;
+  _mcuSetIntRAM(mcu, address, direct, value, TRACK_ALL);
 }
 
-// addc A,@R0
-void addc_36(MCU* mcu)
+inline BYTE mcuReadExtRAM(MCU* mcu, WORD address)
 {
-  mcuAddc(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[0], false));
-  mcu->PC += 1;
+  return _mcuReadExtRAM(mcu, address, true);
 }
 
-// addc A,@R1
-void addc_37(MCU* mcu)
+inline void mcuWriteExtRAM(MCU* mcu, WORD address, BYTE value)
 {
-  mcuAddc(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[1], false));
-  mcu->PC += 1;
+  _mcuWriteExtRAM(mcu, address, value, true);
 }
 
-// addc A,R0
-void addc_38(MCU* mcu)
+inline BYTE mcuReadROM(MCU* mcu, WORD address)
 {
-  mcuAddc(mcu, mcu->ACC, &mcu->R[0]);
-  mcu->PC += 1;
+  return *_mcuROM(mcu, address, true);
 }
 
-// addc A,R1
-void addc_39(MCU* mcu)
+static inline BYTE* mcuExtRAM(MCU* mcu, WORD address)
 {
-  mcuAddc(mcu, mcu->ACC, &mcu->R[1]);
-  mcu->PC += 1;
+  return _mcuExtRAM(mcu, address, true);
 }
 
-// addc A,R2
-void addc_3A(MCU* mcu)
+static inline BYTE* mcuROM(MCU* mcu, WORD address)
 {
-  mcuAddc(mcu, mcu->ACC, &mcu->R[2]);
-  mcu->PC += 1;
+  return _mcuROM(mcu, address, true);
 }
 
-// addc A,R3
-void addc_3B(MCU* mcu)
-{
-  mcuAddc(mcu, mcu->ACC, &mcu->R[3]);
-  mcu->PC += 1;
-}
+/*
+ * Byte and mask of every bit address.
+ */
+#define BIT_BYTE(bit) ((bit) >= 0x80 ? (bit) & 0xF8 : 0x20 + ((bit) >> 3))
+#define BIT_MASK(bit) (1 << ((bit) & 0x07))
 
-// addc A,R4
-void addc_3C(MCU* mcu)
-{
-  mcuAddc(mcu, mcu->ACC, &mcu->R[4]);
-  mcu->PC += 1;
-}
+#define BITS_4(f, n) f(n), f(n + 1), f(n + 2), f(n + 3)
+#define BITS_16(f, n) BITS_4(f, n), BITS_4(f, n + 4), BITS_4(f, n + 8), BITS_4(f, n + 12)
+#define BITS_64(f, n) BITS_16(f, n), BITS_16(f, n + 16), BITS_16(f, n + 32), \
+                      BITS_16(f, n + 48)
+#define BITS_256(f) BITS_64(f, 0), BITS_64(f, 64), BITS_64(f, 128), BITS_64(f, 192)
 
-// addc A,R5
-void addc_3D(MCU* mcu)
-{
-  mcuAddc(mcu, mcu->ACC, &mcu->R[5]);
-  mcu->PC += 1;
-}
+static const BYTE g_bitByte[256] = { BITS_256(BIT_BYTE) };
+static const BYTE g_bitMask[256] = { BITS_256(BIT_MASK) };
 
-// addc A,R6
-void addc_3E(MCU* mcu)
+static inline bool _mcuCheckBit(MCU* mcu, BYTE bit, int track)
 {
-  mcuAddc(mcu, mcu->ACC, &mcu->R[6]);
-  mcu->PC += 1;
+  return (*_mcuIntRAM(mcu, g_bitByte[bit], true, track) & g_bitMask[bit]) != 0;
 }
 
-// addc A,R7
-void addc_3F(MCU* mcu)
+static inline void _mcuSetBit(MCU* mcu, BYTE bit, bool state, int track)
 {
-  mcuAddc(mcu, mcu->ACC, &mcu->R[7]);
-  mcu->PC += 1;
-}
+  BYTE* byte = _mcuIntRAM(mcu, g_bitByte[bit], true, track);
 
-// movx A,@DPTR
-void movx_E0(MCU* mcu)
-{
-  *mcu->ACC = *mcuExtRAM(mcu, *mcu->DPTR);
-  mcu->PC += 1;
+  if (state)
+    *byte |= g_bitMask[bit];
+  else
+    *byte &= ~g_bitMask[bit];
 }
 
-// movx @DPTR,A
-void movx_F0(MCU* mcu)
+inline bool mcuCheckBit(MCU* mcu, BYTE bit)
 {
-  *mcuExtRAM(mcu, *mcu->DPTR) = *mcu->ACC;
-  mcu->PC += 1;
+  return _mcuCheckBit(mcu, bit, TRACK_ALL);
 }
 
-// push (adress)
-void push_C0(MCU* mcu)
+inline void mcuSetBit(MCU* mcu, BYTE bit, bool state)
 {
-  *mcu->SP += 1;
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
-  mcu->PC += 1;
+  _mcuSetBit(mcu, bit, state, TRACK_ALL);
 }
 
-// pop (adress)
-void pop_D0(MCU* mcu)
+/*
+ * AC, OV and CY bits of PSW after a + b + c (LAZY_ADD) or a - b - c
+ * (LAZY_SUB).
+ */
+static inline BYTE mcuArithmeticFlags(BYTE op, BYTE a, BYTE b, int c)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu, *mcu->SP, false));
-  *mcu->SP = *mcu->SP - 1;
-  mcu->PC += 1;
-}
+  int temp1, temp2;
+  BYTE flags = 0;
 
-// clr C
-void clr_C3(MCU* mcu)
-{
-  setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
-}
+  if (op == LAZY_ADD) {
+    if (((0x0F & a) + (0x0F & (b + c))) > 0x0F)
+      flags |= PSW_AC & 0xFF;
 
-// setb C
-void setb_D3(MCU* mcu)
-{
-  setRegister(mcu, PSW_CY, true);
-  mcu->PC += 1;
-}
+    temp1 = ((0x7F & a) + (0x7F & b)) + c > 0x7F;
+    temp2 = a + b + c;
 
-// setb (bit)
-void setb_D2(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+    if (temp2 > 0xFF)
+      flags |= PSW_CY & 0xFF;
+  } else {
+    if (((char) (0x0F & a) - (char) (0xF & b) - c))
+      flags |= PSW_AC & 0xFF;
 
-// clr (bit)
-void clr_C2(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
-  mcu->PC += 1;
-}
+    temp1 = ((char) (0x7F & a) - (char) (0x7F & b) - c) < 0;
+    temp2 = a - b - c;
 
-// xrl (adress),A
-void xrl_62(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true) ^ (*mcu->ACC));
-  mcu->PC += 1;
-}
+    if (temp2 < 0)
+      flags |= PSW_CY & 0xFF;
+  }
 
-// xrl (adress),#(data)
-void xrl_63(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) ^= *mcuROM(mcu, mcu->PC + 1);
-  mcu->PC += 2;
-}
+  if ((flags & PSW_CY & 0xFF) ? !temp1 : temp1)
+    flags |= PSW_OV & 0xFF;
 
-// xrl A,#(data)
-void xrl_64(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = *mcu->ACC ^ *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  return flags;
 }
 
-// xrl A,(adress)
-void xrl_65(MCU* mcu)
+static inline bool mcuParity(BYTE value)
 {
-  mcu->PC += 1;
-  *mcu->ACC = *mcu->ACC ^ *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  int i = 0;
+  int n = 0;
+  for (; i < 8; ++i)
+    if ((1 << i) & value)
+      n += 1;
 
-// xrl A,@R0
-void xrl_66(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC ^ *mcuIntRAM(mcu, mcu->R[0], false);
-  mcu->PC += 1;
+  return 1 == (n % 2);
 }
 
-// xrl A,@R1
-void xrl_67(MCU* mcu)
+void syncFlagsMCU(MCU* mcu)
 {
-  *mcu->ACC = *mcu->ACC ^ *mcuIntRAM(mcu, mcu->R[1], false);
-  mcu->PC += 1;
-}
+  BYTE before = *mcu->PSW;
 
-// xrl A,R0
-void xrl_68(MCU* mcu)
-{
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[0];
-  mcu->PC += 1;
-}
+  if (mcu->lazyOp != LAZY_NONE) {
+    *mcu->PSW &= ~(PSW_AC | PSW_CY | PSW_OV) & 0xFF;
+    *mcu->PSW |= mcuArithmeticFlags(mcu->lazyOp, mcu->lazyA, mcu->lazyB, mcu->lazyC);
+    mcu->lazyOp = LAZY_NONE;
+  }
 
-// xrl A,R1
-void xrl_69(MCU* mcu)
-{
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[1];
-  mcu->PC += 1;
+  if (mcu->lazyParity) {
+    if (mcuParity(mcu->parityACC))
+      *mcu->PSW |= PSW_P & 0xFF;
+    else
+      *mcu->PSW &= ~PSW_P & 0xFF;
+    mcu->lazyParity = false;
+  }
+
+  // Show change like it was done by last instruction.
+  if (*mcu->PSW != before)
+    mcu->changedSFR = 0xD0;
 }
 
-// xrl A,R2
-void xrl_6A(MCU* mcu)
-{
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[2];
-  mcu->PC += 1;
+/*
+ * CY used by addc and subb. Does not force pending flags to be computed.
+ */
+static inline int mcuCarry(MCU* mcu)
+{
+  if (!mcu->lazyFlags)
+    return checkRegister(mcu, PSW_CY);
+
+  switch (mcu->lazyOp) {
+  case LAZY_ADD:
+#ifdef LOCKSTEP_FAULT
+    return 0;
+#else
+    return mcu->lazyA + mcu->lazyB + mcu->lazyC > 0xFF;
+#endif
+  case LAZY_SUB:
+    return mcu->lazyA - mcu->lazyB - mcu->lazyC < 0;
+  default:
+    return (*mcu->PSW & PSW_CY & 0xFF) != 0;
+  }
 }
 
-// xrl A,R3
-void xrl_6B(MCU* mcu)
+static inline void mcuArithmetic(MCU* mcu, BYTE op, BYTE* a, BYTE* b, int c)
 {
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[3];
-  mcu->PC += 1;
+  BYTE flags;
+
+  if (mcu->lazyFlags) {
+    mcu->lazyOp = op;
+    mcu->lazyA = *a;
+    mcu->lazyB = *b;
+    mcu->lazyC = c;
+  } else {
+    flags = mcuArithmeticFlags(op, *a, *b, c);
+    setRegister(mcu, PSW_AC, flags & PSW_AC & 0xFF);
+    setRegister(mcu, PSW_CY, flags & PSW_CY & 0xFF);
+    setRegister(mcu, PSW_OV, flags & PSW_OV & 0xFF);
+  }
+
+  if (op == LAZY_ADD)
+    *a = (BYTE) (*a + *b + c) & 0xFF;
+  else
+    *a = (BYTE) (*a - *b - c) & 0xFF;
 }
 
-// xrl A,R4
-void xrl_6C(MCU* mcu)
+static inline void mcuAdd(MCU* mcu, BYTE* a, BYTE* b)
 {
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[4];
-  mcu->PC += 1;
+  mcuArithmetic(mcu, LAZY_ADD, a, b, 0);
 }
 
-// xrl A,R5
-void xrl_6D(MCU* mcu)
+static inline void mcuAddc(MCU* mcu, BYTE* a, BYTE* b)
 {
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[5];
-  mcu->PC += 1;
+  mcuArithmetic(mcu, LAZY_ADD, a, b, mcuCarry(mcu));
 }
 
-// xrl A,R6
-void xrl_6E(MCU* mcu)
+extern inline void mcuSub(MCU* mcu, BYTE* a, BYTE* b)
 {
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[6];
-  mcu->PC += 1;
+  mcuArithmetic(mcu, LAZY_SUB, a, b, mcuCarry(mcu));
 }
 
-// xrl A,R7
-void xrl_6F(MCU* mcu)
-{
-  *mcu->ACC = (*mcu->ACC) ^ mcu->R[7];
-  mcu->PC += 1;
-}
+/*
+ * Instructions, built with debugger information and without it for cores
+ * used when noDebug is set. Compact set runs as fast as the full one on
+ * tetris52 and is about 35 kB smaller.
+ */
+#ifdef COMPACT_HANDLERS
+#define HANDLERS_COMPACT 1
+#else
+#define HANDLERS_COMPACT 0
+#endif
+
+#define INSTR(name) name
+#define INSTR_TRACK TRACK_ALL
+#define INSTR_COMPACT HANDLERS_COMPACT
+#include "MCS51Instructions.h"
+
+#define INSTR(name) name##_fast
+#define INSTR_TRACK TRACK_SFR
+#define INSTR_COMPACT HANDLERS_COMPACT
+#include "MCS51Instructions.h"
 
-// xch A,(adress)
-void xch_C5(MCU* mcu)
-{
-  BYTE tempB;
+// Timers
 
-  mcu->PC += 1;
-  tempB = *mcu->ACC;
-  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, tempB);
-  mcu->PC += 1;
-}
+/*
+ * Counting is done at once for all cycles since timerBase, so nothing has
+ * to be done between overflows.
+ */
+#define TIMER_NEVER ((unsigned long long) -1)
 
-// xch A,@R0
-void xch_C6(MCU* mcu)
-{
-  BYTE tempB;
+// T0, T1, T2 and T2EX pins.
+#define TIMER_PINS(mcu) ((*(mcu)->P3 >> 4 & 0x03) | (*(mcu)->P1 << 2 & 0x0C))
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[0], false);
-  mcuSetIntRAM(mcu, mcu->R[0], false, tempB);
-  mcu->PC += 1;
+/*
+ * Add n counts to timer in given mode (3 - single 8-bit counter in tl).
+ * Return true on overflow.
+ */
+static bool mcuTimerAdd(BYTE* tl, BYTE* th, BYTE mode, unsigned long long n)
+{
+  unsigned long long value;
+
+  switch (mode) {
+  case 0:
+    value = ((unsigned long long) *th << 5 | (*tl & 0x1F)) + n;
+    *th = (BYTE) (value >> 5);
+    *tl = (*tl & 0xE0) | (value & 0x1F);
+    return value > 0x1FFF;
+  case 1:
+    value = ((unsigned long long) *th << 8 | *tl) + n;
+    *th = (BYTE) (value >> 8);
+    *tl = (BYTE) value;
+    return value > 0xFFFF;
+  case 2:
+    value = *tl + n;
+    if (value <= 0xFF) {
+      *tl = (BYTE) value;
+      return false;
+    }
+    *tl = *th + (value - 0x100) % (0x100 - *th);
+    return true;
+  default:
+    value = *tl + n;
+    *tl = (BYTE) value;
+    return value > 0xFF;
+  }
 }
 
-// xch A,@R1
-void xch_C7(MCU* mcu)
+/*
+ * Counts left to overflow.
+ */
+static unsigned long long mcuTimerLeft(BYTE tl, BYTE th, BYTE mode)
 {
-  BYTE tempB;
-
-  tempB = *mcu->ACC;
-  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[1], false);
-  mcuSetIntRAM(mcu, mcu->R[1], false, tempB);
-  mcu->PC += 1;
+  switch (mode) {
+  case 0:
+    return 0x2000 - (th << 5 | (tl & 0x1F));
+  case 1:
+    return 0x10000 - (th << 8 | tl);
+  default:
+    return 0x100 - tl;
+  }
 }
 
-// xch A,R0
-void xch_C8(MCU* mcu)
-{
-  BYTE tempB;
+/*
+ * Count cycles since timerBase with saved configuration. Pin transitions
+ * are counted only when poll is set, that is after instruction.
+ */
+static void mcuSyncTimers(MCU* mcu, bool poll)
+{
+  unsigned long long elapsed = mcu->cycles - mcu->timerBase;
+  unsigned long long n;
+  BYTE tmod = mcu->timerTMOD;
+  BYTE tcon = mcu->timerTCON;
+  BYTE t2con = mcu->timerT2CON;
+  BYTE mode0 = tmod & 0x03;
+  BYTE mode1 = tmod >> 4 & 0x03;
+  BYTE falling = 0;
+  BYTE flags = (*mcu->TCON & 0xA0) | (*mcu->T2CON & 0xC0) >> 6;
+
+  mcu->timerBase = mcu->cycles;
+
+  if (poll) {
+    BYTE pins = TIMER_PINS(mcu);
+    falling = mcu->timerPins & ~pins;
+    mcu->timerPins = pins;
+  }
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[0];
-  mcu->R[0] = tempB;
-  mcu->PC += 1;
-}
+  // Timer 0.
+  if ((tcon & 0x10) && (!(tmod & 0x08) || (*mcu->P3 & 0x04))) {
+    n = tmod & 0x04 ? falling & 0x01 : elapsed;
+    if (n != 0 && mcuTimerAdd(mcu->TL0, mcu->TH0, mode0, n))
+      *mcu->TCON |= 0x20;
+  }
 
-// xch A,R1
-void xch_C9(MCU* mcu)
-{
-  BYTE tempB;
+  // TH0 in mode 3, runs with TR1 and sets TF1.
+  if (mode0 == 3 && (tcon & 0x40) && elapsed != 0 &&
+      mcuTimerAdd(mcu->TH0, NULL, 3, elapsed))
+    *mcu->TCON |= 0x80;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[1];
-  mcu->R[1] = tempB;
-  mcu->PC += 1;
-}
+  // Timer 1, it can't set TF1 when timer 0 is in mode 3.
+  if (mode1 != 3 && (tcon & 0x40) && (!(tmod & 0x80) || (*mcu->P3 & 0x08))) {
+    n = tmod & 0x40 ? falling >> 1 & 0x01 : elapsed;
+    if (n != 0 && mcuTimerAdd(mcu->TL1, mcu->TH1, mode1, n) && mode0 != 3)
+      *mcu->TCON |= 0x80;
+  }
 
-// xch A,R2
-void xch_CA(MCU* mcu)
-{
-  BYTE tempB;
+  // Timer 2. Baud rate generator counts every state.
+  if (t2con & 0x04) {
+    if (t2con & 0x02)
+      n = falling >> 2 & 0x01;
+    else
+      n = t2con & 0x30 ? elapsed * 6 : elapsed;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[2];
-  mcu->R[2] = tempB;
-  mcu->PC += 1;
-}
+    unsigned long long value = ((unsigned long long) *mcu->TH2 << 8 | *mcu->TL2) + n;
 
-// xch A,R3
-void xch_CB(MCU* mcu)
-{
-  BYTE tempB;
+    if (value > 0xFFFF) {
+      if (!(t2con & 0x30) && (t2con & 0x01)) { // capture
+        value &= 0xFFFF;
+      } else { // auto-reload and baud rate generator
+        WORD reload = (WORD) *mcu->RCAP2H << 8 | *mcu->RCAP2L;
+        value = reload + (value - 0x10000) % (0x10000 - reload);
+      }
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[3];
-  mcu->R[3] = tempB;
-  mcu->PC += 1;
-}
+      if (!(t2con & 0x30))
+        *mcu->T2CON |= 0x80;
+    }
 
-// xch A,R4
-void xch_CC(MCU* mcu)
-{
-  BYTE tempB;
+    *mcu->TH2 = (BYTE) (value >> 8);
+    *mcu->TL2 = (BYTE) value;
+  }
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[4];
-  mcu->R[4] = tempB;
-  mcu->PC += 1;
-}
+  // Falling edge on T2EX.
+  if ((t2con & 0x08) && (falling & 0x08)) {
+    if (!(t2con & 0x30)) {
+      if (t2con & 0x01) {
+        *mcu->RCAP2H = *mcu->TH2;
+        *mcu->RCAP2L = *mcu->TL2;
+      } else {
+        *mcu->TH2 = *mcu->RCAP2H;
+        *mcu->TL2 = *mcu->RCAP2L;
+      }
+    }
 
-// xch A,R5
-void xch_CD(MCU* mcu)
-{
-  BYTE tempB;
+    *mcu->T2CON |= 0x40;
+  }
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[5];
-  mcu->R[5] = tempB;
-  mcu->PC += 1;
+  // New interrupt requests.
+  if (flags != ((*mcu->TCON & 0xA0) | (*mcu->T2CON & 0xC0) >> 6))
+    mcu->pendingInterrupts |= INT_DIRTY;
 }
 
-// xch A,R6
-void xch_CE(MCU* mcu)
+/*
+ * Count up to now, take new configuration and find next overflow.
+ */
+static void mcuUpdateTimers(MCU* mcu, bool timer2)
 {
-  BYTE tempB;
+  unsigned long long left = TIMER_NEVER;
+  BYTE tmod, tcon, t2con, mode0, mode1;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[6];
-  mcu->R[6] = tempB;
-  mcu->PC += 1;
-}
+  mcuSyncTimers(mcu, true);
 
-// xch A,R7
-void xch_CF(MCU* mcu)
-{
-  BYTE tempB;
+  tmod = mcu->timerTMOD = *mcu->TMOD;
+  tcon = mcu->timerTCON = *mcu->TCON & 0xF0;
+  t2con = mcu->timerT2CON = timer2 ? *mcu->T2CON : 0;
+  mode0 = tmod & 0x03;
+  mode1 = tmod >> 4 & 0x03;
+  mcu->timersDirty = false;
 
-  tempB = *mcu->ACC;
-  *mcu->ACC = mcu->R[7];
-  mcu->R[7] = tempB;
-  mcu->PC += 1;
-}
+  // Gate and counters depend on pins, check them after every instruction.
+  if (((tcon & 0x10) && (tmod & 0x0C)) ||
+      ((tcon & 0x40) && mode1 != 3 && (tmod & 0xC0)) ||
+      (t2con & 0x08) || ((t2con & 0x06) == 0x06)) {
+    mcu->timerDeadline = 0;
+    return;
+  }
 
-// lcall 16bit_adres
-void lcall_12(MCU* mcu)
-{
-  WORD tempW;
+  /*
+   * Overflow matters only when it sets a cleared flag, reloads are done
+   * when counting anyway.
+   */
+  if ((tcon & 0x30) == 0x10)
+    left = mcuTimerLeft(*mcu->TL0, *mcu->TH0, mode0);
 
-  tempW = mcu->PC + 3;
-  mcu->PC += 1;
-  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC) << 8 | *mcuROM(mcu, mcu->PC + 1);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
-}
+  if (mode0 == 3 && (tcon & 0xC0) == 0x40 && mcuTimerLeft(*mcu->TH0, 0, 3) < left)
+    left = mcuTimerLeft(*mcu->TH0, 0, 3);
 
-// ret
-void ret_22(MCU* mcu)
-{
-  mcu->PC = (WORD) *mcuIntRAM(mcu, *mcu->SP, false) << 8 | (WORD) *mcuIntRAM(mcu,
-            *mcu->SP - 1, false);
-  *mcu->SP = *mcu->SP - 2;
-}
+  if (mode0 != 3 && mode1 != 3 && (tcon & 0xC0) == 0x40 &&
+      mcuTimerLeft(*mcu->TL1, *mcu->TH1, mode1) < left)
+    left = mcuTimerLeft(*mcu->TL1, *mcu->TH1, mode1);
 
-// jnz (offset)
-void jnz_70(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (*mcu->ACC != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  else
-    mcu->PC += 1;
-}
+  if ((t2con & 0xB4) == 0x04) {
+    unsigned long long t2 = 0x10000 - ((WORD) *mcu->TH2 << 8 | *mcu->TL2);
+    if (t2 < left)
+      left = t2;
+  }
 
-// jz (offset)
-void jz_60(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (*mcu->ACC == 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  else
-    mcu->PC += 1;
+  mcu->timerDeadline = left == TIMER_NEVER ? TIMER_NEVER : mcu->cycles + left;
 }
 
-// jc (offset)
-void jc_40(MCU* mcu)
+void syncTimersMCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY))
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  else
-    mcu->PC += 1;
+  mcuSyncTimers(mcu, false);
+
+  // Registers could be changed, find the next overflow again.
+  mcu->timersDirty = true;
 }
 
-// jnc (offset)
-void jnc_50(MCU* mcu)
+// SFR write hooks, old value is only needed by WDTRST
+static void mcuWritePSW(MCU* mcu, BYTE before)
 {
-  mcu->PC += 1;
-  if (!checkRegister(mcu, PSW_CY))
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  else
-    mcu->PC += 1;
+  (void)before;
+  mcu->R = &mcu->idata[*mcu->PSW & (PSW_RS1 | PSW_RS0) & 0xFF];
 }
 
-// swap A
-void swap_C4(MCU* mcu)
+static void mcuWriteACC(MCU* mcu, BYTE before)
 {
-  BYTE tempB;
+  (void)before;
+  mcu->parityACC = *mcu->ACC;
 
-  tempB = *mcu->ACC;
-  tempB = (tempB << 4) & 0xF0;
-  *mcu->ACC = (*mcu->ACC >> 4) & 0x0F;
-  *mcu->ACC = *mcu->ACC | tempB;
-  mcu->PC += 1;
+  if (mcu->lazyFlags)
+    mcu->lazyParity = true;
+  else if (mcuParity(mcu->parityACC))
+    *mcu->PSW |= PSW_P & 0xFF;
+  else
+    *mcu->PSW &= ~PSW_P & 0xFF;
 }
 
-// movc A,@DPTR+A
-void movc_93(MCU* mcu)
+static void mcuWriteSBUF(MCU* mcu, BYTE before)
 {
-  *mcu->ACC = *mcuROM(mcu, *mcu->ACC + *mcu->DPTR);
-  mcu->PC += 1;
+  (void)before;
+  mcu->OUTPUT = *mcu->SBUF;
 }
 
-// movc A,@mcu->PC+A
-void movc_83(MCU* mcu)
+static void mcuWritePCON(MCU* mcu, BYTE before)
 {
-  *mcu->ACC = *mcuROM(mcu, *mcu->ACC + mcu->PC);
-  mcu->PC += 1;
+  (void)before;
+  mcu->idle = (*mcu->PCON & PCON_IDL & 0xFF) != 0;
+  mcu->powerDown = (*mcu->PCON & PCON_PD & 0xFF) != 0;
 }
 
-// mov A,@R0
-void mov_E6(MCU* mcu)
+/*
+ * Call hooks which only follow value of SFR, after it was changed from
+ * outside of the simulator. SBUF and WDTRST react on writes, they are
+ * skipped.
+ */
+static void mcuRefreshSFR(MCU* mcu)
 {
-  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[0], false);
-  mcu->PC += 1;
-}
+  static const BYTE state[] = { 0xD0, 0xE0, 0x87, 0xA2 };
 
-// mov A,@R1
-void mov_E7(MCU* mcu)
-{
-  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[1], false);
-  mcu->PC += 1;
+  for (unsigned i = 0; i < sizeof(state); ++i)
+    if (mcu->_sfrWrite[state[i] - 0x80] != NULL)
+      mcu->_sfrWrite[state[i] - 0x80](mcu, mcu->sfr[state[i] - 0x80]);
 }
 
-// mov @R0,A
-void mov_F6(MCU* mcu)
+void syncMCU(MCU* mcu)
 {
-  mcuSetIntRAM(mcu, mcu->R[0], false, *mcu->ACC);
-  mcu->PC += 1;
-}
+  mcuRefreshSFR(mcu);
+  syncFlagsMCU(mcu);
+  syncTimersMCU(mcu);
 
-// mov @R1,a
-void mov_F7(MCU* mcu)
-{
-  mcuSetIntRAM(mcu, mcu->R[1], false, *mcu->ACC);
-  mcu->PC += 1;
+  // Flags and enable bits could be changed.
+  mcu->pendingInterrupts |= INT_DIRTY;
 }
 
-// mov R0,#(data)
-void mov_78(MCU* mcu)
+/*
+ * True when timerDeadline is valid for current configuration.
+ */
+static inline bool mcuTimersSettled(MCU* mcu, bool timer2)
 {
-  mcu->PC += 1;
-  mcu->R[0] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  return !mcu->timersDirty && *mcu->TMOD == mcu->timerTMOD &&
+         (*mcu->TCON & 0xF0) == mcu->timerTCON &&
+         (!timer2 || *mcu->T2CON == mcu->timerT2CON);
 }
 
-// mov R1,#(data)
-void mov_79(MCU* mcu)
+void timers8051(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[1] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  if (mcu->cycles < mcu->timerDeadline && mcuTimersSettled(mcu, false))
+    return;
 
-// mov R2,#(data)
-void mov_7A(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[2] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  mcuUpdateTimers(mcu, false);
 }
 
-// mov R3,#(data)
-void mov_7B(MCU* mcu)
+void timers8052(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[3] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  if (mcu->cycles < mcu->timerDeadline && mcuTimersSettled(mcu, true))
+    return;
 
-// mov R4,#(data)
-void mov_7C(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[4] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  mcuUpdateTimers(mcu, true);
 }
 
-// mov R5,#(data)
-void mov_7D(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[5] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+// Interrupts
 
-// mov R6,#(data)
-void mov_7E(MCU* mcu)
+/*
+ * Update IE0 and IE1 from INT0 and INT1 pins and find requesting sources.
+ */
+static void mcuPendingInterrupts(MCU* mcu, bool timer2)
 {
-  mcu->PC += 1;
-  mcu->R[6] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  BYTE pins = *mcu->P3 & 0x0C;
+  BYTE falling = mcu->interruptPins & ~pins;
+  BYTE requests = 0;
 
-// mov R7,#(data)
-void mov_7F(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[7] = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->interruptPins = pins;
 
-// mov R0,(adress)
-void mov_A8(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[0] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  // IT0/IT1 set - falling edge, otherwise IE0/IE1 follow low level.
+  if (*mcu->TCON & 0x01) {
+    if (falling & 0x04)
+      *mcu->TCON |= 0x02;
+  } else if (pins & 0x04)
+    *mcu->TCON &= ~0x02;
+  else
+    *mcu->TCON |= 0x02;
 
-// mov R1,(adress)
-void mov_A9(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[1] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  if (*mcu->TCON & 0x04) {
+    if (falling & 0x08)
+      *mcu->TCON |= 0x08;
+  } else if (pins & 0x08)
+    *mcu->TCON &= ~0x08;
+  else
+    *mcu->TCON |= 0x08;
 
-// mov R2,(adress)
-void mov_AA(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[2] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  if (*mcu->TCON & 0x02)
+    requests |= INT_IE0;
+  if (*mcu->TCON & 0x20)
+    requests |= INT_TF0;
+  if (*mcu->TCON & 0x08)
+    requests |= INT_IE1;
+  if (*mcu->TCON & 0x80)
+    requests |= INT_TF1;
+  if (*mcu->SCON & 0x03)
+    requests |= INT_SERIAL;
+  if (timer2 && (*mcu->T2CON & 0xC0))
+    requests |= INT_TIMER2;
 
-// mov R3,(adress)
-void mov_AB(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[3] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
+  mcu->pendingInterrupts = *mcu->IE & 0x80 ? requests & *mcu->IE : 0;
 }
 
-// mov R4,(adress)
-void mov_AC(MCU* mcu)
+/*
+ * Two priority levels. Interrupt is taken when no interrupt of the same or
+ * higher level is in service and not right after reti.
+ */
+static void mcuInterrupts(MCU* mcu, bool timer2)
 {
-  mcu->PC += 1;
-  mcu->R[4] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  static const WORD vectors[] = { 0x0003, 0x000B, 0x0013, 0x001B, 0x0023, 0x002B };
+  BYTE pending, source, level;
+  int n = 0;
 
-// mov R5,(adress)
-void mov_AD(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[5] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  if (mcu->pendingInterrupts & INT_DIRTY)
+    mcuPendingInterrupts(mcu, timer2);
 
-// mov R6,(adress)
-void mov_AE(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[6] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  if (mcu->pendingInterrupts == 0 || mcu->lastInstruction == 0x32)
+    return;
 
-// mov R7,(adress)
-void mov_AF(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[7] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
-}
+  pending = mcu->pendingInterrupts & *mcu->IP;
+  level = INT_HIGH;
 
-// mov (adress),R0
-void mov_88(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[0]);
-  mcu->PC += 1;
-}
+  if (pending == 0 || (mcu->interruptsInService & INT_HIGH)) {
+    pending = mcu->pendingInterrupts & ~*mcu->IP;
+    level = INT_LOW;
 
-// mov (adress),R1
-void mov_89(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[1]);
-  mcu->PC += 1;
-}
+    if (pending == 0 || mcu->interruptsInService != 0)
+      return;
+  }
 
-// mov (adress),R2
-void mov_8A(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[2]);
-  mcu->PC += 1;
-}
+  source = pending & -pending;
+  while (!(source & 1 << n))
+    n += 1;
 
-// mov (adress),R3
-void mov_8B(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[3]);
-  mcu->PC += 1;
-}
+  // Flags cleared by hardware.
+  if (source == INT_TF0)
+    *mcu->TCON &= ~0x20;
+  else if (source == INT_TF1)
+    *mcu->TCON &= ~0x80;
+  else if (source == INT_IE0 && (*mcu->TCON & 0x01))
+    *mcu->TCON &= ~0x02;
+  else if (source == INT_IE1 && (*mcu->TCON & 0x04))
+    *mcu->TCON &= ~0x08;
 
-// mov (adress),R4
-void mov_8C(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[4]);
-  mcu->PC += 1;
-}
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
+  mcu->PC = vectors[n];
 
-// mov (adress),R5
-void mov_8D(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[5]);
-  mcu->PC += 1;
-}
+  mcu->interruptsInService |= level;
+  mcu->pendingInterrupts |= INT_DIRTY;
 
-// mov (adress),R6
-void mov_8E(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[6]);
-  mcu->PC += 1;
+  // Interrupt ends idle mode.
+  if (mcu->idle) {
+    *mcu->PCON &= ~PCON_IDL & 0xFF;
+    mcu->idle = false;
+  }
 }
 
-// mov (adress),R7
-void mov_8F(MCU* mcu)
+void interrupts8051(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[7]);
-  mcu->PC += 1;
+  if (mcu->pendingInterrupts != 0)
+    mcuInterrupts(mcu, false);
 }
 
-// mov R0,A
-void mov_F8(MCU* mcu)
+void interrupts8052(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[0] = *mcu->ACC;
+  if (mcu->pendingInterrupts != 0)
+    mcuInterrupts(mcu, true);
 }
 
-// mov R1,A
-void mov_F9(MCU* mcu)
+void settleMCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[1] = *mcu->ACC;
-}
+  if (mcu->_timers != NULL)
+    mcu->_timers(mcu);
 
-// mov R2,A
-void mov_FA(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[2] = *mcu->ACC;
+  if (mcu->_interrupts != NULL && (mcu->pendingInterrupts & INT_DIRTY))
+    mcuPendingInterrupts(mcu, mcu->_timers == &timers8052);
 }
 
-// mov R3,A
-void mov_FB(MCU* mcu)
+// Additional Code
+void Mcu89S5x(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[3] = *mcu->ACC;
+  /*
+   * WDT
+   */
+  if (mcu->WDTEnable) {
+    mcu->WDTTimerValue += mcu->cycleCount[mcu->lastInstruction];
+    if (mcu->WDTTimerValue > 0x3FFF)
+      resetMCU(mcu);
+  }
 }
 
-// mov R4,A
-void mov_FC(MCU* mcu)
+/*
+ * Two DPTR
+ */
+static void mcuWriteAUXR1(MCU* mcu, BYTE before)
 {
-  mcu->PC += 1;
-  mcu->R[4] = *mcu->ACC;
-}
+  (void)before;
+  BYTE address = *mcu->AUXR1 & AUXR1_DPS & 0xFF ? 0x84 : 0x82;
 
-// mov R5,A
-void mov_FD(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[5] = *mcu->ACC;
+  mcu->DPTR = (WORD*)&mcu->sfr[address - 0x80];
+  mcu->DPL = &mcu->sfr[address - 0x80];
+  mcu->DPH = &mcu->sfr[address + 1 - 0x80];
 }
 
-// mov R6,A
-void mov_FE(MCU* mcu)
+/*
+ * WDT is started by writing 1Eh and E1h into WDTRST.
+ */
+static void mcuWriteWDTRST(MCU* mcu, BYTE before)
 {
-  mcu->PC += 1;
-  mcu->R[6] = *mcu->ACC;
+  if (before == 0x1E && *mcu->WDTRST == 0xE1) {
+    mcu->WDTEnable = true;
+    mcu->WDTTimerValue = 0;
+  }
 }
 
-// mov R7,A
-void mov_FF(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[7] = *mcu->ACC;
-}
+/*
+ * Execution cores, built from MCS51Core.h after the engine code.
+ */
+static const MCUCore core8051, core8051_fast, core8052, core8052_fast;
+static const MCUCore core89S51, core89S51_fast, core89S52, core89S52_fast;
 
-// mov A,R0
-void mov_E8(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[0];
-}
+/*
+ * SFR write hooks, shared by all instances of a variant.
+ */
+static void (* const sfrWrite8051[128])(MCU* mcu, BYTE before) = {
+  [0x87 - 0x80] = &mcuWritePCON,
+  [0x99 - 0x80] = &mcuWriteSBUF,
+  [0xD0 - 0x80] = &mcuWritePSW,
+  [0xE0 - 0x80] = &mcuWriteACC,
+};
 
-// mov A,R1
-void mov_E9(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[1];
-}
+static void (* const sfrWrite89S5x[128])(MCU* mcu, BYTE before) = {
+  [0x87 - 0x80] = &mcuWritePCON,
+  [0x99 - 0x80] = &mcuWriteSBUF,
+  [0xA2 - 0x80] = &mcuWriteAUXR1,
+  [0xA6 - 0x80] = &mcuWriteWDTRST,
+  [0xD0 - 0x80] = &mcuWritePSW,
+  [0xE0 - 0x80] = &mcuWriteACC,
+};
 
-// mov A,R2
-void mov_EA(MCU* mcu)
+unsigned randomMCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[2];
+  // xorshift32, state is never 0
+  mcu->randomState = mcuXorshift(mcu->randomState);
+  return mcu->randomState;
 }
 
-// mov A,R3
-void mov_EB(MCU* mcu)
+void seedMCU(MCU* mcu, unsigned seed)
 {
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[3];
+  mcu->randomState = seed ? seed : MCU_DEFAULT_SEED;
+  poisonMCU(mcu, POISON_RANDOM, mcu->randomState);
 }
 
-// mov A,R4
-void mov_EC(MCU* mcu)
+void poisonMCU(MCU* mcu, MCUPoison policy, unsigned value)
 {
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[4];
-}
+  mcu->poison = policy;
+  mcu->poisonValue = value;
 
-// mov A,R5
-void mov_ED(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[5];
-}
+  mcuPoisonPage(mcu, 256, mcu->idata);
 
-// mov A,R6
-void mov_EE(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[6];
-}
+  for (unsigned page = 0; page < 256; ++page) {
+    mcuReleasePage(mcu->xdata[page]);
+    mcu->xdata[page] = NULL;
+  }
 
-// mov A,R7
-void mov_EF(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = mcu->R[7];
+  for (unsigned page = 0; page < 256; ++page)
+    mcuMapExtRAMPage(mcu, page);
 }
 
-// clr A
-void clr_E4(MCU* mcu)
+void init8051MCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  *mcu->ACC = 0;
-}
+  mcu->mcuType = M_8052;
+  mcu->oscillator = 11059200;
 
-// ajmp 00xx
-void ajmp_01(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC);
-}
+  // Pages are allocated on first write.
+  memset(mcu->xdata, 0, sizeof(mcu->xdata));
+  memset(mcu->irom, 0, sizeof(mcu->irom));
+  memset(mcu->xrom, 0, sizeof(mcu->xrom));
 
-// ajmp 01xx
-void ajmp_21(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0100 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->idataMemorySize = 0x80;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0x1000;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
 
-// ajmp 02xx
-void ajmp_41(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0200 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->EA = 1;
 
-// ajmp 03xx
-void ajmp_61(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0300 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->EAconnect = 0;
+
+  mcu->devices = NULL;
+  mcu->numOfDevices = 0;
+
+  mcu->decoded = NULL;
+  mcu->decodedSize = 0;
+  mcu->decodedValid = false;
+  mcu->decodedCore = NULL;
+  mcu->usePredecoded = false;
+  mcu->codeVersion = 0;
+  mcu->useBlocks = false;
+  mcu->hotBlockThreshold = 16;
+  mcu->coverage = NULL;
+  mcu->module = NULL;
+  mcu->lazyFlags = false;
+  mcu->lazyOp = LAZY_NONE;
+  mcu->lazyParity = false;
 
-// ajmp 04xx
-void ajmp_81(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0400 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->autoRead = true;
+  mcu->autoWrite = true;
 
-// ajmp 05xx
-void ajmp_A1(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0500 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->PCBreakpoints = NULL;
+  mcu->accessIntRAMPauses = NULL;
+  mcu->accessExtRAMPauses = NULL;
+  mcu->accessIntROMPauses = NULL;
+  mcu->accessExtROMPauses = NULL;
+  mcu->accessSFRPauses = NULL;
+  mcu->intRAMPauses = NULL;
+  mcu->extRAMPauses = NULL;
+  mcu->SFRPauses = NULL;
 
-// ajmp 06xx
-void ajmp_C1(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0600 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->numOfPCBreakpoints = 0;
+  mcu->numOfaccessIntRAMPauses = 0;
+  mcu->numOfAccessExtRAMPauses = 0;
+  mcu->numOfAccessIntROMPauses = 0;
+  mcu->numOfAccessExtROMPauses = 0;
+  mcu->numOfAccessSFRPauses = 0;
+  mcu->numOfIntRAMPauses = 0;
+  mcu->numOfExtRAMPauses = 0;
+  mcu->numOfSFRPauses = 0;
 
-// ajmp 07xx
-void ajmp_E1(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->PC = 0x0700 | (WORD) *mcuROM(mcu, mcu->PC);
-}
+  mcu->P0 = &mcu->sfr[0x80 - 0x80];
+  mcu->SP = &mcu->sfr[0x81 - 0x80];
+  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
+  mcu->DPL = &mcu->sfr[0x82 - 0x80];
+  mcu->DPH = &mcu->sfr[0x83 - 0x80];
+  mcu->PCON = &mcu->sfr[0x87 - 0x80];
+  mcu->TCON = &mcu->sfr[0x88 - 0x80];
+  mcu->TMOD = &mcu->sfr[0x89 - 0x80];
+  mcu->TL0 = &mcu->sfr[0x8A - 0x80];
+  mcu->TL1 = &mcu->sfr[0x8B - 0x80];
+  mcu->TH0 = &mcu->sfr[0x8C - 0x80];
+  mcu->TH1 = &mcu->sfr[0x8D - 0x80];
+  mcu->P1 = &mcu->sfr[0x90 - 0x80];
+  mcu->SCON = &mcu->sfr[0x98 - 0x80];
+  mcu->SBUF = &mcu->sfr[0x99 - 0x80];
+  mcu->P2 = &mcu->sfr[0xA0 - 0x80];
+  mcu->IE = &mcu->sfr[0xA8 - 0x80];
+  mcu->P3 = &mcu->sfr[0xB0 - 0x80];
+  mcu->IP = &mcu->sfr[0xB8 - 0x80];
+  mcu->T2CON = &mcu->sfr[0xC8 - 0x80];
+  mcu->RCAP2L = &mcu->sfr[0xCA - 0x80];
+  mcu->RCAP2H = &mcu->sfr[0xCB - 0x80];
+  mcu->TL2 = &mcu->sfr[0xCC - 0x80];
+  mcu->TH2 = &mcu->sfr[0xCD - 0x80];
+  mcu->PSW = &mcu->sfr[0xD0 - 0x80];
+  mcu->ACC = &mcu->sfr[0xE0 - 0x80];
+  mcu->B = &mcu->sfr[0xF0 - 0x80];
+  mcu->R = &mcu->idata[0];
 
-// acall 00xx
-void acall_11(MCU* mcu)
-{
-  WORD tempW;
+  mcu->cycleCount = CYCLE_COUNT;
+  mcu->byteCount = BYTE_COUNT;
+  mcu->mnemonicTable = MNEMONIC_TABLE;
+  mcu->mnemonicParams = MNEMONIC_PARAMS;
+  mcu->SFRNames = SFR_NAMES;
+  mcu->SFRBits = SFR_BITS;
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
-}
+  mcu->_instructions = instructions;
+  mcu->_sfrWrite = sfrWrite8051;
 
-// acall 01xx
-void acall_31(MCU* mcu)
-{
-  WORD tempW;
+  mcu->_timers = &timers8051;
+  mcu->_interrupts = &interrupts8051;
+  mcu->_additionalCode = NULL;
+  mcu->_cores[0] = &core8051;
+  mcu->_cores[1] = &core8051_fast;
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0100 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+  // Memory map is made here too, memory is poisoned when it is touched.
+  seedMCU(mcu, MCU_DEFAULT_SEED);
+  mapMemoryMCU(mcu);
+  resetMCU(mcu);
 }
 
-// acall 02xx
-void acall_51(MCU* mcu)
+void init8031MCU(MCU* mcu)
 {
-  WORD tempW;
+  init8051MCU(mcu);
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0200 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+  mcu->idataMemorySize = 0x100;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
+
+  mapMemoryMCU(mcu);
 }
 
-// acall 03xx
-void acall_71(MCU* mcu)
+void init8052MCU(MCU* mcu)
 {
-  WORD tempW;
+  init8051MCU(mcu);
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0300 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
-}
+  mcu->idataMemorySize = 0x100;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0x2000;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
 
-// acall 04xx
-void acall_91(MCU* mcu)
-{
-  WORD tempW;
+  mcu->_timers = &timers8052;
+  mcu->_interrupts = &interrupts8052;
+  mcu->_additionalCode = NULL;
+  mcu->_cores[0] = &core8052;
+  mcu->_cores[1] = &core8052_fast;
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0400 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+  mapMemoryMCU(mcu);
 }
 
-// acall 05xx
-void acall_B1(MCU* mcu)
+void init8032MCU(MCU* mcu)
 {
-  WORD tempW;
+  init8052MCU(mcu);
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0500 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+  mcu->idataMemorySize = 0x100;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
+
+  mapMemoryMCU(mcu);
 }
 
-// acall 06xx
-void acall_D1(MCU* mcu)
+void init89S51MCU(MCU* mcu)
 {
-  WORD tempW;
+  init8051MCU(mcu);
+  mcu->WDTEnable = false;
+  mcu->WDTTimerValue = 0;
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0600 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
-}
+  mcu->idataMemorySize = 0x100;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0x1000;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
 
-// acall 07xx
-void acall_F1(MCU* mcu)
-{
-  WORD tempW;
+  mcu->DP1H = &mcu->sfr[0x85 - 0x80];
+  mcu->DP1L = &mcu->sfr[0x84 - 0x80];
+  mcu->DP0H = &mcu->sfr[0x83 - 0x80];
+  mcu->DP0L = &mcu->sfr[0x82 - 0x80];
+  mcu->WDTRST = &mcu->sfr[0xA6 - 0x80];
+  mcu->AUXR1 = &mcu->sfr[0xA2 - 0x80];
+  mcu->AUXR = &mcu->sfr[0x8E - 0x80];
+  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
 
-  tempW = mcu->PC + 2;
-  mcu->PC += 1;
-  mcu->PC = 0x0700 | *mcuROM(mcu, mcu->PC);
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
-  *mcu->SP += 1;
-  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
-}
+  mcu->_additionalCode = &Mcu89S5x;
+  mcu->_cores[0] = &core89S51;
+  mcu->_cores[1] = &core89S51_fast;
+  mcu->_sfrWrite = sfrWrite89S5x;
 
-// djnz R0,(offset)
-void djnz_D8(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[0]--;
-  if (mcu->R[0] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  mapMemoryMCU(mcu);
 }
 
-// djnz R1,(offset)
-void djnz_D9(MCU* mcu)
+void init89S52MCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[1]--;
-  if (mcu->R[1] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  init8052MCU(mcu);
+  mcu->WDTEnable = false;
+  mcu->WDTTimerValue = 0;
 
-// djnz R2,(offset)
-void djnz_DA(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[2]--;
-  if (mcu->R[2] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->idataMemorySize = 0x100;
+  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
+  mcu->iromMemorySize = 0x2000;
+  mcu->xromMemorySize = MAX_ROM_SIZE;
 
-// djnz R3,(offset)
-void djnz_DB(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[3]--;
-  if (mcu->R[3] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->DP1H = &mcu->sfr[0x85 - 0x80];
+  mcu->DP1L = &mcu->sfr[0x84 - 0x80];
+  mcu->DP0H = &mcu->sfr[0x83 - 0x80];
+  mcu->DP0L = &mcu->sfr[0x82 - 0x80];
+  mcu->WDTRST = &mcu->sfr[0xA6 - 0x80];
+  mcu->AUXR1 = &mcu->sfr[0xA2 - 0x80];
+  mcu->AUXR = &mcu->sfr[0x8E - 0x80];
+  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
 
-// djnz R4,(offset)
-void djnz_DC(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[4]--;
-  if (mcu->R[4] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->_additionalCode = &Mcu89S5x;
+  mcu->_cores[0] = &core89S52;
+  mcu->_cores[1] = &core89S52_fast;
+  mcu->_sfrWrite = sfrWrite89S5x;
+
+  mapMemoryMCU(mcu);
+}
+
+bool initNamedMCU(MCU* mcu, const char* type)
+{
+  if (0 == strcmp(type, "8031"))
+    init8031MCU(mcu);
+  else if (0 == strcmp(type, "8032"))
+    init8032MCU(mcu);
+  else if (0 == strcmp(type, "8051"))
+    init8051MCU(mcu);
+  else if (0 == strcmp(type, "8052"))
+    init8052MCU(mcu);
+  else if (0 == strcmp(type, "89S51"))
+    init89S51MCU(mcu);
+  else if (0 == strcmp(type, "89S52"))
+    init89S52MCU(mcu);
+  else
+    return false;
 
-// djnz R5,(offset)
-void djnz_DD(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[5]--;
-  if (mcu->R[5] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  return true;
 }
 
-// djnz R6,(offset)
-void djnz_DE(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcu->R[6]--;
-  if (mcu->R[6] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+/*
+ * SFR after reset, restored by one copy.
+ */
+static const BYTE mcuResetSFR[SFR_SIZE] = {
+  [0x80 - 0x80] = 0xFF, // P0
+  [0x81 - 0x80] = 0x07, // SP
+  [0x90 - 0x80] = 0xFF, // P1
+  [0xA0 - 0x80] = 0xFF, // P2
+  [0xB0 - 0x80] = 0xFF, // P3
+};
 
-// djnz R7,(offset)
-void djnz_DF(MCU* mcu)
+void resetMCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcu->R[7]--;
-  if (mcu->R[7] != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->PC = 0;
+  mcu->cycles = 0;
+  mcu->instructions = 0;
 
-// djnz (adress),(offset)
-void djnz_D5(MCU* mcu)
-{
-  BYTE tempB;
+  mcu->OUTPUT = -1;
+  mcu->INPUT = -1;
 
-  mcu->PC += 1;
-  tempB = *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-  (*mcuIntRAM(mcu, tempB, true))--;
-  if (*mcuIntRAM(mcu, tempB, true) != 0)
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
-}
+  mcu->maxValueOfStackPointer = 0x07;
+  mcu->minIntRamAddress = -1;
+  mcu->maxIntRamAddress = -1;
+  mcu->minExtRamAddress = -1;
+  mcu->maxExtRamAddress = -1;
+  mcu->maxIntRomAddress = 0;
+  mcu->maxExtRomAddress = 0;
 
-// orl (adress),#(data)
-void orl_43(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true) | *mcuROM(mcu, mcu->PC + 1));
-  mcu->PC += 2;
-}
+  memcpy(mcu->sfr, mcuResetSFR, SFR_SIZE);
+  mcu->lazyOp = LAZY_NONE;
+  mcu->lazyParity = false;
+  mcu->timerBase = 0;
+  mcu->timerDeadline = 0;
+  mcu->timersDirty = true;
+  mcu->timerTMOD = 0;
+  mcu->timerTCON = 0;
+  mcu->timerT2CON = 0;
+  mcu->timerPins = 0xFF;
+  mcu->pendingInterrupts = INT_DIRTY;
+  mcu->interruptsInService = 0;
+  mcu->interruptPins = 0x0C;
+  mcu->parityACC = 0;
+  mcu->idle = false;
+  mcu->powerDown = false;
 
-// orl A,#(data)
-void orl_44(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = *mcuROM(mcu, mcu->PC) | *mcu->ACC;
-  mcu->PC += 1;
-}
+  mcu->accessedSFR = -1;
+  mcu->accessedIntRAM = -1;
+  mcu->accessedExtRAM = -1;
+  mcu->accessedIntROM = -1;
+  mcu->accessedExtROM = -1;
+  mcu->changedSFR = 0x80;
+  mcu->changedIntRAM = 0;
+  mcu->changedExtRAM = 0;
+  mcu->_writtenSFR = -1;
 
-// orl A,(adress)
-void orl_45(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) | *mcu->ACC;
-  mcu->PC += 1;
+  mcuRefreshSFR(mcu);
 }
 
-// orl (adress),A
-void orl_42(MCU* mcu)
+void removeMCU(MCU* mcu)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true) | *mcu->ACC);
-  mcu->PC += 1;
-}
+  clearAllBreakpointsAndPauses(mcu);
 
-// orl A,R0
-void orl_48(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[0];
-  mcu->PC += 1;
+  free(mcu->devices);
+  mcu->devices = NULL;
+  mcu->numOfDevices = 0;
+
+  free(mcu->decoded);
+  mcu->decoded = NULL;
+  mcu->decodedValid = false;
+
+  for (unsigned page = 0; page < 256; ++page) {
+    mcuReleasePage(mcu->xdata[page]);
+    mcuReleasePage(mcu->irom[page]);
+    mcuReleasePage(mcu->xrom[page]);
+    mcu->xdata[page] = NULL;
+    mcu->irom[page] = NULL;
+    mcu->xrom[page] = NULL;
+  }
 }
 
-// orl A,R1
-void orl_49(MCU* mcu)
+static void* mcuCopyArray(const void* from, size_t size)
 {
-  *mcu->ACC = *mcu->ACC | mcu->R[1];
-  mcu->PC += 1;
-}
+  void* copy;
 
-// orl A,R2
-void orl_4A(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[2];
-  mcu->PC += 1;
-}
+  if (from == NULL || size == 0)
+    return NULL;
 
-// orl A,R3
-void orl_4B(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[3];
-  mcu->PC += 1;
+  copy = malloc(size);
+  memcpy(copy, from, size);
+  return copy;
 }
 
-// orl A,R4
-void orl_4C(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[4];
-  mcu->PC += 1;
-}
+#define RELOCATE(ptr, from, to) ((ptr) == NULL ? NULL : (to) + ((ptr) - (from)))
 
-// orl A,R5
-void orl_4D(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[5];
-  mcu->PC += 1;
-}
+/*
+ * Points registers of dst, struct copy of src, to its own idata and sfr.
+ */
+static void mcuRelocate(MCU* dst, MCU* src)
+{
+  dst->R = RELOCATE(src->R, src->idata, dst->idata);
+  dst->DPTR = (WORD*) RELOCATE((BYTE*) src->DPTR, src->sfr, dst->sfr);
+  dst->ACC = RELOCATE(src->ACC, src->sfr, dst->sfr);
+  dst->PSW = RELOCATE(src->PSW, src->sfr, dst->sfr);
+  dst->SP = RELOCATE(src->SP, src->sfr, dst->sfr);
+  dst->DPL = RELOCATE(src->DPL, src->sfr, dst->sfr);
+  dst->DPH = RELOCATE(src->DPH, src->sfr, dst->sfr);
+  dst->B = RELOCATE(src->B, src->sfr, dst->sfr);
+  dst->P0 = RELOCATE(src->P0, src->sfr, dst->sfr);
+  dst->DP0L = RELOCATE(src->DP0L, src->sfr, dst->sfr);
+  dst->DP0H = RELOCATE(src->DP0H, src->sfr, dst->sfr);
+  dst->DP1L = RELOCATE(src->DP1L, src->sfr, dst->sfr);
+  dst->DP1H = RELOCATE(src->DP1H, src->sfr, dst->sfr);
+  dst->PCON = RELOCATE(src->PCON, src->sfr, dst->sfr);
+  dst->TCON = RELOCATE(src->TCON, src->sfr, dst->sfr);
+  dst->TMOD = RELOCATE(src->TMOD, src->sfr, dst->sfr);
+  dst->TL0 = RELOCATE(src->TL0, src->sfr, dst->sfr);
+  dst->TL1 = RELOCATE(src->TL1, src->sfr, dst->sfr);
+  dst->TH0 = RELOCATE(src->TH0, src->sfr, dst->sfr);
+  dst->TH1 = RELOCATE(src->TH1, src->sfr, dst->sfr);
+  dst->AUXR = RELOCATE(src->AUXR, src->sfr, dst->sfr);
+  dst->WDTRST = RELOCATE(src->WDTRST, src->sfr, dst->sfr);
+  dst->P1 = RELOCATE(src->P1, src->sfr, dst->sfr);
+  dst->SCON = RELOCATE(src->SCON, src->sfr, dst->sfr);
+  dst->SBUF = RELOCATE(src->SBUF, src->sfr, dst->sfr);
+  dst->AUXR1 = RELOCATE(src->AUXR1, src->sfr, dst->sfr);
+  dst->P2 = RELOCATE(src->P2, src->sfr, dst->sfr);
+  dst->IE = RELOCATE(src->IE, src->sfr, dst->sfr);
+  dst->P3 = RELOCATE(src->P3, src->sfr, dst->sfr);
+  dst->IP = RELOCATE(src->IP, src->sfr, dst->sfr);
+  dst->T2CON = RELOCATE(src->T2CON, src->sfr, dst->sfr);
+  dst->RCAP2L = RELOCATE(src->RCAP2L, src->sfr, dst->sfr);
+  dst->RCAP2H = RELOCATE(src->RCAP2H, src->sfr, dst->sfr);
+  dst->TL2 = RELOCATE(src->TL2, src->sfr, dst->sfr);
+  dst->TH2 = RELOCATE(src->TH2, src->sfr, dst->sfr);
+}
+
+static void mcuCopy(MCU* dst, MCU* src, bool decoded)
+{
+  *dst = *src;
+
+  for (unsigned page = 0; page < 256; ++page) {
+    mcuSharePage(src->xdata[page]);
+    mcuSharePage(src->irom[page]);
+    mcuSharePage(src->xrom[page]);
+  }
 
-// orl A,R6
-void orl_4E(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[6];
-  mcu->PC += 1;
-}
+  // Writes of both to their pages have to copy them now.
+  for (unsigned page = 0; page < 256; ++page) {
+    if (!(src->xdataPageFlags[page] & PAGE_COPY))
+      src->xdataPageFlags[page] |= PAGE_COPY;
+    dst->xdataPageFlags[page] |= PAGE_COPY;
+  }
 
-// orl A,R7
-void orl_4F(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | mcu->R[7];
-  mcu->PC += 1;
-}
+  mcuRelocate(dst, src);
 
-// orl A,@R0
-void orl_46(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | *mcuIntRAM(mcu, mcu->R[0], false);
-  mcu->PC += 1;
-}
+  dst->devices = mcuCopyArray(src->devices, src->numOfDevices * sizeof(MCUDevice));
+  dst->coverage = NULL;
+  dst->module = NULL;
+  if (decoded) {
+    dst->decoded = mcuCopyArray(src->decoded, src->decodedSize * sizeof(MCUDecoded));
+  } else {
+    dst->decoded = NULL;
+    dst->decodedSize = 0;
+    dst->decodedValid = false;
+  }
 
-// orl A,@R1
-void orl_47(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC | *mcuIntRAM(mcu, mcu->R[1], false);
-  mcu->PC += 1;
-}
+  dst->PCBreakpoints = mcuCopyArray(src->PCBreakpoints,
+                                    src->numOfPCBreakpoints * sizeof(WORD));
+  dst->accessIntRAMPauses = mcuCopyArray(src->accessIntRAMPauses,
+                                         src->numOfaccessIntRAMPauses * sizeof(WORD));
+  dst->accessExtRAMPauses = mcuCopyArray(src->accessExtRAMPauses,
+                                         src->numOfAccessExtRAMPauses * sizeof(WORD));
+  dst->accessIntROMPauses = mcuCopyArray(src->accessIntROMPauses,
+                                         src->numOfAccessIntROMPauses * sizeof(WORD));
+  dst->accessExtROMPauses = mcuCopyArray(src->accessExtROMPauses,
+                                         src->numOfAccessExtROMPauses * sizeof(WORD));
+  dst->accessSFRPauses = mcuCopyArray(src->accessSFRPauses,
+                                      src->numOfAccessSFRPauses * sizeof(WORD));
+  dst->intRAMPauses = mcuCopyArray(src->intRAMPauses,
+                                   src->numOfIntRAMPauses * sizeof(MCUConditionBreakpoint));
+  dst->extRAMPauses = mcuCopyArray(src->extRAMPauses,
+                                   src->numOfExtRAMPauses * sizeof(MCUConditionBreakpoint));
+  dst->SFRPauses = mcuCopyArray(src->SFRPauses,
+                                src->numOfSFRPauses * sizeof(MCUConditionBreakpoint));
 
-// anl A,#(data)
-void anl_54(MCU* mcu)
-{
-  mcu->PC += 1;
-  *mcu->ACC = *mcu->ACC & *mcuROM(mcu, mcu->PC);
-  mcu->PC += 1;
+  // Page tables point to the same pages, they and decoded image stay valid.
 }
 
-// anl A,(adress)
-void anl_55(MCU* mcu)
+void viewMCU(MCU* view, MCU* mcu)
 {
-  mcu->PC += 1;
-  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) & *mcu->ACC;
-  mcu->PC += 1;
+  *view = *mcu;
+  mcuRelocate(view, mcu);
+  syncMCU(view);
 }
 
-// anl (adress),A
-void anl_52(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true) & *mcu->ACC);
-  mcu->PC += 1;
-}
+#undef RELOCATE
 
-// anl (adress),#(data)
-void anl_53(MCU* mcu)
+void cloneMCU(MCU* dst, MCU* src)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
-               *mcuROM(mcu, mcu->PC), true) & *mcuROM(mcu, mcu->PC + 1));
-  mcu->PC += 2;
+  mcuCopy(dst, src, true);
 }
 
-// anl A,R0
-void anl_58(MCU* mcu)
+/*
+ * Decoded image of a is valid for b too.
+ */
+static bool mcuSameCode(const MCU* a, const MCU* b)
 {
-  *mcu->ACC = *mcu->ACC & mcu->R[0];
-  mcu->PC += 1;
+  return a->iromMemorySize == b->iromMemorySize &&
+         a->xromMemorySize == b->xromMemorySize &&
+         a->EA == b->EA &&
+         a->EAconnect == b->EAconnect &&
+         a->numOfDevices == b->numOfDevices &&
+         0 == memcmp(a->irom, b->irom, sizeof(a->irom)) &&
+         0 == memcmp(a->xrom, b->xrom, sizeof(a->xrom)) &&
+         (a->numOfDevices == 0 ||
+          0 == memcmp(a->devices, b->devices, a->numOfDevices * sizeof(MCUDevice)));
 }
 
-// anl A,R1
-void anl_59(MCU* mcu)
+void snapshotMCU(MCU* snapshot, MCU* mcu)
 {
-  *mcu->ACC = *mcu->ACC & mcu->R[1];
-  mcu->PC += 1;
+  // Pending flags and timers are stored in SFR.
+  syncMCU(mcu);
+  mcuCopy(snapshot, mcu, false);
 }
 
-// anl A,R2
-void anl_5A(MCU* mcu)
+void restoreMCU(MCU* mcu, MCU* snapshot)
 {
-  *mcu->ACC = *mcu->ACC & mcu->R[2];
-  mcu->PC += 1;
-}
+  MCU settings = *mcu;
+  bool sameCode = mcuSameCode(mcu, snapshot);
 
-// anl A,R3
-void anl_5B(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC & mcu->R[3];
-  mcu->PC += 1;
-}
+  // Decoded image isn't freed, it is used again.
+  mcu->decoded = NULL;
+  removeMCU(mcu);
+  mcuCopy(mcu, snapshot, false);
 
-// anl A,R4
-void anl_5C(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC & mcu->R[4];
-  mcu->PC += 1;
-}
+  mcu->noDebug = settings.noDebug;
+  mcu->usePredecoded = settings.usePredecoded;
+  mcu->useBlocks = settings.useBlocks;
+  mcu->hotBlockThreshold = settings.hotBlockThreshold;
+  mcu->lazyFlags = settings.lazyFlags;
+  mcu->coverage = settings.coverage;
+  mcu->module = settings.module;
 
-// anl A,R5
-void anl_5D(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC & mcu->R[5];
-  mcu->PC += 1;
-}
+  mcu->decoded = settings.decoded;
+  mcu->decodedSize = settings.decodedSize;
+  mcu->decodedCore = settings.decodedCore;
+  mcu->decodedValid = sameCode && settings.decodedValid;
 
-// anl A,R6
-void anl_5E(MCU* mcu)
-{
-  *mcu->ACC = *mcu->ACC & mcu->R[6];
-  mcu->PC += 1;
+  // Never goes back, so version seen before doesn't come with other code.
+  mcu->codeVersion = settings.codeVersion + !sameCode;
 }
 
-// anl A,R7
-void anl_5F(MCU* mcu)
+static void mcuMoveBreakpoints(MCU* dst, MCU* src)
 {
-  *mcu->ACC = *mcu->ACC & mcu->R[7];
-  mcu->PC += 1;
+  dst->PCBreakpoints = src->PCBreakpoints;
+  dst->accessIntRAMPauses = src->accessIntRAMPauses;
+  dst->accessExtRAMPauses = src->accessExtRAMPauses;
+  dst->accessIntROMPauses = src->accessIntROMPauses;
+  dst->accessExtROMPauses = src->accessExtROMPauses;
+  dst->accessSFRPauses = src->accessSFRPauses;
+  dst->intRAMPauses = src->intRAMPauses;
+  dst->extRAMPauses = src->extRAMPauses;
+  dst->SFRPauses = src->SFRPauses;
+
+  dst->numOfPCBreakpoints = src->numOfPCBreakpoints;
+  dst->numOfaccessIntRAMPauses = src->numOfaccessIntRAMPauses;
+  dst->numOfAccessExtRAMPauses = src->numOfAccessExtRAMPauses;
+  dst->numOfAccessIntROMPauses = src->numOfAccessIntROMPauses;
+  dst->numOfAccessExtROMPauses = src->numOfAccessExtROMPauses;
+  dst->numOfAccessSFRPauses = src->numOfAccessSFRPauses;
+  dst->numOfIntRAMPauses = src->numOfIntRAMPauses;
+  dst->numOfExtRAMPauses = src->numOfExtRAMPauses;
+  dst->numOfSFRPauses = src->numOfSFRPauses;
 }
 
-// anl A,@R0
-void anl_56(MCU* mcu)
+void rewindMCU(MCU* mcu, MCU* snapshot)
 {
-  *mcu->ACC = *mcu->ACC & *mcuIntRAM(mcu, mcu->R[0], false);
-  mcu->PC += 1;
+  MCU breakpoints;
+
+  // Arrays of mcu are given back after restore.
+  mcuMoveBreakpoints(&breakpoints, mcu);
+  mcu->PCBreakpoints = NULL;
+  mcu->accessIntRAMPauses = NULL;
+  mcu->accessExtRAMPauses = NULL;
+  mcu->accessIntROMPauses = NULL;
+  mcu->accessExtROMPauses = NULL;
+  mcu->accessSFRPauses = NULL;
+  mcu->intRAMPauses = NULL;
+  mcu->extRAMPauses = NULL;
+  mcu->SFRPauses = NULL;
+
+  restoreMCU(mcu, snapshot);
+
+  clearAllBreakpointsAndPauses(mcu);
+  mcuMoveBreakpoints(mcu, &breakpoints);
 }
 
-// anl A,@R1
-void anl_57(MCU* mcu)
+static bool mcuSamePages(const MCU* a, const MCU* b, MemoryType type)
 {
-  *mcu->ACC = *mcu->ACC & *mcuIntRAM(mcu, mcu->R[1], false);
-  mcu->PC += 1;
+  MCUPage** pagesA = mcuPages(a, type);
+  MCUPage** pagesB = mcuPages(b, type);
+  BYTE bufferA[256], bufferB[256];
+  bool samePoison = type != XDATA ||
+                    (a->poison == b->poison && a->poisonValue == b->poisonValue);
+
+  for (unsigned page = 0; page < 256; ++page) {
+    if ((pagesA[page] != pagesB[page] || (pagesA[page] == NULL && !samePoison)) &&
+        0 != memcmp(mcuPageContents(a, type, page, bufferA),
+                    mcuPageContents(b, type, page, bufferB), 256))
+      return false;
+  }
+
+  return true;
 }
 
-// mov C,(bit)
-void mov_A2(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+/*
+ * SFR kept by lanes, see sameSharedStateMCU().
+ */
+static inline bool mcuLaneSFR(BYTE address)
+{
+  switch (address) {
+  case 0x81: // SP
+  case 0x82: // DPL
+  case 0x83: // DPH
+  case 0x99: // SBUF
+  case 0xD0: // PSW
+  case 0xE0: // ACC
+  case 0xF0: // B
+    return true;
+  }
+
+  return false;
 }
 
-// cpl (bit)
-void cpl_B2(MCU* mcu)
+static bool mcuSameSFR(const MCU* a, const MCU* b, bool lanes)
 {
-  mcu->PC += 1;
-  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
-  else
-    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
+  if (!lanes)
+    return 0 == memcmp(a->sfr, b->sfr, SFR_SIZE);
+
+  for (unsigned i = 0; i < SFR_SIZE; ++i) {
+    if (a->sfr[i] != b->sfr[i] && !mcuLaneSFR(i + 0x80))
+      return false;
+  }
+
+  return true;
 }
 
-// cpl C
-void cpl_B3(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY))
-    setRegister(mcu, PSW_CY, false);
-  else
-    setRegister(mcu, PSW_CY, true);
+static bool mcuSameState(MCU* a, MCU* b, bool lanes)
+{
+  // Compared in synced views, syncing a or b would hide lazy state from
+  // the engine running them (see Lockstep.h).
+  MCU viewA, viewB;
+
+  viewMCU(&viewA, a);
+  viewMCU(&viewB, b);
+  a = &viewA;
+  b = &viewB;
+
+  return a->PC == b->PC &&
+         a->cycles == b->cycles &&
+         a->instructions == b->instructions &&
+         a->mcuType == b->mcuType &&
+         a->oscillator == b->oscillator &&
+         a->idle == b->idle &&
+         a->powerDown == b->powerDown &&
+         a->errid == b->errid &&
+         (lanes || a->parityACC == b->parityACC) &&
+         a->pendingInterrupts == b->pendingInterrupts &&
+         a->interruptsInService == b->interruptsInService &&
+         a->interruptPins == b->interruptPins &&
+         a->timerTMOD == b->timerTMOD &&
+         a->timerTCON == b->timerTCON &&
+         a->timerT2CON == b->timerT2CON &&
+         a->timerPins == b->timerPins &&
+         a->OUTPUT == b->OUTPUT &&
+         a->INPUT == b->INPUT &&
+         a->WDTEnable == b->WDTEnable &&
+         a->WDTTimerValue == b->WDTTimerValue &&
+         a->EA == b->EA &&
+         a->EAconnect == b->EAconnect &&
+         a->autoRead == b->autoRead &&
+         a->autoWrite == b->autoWrite &&
+         a->idataMemorySize == b->idataMemorySize &&
+         a->xdataMemorySize == b->xdataMemorySize &&
+         a->iromMemorySize == b->iromMemorySize &&
+         a->xromMemorySize == b->xromMemorySize &&
+         a->numOfDevices == b->numOfDevices &&
+         (lanes || a->R - a->idata == b->R - b->idata) &&
+         (BYTE*) a->DPTR - a->sfr == (BYTE*) b->DPTR - b->sfr &&
+         mcuSameSFR(a, b, lanes) &&
+         (lanes || 0 == memcmp(a->idata, b->idata, INT_RAM_SIZE)) &&
+         mcuSamePages(a, b, XDATA) &&
+         mcuSamePages(a, b, IROM) &&
+         mcuSamePages(a, b, XROM);
+}
+
+bool sameStateMCU(MCU* a, MCU* b)
+{
+  return mcuSameState(a, b, false);
+}
+
+bool sameSharedStateMCU(MCU* a, MCU* b)
+{
+  return mcuSameState(a, b, true);
 }
 
-// orl C,(bit)
-void orl_72(MCU* mcu)
+char* getError(MCU* mcu)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY) || mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  switch (mcu->errid) {
+  case E_NOERRORS:
+    return NULL;
+    break;
+  case E_IRAMOUTSIDE:
+    return "Using an address outside the available internal ram memory.";
+    break;
+  case E_XRAMOUTSIDE:
+    return "Using an address outside the available external ram memory.";
+    break;
+  case E_UNSUPPORTED:
+    return "Using unsupported instruction.";
+    break;
+  default:
+    return "Undefined error.";
+    break;
+  }
 }
 
-// orl C,/(bit)
-void orl_A0(MCU* mcu)
+inline BYTE* intRAM(MCU* mcu, BYTE address, bool direct)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY) || !mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  return _mcuIntRAM(mcu, address, direct, TRACK_NONE);
 }
 
-// anl C,(bit)
-void anl_82(MCU* mcu)
+inline BYTE* extRAM(MCU* mcu, WORD address)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY) && mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  return mcuPoisonedExtRAM(mcu, address, false);
 }
 
-// anl C,/(bit)
-void anl_B0(MCU* mcu)
+inline BYTE* ROM(MCU* mcu, WORD address)
 {
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_CY) && !mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  mcu->PC += 1;
+  return _mcuROM(mcu, address, false);
 }
 
-// cpl A
-void cpl_F4(MCU* mcu)
+BYTE getMemoryMCU(const MCU* mcu, MemoryType type, WORD address)
 {
-  *mcu->ACC = *mcu->ACC ^ 0xFF;
-  mcu->PC += 1;
+  MCUPage* page;
+
+  if (mcuPages(mcu, type) == NULL)
+    return 0;
+
+  // Debugger core reads it after every instruction.
+  page = mcuPages(mcu, type)[address >> 8];
+  if (page != NULL)
+    return page->data[address & 0xFF];
+
+  return type == XDATA ? mcuPoisonByte(mcu, address >> 8, address & 0xFF) : 0x00;
 }
 
-// mov @R0,(adress)
-void mov_A6(MCU* mcu)
+void setMemoryMCU(MCU* mcu, MemoryType type, WORD address, BYTE value)
 {
-  mcu->PC += 1;
-  *mcuIntRAM(mcu, mcu->R[0], false)
-  = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
+  writeMemoryMCU(mcu, type, address, &value, 1);
 }
 
-// mov @R1,(adress)
-void mov_A7(MCU* mcu)
+void readMemoryMCU(const MCU* mcu, MemoryType type, WORD address, BYTE* buffer,
+                   unsigned size)
 {
-  mcu->PC += 1;
-  *mcuIntRAM(mcu, mcu->R[1], false)
-  = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
-  mcu->PC += 1;
+  BYTE poison[256];
+  const BYTE* data = NULL;
+
+  if (mcuPages(mcu, type) == NULL) {
+    memset(buffer, 0, size);
+    return;
+  }
+
+  for (unsigned i = 0; i < size; ++i, ++address) {
+    if (data == NULL || (address & 0xFF) == 0)
+      data = mcuPageContents(mcu, type, address >> 8, poison);
+
+    buffer[i] = data[address & 0xFF];
+  }
 }
 
-// mov @R0,#(data)
-void mov_76(MCU* mcu)
+/*
+ * Page is taken only for bytes which differ, so loading the same image
+ * again or filling zeros keeps pages shared or not allocated.
+ */
+static void mcuWriteMemory(MCU* mcu, MemoryType type, WORD address, const BYTE* buffer,
+                           BYTE value, unsigned size)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, mcu->R[0], false, *mcuROM(mcu, mcu->PC));
-  mcu->PC += 1;
+  MCUPage** pages = mcuPages(mcu, type);
+  BYTE poison[256];
+  const BYTE* data = NULL;
+  bool remap = false;
+
+  if (pages == NULL)
+    return;
+
+  for (unsigned i = 0; i < size; ++i, ++address) {
+    BYTE byte = buffer != NULL ? buffer[i] : value;
+    MCUPage** page = &pages[address >> 8];
+
+    if (data == NULL || (address & 0xFF) == 0)
+      data = mcuPageContents(mcu, type, address >> 8, poison);
+
+    if (data[address & 0xFF] == byte)
+      continue;
+
+    if (mcuPageShared(*page)) {
+      data = mcuOwnPage(mcu, type, address >> 8);
+      remap = true;
+    }
+
+    (*page)->data[address & 0xFF] = byte;
+  }
+
+  // Code memory changes invalidate decoded code in caller.
+  for (unsigned page = 0; remap && page < 256; ++page) {
+    if (type == XDATA)
+      mcuMapExtRAMPage(mcu, page);
+    else
+      mcuMapROMPage(mcu, page);
+  }
 }
 
-// mov @R1,#(data)
-void mov_77(MCU* mcu)
+void writeMemoryMCU(MCU* mcu, MemoryType type, WORD address, const BYTE* buffer,
+                    unsigned size)
 {
-  mcu->PC += 1;
-  mcuSetIntRAM(mcu, mcu->R[1], false, *mcuROM(mcu, mcu->PC));
-  mcu->PC += 1;
+  mcuWriteMemory(mcu, type, address, buffer, 0, size);
 }
 
-// mov (adress),@R0
-void mov_86(MCU* mcu)
+void fillMemoryMCU(MCU* mcu, MemoryType type, WORD address, BYTE value, unsigned size)
 {
-  mcu->PC += 1;
-  *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true)
-  = *mcuIntRAM(mcu, mcu->R[0], false);
-  mcu->PC += 1;
+  mcuWriteMemory(mcu, type, address, NULL, value, size);
 }
 
-// mov (adress),@R1
-void mov_87(MCU* mcu)
+unsigned memoryPagesMCU(const MCU* mcu)
 {
-  mcu->PC += 1;
-  *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true)
-  = *mcuIntRAM(mcu, mcu->R[1], false);
-  mcu->PC += 1;
+  unsigned pages = 0;
+
+  for (unsigned page = 0; page < 256; ++page)
+    pages += (mcu->xdata[page] != NULL) + (mcu->irom[page] != NULL) + (mcu->xrom[page] != NULL);
+
+  return pages;
 }
 
-// jmp @A+DPTR
-void jmp_73(MCU* mcu)
+extern inline bool checkRegister(MCU* mcu, WORD flag)
 {
-  mcu->PC = (WORD) (*mcu->ACC + *mcu->DPTR);
+  return (*mcuIntRAM(mcu, (BYTE) (flag >> 8), true) & (BYTE) (flag & 0x00FF)) > 0;
 }
 
-// cjne A,#(byte),offset
-void cjne_B4(MCU* mcu)
+extern inline void setRegister(MCU* mcu, WORD flag, bool state)
 {
-  mcu->PC += 1;
-  if (*mcu->ACC < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
+  if (state)
+    *mcuIntRAM(mcu, (BYTE) (flag >> 8), true) |= (BYTE) (flag & 0x00FF);
   else
-    setRegister(mcu, PSW_CY, false);
-  if (*mcu->ACC != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
+    *mcuIntRAM(mcu, (BYTE) (flag >> 8), true) &= ~((BYTE) (flag & 0x00FF));
 }
 
-// cjne A,(adress),offset
-void cjne_B5(MCU* mcu)
+
+bool isBreakpointOrPause(MCU* mcu)
 {
-  mcu->PC += 1;
-  if (*mcu->ACC < *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (*mcu->ACC != *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne @R0,#(byte),offset
-void cjne_B6(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (*mcuIntRAM(mcu, mcu->R[0], false) < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (*mcuIntRAM(mcu, mcu->R[0], false) != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne @R1,#(byte),offset
-void cjne_B7(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (*mcuIntRAM(mcu, mcu->R[1], false) < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (*mcuIntRAM(mcu, mcu->R[1], false) != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne R0,#(byte),offset
-void cjne_B8(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[0] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[0] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne R1,#(byte),offset
-void cjne_B9(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[1] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[1] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne R2,#(byte),offset
-void cjne_BA(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[2] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[2] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
-
-// cjne R3,#(byte),offset
-void cjne_BB(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[3] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[3] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
+  int i = 0;
 
-// cjne R4,#(byte),offset
-void cjne_BC(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[4] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[4] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
+  /*
+   * PC Breakpoints.
+   */
+  for (i = 0; i < mcu->numOfPCBreakpoints; ++i)
+    if (mcu->PCBreakpoints[i] == mcu->PC)
+      return true;
 
-// cjne R5,#(byte),offset
-void cjne_BD(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[5] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[5] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
+  /*
+   * Access pauses.
+   */
+  for (i = 0; i < mcu->numOfaccessIntRAMPauses; ++i)
+    if (mcu->accessIntRAMPauses[i] == mcu->accessedIntRAM)
+      return true;
 
-// cjne R6,#(byte),offset
-void cjne_BE(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[6] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[6] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
+  for (i = 0; i < mcu->numOfAccessExtRAMPauses; ++i) {
+    if (mcu->accessExtRAMPauses[i] == mcu->accessedExtRAM)
+      return true;
   }
-}
 
-// cjne R7,#(byte),offset
-void cjne_BF(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcu->R[7] < *mcuROM(mcu, mcu->PC))
-    setRegister(mcu, PSW_CY, true);
-  else
-    setRegister(mcu, PSW_CY, false);
-  if (mcu->R[7] != *mcuROM(mcu, mcu->PC)) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else {
-    mcu->PC += 2;
-  }
-}
+  for (i = 0; i < mcu->numOfAccessIntROMPauses; ++i)
+    if (mcu->accessIntROMPauses[i] == mcu->accessedIntROM)
+      return true;
 
-// reti
-void reti_32(MCU* mcu)
-{
-  mcu->PC = (WORD) *mcuIntRAM(mcu, *mcu->SP, false) << 8 | (WORD) *mcuIntRAM(mcu,
-            *mcu->SP - 1, false);
-  *mcu->SP = *mcu->SP - 2;
-}
+  for (i = 0; i < mcu->numOfAccessExtROMPauses; ++i)
+    if (mcu->accessExtROMPauses[i] == mcu->accessedExtROM)
+      return true;
 
-// jnb (bit),(offset)
-void jnb_30(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (!mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else
-    mcu->PC += 2;
-}
+  for (i = 0; i < mcu->numOfAccessSFRPauses; ++i)
+    if (mcu->accessSFRPauses[i] == mcu->accessedSFR)
+      return true;
 
-// jb (bit),(offset)
-void jb_20(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else
-    mcu->PC += 2;
-}
+  /*
+   * Conditional pauses.
+   */
+  for (int n = 0; n < 3; ++n) {
 
-// jbc (bit),(offset)
-void jbc_10(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
-    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
-    mcu->PC += 1;
-    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
-  } else
-    mcu->PC += 2;
-}
+    int num = 0;
+    BYTE val1 = 0;
+    BYTE val2 = 0;
+    BreakpointType type = 0;
 
-// subb A,#(data)
-void subb_94(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
-  mcu->PC += 1;
-}
+    if (n == 0)
+      num = mcu->numOfIntRAMPauses;
+    else if (n == 1)
+      num = mcu->numOfExtRAMPauses;
+    else if (n == 2)
+      num = mcu->numOfSFRPauses;
 
-// subb A,(adress)
-void subb_95(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
-  mcu->PC += 1;
-}
+    for (i = 0; i < num; ++i) {
+      if (n == 0) {
+        val1 = mcu->idata[mcu->intRAMPauses[i].address];
+        val2 = mcu->intRAMPauses[i].value;
+        type = mcu->intRAMPauses[i].type;
+      } else if (n == 1) {
+        val1 = getMemoryMCU(mcu, XDATA, mcu->extRAMPauses[i].address);
+        val2 = mcu->extRAMPauses[i].value;
+        type = mcu->extRAMPauses[i].type;
+      } else if (n == 2) {
+        syncMCU(mcu);
+        val1 = mcu->sfr[mcu->SFRPauses[i].address];
+        val2 = mcu->SFRPauses[i].value;
+        type = mcu->SFRPauses[i].type;
+      }
 
-// subb A,@R0
-void subb_96(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[0], false));
-  mcu->PC += 1;
-}
+      switch (type) {
+      case EQUAL:
+        if (val1 == val2)
+          return true;
+        break;
+      case NOT_EQUAL:
+        if (val1 != val2)
+          return true;
+        break;
+      case LESS:
+        if (val1 < val2)
+          return true;
+        break;
+      case LESS_EQUAL:
+        if (val1 <= val2)
+          return true;
+        break;
+      case GREATER:
+        if (val1 > val2)
+          return true;
+        break;
+      case GREATER_EQUAL:
+        if (val1 >= val2)
+          return true;
+        break;
+      case AND:
+        if (val1 & val2)
+          return true;
+        break;
+      case OR:
+        if (val1 | val2)
+          return true;
+        break;
+      case XOR:
+        if (val1 ^ val2)
+          return true;
+        break;
+      }
+    }
+  }
 
-// subb A,@R1
-void subb_97(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[1], false));
-  mcu->PC += 1;
+  return false;
 }
 
-// subb A,R0
-void subb_98(MCU* mcu)
+void setPCBreakpoint(MCU* mcu, WORD address)
 {
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[0]);
-}
+  /* Sprawdz, czy już nie istnieje taki. */
+  for (int i = 0; i < mcu->numOfPCBreakpoints; ++i)
+    if (mcu->PCBreakpoints[i] == address)
+      return;
 
-// subb A,R1
-void subb_99(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[1]);
+  mcu->numOfPCBreakpoints += 1;
+  mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
+                               mcu->numOfPCBreakpoints * sizeof(WORD*));
+  mcu->PCBreakpoints[mcu->numOfPCBreakpoints - 1] = address;
 }
 
-// subb A,R2
-void subb_9A(MCU* mcu)
+void setAccessPause(MCU* mcu, MemoryType memoryType, WORD address)
 {
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[2]);
-}
+  int* num = NULL;
+  WORD** breakpoints = NULL;
 
-// subb A,R3
-void subb_9B(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[3]);
-}
+  switch (memoryType) {
+  case IDATA:
+    num = &mcu->numOfaccessIntRAMPauses;
+    breakpoints = &mcu->accessIntRAMPauses;
+    break;
+  case XDATA:
+    num = &mcu->numOfAccessExtRAMPauses;
+    breakpoints = &mcu->accessExtRAMPauses;
+    break;
+  case SFR:
+    num = &mcu->numOfAccessSFRPauses;
+    breakpoints = &mcu->accessSFRPauses;
+    break;
+  case IROM:
+    num = &mcu->numOfAccessIntROMPauses;
+    breakpoints = &mcu->accessIntROMPauses;
+    break;
+  case XROM:
+    num = &mcu->numOfAccessExtROMPauses;
+    breakpoints = &mcu->accessExtROMPauses;
+    break;
+  default:
+    return;
+  }
 
-// subb A,R4
-void subb_9C(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[4]);
-}
+  if (memoryType == IDATA && address > 0xFF)
+    return;
+  if (memoryType == SFR && (address < 0x80 || address > 0xFF))
+    return;
 
-// subb A,R5
-void subb_9D(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[5]);
-}
+  /* Sprawdz, czy już nie istnieje taki. */
+  for (int i = 0; i < *num; ++i)
+    if (**breakpoints == address)
+      return;
 
-// subb A,R6
-void subb_9E(MCU* mcu)
-{
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[6]);
+  *num += 1;
+  *breakpoints = realloc(*breakpoints, *num * sizeof(WORD*));
+  *breakpoints[*num - 1] = address;
 }
 
-// subb A,R7
-void subb_9F(MCU* mcu)
+void setCondPause(MCU* mcu, MemoryType memoryType,
+                  WORD address, BreakpointType breakType, BYTE value)
 {
-  mcu->PC += 1;
-  mcuSub(mcu, mcu->ACC, &mcu->R[7]);
-}
+  int* num = NULL;
+  MCUConditionBreakpoint** breakpoints = NULL;
 
-// da A
-void da_D4(MCU* mcu)
-{
-  mcu->PC += 1;
-  if (checkRegister(mcu, PSW_AC) || ((*mcu->ACC & 0x0F) > 0x09)) {
-    *mcu->ACC += 0x06;
-    if ((*mcu->ACC & 0x0F) > 0x0F)
-      setRegister(mcu, PSW_CY, true);
-  }
-  if (checkRegister(mcu, PSW_CY) || ((*mcu->ACC & 0xF0) > 0x90)) {
-    *mcu->ACC += 0x60;
-    if ((*mcu->ACC & 0xF0) > 0xF0)
-      setRegister(mcu, PSW_CY, true);
+  switch (memoryType) {
+  case IDATA:
+    num = &mcu->numOfIntRAMPauses;
+    breakpoints = &mcu->intRAMPauses;
+    break;
+  case XDATA:
+    num = &mcu->numOfExtRAMPauses;
+    breakpoints = &mcu->extRAMPauses;
+    break;
+  case SFR:
+    num = &mcu->numOfSFRPauses;
+    breakpoints = &mcu->SFRPauses;
+    break;
+  default:
+    return;
   }
-}
 
-// xchd A,@R0
-void xchd_D6(MCU* mcu)
-{
-  BYTE tempB;
-
-  mcu->PC += 1;
-  tempB = *mcuIntRAM(mcu, mcu->R[0], false) & 0xF;
-  *mcuIntRAM(mcu, mcu->R[0], false) &= 0xF;
-  *mcuIntRAM(mcu, mcu->R[0], false) |= (*mcu->ACC) & 0xF;
-  (*mcu->ACC) &= 0xF;
-  (*mcu->ACC) |= tempB;
-}
-
-// xchd A,@R1
-void xchd_D7(MCU* mcu)
-{
-  BYTE tempB;
-
-  mcu->PC += 1;
-  tempB = *mcuIntRAM(mcu, mcu->R[1], false) & 0xF;
-  *mcuIntRAM(mcu, mcu->R[1], false) &= 0xF;
-  *mcuIntRAM(mcu, mcu->R[1], false) |= (*mcu->ACC) & 0xF;
-  (*mcu->ACC) &= 0xF;
-  (*mcu->ACC) |= tempB;
-}
-
-// movx A,@R0
-void movx_E2(MCU* mcu)
-{
-  *mcu->ACC = *mcuExtRAM(mcu, mcu->R[0]);
-  mcu->PC += 1;
-}
-
-// A,@R1
-void movx_E3(MCU* mcu)
-{
-  *mcu->ACC = *mcuExtRAM(mcu, mcu->R[1]);
-  mcu->PC += 1;
-}
+  if (memoryType == IDATA && address > 0xFF)
+    return;
+  if (memoryType == SFR && (address < 0x80 || address > 0xFF))
+    return;
 
-// movx @R0,A
-void movx_F2(MCU* mcu)
-{
-  *mcuExtRAM(mcu, mcu->R[0]) = *mcu->ACC;
-  mcu->PC += 1;
-}
+  /* Sprawdz, czy już nie istnieje taki. */
+  for (int i = 0; i < *num; ++i)
+    if ((*breakpoints)->address == address)
+      return;
 
-// movx @R1,A
-void movx_F3(MCU* mcu)
-{
-  *mcuExtRAM(mcu, mcu->R[1]) = *mcu->ACC;
-  mcu->PC += 1;
+  *num += 1;
+  *breakpoints = realloc(*breakpoints, *num * sizeof(MCUConditionBreakpoint*));
+  (*breakpoints)[*num - 1].address = address;
+  (*breakpoints)[*num - 1].type = breakType;
+  (*breakpoints)[*num - 1].value = value;
 }
 
-// Timers
-void timers8051(MCU* mcu)
+void clearPCBreakpoint(MCU* mcu, WORD address)
 {
-  BYTE mode = *mcu->TMOD & 0x03;
-  if (checkRegister(mcu, TCON_TR0) && (!checkRegister(mcu, TMOD_GATE0) || checkRegister(
-                                         mcu, P3_INT0))) {
-
-    switch (mode) {
-    case 0:
-      if ((int) (*mcu->TL0) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0x1F)
-        *mcu->TL0 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL0 = (BYTE) ((int) *mcu->TL0 - (int) 0x20 + mcu->cycleCount[mcu->lastInstruction]);
-        if ((int) (*mcu->TH0) < 0xFF)
-          *mcu->TH0 += 1;
-        else {
-          *mcu->TH0 = 0;
-          setRegister(mcu, TCON_TF0, true);
-        }
-      }
-      break;
-    case 1:
-      if ((int) (*mcu->TL0) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-        *mcu->TL0 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL0
-        = (BYTE) ((int) *mcu->TL0 - (int) 0x100 + mcu->cycleCount[mcu->lastInstruction]);
-        if ((int) (*mcu->TH0) < 0xFF)
-          *mcu->TH0 += 1;
-        else {
-          *mcu->TH0 = 0;
-          setRegister(mcu, TCON_TF0, true);
-        }
-      }
-      break;
-    case 2:
-      if ((int) (*mcu->TL0) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-        *mcu->TL0 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL0 = *mcu->TH0;
-        setRegister(mcu, TCON_TF0, true);
-      }
-      break;
-    case 3:
-      if ((int) (*mcu->TL0) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-        *mcu->TL0 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL0
-        = (BYTE) ((int) *mcu->TL0 - (int) 0x100 + mcu->cycleCount[mcu->lastInstruction]);
-        setRegister(mcu, TCON_TF0, true);
-      }
-      break;
-    }
-  }
-
-  // TH0 in mode 3
-  if (mode == 3 && checkRegister(mcu, TCON_TR1)) {
-    if ((int) (*mcu->TH0) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-      *mcu->TH0 += mcu->cycleCount[mcu->lastInstruction];
-    else {
-      *mcu->TH0 = (BYTE) ((int) *mcu->TH0 - (int) 0x100 + mcu->cycleCount[mcu->lastInstruction]);
-      setRegister(mcu, TCON_TF1, true);
-    }
-  }
-
-  mode = (*mcu->TMOD & 0x30) >> 4;
-  if (checkRegister(mcu, TCON_TR1) && (!checkRegister(mcu, TMOD_GATE1) || checkRegister(
-                                         mcu, P3_INT1))) {
-
-    switch (mode) {
-    case 0:
-      if ((int) (*mcu->TL1) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0x1F)
-        *mcu->TL1 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL1 = (BYTE) ((int) *mcu->TL1 - (int) 0x20 + mcu->cycleCount[mcu->lastInstruction]);
-        if ((int) (*mcu->TH1) < 0xFF)
-          *mcu->TH1 += 1;
-        else {
-          *mcu->TH1 = 0;
-          setRegister(mcu, TCON_TF1, true);
-        }
-      }
-      break;
-    case 1:
-      if ((int) (*mcu->TL1) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-        *mcu->TL1 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL1
-        = (BYTE) ((int) *mcu->TL1 - (int) 0x100 + mcu->cycleCount[mcu->lastInstruction]);
-        if ((int) (*mcu->TH1) < 0xFF)
-          *mcu->TH1 += 1;
-        else {
-          *mcu->TH1 = 0;
-          setRegister(mcu, TCON_TF1, true);
-        }
-      }
-      break;
-    case 2:
-      if ((int) (*mcu->TL1) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-        *mcu->TL1 += mcu->cycleCount[mcu->lastInstruction];
-      else {
-        *mcu->TL1 = *mcu->TH1;
-        setRegister(mcu, TCON_TF1, true);
+  for (int i = 0; i < mcu->numOfPCBreakpoints; ++i) {
+    if (mcu->PCBreakpoints[i] == address) {
+      if (i == mcu->numOfPCBreakpoints - 1) {
+        mcu->numOfPCBreakpoints -= 1;
+        mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
+                                     mcu->numOfPCBreakpoints * sizeof(WORD*));
+      } else {
+        memmove(&mcu->PCBreakpoints[i], &mcu->PCBreakpoints[i + 1],
+                (mcu->numOfPCBreakpoints - i - 1) * sizeof(WORD*));
+        mcu->numOfPCBreakpoints -= 1;
+        mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
+                                     mcu->numOfPCBreakpoints * sizeof(WORD*));
       }
-      break;
-    case 3:
-      // stop
-      break;
+      /* szukaj dalej gdyby breakpoint się powtarzał */
+      i -= 1;
+      continue;
     }
   }
 }
 
-void timers8052(MCU* mcu)
+void clearAccessPause(MCU* mcu, MemoryType memoryType, WORD address)
 {
-  timers8051(mcu);
-
-  // TODO! Prosta obsługa i nie jestem pewien czy dobra ;/.
-  if (checkRegister(mcu, T2CON_TR2) && (!checkRegister(mcu, TMOD_GATE0) || checkRegister(
-                                          mcu, P3_INT0))) {
-    if ((int) (*mcu->TL2) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-      *mcu->TL2 += mcu->cycleCount[mcu->lastInstruction];
-    else {
-      *mcu->TL2 = *mcu->RCAP2L;
-      setRegister(mcu, TCON_TF1, true);
-    }
-
-    if ((int) (*mcu->TH2) + (int) mcu->cycleCount[mcu->lastInstruction] <= 0xFF)
-      *mcu->TH2 += mcu->cycleCount[mcu->lastInstruction];
-    else {
-      *mcu->TH2 = *mcu->RCAP2H;
-      setRegister(mcu, TCON_TF1, true);
-    }
-  }
-}
+  int* num = NULL;
+  WORD* breakpoints = NULL;
 
-// Interrupts
-void interrupts8051(MCU* mcu)
-{
-  if (checkRegister(mcu, IE_EA)) {
-    // T0
-    if (checkRegister(mcu, TCON_TF0) && checkRegister(mcu, IE_ET0)) {
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
-      mcu->PC = 0x000B;
-    }
-    // INT1
-    if (checkRegister(mcu, TCON_IE1) && checkRegister(mcu, IE_EX1)) {
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
-      mcu->PC = 0x0013;
-    }
-    // T1
-    if (checkRegister(mcu, TCON_TF1) && checkRegister(mcu, IE_ET1)) {
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
-      mcu->PC = 0x001B;
-    }    // INT0
-    if (checkRegister(mcu, TCON_IE0) && checkRegister(mcu, IE_EX0)) {
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
-      mcu->PC = 0x0003;
-    }
+  switch (memoryType) {
+  case IDATA:
+    num = &mcu->numOfaccessIntRAMPauses;
+    breakpoints = mcu->accessIntRAMPauses;
+    break;
+  case XDATA:
+    num = &mcu->numOfAccessExtRAMPauses;
+    breakpoints = mcu->accessExtRAMPauses;
+    break;
+  case SFR:
+    num = &mcu->numOfAccessSFRPauses;
+    breakpoints = mcu->accessSFRPauses;
+    break;
+  case IROM:
+    num = &mcu->numOfAccessIntROMPauses;
+    breakpoints = mcu->accessIntROMPauses;
+    break;
+  case XROM:
+    num = &mcu->numOfAccessExtROMPauses;
+    breakpoints = mcu->accessExtROMPauses;
+    break;
+  default:
+    return;
   }
-}
 
-void interrupts8052(MCU* mcu)
-{
-  if (checkRegister(mcu, IE_EA)) {
-    // T2
-    if (checkRegister(mcu, T2CON_TF2) && checkRegister(mcu, T2CON_EXF2)
-        && checkRegister(mcu, IE_ET2)) {
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC & 0x00FF));
-      *mcu->SP += 1;
-      mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (mcu->PC >> 8));
-      mcu->PC = 0x002B;
+  for (int i = 0; i < *num; ++i) {
+    if (breakpoints[i] == address) {
+      if (i == *num - 1) {
+        *num -= 1;
+        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
+      } else {
+        memmove(&breakpoints[i], &breakpoints[i + 1], (*num - i - 1) * sizeof(WORD*));
+        *num -= 1;
+        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
+      }
+      /* szukaj dalej gdyby breakpoint się powtarzał */
+      i -= 1;
+      continue;
     }
-
-    interrupts8051(mcu);
   }
 }
 
-// Additional Code
-void Mcu89S5x(MCU* mcu)
+void clearCondPause(MCU* mcu, MemoryType memoryType, WORD address)
 {
-  /*
-   * Two DPTR
-   */
-  if(checkRegister(mcu, AUXR1_DPS))
-    mcu->DPTR = (WORD*)&mcu->sfr[0x84 - 0x80];
-  else
-    mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
+  int* num = NULL;
+  MCUConditionBreakpoint* breakpoints = NULL;
 
-  /*
-   * WDT
-   */
-  if (mcu->accessedSFR == 0xA6 && mcu->_beforeAccessedSFR == 0x1E && *mcu->WDTRST == 0xE1) {
-    mcu->WDTEnable = true;
-    mcu->WDTTimerValue = 0;
+  switch (memoryType) {
+  case IDATA:
+    num = &mcu->numOfIntRAMPauses;
+    breakpoints = mcu->intRAMPauses;
+    break;
+  case XDATA:
+    num = &mcu->numOfExtRAMPauses;
+    breakpoints = mcu->extRAMPauses;
+    break;
+  case SFR:
+    num = &mcu->numOfSFRPauses;
+    breakpoints = mcu->SFRPauses;
+    break;
+  default:
+    return;
   }
 
-  if (mcu->WDTEnable) {
-    mcu->WDTTimerValue += mcu->cycleCount[mcu->lastInstruction];
-    if (mcu->WDTTimerValue > 0x3FFF)
-      resetMCU(mcu);
+  for (int i = 0; i < *num; ++i) {
+    if (breakpoints[i].address == address) {
+      if (i == *num - 1) {
+        *num -= 1;
+        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
+      } else {
+        memmove(&breakpoints[i], &breakpoints[i + 1], (*num - i - 1) * sizeof(WORD*));
+        *num -= 1;
+        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
+      }
+      /* szukaj dalej gdyby breakpoint się powtarzał */
+      i -= 1;
+      continue;
+    }
   }
 }
 
-void init8051MCU(MCU* mcu)
+void clearAllBreakpointsAndPauses(MCU* mcu)
 {
-  mcu->mcuType = M_8052;
-  mcu->oscillator = 11059200;
-
-  memset(mcu->idata, 0, INT_RAM_SIZE);
-
-  for (int i = 0; i < INT_RAM_SIZE; ++i)
-    mcu->idata[i] = rand();
-
-  for (int i = 0; i < MAX_EXT_RAM_SIZE; ++i)
-    mcu->xdata[i] = rand();
-
-  mcu->idataMemorySize = 0x80;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0x1000;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
-
-  mcu->EA = 1;
-
-  if (mcu->EA)
-    mcu->currentRom = mcu->irom;
-  else
-    mcu->currentRom = mcu->xrom;
-
-  mcu->autoRead = true;
-  mcu->autoWrite = true;
-
-  mcu->PCBreakpoints = NULL;
-  mcu->accessIntRAMPauses = NULL;
-  mcu->accessExtRAMPauses = NULL;
-  mcu->accessIntROMPauses = NULL;
-  mcu->accessExtROMPauses = NULL;
-  mcu->accessSFRPauses = NULL;
-  mcu->intRAMPauses = NULL;
-  mcu->extRAMPauses = NULL;
-  mcu->SFRPauses = NULL;
-
-  mcu->numOfPCBreakpoints = 0;
-  mcu->numOfaccessIntRAMPauses = 0;
-  mcu->numOfAccessExtRAMPauses = 0;
-  mcu->numOfAccessIntROMPauses = 0;
-  mcu->numOfAccessExtROMPauses = 0;
-  mcu->numOfAccessSFRPauses = 0;
-  mcu->numOfIntRAMPauses = 0;
-  mcu->numOfExtRAMPauses = 0;
-  mcu->numOfSFRPauses = 0;
-
-  mcu->P0 = &mcu->sfr[0x80 - 0x80];
-  mcu->SP = &mcu->sfr[0x81 - 0x80];
-  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
-  mcu->DPL = &mcu->sfr[0x82 - 0x80];
-  mcu->DPH = &mcu->sfr[0x83 - 0x80];
-  mcu->PCON = &mcu->sfr[0x87 - 0x80];
-  mcu->TCON = &mcu->sfr[0x88 - 0x80];
-  mcu->TMOD = &mcu->sfr[0x89 - 0x80];
-  mcu->TL0 = &mcu->sfr[0x8A - 0x80];
-  mcu->TL1 = &mcu->sfr[0x8B - 0x80];
-  mcu->TH0 = &mcu->sfr[0x8C - 0x80];
-  mcu->TH1 = &mcu->sfr[0x8D - 0x80];
-  mcu->P1 = &mcu->sfr[0x90 - 0x80];
-  mcu->SCON = &mcu->sfr[0x98 - 0x80];
-  mcu->SBUF = &mcu->sfr[0x99 - 0x80];
-  mcu->P2 = &mcu->sfr[0xA0 - 0x80];
-  mcu->IE = &mcu->sfr[0xA8 - 0x80];
-  mcu->P3 = &mcu->sfr[0xB0 - 0x80];
-  mcu->IP = &mcu->sfr[0xC0 - 0x80];
-  mcu->T2CON = &mcu->sfr[0xC8 - 0x80];
-  mcu->RCAP2L = &mcu->sfr[0xCA - 0x80];
-  mcu->RCAP2H = &mcu->sfr[0xCB - 0x80];
-  mcu->TL2 = &mcu->sfr[0xCD - 0x80];
-  mcu->TH2 = &mcu->sfr[0xCE - 0x80];
-  mcu->PSW = &mcu->sfr[0xD0 - 0x80];
-  mcu->ACC = &mcu->sfr[0xE0 - 0x80];
-  mcu->B = &mcu->sfr[0xF0 - 0x80];
-  mcu->R = &mcu->sfr[0x00 - 0x80];
-
-  mcu->cycleCount[0] = 1;
-  mcu->cycleCount[1] = 2;
-  mcu->cycleCount[2] = 2;
-  mcu->cycleCount[3] = 1;
-  mcu->cycleCount[4] = 1;
-  mcu->cycleCount[5] = 1;
-  mcu->cycleCount[6] = 1;
-  mcu->cycleCount[7] = 1;
-  mcu->cycleCount[8] = 1;
-  mcu->cycleCount[9] = 1;
-  mcu->cycleCount[10] = 1;
-  mcu->cycleCount[11] = 1;
-  mcu->cycleCount[12] = 1;
-  mcu->cycleCount[13] = 1;
-  mcu->cycleCount[14] = 1;
-  mcu->cycleCount[15] = 1;
-  mcu->cycleCount[16] = 2;
-  mcu->cycleCount[17] = 2;
-  mcu->cycleCount[18] = 2;
-  mcu->cycleCount[19] = 1;
-  mcu->cycleCount[20] = 1;
-  mcu->cycleCount[21] = 1;
-  mcu->cycleCount[22] = 1;
-  mcu->cycleCount[23] = 1;
-  mcu->cycleCount[24] = 1;
-  mcu->cycleCount[25] = 1;
-  mcu->cycleCount[26] = 1;
-  mcu->cycleCount[27] = 1;
-  mcu->cycleCount[28] = 1;
-  mcu->cycleCount[29] = 1;
-  mcu->cycleCount[30] = 1;
-  mcu->cycleCount[31] = 1;
-  mcu->cycleCount[32] = 2;
-  mcu->cycleCount[33] = 2;
-  mcu->cycleCount[34] = 2;
-  mcu->cycleCount[35] = 1;
-  mcu->cycleCount[36] = 1;
-  mcu->cycleCount[37] = 1;
-  mcu->cycleCount[38] = 1;
-  mcu->cycleCount[39] = 1;
-  mcu->cycleCount[40] = 1;
-  mcu->cycleCount[41] = 1;
-  mcu->cycleCount[42] = 1;
-  mcu->cycleCount[43] = 1;
-  mcu->cycleCount[44] = 1;
-  mcu->cycleCount[45] = 1;
-  mcu->cycleCount[46] = 1;
-  mcu->cycleCount[47] = 1;
-  mcu->cycleCount[48] = 2;
-  mcu->cycleCount[49] = 2;
-  mcu->cycleCount[50] = 2;
-  mcu->cycleCount[51] = 1;
-  mcu->cycleCount[52] = 1;
-  mcu->cycleCount[53] = 1;
-  mcu->cycleCount[54] = 1;
-  mcu->cycleCount[55] = 1;
-  mcu->cycleCount[56] = 1;
-  mcu->cycleCount[57] = 1;
-  mcu->cycleCount[58] = 1;
-  mcu->cycleCount[59] = 1;
-  mcu->cycleCount[60] = 1;
-  mcu->cycleCount[61] = 1;
-  mcu->cycleCount[62] = 1;
-  mcu->cycleCount[63] = 1;
-  mcu->cycleCount[64] = 2;
-  mcu->cycleCount[65] = 2;
-  mcu->cycleCount[66] = 1;
-  mcu->cycleCount[67] = 2;
-  mcu->cycleCount[68] = 1;
-  mcu->cycleCount[69] = 1;
-  mcu->cycleCount[70] = 1;
-  mcu->cycleCount[71] = 1;
-  mcu->cycleCount[72] = 1;
-  mcu->cycleCount[73] = 1;
-  mcu->cycleCount[74] = 1;
-  mcu->cycleCount[75] = 1;
-  mcu->cycleCount[76] = 1;
-  mcu->cycleCount[77] = 1;
-  mcu->cycleCount[78] = 1;
-  mcu->cycleCount[79] = 1;
-  mcu->cycleCount[80] = 2;
-  mcu->cycleCount[81] = 2;
-  mcu->cycleCount[82] = 1;
-  mcu->cycleCount[83] = 2;
-  mcu->cycleCount[84] = 1;
-  mcu->cycleCount[85] = 1;
-  mcu->cycleCount[86] = 1;
-  mcu->cycleCount[87] = 1;
-  mcu->cycleCount[88] = 1;
-  mcu->cycleCount[89] = 1;
-  mcu->cycleCount[90] = 1;
-  mcu->cycleCount[91] = 1;
-  mcu->cycleCount[92] = 1;
-  mcu->cycleCount[93] = 1;
-  mcu->cycleCount[94] = 1;
-  mcu->cycleCount[95] = 1;
-  mcu->cycleCount[96] = 2;
-  mcu->cycleCount[97] = 2;
-  mcu->cycleCount[98] = 1;
-  mcu->cycleCount[99] = 2;
-  mcu->cycleCount[100] = 1;
-  mcu->cycleCount[101] = 1;
-  mcu->cycleCount[102] = 1;
-  mcu->cycleCount[103] = 1;
-  mcu->cycleCount[104] = 1;
-  mcu->cycleCount[105] = 1;
-  mcu->cycleCount[106] = 1;
-  mcu->cycleCount[107] = 1;
-  mcu->cycleCount[108] = 1;
-  mcu->cycleCount[109] = 1;
-  mcu->cycleCount[110] = 1;
-  mcu->cycleCount[111] = 1;
-  mcu->cycleCount[112] = 2;
-  mcu->cycleCount[113] = 2;
-  mcu->cycleCount[114] = 2;
-  mcu->cycleCount[115] = 2;
-  mcu->cycleCount[116] = 1;
-  mcu->cycleCount[117] = 2;
-  mcu->cycleCount[118] = 1;
-  mcu->cycleCount[119] = 1;
-  mcu->cycleCount[120] = 1;
-  mcu->cycleCount[121] = 1;
-  mcu->cycleCount[122] = 1;
-  mcu->cycleCount[123] = 1;
-  mcu->cycleCount[124] = 1;
-  mcu->cycleCount[125] = 1;
-  mcu->cycleCount[126] = 1;
-  mcu->cycleCount[127] = 1;
-  mcu->cycleCount[128] = 2;
-  mcu->cycleCount[129] = 2;
-  mcu->cycleCount[130] = 2;
-  mcu->cycleCount[131] = 2;
-  mcu->cycleCount[132] = 4;
-  mcu->cycleCount[133] = 2;
-  mcu->cycleCount[134] = 2;
-  mcu->cycleCount[135] = 2;
-  mcu->cycleCount[136] = 2;
-  mcu->cycleCount[137] = 2;
-  mcu->cycleCount[138] = 2;
-  mcu->cycleCount[139] = 2;
-  mcu->cycleCount[140] = 2;
-  mcu->cycleCount[141] = 2;
-  mcu->cycleCount[142] = 2;
-  mcu->cycleCount[143] = 2;
-  mcu->cycleCount[144] = 2;
-  mcu->cycleCount[145] = 2;
-  mcu->cycleCount[146] = 2;
-  mcu->cycleCount[147] = 2;
-  mcu->cycleCount[148] = 1;
-  mcu->cycleCount[149] = 1;
-  mcu->cycleCount[150] = 1;
-  mcu->cycleCount[151] = 1;
-  mcu->cycleCount[152] = 1;
-  mcu->cycleCount[153] = 1;
-  mcu->cycleCount[154] = 1;
-  mcu->cycleCount[155] = 1;
-  mcu->cycleCount[156] = 1;
-  mcu->cycleCount[157] = 1;
-  mcu->cycleCount[158] = 1;
-  mcu->cycleCount[159] = 1;
-  mcu->cycleCount[160] = 2;
-  mcu->cycleCount[161] = 2;
-  mcu->cycleCount[162] = 1;
-  mcu->cycleCount[163] = 2;
-  mcu->cycleCount[164] = 4;
-  mcu->cycleCount[165] = 1;
-  mcu->cycleCount[166] = 2;
-  mcu->cycleCount[167] = 2;
-  mcu->cycleCount[168] = 2;
-  mcu->cycleCount[169] = 2;
-  mcu->cycleCount[170] = 2;
-  mcu->cycleCount[171] = 2;
-  mcu->cycleCount[172] = 2;
-  mcu->cycleCount[173] = 2;
-  mcu->cycleCount[174] = 2;
-  mcu->cycleCount[175] = 2;
-  mcu->cycleCount[176] = 2;
-  mcu->cycleCount[177] = 2;
-  mcu->cycleCount[178] = 1;
-  mcu->cycleCount[179] = 1;
-  mcu->cycleCount[180] = 2;
-  mcu->cycleCount[181] = 2;
-  mcu->cycleCount[182] = 2;
-  mcu->cycleCount[183] = 2;
-  mcu->cycleCount[184] = 2;
-  mcu->cycleCount[185] = 2;
-  mcu->cycleCount[186] = 2;
-  mcu->cycleCount[187] = 2;
-  mcu->cycleCount[188] = 2;
-  mcu->cycleCount[189] = 2;
-  mcu->cycleCount[190] = 2;
-  mcu->cycleCount[191] = 2;
-  mcu->cycleCount[192] = 2;
-  mcu->cycleCount[193] = 2;
-  mcu->cycleCount[194] = 1;
-  mcu->cycleCount[195] = 1;
-  mcu->cycleCount[196] = 1;
-  mcu->cycleCount[197] = 1;
-  mcu->cycleCount[198] = 1;
-  mcu->cycleCount[199] = 1;
-  mcu->cycleCount[200] = 1;
-  mcu->cycleCount[201] = 1;
-  mcu->cycleCount[202] = 1;
-  mcu->cycleCount[203] = 1;
-  mcu->cycleCount[204] = 1;
-  mcu->cycleCount[205] = 1;
-  mcu->cycleCount[206] = 1;
-  mcu->cycleCount[207] = 1;
-  mcu->cycleCount[208] = 2;
-  mcu->cycleCount[209] = 2;
-  mcu->cycleCount[210] = 1;
-  mcu->cycleCount[211] = 1;
-  mcu->cycleCount[212] = 1;
-  mcu->cycleCount[213] = 2;
-  mcu->cycleCount[214] = 1;
-  mcu->cycleCount[215] = 1;
-  mcu->cycleCount[216] = 2;
-  mcu->cycleCount[217] = 2;
-  mcu->cycleCount[218] = 2;
-  mcu->cycleCount[219] = 2;
-  mcu->cycleCount[220] = 2;
-  mcu->cycleCount[221] = 2;
-  mcu->cycleCount[222] = 2;
-  mcu->cycleCount[223] = 2;
-  mcu->cycleCount[224] = 2;
-  mcu->cycleCount[225] = 2;
-  mcu->cycleCount[226] = 2;
-  mcu->cycleCount[227] = 2;
-  mcu->cycleCount[228] = 1;
-  mcu->cycleCount[229] = 1;
-  mcu->cycleCount[230] = 1;
-  mcu->cycleCount[231] = 1;
-  mcu->cycleCount[232] = 1;
-  mcu->cycleCount[233] = 1;
-  mcu->cycleCount[234] = 1;
-  mcu->cycleCount[235] = 1;
-  mcu->cycleCount[236] = 1;
-  mcu->cycleCount[237] = 1;
-  mcu->cycleCount[238] = 1;
-  mcu->cycleCount[239] = 1;
-  mcu->cycleCount[240] = 2;
-  mcu->cycleCount[241] = 2;
-  mcu->cycleCount[242] = 2;
-  mcu->cycleCount[243] = 2;
-  mcu->cycleCount[244] = 1;
-  mcu->cycleCount[245] = 1;
-  mcu->cycleCount[246] = 1;
-  mcu->cycleCount[247] = 1;
-  mcu->cycleCount[248] = 1;
-  mcu->cycleCount[249] = 1;
-  mcu->cycleCount[250] = 1;
-  mcu->cycleCount[251] = 1;
-  mcu->cycleCount[252] = 1;
-  mcu->cycleCount[253] = 1;
-  mcu->cycleCount[254] = 1;
-  mcu->cycleCount[255] = 1;
-
-  mcu->byteCount[0] = 1;
-  mcu->byteCount[1] = 2;
-  mcu->byteCount[2] = 3;
-  mcu->byteCount[3] = 1;
-  mcu->byteCount[4] = 1;
-  mcu->byteCount[5] = 2;
-  mcu->byteCount[6] = 1;
-  mcu->byteCount[7] = 1;
-  mcu->byteCount[8] = 1;
-  mcu->byteCount[9] = 1;
-  mcu->byteCount[10] = 1;
-  mcu->byteCount[11] = 1;
-  mcu->byteCount[12] = 1;
-  mcu->byteCount[13] = 1;
-  mcu->byteCount[14] = 1;
-  mcu->byteCount[15] = 1;
-  mcu->byteCount[16] = 3;
-  mcu->byteCount[17] = 2;
-  mcu->byteCount[18] = 3;
-  mcu->byteCount[19] = 1;
-  mcu->byteCount[20] = 1;
-  mcu->byteCount[21] = 2;
-  mcu->byteCount[22] = 1;
-  mcu->byteCount[23] = 1;
-  mcu->byteCount[24] = 1;
-  mcu->byteCount[25] = 1;
-  mcu->byteCount[26] = 1;
-  mcu->byteCount[27] = 1;
-  mcu->byteCount[28] = 1;
-  mcu->byteCount[29] = 1;
-  mcu->byteCount[30] = 1;
-  mcu->byteCount[31] = 1;
-  mcu->byteCount[32] = 3;
-  mcu->byteCount[33] = 2;
-  mcu->byteCount[34] = 1;
-  mcu->byteCount[35] = 1;
-  mcu->byteCount[36] = 2;
-  mcu->byteCount[37] = 2;
-  mcu->byteCount[38] = 1;
-  mcu->byteCount[39] = 1;
-  mcu->byteCount[40] = 1;
-  mcu->byteCount[41] = 1;
-  mcu->byteCount[42] = 1;
-  mcu->byteCount[43] = 1;
-  mcu->byteCount[44] = 1;
-  mcu->byteCount[45] = 1;
-  mcu->byteCount[46] = 1;
-  mcu->byteCount[47] = 1;
-  mcu->byteCount[48] = 3;
-  mcu->byteCount[49] = 2;
-  mcu->byteCount[50] = 1;
-  mcu->byteCount[51] = 1;
-  mcu->byteCount[52] = 2;
-  mcu->byteCount[53] = 2;
-  mcu->byteCount[54] = 1;
-  mcu->byteCount[55] = 1;
-  mcu->byteCount[56] = 1;
-  mcu->byteCount[57] = 1;
-  mcu->byteCount[58] = 1;
-  mcu->byteCount[59] = 1;
-  mcu->byteCount[60] = 1;
-  mcu->byteCount[61] = 1;
-  mcu->byteCount[62] = 1;
-  mcu->byteCount[63] = 1;
-  mcu->byteCount[64] = 2;
-  mcu->byteCount[65] = 2;
-  mcu->byteCount[66] = 2;
-  mcu->byteCount[67] = 3;
-  mcu->byteCount[68] = 2;
-  mcu->byteCount[69] = 2;
-  mcu->byteCount[70] = 1;
-  mcu->byteCount[71] = 1;
-  mcu->byteCount[72] = 1;
-  mcu->byteCount[73] = 1;
-  mcu->byteCount[74] = 1;
-  mcu->byteCount[75] = 1;
-  mcu->byteCount[76] = 1;
-  mcu->byteCount[77] = 1;
-  mcu->byteCount[78] = 1;
-  mcu->byteCount[79] = 1;
-  mcu->byteCount[80] = 2;
-  mcu->byteCount[81] = 2;
-  mcu->byteCount[82] = 2;
-  mcu->byteCount[83] = 3;
-  mcu->byteCount[84] = 2;
-  mcu->byteCount[85] = 2;
-  mcu->byteCount[86] = 1;
-  mcu->byteCount[87] = 1;
-  mcu->byteCount[88] = 1;
-  mcu->byteCount[89] = 1;
-  mcu->byteCount[90] = 1;
-  mcu->byteCount[91] = 1;
-  mcu->byteCount[92] = 1;
-  mcu->byteCount[93] = 1;
-  mcu->byteCount[94] = 1;
-  mcu->byteCount[95] = 1;
-  mcu->byteCount[96] = 2;
-  mcu->byteCount[97] = 2;
-  mcu->byteCount[98] = 2;
-  mcu->byteCount[99] = 3;
-  mcu->byteCount[100] = 2;
-  mcu->byteCount[101] = 2;
-  mcu->byteCount[102] = 1;
-  mcu->byteCount[103] = 1;
-  mcu->byteCount[104] = 1;
-  mcu->byteCount[105] = 1;
-  mcu->byteCount[106] = 1;
-  mcu->byteCount[107] = 1;
-  mcu->byteCount[108] = 1;
-  mcu->byteCount[109] = 1;
-  mcu->byteCount[110] = 1;
-  mcu->byteCount[111] = 1;
-  mcu->byteCount[112] = 2;
-  mcu->byteCount[113] = 2;
-  mcu->byteCount[114] = 2;
-  mcu->byteCount[115] = 1;
-  mcu->byteCount[116] = 2;
-  mcu->byteCount[117] = 3;
-  mcu->byteCount[118] = 2;
-  mcu->byteCount[119] = 2;
-  mcu->byteCount[120] = 2;
-  mcu->byteCount[121] = 2;
-  mcu->byteCount[122] = 2;
-  mcu->byteCount[123] = 2;
-  mcu->byteCount[124] = 2;
-  mcu->byteCount[125] = 2;
-  mcu->byteCount[126] = 2;
-  mcu->byteCount[127] = 2;
-  mcu->byteCount[128] = 2;
-  mcu->byteCount[129] = 2;
-  mcu->byteCount[130] = 2;
-  mcu->byteCount[131] = 1;
-  mcu->byteCount[132] = 1;
-  mcu->byteCount[133] = 3;
-  mcu->byteCount[134] = 2;
-  mcu->byteCount[135] = 2;
-  mcu->byteCount[136] = 2;
-  mcu->byteCount[137] = 2;
-  mcu->byteCount[138] = 2;
-  mcu->byteCount[139] = 2;
-  mcu->byteCount[140] = 2;
-  mcu->byteCount[141] = 2;
-  mcu->byteCount[142] = 2;
-  mcu->byteCount[143] = 2;
-  mcu->byteCount[144] = 3;
-  mcu->byteCount[145] = 2;
-  mcu->byteCount[146] = 2;
-  mcu->byteCount[147] = 1;
-  mcu->byteCount[148] = 2;
-  mcu->byteCount[149] = 2;
-  mcu->byteCount[150] = 1;
-  mcu->byteCount[151] = 1;
-  mcu->byteCount[152] = 1;
-  mcu->byteCount[153] = 1;
-  mcu->byteCount[154] = 1;
-  mcu->byteCount[155] = 1;
-  mcu->byteCount[156] = 1;
-  mcu->byteCount[157] = 1;
-  mcu->byteCount[158] = 1;
-  mcu->byteCount[159] = 1;
-  mcu->byteCount[160] = 2;
-  mcu->byteCount[161] = 2;
-  mcu->byteCount[162] = 2;
-  mcu->byteCount[163] = 1;
-  mcu->byteCount[164] = 1;
-  mcu->byteCount[165] = 1;
-  mcu->byteCount[166] = 2;
-  mcu->byteCount[167] = 2;
-  mcu->byteCount[168] = 2;
-  mcu->byteCount[169] = 2;
-  mcu->byteCount[170] = 2;
-  mcu->byteCount[171] = 2;
-  mcu->byteCount[172] = 2;
-  mcu->byteCount[173] = 2;
-  mcu->byteCount[174] = 2;
-  mcu->byteCount[175] = 2;
-  mcu->byteCount[176] = 2;
-  mcu->byteCount[177] = 2;
-  mcu->byteCount[178] = 2;
-  mcu->byteCount[179] = 1;
-  mcu->byteCount[180] = 3;
-  mcu->byteCount[181] = 3;
-  mcu->byteCount[182] = 3;
-  mcu->byteCount[183] = 3;
-  mcu->byteCount[184] = 3;
-  mcu->byteCount[185] = 3;
-  mcu->byteCount[186] = 3;
-  mcu->byteCount[187] = 3;
-  mcu->byteCount[188] = 3;
-  mcu->byteCount[189] = 3;
-  mcu->byteCount[190] = 3;
-  mcu->byteCount[191] = 3;
-  mcu->byteCount[192] = 2;
-  mcu->byteCount[193] = 2;
-  mcu->byteCount[194] = 2;
-  mcu->byteCount[195] = 1;
-  mcu->byteCount[196] = 1;
-  mcu->byteCount[197] = 2;
-  mcu->byteCount[198] = 1;
-  mcu->byteCount[199] = 1;
-  mcu->byteCount[200] = 1;
-  mcu->byteCount[201] = 1;
-  mcu->byteCount[202] = 1;
-  mcu->byteCount[203] = 1;
-  mcu->byteCount[204] = 1;
-  mcu->byteCount[205] = 1;
-  mcu->byteCount[206] = 1;
-  mcu->byteCount[207] = 1;
-  mcu->byteCount[208] = 2;
-  mcu->byteCount[209] = 2;
-  mcu->byteCount[210] = 2;
-  mcu->byteCount[211] = 1;
-  mcu->byteCount[212] = 1;
-  mcu->byteCount[213] = 3;
-  mcu->byteCount[214] = 1;
-  mcu->byteCount[215] = 1;
-  mcu->byteCount[216] = 2;
-  mcu->byteCount[217] = 2;
-  mcu->byteCount[218] = 2;
-  mcu->byteCount[219] = 2;
-  mcu->byteCount[220] = 2;
-  mcu->byteCount[221] = 2;
-  mcu->byteCount[222] = 2;
-  mcu->byteCount[223] = 2;
-  mcu->byteCount[224] = 1;
-  mcu->byteCount[225] = 2;
-  mcu->byteCount[226] = 1;
-  mcu->byteCount[227] = 1;
-  mcu->byteCount[228] = 1;
-  mcu->byteCount[229] = 2;
-  mcu->byteCount[230] = 1;
-  mcu->byteCount[231] = 1;
-  mcu->byteCount[232] = 1;
-  mcu->byteCount[233] = 1;
-  mcu->byteCount[234] = 1;
-  mcu->byteCount[235] = 1;
-  mcu->byteCount[236] = 1;
-  mcu->byteCount[237] = 1;
-  mcu->byteCount[238] = 1;
-  mcu->byteCount[239] = 1;
-  mcu->byteCount[240] = 1;
-  mcu->byteCount[241] = 2;
-  mcu->byteCount[242] = 1;
-  mcu->byteCount[243] = 1;
-  mcu->byteCount[244] = 1;
-  mcu->byteCount[245] = 2;
-  mcu->byteCount[246] = 1;
-  mcu->byteCount[247] = 1;
-  mcu->byteCount[248] = 1;
-  mcu->byteCount[249] = 1;
-  mcu->byteCount[250] = 1;
-  mcu->byteCount[251] = 1;
-  mcu->byteCount[252] = 1;
-  mcu->byteCount[253] = 1;
-  mcu->byteCount[254] = 1;
-  mcu->byteCount[255] = 1;
-
-  mcu->mnemonicTable[0] = "nop  ";
-  mcu->mnemonicTable[1] = "ajmp ";
-  mcu->mnemonicTable[2] = "ljmp ";
-  mcu->mnemonicTable[3] = "rr   ";
-  mcu->mnemonicTable[4] = "inc  ";
-  mcu->mnemonicTable[5] = "inc  ";
-  mcu->mnemonicTable[6] = "inc  ";
-  mcu->mnemonicTable[7] = "inc  ";
-  mcu->mnemonicTable[8] = "inc  ";
-  mcu->mnemonicTable[9] = "inc  ";
-  mcu->mnemonicTable[10] = "inc  ";
-  mcu->mnemonicTable[11] = "inc  ";
-  mcu->mnemonicTable[12] = "inc  ";
-  mcu->mnemonicTable[13] = "inc  ";
-  mcu->mnemonicTable[14] = "inc  ";
-  mcu->mnemonicTable[15] = "inc  ";
-  mcu->mnemonicTable[16] = "jbc  ";
-  mcu->mnemonicTable[17] = "acall";
-  mcu->mnemonicTable[18] = "lcall";
-  mcu->mnemonicTable[19] = "rrc  ";
-  mcu->mnemonicTable[20] = "dec  ";
-  mcu->mnemonicTable[21] = "dec  ";
-  mcu->mnemonicTable[22] = "dec  ";
-  mcu->mnemonicTable[23] = "dec  ";
-  mcu->mnemonicTable[24] = "dec  ";
-  mcu->mnemonicTable[25] = "dec  ";
-  mcu->mnemonicTable[26] = "dec  ";
-  mcu->mnemonicTable[27] = "dec  ";
-  mcu->mnemonicTable[28] = "dec  ";
-  mcu->mnemonicTable[29] = "dec  ";
-  mcu->mnemonicTable[30] = "dec  ";
-  mcu->mnemonicTable[31] = "dec  ";
-  mcu->mnemonicTable[32] = "jb   ";
-  mcu->mnemonicTable[33] = "ajmp ";
-  mcu->mnemonicTable[34] = "ret  ";
-  mcu->mnemonicTable[35] = "rl   ";
-  mcu->mnemonicTable[36] = "add  ";
-  mcu->mnemonicTable[37] = "add  ";
-  mcu->mnemonicTable[38] = "add  ";
-  mcu->mnemonicTable[39] = "add  ";
-  mcu->mnemonicTable[40] = "add  ";
-  mcu->mnemonicTable[41] = "add  ";
-  mcu->mnemonicTable[42] = "add  ";
-  mcu->mnemonicTable[43] = "add  ";
-  mcu->mnemonicTable[44] = "add  ";
-  mcu->mnemonicTable[45] = "add  ";
-  mcu->mnemonicTable[46] = "add  ";
-  mcu->mnemonicTable[47] = "add  ";
-  mcu->mnemonicTable[48] = "jnb  ";
-  mcu->mnemonicTable[49] = "acall";
-  mcu->mnemonicTable[50] = "reti ";
-  mcu->mnemonicTable[51] = "rlc  ";
-  mcu->mnemonicTable[52] = "addc ";
-  mcu->mnemonicTable[53] = "addc ";
-  mcu->mnemonicTable[54] = "addc ";
-  mcu->mnemonicTable[55] = "addc ";
-  mcu->mnemonicTable[56] = "addc ";
-  mcu->mnemonicTable[57] = "addc ";
-  mcu->mnemonicTable[58] = "addc ";
-  mcu->mnemonicTable[59] = "addc ";
-  mcu->mnemonicTable[60] = "addc ";
-  mcu->mnemonicTable[61] = "addc ";
-  mcu->mnemonicTable[62] = "addc ";
-  mcu->mnemonicTable[63] = "addc ";
-  mcu->mnemonicTable[64] = "jc   ";
-  mcu->mnemonicTable[65] = "ajmp ";
-  mcu->mnemonicTable[66] = "orl  ";
-  mcu->mnemonicTable[67] = "orl  ";
-  mcu->mnemonicTable[68] = "orl  ";
-  mcu->mnemonicTable[69] = "orl  ";
-  mcu->mnemonicTable[70] = "orl  ";
-  mcu->mnemonicTable[71] = "orl  ";
-  mcu->mnemonicTable[72] = "orl  ";
-  mcu->mnemonicTable[73] = "orl  ";
-  mcu->mnemonicTable[74] = "orl  ";
-  mcu->mnemonicTable[75] = "orl  ";
-  mcu->mnemonicTable[76] = "orl  ";
-  mcu->mnemonicTable[77] = "orl  ";
-  mcu->mnemonicTable[78] = "orl  ";
-  mcu->mnemonicTable[79] = "orl  ";
-  mcu->mnemonicTable[80] = "jnc  ";
-  mcu->mnemonicTable[81] = "acall";
-  mcu->mnemonicTable[82] = "anl  ";
-  mcu->mnemonicTable[83] = "anl  ";
-  mcu->mnemonicTable[84] = "anl  ";
-  mcu->mnemonicTable[85] = "anl  ";
-  mcu->mnemonicTable[86] = "anl  ";
-  mcu->mnemonicTable[87] = "anl  ";
-  mcu->mnemonicTable[88] = "anl  ";
-  mcu->mnemonicTable[89] = "anl  ";
-  mcu->mnemonicTable[90] = "anl  ";
-  mcu->mnemonicTable[91] = "anl  ";
-  mcu->mnemonicTable[92] = "anl  ";
-  mcu->mnemonicTable[93] = "anl  ";
-  mcu->mnemonicTable[94] = "anl  ";
-  mcu->mnemonicTable[95] = "anl  ";
-  mcu->mnemonicTable[96] = "jz   ";
-  mcu->mnemonicTable[97] = "ajmp ";
-  mcu->mnemonicTable[98] = "xrl  ";
-  mcu->mnemonicTable[99] = "xrl  ";
-  mcu->mnemonicTable[100] = "xrl  ";
-  mcu->mnemonicTable[101] = "xrl  ";
-  mcu->mnemonicTable[102] = "xrl  ";
-  mcu->mnemonicTable[103] = "xrl  ";
-  mcu->mnemonicTable[104] = "xrl  ";
-  mcu->mnemonicTable[105] = "xrl  ";
-  mcu->mnemonicTable[106] = "xrl  ";
-  mcu->mnemonicTable[107] = "xrl  ";
-  mcu->mnemonicTable[108] = "xrl  ";
-  mcu->mnemonicTable[109] = "xrl  ";
-  mcu->mnemonicTable[110] = "xrl  ";
-  mcu->mnemonicTable[111] = "xrl  ";
-  mcu->mnemonicTable[112] = "jnz  ";
-  mcu->mnemonicTable[113] = "acall";
-  mcu->mnemonicTable[114] = "orl  ";
-  mcu->mnemonicTable[115] = "jmp  ";
-  mcu->mnemonicTable[116] = "mov  ";
-  mcu->mnemonicTable[117] = "mov  ";
-  mcu->mnemonicTable[118] = "mov  ";
-  mcu->mnemonicTable[119] = "mov  ";
-  mcu->mnemonicTable[120] = "mov  ";
-  mcu->mnemonicTable[121] = "mov  ";
-  mcu->mnemonicTable[122] = "mov  ";
-  mcu->mnemonicTable[123] = "mov  ";
-  mcu->mnemonicTable[124] = "mov  ";
-  mcu->mnemonicTable[125] = "mov  ";
-  mcu->mnemonicTable[126] = "mov  ";
-  mcu->mnemonicTable[127] = "mov  ";
-  mcu->mnemonicTable[128] = "sjmp ";
-  mcu->mnemonicTable[129] = "ajmp ";
-  mcu->mnemonicTable[130] = "anl  ";
-  mcu->mnemonicTable[131] = "movc ";
-  mcu->mnemonicTable[132] = "div  ";
-  mcu->mnemonicTable[133] = "mov  ";
-  mcu->mnemonicTable[134] = "mov  ";
-  mcu->mnemonicTable[135] = "mov  ";
-  mcu->mnemonicTable[136] = "mov  ";
-  mcu->mnemonicTable[137] = "mov  ";
-  mcu->mnemonicTable[138] = "mov  ";
-  mcu->mnemonicTable[139] = "mov  ";
-  mcu->mnemonicTable[140] = "mov  ";
-  mcu->mnemonicTable[141] = "mov  ";
-  mcu->mnemonicTable[142] = "mov  ";
-  mcu->mnemonicTable[143] = "mov  ";
-  mcu->mnemonicTable[144] = "mov  ";
-  mcu->mnemonicTable[145] = "acall";
-  mcu->mnemonicTable[146] = "mov  ";
-  mcu->mnemonicTable[147] = "movc ";
-  mcu->mnemonicTable[148] = "subb ";
-  mcu->mnemonicTable[149] = "subb ";
-  mcu->mnemonicTable[150] = "subb ";
-  mcu->mnemonicTable[151] = "subb ";
-  mcu->mnemonicTable[152] = "subb ";
-  mcu->mnemonicTable[153] = "subb ";
-  mcu->mnemonicTable[154] = "subb ";
-  mcu->mnemonicTable[155] = "subb ";
-  mcu->mnemonicTable[156] = "subb ";
-  mcu->mnemonicTable[157] = "subb ";
-  mcu->mnemonicTable[158] = "subb ";
-  mcu->mnemonicTable[159] = "subb ";
-  mcu->mnemonicTable[160] = "orl  ";
-  mcu->mnemonicTable[161] = "ajmp ";
-  mcu->mnemonicTable[162] = "mov  ";
-  mcu->mnemonicTable[163] = "inc  ";
-  mcu->mnemonicTable[164] = "mul  ";
-  mcu->mnemonicTable[165] = "RESVD";
-  mcu->mnemonicTable[166] = "mov  ";
-  mcu->mnemonicTable[167] = "mov  ";
-  mcu->mnemonicTable[168] = "mov  ";
-  mcu->mnemonicTable[169] = "mov  ";
-  mcu->mnemonicTable[170] = "mov  ";
-  mcu->mnemonicTable[171] = "mov  ";
-  mcu->mnemonicTable[172] = "mov  ";
-  mcu->mnemonicTable[173] = "mov  ";
-  mcu->mnemonicTable[174] = "mov  ";
-  mcu->mnemonicTable[175] = "mov  ";
-  mcu->mnemonicTable[176] = "anl  ";
-  mcu->mnemonicTable[177] = "acall";
-  mcu->mnemonicTable[178] = "cpl  ";
-  mcu->mnemonicTable[179] = "cpl  ";
-  mcu->mnemonicTable[180] = "cjne ";
-  mcu->mnemonicTable[181] = "cjne ";
-  mcu->mnemonicTable[182] = "cjne ";
-  mcu->mnemonicTable[183] = "cjne ";
-  mcu->mnemonicTable[184] = "cjne ";
-  mcu->mnemonicTable[185] = "cjne ";
-  mcu->mnemonicTable[186] = "cjne ";
-  mcu->mnemonicTable[187] = "cjne ";
-  mcu->mnemonicTable[188] = "cjne ";
-  mcu->mnemonicTable[189] = "cjne ";
-  mcu->mnemonicTable[190] = "cjne ";
-  mcu->mnemonicTable[191] = "cjne ";
-  mcu->mnemonicTable[192] = "push ";
-  mcu->mnemonicTable[193] = "ajmp ";
-  mcu->mnemonicTable[194] = "clr  ";
-  mcu->mnemonicTable[195] = "clr  ";
-  mcu->mnemonicTable[196] = "swap ";
-  mcu->mnemonicTable[197] = "xch  ";
-  mcu->mnemonicTable[198] = "xch  ";
-  mcu->mnemonicTable[199] = "xch  ";
-  mcu->mnemonicTable[200] = "xch  ";
-  mcu->mnemonicTable[201] = "xch  ";
-  mcu->mnemonicTable[202] = "xch  ";
-  mcu->mnemonicTable[203] = "xch  ";
-  mcu->mnemonicTable[204] = "xch  ";
-  mcu->mnemonicTable[205] = "xch  ";
-  mcu->mnemonicTable[206] = "xch  ";
-  mcu->mnemonicTable[207] = "xch  ";
-  mcu->mnemonicTable[208] = "pop  ";
-  mcu->mnemonicTable[209] = "acall";
-  mcu->mnemonicTable[210] = "setb ";
-  mcu->mnemonicTable[211] = "setb ";
-  mcu->mnemonicTable[212] = "da   ";
-  mcu->mnemonicTable[213] = "djnz ";
-  mcu->mnemonicTable[214] = "xchd ";
-  mcu->mnemonicTable[215] = "xchd ";
-  mcu->mnemonicTable[216] = "djnz ";
-  mcu->mnemonicTable[217] = "djnz ";
-  mcu->mnemonicTable[218] = "djnz ";
-  mcu->mnemonicTable[219] = "djnz ";
-  mcu->mnemonicTable[220] = "djnz ";
-  mcu->mnemonicTable[221] = "djnz ";
-  mcu->mnemonicTable[222] = "djnz ";
-  mcu->mnemonicTable[223] = "djnz ";
-  mcu->mnemonicTable[224] = "movx ";
-  mcu->mnemonicTable[225] = "ajmp ";
-  mcu->mnemonicTable[226] = "movx ";
-  mcu->mnemonicTable[227] = "movx ";
-  mcu->mnemonicTable[228] = "clr  ";
-  mcu->mnemonicTable[229] = "mov  ";
-  mcu->mnemonicTable[230] = "mov  ";
-  mcu->mnemonicTable[231] = "mov  ";
-  mcu->mnemonicTable[232] = "mov  ";
-  mcu->mnemonicTable[233] = "mov  ";
-  mcu->mnemonicTable[234] = "mov  ";
-  mcu->mnemonicTable[235] = "mov  ";
-  mcu->mnemonicTable[236] = "mov  ";
-  mcu->mnemonicTable[237] = "mov  ";
-  mcu->mnemonicTable[238] = "mov  ";
-  mcu->mnemonicTable[239] = "mov  ";
-  mcu->mnemonicTable[240] = "movx ";
-  mcu->mnemonicTable[241] = "acall";
-  mcu->mnemonicTable[242] = "movx ";
-  mcu->mnemonicTable[243] = "movx ";
-  mcu->mnemonicTable[244] = "cpl  ";
-  mcu->mnemonicTable[245] = "mov  ";
-  mcu->mnemonicTable[246] = "mov  ";
-  mcu->mnemonicTable[247] = "mov  ";
-  mcu->mnemonicTable[248] = "mov  ";
-  mcu->mnemonicTable[249] = "mov  ";
-  mcu->mnemonicTable[250] = "mov  ";
-  mcu->mnemonicTable[251] = "mov  ";
-  mcu->mnemonicTable[252] = "mov  ";
-  mcu->mnemonicTable[253] = "mov  ";
-  mcu->mnemonicTable[254] = "mov  ";
-  mcu->mnemonicTable[255] = "mov  ";
-
-  mcu->mnemonicParams[0] = "";
-  mcu->mnemonicParams[1] = "00N%1";
-  mcu->mnemonicParams[2] = "N%1N%2";
-  mcu->mnemonicParams[3] = "A";
-  mcu->mnemonicParams[4] = "A";
-  mcu->mnemonicParams[5] = "%1";
-  mcu->mnemonicParams[6] = "@R0";
-  mcu->mnemonicParams[7] = "@R1";
-  mcu->mnemonicParams[8] = "R0";
-  mcu->mnemonicParams[9] = "R1";
-  mcu->mnemonicParams[10] = "R2";
-  mcu->mnemonicParams[11] = "R3";
-  mcu->mnemonicParams[12] = "R4";
-  mcu->mnemonicParams[13] = "R5";
-  mcu->mnemonicParams[14] = "R6";
-  mcu->mnemonicParams[15] = "R7";
-  mcu->mnemonicParams[16] = "0%1, O%2";
-  mcu->mnemonicParams[17] = "00N%1";
-  mcu->mnemonicParams[18] = "N%1N%2";
-  mcu->mnemonicParams[19] = "A";
-  mcu->mnemonicParams[20] = "A";
-  mcu->mnemonicParams[21] = "%1";
-  mcu->mnemonicParams[22] = "@R0";
-  mcu->mnemonicParams[23] = "@R1";
-  mcu->mnemonicParams[24] = "R0";
-  mcu->mnemonicParams[25] = "R1";
-  mcu->mnemonicParams[26] = "R2";
-  mcu->mnemonicParams[27] = "R3";
-  mcu->mnemonicParams[28] = "R4";
-  mcu->mnemonicParams[29] = "R5";
-  mcu->mnemonicParams[30] = "R6";
-  mcu->mnemonicParams[31] = "R7";
-  mcu->mnemonicParams[32] = "0%1, O%2";
-  mcu->mnemonicParams[33] = "01N%1";
-  mcu->mnemonicParams[34] = "";
-  mcu->mnemonicParams[35] = "A";
-  mcu->mnemonicParams[36] = "A, #%1";
-  mcu->mnemonicParams[37] = "A, %1";
-  mcu->mnemonicParams[38] = "A, @R0";
-  mcu->mnemonicParams[39] = "A, @R1";
-  mcu->mnemonicParams[40] = "A, R0";
-  mcu->mnemonicParams[41] = "A, R1";
-  mcu->mnemonicParams[42] = "A, R2";
-  mcu->mnemonicParams[43] = "A, R3";
-  mcu->mnemonicParams[44] = "A, R4";
-  mcu->mnemonicParams[45] = "A, R5";
-  mcu->mnemonicParams[46] = "A, R6";
-  mcu->mnemonicParams[47] = "A, R7";
-  mcu->mnemonicParams[48] = "0%1, O%2";
-  mcu->mnemonicParams[49] = "01N%1";
-  mcu->mnemonicParams[50] = "";
-  mcu->mnemonicParams[51] = "A";
-  mcu->mnemonicParams[52] = "A, #%1";
-  mcu->mnemonicParams[53] = "A, %1";
-  mcu->mnemonicParams[54] = "A, @R0";
-  mcu->mnemonicParams[55] = "A, @R1";
-  mcu->mnemonicParams[56] = "A, R0";
-  mcu->mnemonicParams[57] = "A, R1";
-  mcu->mnemonicParams[58] = "A, R2";
-  mcu->mnemonicParams[59] = "A, R3";
-  mcu->mnemonicParams[60] = "A, R4";
-  mcu->mnemonicParams[61] = "A, R5";
-  mcu->mnemonicParams[62] = "A, R6";
-  mcu->mnemonicParams[63] = "A, R7";
-  mcu->mnemonicParams[64] = "O%1";
-  mcu->mnemonicParams[65] = "02N%1";
-  mcu->mnemonicParams[66] = "%1, A";
-  mcu->mnemonicParams[67] = "%1, #%2";
-  mcu->mnemonicParams[68] = "A, #%1";
-  mcu->mnemonicParams[69] = "A, %1";
-  mcu->mnemonicParams[70] = "A, @R0";
-  mcu->mnemonicParams[71] = "A, @R1";
-  mcu->mnemonicParams[72] = "A, R0";
-  mcu->mnemonicParams[73] = "A, R1";
-  mcu->mnemonicParams[74] = "A, R2";
-  mcu->mnemonicParams[75] = "A, R3";
-  mcu->mnemonicParams[76] = "A, R4";
-  mcu->mnemonicParams[77] = "A, R5";
-  mcu->mnemonicParams[78] = "A, R6";
-  mcu->mnemonicParams[79] = "A, R7";
-  mcu->mnemonicParams[80] = "O%1";
-  mcu->mnemonicParams[81] = "02N%1";
-  mcu->mnemonicParams[82] = "%1, A";
-  mcu->mnemonicParams[83] = "%1, #%2";
-  mcu->mnemonicParams[84] = "A, #%1";
-  mcu->mnemonicParams[85] = "A, %1";
-  mcu->mnemonicParams[86] = "A, @R0";
-  mcu->mnemonicParams[87] = "A, @R1";
-  mcu->mnemonicParams[88] = "A, R0";
-  mcu->mnemonicParams[89] = "A, R1";
-  mcu->mnemonicParams[90] = "A, R2";
-  mcu->mnemonicParams[91] = "A, R3";
-  mcu->mnemonicParams[92] = "A, R4";
-  mcu->mnemonicParams[93] = "A, R5";
-  mcu->mnemonicParams[94] = "A, R6";
-  mcu->mnemonicParams[95] = "A, R7";
-  mcu->mnemonicParams[96] = "O%1";
-  mcu->mnemonicParams[97] = "03N%1";
-  mcu->mnemonicParams[98] = "%1, A";
-  mcu->mnemonicParams[99] = "%1, #%2";
-  mcu->mnemonicParams[100] = "A, #%1";
-  mcu->mnemonicParams[101] = "A, %1";
-  mcu->mnemonicParams[102] = "A, @R0";
-  mcu->mnemonicParams[103] = "A, @R1";
-  mcu->mnemonicParams[104] = "A, R0";
-  mcu->mnemonicParams[105] = "A, R1";
-  mcu->mnemonicParams[106] = "A, R2";
-  mcu->mnemonicParams[107] = "A, R3";
-  mcu->mnemonicParams[108] = "A, R4";
-  mcu->mnemonicParams[109] = "A, R5";
-  mcu->mnemonicParams[110] = "A, R6";
-  mcu->mnemonicParams[111] = "A, R7";
-  mcu->mnemonicParams[112] = "O%1";
-  mcu->mnemonicParams[113] = "03N%1";
-  mcu->mnemonicParams[114] = "C, 0%1";
-  mcu->mnemonicParams[115] = "@A+DPTR";
-  mcu->mnemonicParams[116] = "A, #%1";
-  mcu->mnemonicParams[117] = "%1, #%2";
-  mcu->mnemonicParams[118] = "@R0, #%1";
-  mcu->mnemonicParams[119] = "@R1, #%1";
-  mcu->mnemonicParams[120] = "R0, #%1";
-  mcu->mnemonicParams[121] = "R1, #%1";
-  mcu->mnemonicParams[122] = "R2, #%1";
-  mcu->mnemonicParams[123] = "R3, #%1";
-  mcu->mnemonicParams[124] = "R4, #%1";
-  mcu->mnemonicParams[125] = "R5, #%1";
-  mcu->mnemonicParams[126] = "R6, #%1";
-  mcu->mnemonicParams[127] = "R7, #%1";
-  mcu->mnemonicParams[128] = "O%1";
-  mcu->mnemonicParams[129] = "04N%1";
-  mcu->mnemonicParams[130] = "C, 0%1";
-  mcu->mnemonicParams[131] = "A, @A+PC";
-  mcu->mnemonicParams[132] = "AB";
-  mcu->mnemonicParams[133] = "%2, %1";
-  mcu->mnemonicParams[134] = "%1, @R0";
-  mcu->mnemonicParams[135] = "%1, @R1";
-  mcu->mnemonicParams[136] = "%1, R0";
-  mcu->mnemonicParams[137] = "%1, R1";
-  mcu->mnemonicParams[138] = "%1, R2";
-  mcu->mnemonicParams[139] = "%1, R3";
-  mcu->mnemonicParams[140] = "%1, R4";
-  mcu->mnemonicParams[141] = "%1, R5";
-  mcu->mnemonicParams[142] = "%1, R6";
-  mcu->mnemonicParams[143] = "%1, R7";
-  mcu->mnemonicParams[144] = "DPTR, #N%1N%2";
-  mcu->mnemonicParams[145] = "04N%1";
-  mcu->mnemonicParams[146] = "0%1, C";
-  mcu->mnemonicParams[147] = "A, @A+DPTR";
-  mcu->mnemonicParams[148] = "A, #%1";
-  mcu->mnemonicParams[149] = "A, %1";
-  mcu->mnemonicParams[150] = "A, @R0";
-  mcu->mnemonicParams[151] = "A, @R1";
-  mcu->mnemonicParams[152] = "A, R0";
-  mcu->mnemonicParams[153] = "A, R1";
-  mcu->mnemonicParams[154] = "A, R2";
-  mcu->mnemonicParams[155] = "A, R3";
-  mcu->mnemonicParams[156] = "A, R4";
-  mcu->mnemonicParams[157] = "A, R5";
-  mcu->mnemonicParams[158] = "A, R6";
-  mcu->mnemonicParams[159] = "A, R7";
-  mcu->mnemonicParams[160] = "C, /0%1";
-  mcu->mnemonicParams[161] = "05N%1";
-  mcu->mnemonicParams[162] = "C, 0%1";
-  mcu->mnemonicParams[163] = "DPTR";
-  mcu->mnemonicParams[164] = "AB";
-  mcu->mnemonicParams[165] = "";
-  mcu->mnemonicParams[166] = "@R0, %1";
-  mcu->mnemonicParams[167] = "@R1, %1";
-  mcu->mnemonicParams[168] = "R0, %1";
-  mcu->mnemonicParams[169] = "R1, %1";
-  mcu->mnemonicParams[170] = "R2, %1";
-  mcu->mnemonicParams[171] = "R3, %1";
-  mcu->mnemonicParams[172] = "R4, %1";
-  mcu->mnemonicParams[173] = "R5, %1";
-  mcu->mnemonicParams[174] = "R6, %1";
-  mcu->mnemonicParams[175] = "R7, %1";
-  mcu->mnemonicParams[176] = "C, /0%1";
-  mcu->mnemonicParams[177] = "05N%1";
-  mcu->mnemonicParams[178] = "0%1";
-  mcu->mnemonicParams[179] = "C";
-  mcu->mnemonicParams[180] = "A, #%1, O%2";
-  mcu->mnemonicParams[181] = "A, %1, O%2";
-  mcu->mnemonicParams[182] = "@R0, #%1, O%2";
-  mcu->mnemonicParams[183] = "@R1, #%1, O%2";
-  mcu->mnemonicParams[184] = "R0, #%1, O%2";
-  mcu->mnemonicParams[185] = "R1, #%1, O%2";
-  mcu->mnemonicParams[186] = "R2, #%1, O%2";
-  mcu->mnemonicParams[187] = "R3, #%1, O%2";
-  mcu->mnemonicParams[188] = "R4, #%1, O%2";
-  mcu->mnemonicParams[189] = "R5, #%1, O%2";
-  mcu->mnemonicParams[190] = "R6, #%1, O%2";
-  mcu->mnemonicParams[191] = "R7, #%1, O%2";
-  mcu->mnemonicParams[192] = "%1";
-  mcu->mnemonicParams[193] = "06N%1";
-  mcu->mnemonicParams[194] = "0%1";
-  mcu->mnemonicParams[195] = "C";
-  mcu->mnemonicParams[196] = "A";
-  mcu->mnemonicParams[197] = "A, %1";
-  mcu->mnemonicParams[198] = "A, @R0";
-  mcu->mnemonicParams[199] = "A, @R1";
-  mcu->mnemonicParams[200] = "A, R0";
-  mcu->mnemonicParams[201] = "A, R1";
-  mcu->mnemonicParams[202] = "A, R2";
-  mcu->mnemonicParams[203] = "A, R3";
-  mcu->mnemonicParams[204] = "A, R4";
-  mcu->mnemonicParams[205] = "A, R5";
-  mcu->mnemonicParams[206] = "A, R6";
-  mcu->mnemonicParams[207] = "A, R7";
-  mcu->mnemonicParams[208] = "%1";
-  mcu->mnemonicParams[209] = "06N%1";
-  mcu->mnemonicParams[210] = "0%1";
-  mcu->mnemonicParams[211] = "C";
-  mcu->mnemonicParams[212] = "A";
-  mcu->mnemonicParams[213] = "%1, O%2";
-  mcu->mnemonicParams[214] = "A, @R0";
-  mcu->mnemonicParams[215] = "A, @R1";
-  mcu->mnemonicParams[216] = "R0, O%1";
-  mcu->mnemonicParams[217] = "R1, O%1";
-  mcu->mnemonicParams[218] = "R2, O%1";
-  mcu->mnemonicParams[219] = "R3, O%1";
-  mcu->mnemonicParams[220] = "R4, O%1";
-  mcu->mnemonicParams[221] = "R5, O%1";
-  mcu->mnemonicParams[222] = "R6, O%1";
-  mcu->mnemonicParams[223] = "R7, O%1";
-  mcu->mnemonicParams[224] = "A, @DPTR";
-  mcu->mnemonicParams[225] = "07N%1";
-  mcu->mnemonicParams[226] = "A, @R0";
-  mcu->mnemonicParams[227] = "A, @R1";
-  mcu->mnemonicParams[228] = "A";
-  mcu->mnemonicParams[229] = "A, %1";
-  mcu->mnemonicParams[230] = "A, @R0";
-  mcu->mnemonicParams[231] = "A, @R1";
-  mcu->mnemonicParams[232] = "A, R0";
-  mcu->mnemonicParams[233] = "A, R1";
-  mcu->mnemonicParams[234] = "A, R2";
-  mcu->mnemonicParams[235] = "A, R3";
-  mcu->mnemonicParams[236] = "A, R4";
-  mcu->mnemonicParams[237] = "A, R5";
-  mcu->mnemonicParams[238] = "A, R6";
-  mcu->mnemonicParams[239] = "A, R7";
-  mcu->mnemonicParams[240] = "@DPTR, A";
-  mcu->mnemonicParams[241] = "07N%1";
-  mcu->mnemonicParams[242] = "@R0, A";
-  mcu->mnemonicParams[243] = "@R1, A";
-  mcu->mnemonicParams[244] = "A";
-  mcu->mnemonicParams[245] = "%1, A";
-  mcu->mnemonicParams[246] = "@R0, A";
-  mcu->mnemonicParams[247] = "@R1, A";
-  mcu->mnemonicParams[248] = "R0, A";
-  mcu->mnemonicParams[249] = "R1, A";
-  mcu->mnemonicParams[250] = "R2, A";
-  mcu->mnemonicParams[251] = "R3, A";
-  mcu->mnemonicParams[252] = "R4, A";
-  mcu->mnemonicParams[253] = "R5, A";
-  mcu->mnemonicParams[254] = "R6, A";
-  mcu->mnemonicParams[255] = "R7, A";
-
-  mcu->SFRNames[0] = "00h";
-  mcu->SFRNames[1] = "01h";
-  mcu->SFRNames[2] = "02h";
-  mcu->SFRNames[3] = "03h";
-  mcu->SFRNames[4] = "04h";
-  mcu->SFRNames[5] = "05h";
-  mcu->SFRNames[6] = "06h";
-  mcu->SFRNames[7] = "07h";
-  mcu->SFRNames[8] = "08h";
-  mcu->SFRNames[9] = "09h";
-  mcu->SFRNames[10] = "0Ah";
-  mcu->SFRNames[11] = "0Bh";
-  mcu->SFRNames[12] = "0Ch";
-  mcu->SFRNames[13] = "0Dh";
-  mcu->SFRNames[14] = "0Eh";
-  mcu->SFRNames[15] = "0Fh";
-  mcu->SFRNames[16] = "10h";
-  mcu->SFRNames[17] = "11h";
-  mcu->SFRNames[18] = "12h";
-  mcu->SFRNames[19] = "13h";
-  mcu->SFRNames[20] = "14h";
-  mcu->SFRNames[21] = "15h";
-  mcu->SFRNames[22] = "16h";
-  mcu->SFRNames[23] = "17h";
-  mcu->SFRNames[24] = "18h";
-  mcu->SFRNames[25] = "19h";
-  mcu->SFRNames[26] = "1Ah";
-  mcu->SFRNames[27] = "1Bh";
-  mcu->SFRNames[28] = "1Ch";
-  mcu->SFRNames[29] = "1Dh";
-  mcu->SFRNames[30] = "1Eh";
-  mcu->SFRNames[31] = "1Fh";
-  mcu->SFRNames[32] = "20h";
-  mcu->SFRNames[33] = "21h";
-  mcu->SFRNames[34] = "22h";
-  mcu->SFRNames[35] = "23h";
-  mcu->SFRNames[36] = "24h";
-  mcu->SFRNames[37] = "25h";
-  mcu->SFRNames[38] = "26h";
-  mcu->SFRNames[39] = "27h";
-  mcu->SFRNames[40] = "28h";
-  mcu->SFRNames[41] = "29h";
-  mcu->SFRNames[42] = "2Ah";
-  mcu->SFRNames[43] = "2Bh";
-  mcu->SFRNames[44] = "2Ch";
-  mcu->SFRNames[45] = "2Dh";
-  mcu->SFRNames[46] = "2Eh";
-  mcu->SFRNames[47] = "2Fh";
-  mcu->SFRNames[48] = "30h";
-  mcu->SFRNames[49] = "31h";
-  mcu->SFRNames[50] = "32h";
-  mcu->SFRNames[51] = "33h";
-  mcu->SFRNames[52] = "34h";
-  mcu->SFRNames[53] = "35h";
-  mcu->SFRNames[54] = "36h";
-  mcu->SFRNames[55] = "37h";
-  mcu->SFRNames[56] = "38h";
-  mcu->SFRNames[57] = "39h";
-  mcu->SFRNames[58] = "3Ah";
-  mcu->SFRNames[59] = "3Bh";
-  mcu->SFRNames[60] = "3Ch";
-  mcu->SFRNames[61] = "3Dh";
-  mcu->SFRNames[62] = "3Eh";
-  mcu->SFRNames[63] = "3Fh";
-  mcu->SFRNames[64] = "40h";
-  mcu->SFRNames[65] = "41h";
-  mcu->SFRNames[66] = "42h";
-  mcu->SFRNames[67] = "43h";
-  mcu->SFRNames[68] = "44h";
-  mcu->SFRNames[69] = "45h";
-  mcu->SFRNames[70] = "46h";
-  mcu->SFRNames[71] = "47h";
-  mcu->SFRNames[72] = "48h";
-  mcu->SFRNames[73] = "49h";
-  mcu->SFRNames[74] = "4Ah";
-  mcu->SFRNames[75] = "4Bh";
-  mcu->SFRNames[76] = "4Ch";
-  mcu->SFRNames[77] = "4Dh";
-  mcu->SFRNames[78] = "4Eh";
-  mcu->SFRNames[79] = "4Fh";
-  mcu->SFRNames[80] = "50h";
-  mcu->SFRNames[81] = "51h";
-  mcu->SFRNames[82] = "52h";
-  mcu->SFRNames[83] = "53h";
-  mcu->SFRNames[84] = "54h";
-  mcu->SFRNames[85] = "55h";
-  mcu->SFRNames[86] = "56h";
-  mcu->SFRNames[87] = "57h";
-  mcu->SFRNames[88] = "58h";
-  mcu->SFRNames[89] = "59h";
-  mcu->SFRNames[90] = "5Ah";
-  mcu->SFRNames[91] = "5Bh";
-  mcu->SFRNames[92] = "5Ch";
-  mcu->SFRNames[93] = "5Dh";
-  mcu->SFRNames[94] = "5Eh";
-  mcu->SFRNames[95] = "5Fh";
-  mcu->SFRNames[96] = "60h";
-  mcu->SFRNames[97] = "61h";
-  mcu->SFRNames[98] = "62h";
-  mcu->SFRNames[99] = "63h";
-  mcu->SFRNames[100] = "64h";
-  mcu->SFRNames[101] = "65h";
-  mcu->SFRNames[102] = "66h";
-  mcu->SFRNames[103] = "67h";
-  mcu->SFRNames[104] = "68h";
-  mcu->SFRNames[105] = "69h";
-  mcu->SFRNames[106] = "6Ah";
-  mcu->SFRNames[107] = "6Bh";
-  mcu->SFRNames[108] = "6Ch";
-  mcu->SFRNames[109] = "6Dh";
-  mcu->SFRNames[110] = "6Eh";
-  mcu->SFRNames[111] = "6Fh";
-  mcu->SFRNames[112] = "70h";
-  mcu->SFRNames[113] = "71h";
-  mcu->SFRNames[114] = "72h";
-  mcu->SFRNames[115] = "73h";
-  mcu->SFRNames[116] = "74h";
-  mcu->SFRNames[117] = "75h";
-  mcu->SFRNames[118] = "76h";
-  mcu->SFRNames[119] = "77h";
-  mcu->SFRNames[120] = "78h";
-  mcu->SFRNames[121] = "79h";
-  mcu->SFRNames[122] = "7Ah";
-  mcu->SFRNames[123] = "7Bh";
-  mcu->SFRNames[124] = "7Ch";
-  mcu->SFRNames[125] = "7Dh";
-  mcu->SFRNames[126] = "7Eh";
-  mcu->SFRNames[127] = "7Fh";
-  mcu->SFRNames[128] = "P0";
-  mcu->SFRNames[129] = "SP";
-  mcu->SFRNames[130] = "DPL";
-  mcu->SFRNames[131] = "DPh";
-  mcu->SFRNames[132] = "84h";
-  mcu->SFRNames[133] = "85h";
-  mcu->SFRNames[134] = "86h";
-  mcu->SFRNames[135] = "PCON";
-  mcu->SFRNames[136] = "TCON";
-  mcu->SFRNames[137] = "TMOD";
-  mcu->SFRNames[138] = "TL0";
-  mcu->SFRNames[139] = "TL1";
-  mcu->SFRNames[140] = "Th0";
-  mcu->SFRNames[141] = "Th1";
-  mcu->SFRNames[142] = "8Eh";
-  mcu->SFRNames[143] = "8Fh";
-  mcu->SFRNames[144] = "P1";
-  mcu->SFRNames[145] = "91h";
-  mcu->SFRNames[146] = "92h";
-  mcu->SFRNames[147] = "93h";
-  mcu->SFRNames[148] = "94h";
-  mcu->SFRNames[149] = "95h";
-  mcu->SFRNames[150] = "96h";
-  mcu->SFRNames[151] = "97h";
-  mcu->SFRNames[152] = "SCON";
-  mcu->SFRNames[153] = "SBUF";
-  mcu->SFRNames[154] = "9Ah";
-  mcu->SFRNames[155] = "9Bh";
-  mcu->SFRNames[156] = "9Ch";
-  mcu->SFRNames[157] = "9Dh";
-  mcu->SFRNames[158] = "9Eh";
-  mcu->SFRNames[159] = "9Fh";
-  mcu->SFRNames[160] = "P2";
-  mcu->SFRNames[161] = "A1h";
-  mcu->SFRNames[162] = "A2h";
-  mcu->SFRNames[163] = "A3h";
-  mcu->SFRNames[164] = "A4h";
-  mcu->SFRNames[165] = "A5h";
-  mcu->SFRNames[166] = "A6h";
-  mcu->SFRNames[167] = "A7h";
-  mcu->SFRNames[168] = "IE";
-  mcu->SFRNames[169] = "A9h";
-  mcu->SFRNames[170] = "AAh";
-  mcu->SFRNames[171] = "ABh";
-  mcu->SFRNames[172] = "ACh";
-  mcu->SFRNames[173] = "ADh";
-  mcu->SFRNames[174] = "AEh";
-  mcu->SFRNames[175] = "AFh";
-  mcu->SFRNames[176] = "P3";
-  mcu->SFRNames[177] = "B1h";
-  mcu->SFRNames[178] = "B2h";
-  mcu->SFRNames[179] = "B3h";
-  mcu->SFRNames[180] = "B4h";
-  mcu->SFRNames[181] = "B5h";
-  mcu->SFRNames[182] = "B6h";
-  mcu->SFRNames[183] = "B7h";
-  mcu->SFRNames[184] = "IP";
-  mcu->SFRNames[185] = "B9h";
-  mcu->SFRNames[186] = "BAh";
-  mcu->SFRNames[187] = "BBh";
-  mcu->SFRNames[188] = "BCh";
-  mcu->SFRNames[189] = "BDh";
-  mcu->SFRNames[190] = "BEh";
-  mcu->SFRNames[191] = "BFh";
-  mcu->SFRNames[192] = "C0h";
-  mcu->SFRNames[193] = "C1h";
-  mcu->SFRNames[194] = "C2h";
-  mcu->SFRNames[195] = "C3h";
-  mcu->SFRNames[196] = "C4h";
-  mcu->SFRNames[197] = "C5h";
-  mcu->SFRNames[198] = "C6h";
-  mcu->SFRNames[199] = "C7h";
-  mcu->SFRNames[200] = "C8h";
-  mcu->SFRNames[201] = "C9h";
-  mcu->SFRNames[202] = "CAh";
-  mcu->SFRNames[203] = "CBh";
-  mcu->SFRNames[204] = "CCh";
-  mcu->SFRNames[205] = "CDh";
-  mcu->SFRNames[206] = "CEh";
-  mcu->SFRNames[207] = "CFh";
-  mcu->SFRNames[208] = "PSW";
-  mcu->SFRNames[209] = "D1h";
-  mcu->SFRNames[210] = "D2h";
-  mcu->SFRNames[211] = "D3h";
-  mcu->SFRNames[212] = "D4h";
-  mcu->SFRNames[213] = "D5h";
-  mcu->SFRNames[214] = "D6h";
-  mcu->SFRNames[215] = "D7h";
-  mcu->SFRNames[216] = "D8h";
-  mcu->SFRNames[217] = "D9h";
-  mcu->SFRNames[218] = "DAh";
-  mcu->SFRNames[219] = "DBh";
-  mcu->SFRNames[220] = "DCh";
-  mcu->SFRNames[221] = "DDh";
-  mcu->SFRNames[222] = "DEh";
-  mcu->SFRNames[223] = "DFh";
-  mcu->SFRNames[224] = "ACC";
-  mcu->SFRNames[225] = "E1h";
-  mcu->SFRNames[226] = "E2h";
-  mcu->SFRNames[227] = "E3h";
-  mcu->SFRNames[228] = "E4h";
-  mcu->SFRNames[229] = "E5h";
-  mcu->SFRNames[230] = "E6h";
-  mcu->SFRNames[231] = "E7h";
-  mcu->SFRNames[232] = "E8h";
-  mcu->SFRNames[233] = "E9h";
-  mcu->SFRNames[234] = "EAh";
-  mcu->SFRNames[235] = "EBh";
-  mcu->SFRNames[236] = "ECh";
-  mcu->SFRNames[237] = "EDh";
-  mcu->SFRNames[238] = "EEh";
-  mcu->SFRNames[239] = "EFh";
-  mcu->SFRNames[240] = "B";
-  mcu->SFRNames[241] = "F1h";
-  mcu->SFRNames[242] = "F2h";
-  mcu->SFRNames[243] = "F3h";
-  mcu->SFRNames[244] = "F4h";
-  mcu->SFRNames[245] = "F5h";
-  mcu->SFRNames[246] = "F6h";
-  mcu->SFRNames[247] = "F7h";
-  mcu->SFRNames[248] = "F8h";
-  mcu->SFRNames[249] = "F9h";
-  mcu->SFRNames[250] = "FAh";
-  mcu->SFRNames[251] = "FBh";
-  mcu->SFRNames[252] = "FCh";
-  mcu->SFRNames[253] = "FDh";
-  mcu->SFRNames[254] = "FEh";
-  mcu->SFRNames[255] = "FFh";
-
-  mcu->SFRBits[0] = "20h.1";
-  mcu->SFRBits[1] = "20h.1";
-  mcu->SFRBits[2] = "20h.2";
-  mcu->SFRBits[3] = "20h.3";
-  mcu->SFRBits[4] = "20h.4";
-  mcu->SFRBits[5] = "20h.5";
-  mcu->SFRBits[6] = "20h.6";
-  mcu->SFRBits[7] = "20h.7";
-  mcu->SFRBits[8] = "21h.0";
-  mcu->SFRBits[9] = "21h.1";
-  mcu->SFRBits[10] = "21h.2";
-  mcu->SFRBits[11] = "21h.3";
-  mcu->SFRBits[12] = "21h.4";
-  mcu->SFRBits[13] = "21h.5";
-  mcu->SFRBits[14] = "21h.6";
-  mcu->SFRBits[15] = "21h.7";
-  mcu->SFRBits[16] = "22h.0";
-  mcu->SFRBits[17] = "22h.1";
-  mcu->SFRBits[18] = "22h.2";
-  mcu->SFRBits[19] = "22h.3";
-  mcu->SFRBits[20] = "22h.4";
-  mcu->SFRBits[21] = "22h.5";
-  mcu->SFRBits[22] = "22h.6";
-  mcu->SFRBits[23] = "22h.7";
-  mcu->SFRBits[24] = "23h.0";
-  mcu->SFRBits[25] = "23h.1";
-  mcu->SFRBits[26] = "23h.2";
-  mcu->SFRBits[27] = "23h.3";
-  mcu->SFRBits[28] = "23h.4";
-  mcu->SFRBits[29] = "23h.5";
-  mcu->SFRBits[30] = "23h.6";
-  mcu->SFRBits[31] = "23h.7";
-  mcu->SFRBits[32] = "24h.0";
-  mcu->SFRBits[33] = "24h.1";
-  mcu->SFRBits[34] = "24h.2";
-  mcu->SFRBits[35] = "24h.3";
-  mcu->SFRBits[36] = "24h.4";
-  mcu->SFRBits[37] = "24h.5";
-  mcu->SFRBits[38] = "24h.6";
-  mcu->SFRBits[39] = "24h.7";
-  mcu->SFRBits[40] = "25h.0";
-  mcu->SFRBits[41] = "25h.1";
-  mcu->SFRBits[42] = "25h.2";
-  mcu->SFRBits[43] = "25h.3";
-  mcu->SFRBits[44] = "25h.4";
-  mcu->SFRBits[45] = "25h.5";
-  mcu->SFRBits[46] = "25h.6";
-  mcu->SFRBits[47] = "25h.7";
-  mcu->SFRBits[48] = "26h.0";
-  mcu->SFRBits[49] = "26h.1";
-  mcu->SFRBits[50] = "26h.2";
-  mcu->SFRBits[51] = "26h.3";
-  mcu->SFRBits[52] = "26h.4";
-  mcu->SFRBits[53] = "26h.5";
-  mcu->SFRBits[54] = "26h.6";
-  mcu->SFRBits[55] = "26h.7";
-  mcu->SFRBits[56] = "27h.0";
-  mcu->SFRBits[57] = "27h.1";
-  mcu->SFRBits[58] = "27h.2";
-  mcu->SFRBits[59] = "27h.3";
-  mcu->SFRBits[60] = "27h.4";
-  mcu->SFRBits[61] = "27h.5";
-  mcu->SFRBits[62] = "27h.6";
-  mcu->SFRBits[63] = "27h.7";
-  mcu->SFRBits[64] = "28h.0";
-  mcu->SFRBits[65] = "28h.1";
-  mcu->SFRBits[66] = "28h.2";
-  mcu->SFRBits[67] = "28h.3";
-  mcu->SFRBits[68] = "28h.4";
-  mcu->SFRBits[69] = "28h.5";
-  mcu->SFRBits[70] = "28h.6";
-  mcu->SFRBits[71] = "28h.7";
-  mcu->SFRBits[72] = "29h.0";
-  mcu->SFRBits[73] = "29h.1";
-  mcu->SFRBits[74] = "29h.2";
-  mcu->SFRBits[75] = "29h.3";
-  mcu->SFRBits[76] = "29h.4";
-  mcu->SFRBits[77] = "29h.5";
-  mcu->SFRBits[78] = "29h.6";
-  mcu->SFRBits[79] = "29h.7";
-  mcu->SFRBits[80] = "2Ah.0";
-  mcu->SFRBits[81] = "2Ah.1";
-  mcu->SFRBits[82] = "2Ah.2";
-  mcu->SFRBits[83] = "2Ah.3";
-  mcu->SFRBits[84] = "2Ah.4";
-  mcu->SFRBits[85] = "2Ah.5";
-  mcu->SFRBits[86] = "2Ah.6";
-  mcu->SFRBits[87] = "2Ah.7";
-  mcu->SFRBits[88] = "2Bh.0";
-  mcu->SFRBits[89] = "2Bh.1";
-  mcu->SFRBits[90] = "2Bh.2";
-  mcu->SFRBits[91] = "2Bh.3";
-  mcu->SFRBits[92] = "2Bh.4";
-  mcu->SFRBits[93] = "2Bh.5";
-  mcu->SFRBits[94] = "2Bh.6";
-  mcu->SFRBits[95] = "2Bh.7";
-  mcu->SFRBits[96] = "2Ch.0";
-  mcu->SFRBits[97] = "2Ch.1";
-  mcu->SFRBits[98] = "2Ch.2";
-  mcu->SFRBits[99] = "2Ch.3";
-  mcu->SFRBits[100] = "2Ch.4";
-  mcu->SFRBits[101] = "2Ch.5";
-  mcu->SFRBits[102] = "2Ch.6";
-  mcu->SFRBits[103] = "2Ch.7";
-  mcu->SFRBits[104] = "2Dh.0";
-  mcu->SFRBits[105] = "2Dh.1";
-  mcu->SFRBits[106] = "2Dh.2";
-  mcu->SFRBits[107] = "2Dh.3";
-  mcu->SFRBits[108] = "2Dh.4";
-  mcu->SFRBits[109] = "2Dh.5";
-  mcu->SFRBits[110] = "2Dh.6";
-  mcu->SFRBits[111] = "2Dh.7";
-  mcu->SFRBits[112] = "2Eh.0";
-  mcu->SFRBits[113] = "2Eh.1";
-  mcu->SFRBits[114] = "2Eh.2";
-  mcu->SFRBits[115] = "2Eh.3";
-  mcu->SFRBits[116] = "2Eh.4";
-  mcu->SFRBits[117] = "2Eh.5";
-  mcu->SFRBits[118] = "2Eh.6";
-  mcu->SFRBits[119] = "2Eh.7";
-  mcu->SFRBits[120] = "2Fh.0";
-  mcu->SFRBits[121] = "2Fh.1";
-  mcu->SFRBits[122] = "2Fh.2";
-  mcu->SFRBits[123] = "2Fh.3";
-  mcu->SFRBits[124] = "2Fh.4";
-  mcu->SFRBits[125] = "2Fh.5";
-  mcu->SFRBits[126] = "2Fh.6";
-  mcu->SFRBits[127] = "2Fh.7";
-  mcu->SFRBits[128] = "P0.0";
-  mcu->SFRBits[129] = "P0.1";
-  mcu->SFRBits[130] = "P0.2";
-  mcu->SFRBits[131] = "P0.3";
-  mcu->SFRBits[132] = "P0.4";
-  mcu->SFRBits[133] = "P0.5";
-  mcu->SFRBits[134] = "P0.6";
-  mcu->SFRBits[135] = "P0.7";
-  mcu->SFRBits[136] = "IT0";
-  mcu->SFRBits[137] = "IE0";
-  mcu->SFRBits[138] = "IT1";
-  mcu->SFRBits[139] = "IE1";
-  mcu->SFRBits[140] = "TR0";
-  mcu->SFRBits[141] = "TF0";
-  mcu->SFRBits[142] = "TR1";
-  mcu->SFRBits[143] = "TF1";
-  mcu->SFRBits[144] = "P1.0";
-  mcu->SFRBits[145] = "P1.1";
-  mcu->SFRBits[146] = "P1.2";
-  mcu->SFRBits[147] = "P1.3";
-  mcu->SFRBits[148] = "P1.4";
-  mcu->SFRBits[149] = "P1.5";
-  mcu->SFRBits[150] = "P1.6";
-  mcu->SFRBits[151] = "P1.7";
-  mcu->SFRBits[152] = "RI";
-  mcu->SFRBits[153] = "TI";
-  mcu->SFRBits[154] = "RB8";
-  mcu->SFRBits[155] = "TB8";
-  mcu->SFRBits[156] = "REN";
-  mcu->SFRBits[157] = "SM2";
-  mcu->SFRBits[158] = "SM1";
-  mcu->SFRBits[159] = "SM0";
-  mcu->SFRBits[160] = "P2.0";
-  mcu->SFRBits[161] = "P2.1";
-  mcu->SFRBits[162] = "P2.2";
-  mcu->SFRBits[163] = "P2.3";
-  mcu->SFRBits[164] = "P2.4";
-  mcu->SFRBits[165] = "P2.5";
-  mcu->SFRBits[166] = "P2.6";
-  mcu->SFRBits[167] = "P2.7";
-  mcu->SFRBits[168] = "EX0";
-  mcu->SFRBits[169] = "ET0";
-  mcu->SFRBits[170] = "EX1";
-  mcu->SFRBits[171] = "ET1";
-  mcu->SFRBits[172] = "ES";
-  mcu->SFRBits[173] = "IE.5";
-  mcu->SFRBits[174] = "IE.6";
-  mcu->SFRBits[175] = "EA";
-  mcu->SFRBits[176] = "RXD";
-  mcu->SFRBits[177] = "TXD";
-  mcu->SFRBits[178] = "INT0";
-  mcu->SFRBits[179] = "INT1";
-  mcu->SFRBits[180] = "T0";
-  mcu->SFRBits[181] = "T1";
-  mcu->SFRBits[182] = "WR";
-  mcu->SFRBits[183] = "RD";
-  mcu->SFRBits[184] = "PX0";
-  mcu->SFRBits[185] = "PT0";
-  mcu->SFRBits[186] = "PX1";
-  mcu->SFRBits[187] = "PT1";
-  mcu->SFRBits[188] = "PS";
-  mcu->SFRBits[189] = "IP.5";
-  mcu->SFRBits[190] = "IP.6";
-  mcu->SFRBits[191] = "IP.7";
-  mcu->SFRBits[192] = "C0h.0";
-  mcu->SFRBits[193] = "C0h.1";
-  mcu->SFRBits[194] = "C0h.2";
-  mcu->SFRBits[195] = "C0h.3";
-  mcu->SFRBits[196] = "C0h.4";
-  mcu->SFRBits[197] = "C0h.5";
-  mcu->SFRBits[198] = "C0h.6";
-  mcu->SFRBits[199] = "C0h.7";
-  mcu->SFRBits[200] = "C8h.0";
-  mcu->SFRBits[201] = "C8h.1";
-  mcu->SFRBits[202] = "C8h.2";
-  mcu->SFRBits[203] = "C8h.3";
-  mcu->SFRBits[204] = "C8h.4";
-  mcu->SFRBits[205] = "C8h.5";
-  mcu->SFRBits[206] = "C8h.6";
-  mcu->SFRBits[207] = "C8h.7";
-  mcu->SFRBits[208] = "P";
-  mcu->SFRBits[209] = "PSW.1";
-  mcu->SFRBits[210] = "OV";
-  mcu->SFRBits[211] = "RS0";
-  mcu->SFRBits[212] = "RS1";
-  mcu->SFRBits[213] = "F0";
-  mcu->SFRBits[214] = "AC";
-  mcu->SFRBits[215] = "CY";
-  mcu->SFRBits[216] = "D8h.0";
-  mcu->SFRBits[217] = "D8h.1";
-  mcu->SFRBits[218] = "D8h.2";
-  mcu->SFRBits[219] = "D8h.3";
-  mcu->SFRBits[220] = "D8h.4";
-  mcu->SFRBits[221] = "D8h.5";
-  mcu->SFRBits[222] = "D8h.6";
-  mcu->SFRBits[223] = "D8h.7";
-  mcu->SFRBits[224] = "ACC.0";
-  mcu->SFRBits[225] = "ACC.1";
-  mcu->SFRBits[226] = "ACC.2";
-  mcu->SFRBits[227] = "ACC.3";
-  mcu->SFRBits[228] = "ACC.4";
-  mcu->SFRBits[229] = "ACC.5";
-  mcu->SFRBits[230] = "ACC.6";
-  mcu->SFRBits[231] = "ACC.7";
-  mcu->SFRBits[232] = "E8h.0";
-  mcu->SFRBits[233] = "E8h.1";
-  mcu->SFRBits[234] = "E8h.2";
-  mcu->SFRBits[235] = "E8h.3";
-  mcu->SFRBits[236] = "E8h.4";
-  mcu->SFRBits[237] = "E8h.5";
-  mcu->SFRBits[238] = "E8h.6";
-  mcu->SFRBits[239] = "E8h.7";
-  mcu->SFRBits[240] = "B.0";
-  mcu->SFRBits[241] = "B.1";
-  mcu->SFRBits[242] = "B.2";
-  mcu->SFRBits[243] = "B.3";
-  mcu->SFRBits[244] = "B.4";
-  mcu->SFRBits[245] = "B.5";
-  mcu->SFRBits[246] = "B.6";
-  mcu->SFRBits[247] = "B.7";
-  mcu->SFRBits[248] = "F8h.0";
-  mcu->SFRBits[249] = "F8h.1";
-  mcu->SFRBits[250] = "F8h.2";
-  mcu->SFRBits[251] = "F8h.3";
-  mcu->SFRBits[252] = "F8h.4";
-  mcu->SFRBits[253] = "F8h.5";
-  mcu->SFRBits[254] = "F8h.6";
-  mcu->SFRBits[255] = "F8h.7";
-
-  mcu->_instructions[0x00] = &nop_00;
-  mcu->_instructions[0xA5] = NULL;
-  mcu->_instructions[0x74] = &mov_74;
-  mcu->_instructions[0x75] = &mov_75;
-  mcu->_instructions[0x02] = &ljmp_02;
-  mcu->_instructions[0x80] = &sjmp_80;
-  mcu->_instructions[0x85] = &mov_85;
-  mcu->_instructions[0xE5] = &mov_E5;
-  mcu->_instructions[0x92] = &mov_92;
-  mcu->_instructions[0x04] = &inc_04;
-  mcu->_instructions[0x05] = &inc_05;
-  mcu->_instructions[0xA3] = &inc_A3;
-  mcu->_instructions[0x06] = &inc_06;
-  mcu->_instructions[0x07] = &inc_07;
-  mcu->_instructions[0x08] = &inc_08;
-  mcu->_instructions[0x09] = &inc_09;
-  mcu->_instructions[0x0A] = &inc_0A;
-  mcu->_instructions[0x0B] = &inc_0B;
-  mcu->_instructions[0x0C] = &inc_0C;
-  mcu->_instructions[0x0D] = &inc_0D;
-  mcu->_instructions[0x0E] = &inc_0E;
-  mcu->_instructions[0x0F] = &inc_0F;
-  mcu->_instructions[0x14] = &dec_14;
-  mcu->_instructions[0x15] = &dec_15;
-  mcu->_instructions[0x16] = &dec_16;
-  mcu->_instructions[0x17] = &dec_17;
-  mcu->_instructions[0x18] = &dec_18;
-  mcu->_instructions[0x19] = &dec_19;
-  mcu->_instructions[0x1A] = &dec_1A;
-  mcu->_instructions[0x1B] = &dec_1B;
-  mcu->_instructions[0x1C] = &dec_1C;
-  mcu->_instructions[0x1D] = &dec_1D;
-  mcu->_instructions[0x1E] = &dec_1E;
-  mcu->_instructions[0x1F] = &dec_1F;
-  mcu->_instructions[0x84] = &div_84;
-  mcu->_instructions[0xA4] = &mul_A4;
-  mcu->_instructions[0x23] = &rl_23;
-  mcu->_instructions[0x03] = &rr_03;
-  mcu->_instructions[0x33] = &rlc_33;
-  mcu->_instructions[0x13] = &rrc_13;
-  mcu->_instructions[0x90] = &mov_90;
-  mcu->_instructions[0xF5] = &mov_F5;
-  mcu->_instructions[0x24] = &add_24;
-  mcu->_instructions[0x25] = &add_25;
-  mcu->_instructions[0x26] = &add_26;
-  mcu->_instructions[0x27] = &add_27;
-  mcu->_instructions[0x28] = &add_28;
-  mcu->_instructions[0x29] = &add_29;
-  mcu->_instructions[0x2A] = &add_2A;
-  mcu->_instructions[0x2B] = &add_2B;
-  mcu->_instructions[0x2C] = &add_2C;
-  mcu->_instructions[0x2D] = &add_2D;
-  mcu->_instructions[0x2E] = &add_2E;
-  mcu->_instructions[0x2F] = &add_2F;
-  mcu->_instructions[0x34] = &addc_34;
-  mcu->_instructions[0x35] = &addc_35;
-  mcu->_instructions[0x36] = &addc_36;
-  mcu->_instructions[0x37] = &addc_37;
-  mcu->_instructions[0x38] = &addc_38;
-  mcu->_instructions[0x39] = &addc_39;
-  mcu->_instructions[0x3A] = &addc_3A;
-  mcu->_instructions[0x3B] = &addc_3B;
-  mcu->_instructions[0x3C] = &addc_3C;
-  mcu->_instructions[0x3D] = &addc_3D;
-  mcu->_instructions[0x3E] = &addc_3E;
-  mcu->_instructions[0x3F] = &addc_3F;
-  mcu->_instructions[0xE0] = &movx_E0;
-  mcu->_instructions[0xF0] = &movx_F0;
-  mcu->_instructions[0xC0] = &push_C0;
-  mcu->_instructions[0xD0] = &pop_D0;
-  mcu->_instructions[0xC3] = &clr_C3;
-  mcu->_instructions[0xD3] = &setb_D3;
-  mcu->_instructions[0xD2] = &setb_D2;
-  mcu->_instructions[0xC2] = &clr_C2;
-  mcu->_instructions[0x62] = &xrl_62;
-  mcu->_instructions[0x63] = &xrl_63;
-  mcu->_instructions[0x64] = &xrl_64;
-  mcu->_instructions[0x65] = &xrl_65;
-  mcu->_instructions[0x66] = &xrl_66;
-  mcu->_instructions[0x67] = &xrl_67;
-  mcu->_instructions[0x68] = &xrl_68;
-  mcu->_instructions[0x69] = &xrl_69;
-  mcu->_instructions[0x6A] = &xrl_6A;
-  mcu->_instructions[0x6B] = &xrl_6B;
-  mcu->_instructions[0x6C] = &xrl_6C;
-  mcu->_instructions[0x6D] = &xrl_6D;
-  mcu->_instructions[0x6E] = &xrl_6E;
-  mcu->_instructions[0x6F] = &xrl_6F;
-  mcu->_instructions[0xC5] = &xch_C5;
-  mcu->_instructions[0xC6] = &xch_C6;
-  mcu->_instructions[0xC7] = &xch_C7;
-  mcu->_instructions[0xC8] = &xch_C8;
-  mcu->_instructions[0xC9] = &xch_C9;
-  mcu->_instructions[0xCA] = &xch_CA;
-  mcu->_instructions[0xCB] = &xch_CB;
-  mcu->_instructions[0xCC] = &xch_CC;
-  mcu->_instructions[0xCD] = &xch_CD;
-  mcu->_instructions[0xCE] = &xch_CE;
-  mcu->_instructions[0xCF] = &xch_CF;
-  mcu->_instructions[0x12] = &lcall_12;
-  mcu->_instructions[0x22] = &ret_22;
-  mcu->_instructions[0x70] = &jnz_70;
-  mcu->_instructions[0x60] = &jz_60;
-  mcu->_instructions[0x40] = &jc_40;
-  mcu->_instructions[0x50] = &jnc_50;
-  mcu->_instructions[0xC4] = &swap_C4;
-  mcu->_instructions[0x93] = &movc_93;
-  mcu->_instructions[0x83] = &movc_83;
-  mcu->_instructions[0xE6] = &mov_E6;
-  mcu->_instructions[0xE7] = &mov_E7;
-  mcu->_instructions[0xF6] = &mov_F6;
-  mcu->_instructions[0xF7] = &mov_F7;
-  mcu->_instructions[0x78] = &mov_78;
-  mcu->_instructions[0x79] = &mov_79;
-  mcu->_instructions[0x7A] = &mov_7A;
-  mcu->_instructions[0x7B] = &mov_7B;
-  mcu->_instructions[0x7C] = &mov_7C;
-  mcu->_instructions[0x7D] = &mov_7D;
-  mcu->_instructions[0x7E] = &mov_7E;
-  mcu->_instructions[0x7F] = &mov_7F;
-  mcu->_instructions[0xA8] = &mov_A8;
-  mcu->_instructions[0xA9] = &mov_A9;
-  mcu->_instructions[0xAA] = &mov_AA;
-  mcu->_instructions[0xAB] = &mov_AB;
-  mcu->_instructions[0xAC] = &mov_AC;
-  mcu->_instructions[0xAD] = &mov_AD;
-  mcu->_instructions[0xAE] = &mov_AE;
-  mcu->_instructions[0xAF] = &mov_AF;
-  mcu->_instructions[0x88] = &mov_88;
-  mcu->_instructions[0x89] = &mov_89;
-  mcu->_instructions[0x8A] = &mov_8A;
-  mcu->_instructions[0x8B] = &mov_8B;
-  mcu->_instructions[0x8C] = &mov_8C;
-  mcu->_instructions[0x8D] = &mov_8D;
-  mcu->_instructions[0x8E] = &mov_8E;
-  mcu->_instructions[0x8F] = &mov_8F;
-  mcu->_instructions[0xF8] = &mov_F8;
-  mcu->_instructions[0xF9] = &mov_F9;
-  mcu->_instructions[0xFA] = &mov_FA;
-  mcu->_instructions[0xFB] = &mov_FB;
-  mcu->_instructions[0xFC] = &mov_FC;
-  mcu->_instructions[0xFD] = &mov_FD;
-  mcu->_instructions[0xFE] = &mov_FE;
-  mcu->_instructions[0xFF] = &mov_FF;
-  mcu->_instructions[0xE8] = &mov_E8;
-  mcu->_instructions[0xE9] = &mov_E9;
-  mcu->_instructions[0xEA] = &mov_EA;
-  mcu->_instructions[0xEB] = &mov_EB;
-  mcu->_instructions[0xEC] = &mov_EC;
-  mcu->_instructions[0xED] = &mov_ED;
-  mcu->_instructions[0xEE] = &mov_EE;
-  mcu->_instructions[0xEF] = &mov_EF;
-  mcu->_instructions[0xE4] = &clr_E4;
-  mcu->_instructions[0x01] = &ajmp_01;
-  mcu->_instructions[0x21] = &ajmp_21;
-  mcu->_instructions[0x41] = &ajmp_41;
-  mcu->_instructions[0x61] = &ajmp_61;
-  mcu->_instructions[0x81] = &ajmp_81;
-  mcu->_instructions[0xA1] = &ajmp_A1;
-  mcu->_instructions[0xC1] = &ajmp_C1;
-  mcu->_instructions[0xE1] = &ajmp_E1;
-  mcu->_instructions[0x11] = &acall_11;
-  mcu->_instructions[0x31] = &acall_31;
-  mcu->_instructions[0x51] = &acall_51;
-  mcu->_instructions[0x71] = &acall_71;
-  mcu->_instructions[0x91] = &acall_91;
-  mcu->_instructions[0xB1] = &acall_B1;
-  mcu->_instructions[0xD1] = &acall_D1;
-  mcu->_instructions[0xF1] = &acall_F1;
-  mcu->_instructions[0xD8] = &djnz_D8;
-  mcu->_instructions[0xD9] = &djnz_D9;
-  mcu->_instructions[0xDA] = &djnz_DA;
-  mcu->_instructions[0xDB] = &djnz_DB;
-  mcu->_instructions[0xDC] = &djnz_DC;
-  mcu->_instructions[0xDD] = &djnz_DD;
-  mcu->_instructions[0xDE] = &djnz_DE;
-  mcu->_instructions[0xDF] = &djnz_DF;
-  mcu->_instructions[0xD5] = &djnz_D5;
-  mcu->_instructions[0x43] = &orl_43;
-  mcu->_instructions[0x44] = &orl_44;
-  mcu->_instructions[0x45] = &orl_45;
-  mcu->_instructions[0x42] = &orl_42;
-  mcu->_instructions[0x48] = &orl_48;
-  mcu->_instructions[0x49] = &orl_49;
-  mcu->_instructions[0x4A] = &orl_4A;
-  mcu->_instructions[0x4B] = &orl_4B;
-  mcu->_instructions[0x4C] = &orl_4C;
-  mcu->_instructions[0x4D] = &orl_4D;
-  mcu->_instructions[0x4E] = &orl_4E;
-  mcu->_instructions[0x4F] = &orl_4F;
-  mcu->_instructions[0x46] = &orl_46;
-  mcu->_instructions[0x47] = &orl_47;
-  mcu->_instructions[0x54] = &anl_54;
-  mcu->_instructions[0x55] = &anl_55;
-  mcu->_instructions[0x52] = &anl_52;
-  mcu->_instructions[0x53] = &anl_53;
-  mcu->_instructions[0x58] = &anl_58;
-  mcu->_instructions[0x59] = &anl_59;
-  mcu->_instructions[0x5A] = &anl_5A;
-  mcu->_instructions[0x5B] = &anl_5B;
-  mcu->_instructions[0x5C] = &anl_5C;
-  mcu->_instructions[0x5D] = &anl_5D;
-  mcu->_instructions[0x5E] = &anl_5E;
-  mcu->_instructions[0x5F] = &anl_5F;
-  mcu->_instructions[0x56] = &anl_56;
-  mcu->_instructions[0x57] = &anl_57;
-  mcu->_instructions[0xA2] = &mov_A2;
-  mcu->_instructions[0xB2] = &cpl_B2;
-  mcu->_instructions[0xB3] = &cpl_B3;
-  mcu->_instructions[0x72] = &orl_72;
-  mcu->_instructions[0xA0] = &orl_A0;
-  mcu->_instructions[0x82] = &anl_82;
-  mcu->_instructions[0xB0] = &anl_B0;
-  mcu->_instructions[0xF4] = &cpl_F4;
-  mcu->_instructions[0xA6] = &mov_A6;
-  mcu->_instructions[0xA7] = &mov_A7;
-  mcu->_instructions[0x76] = &mov_76;
-  mcu->_instructions[0x77] = &mov_77;
-  mcu->_instructions[0x86] = &mov_86;
-  mcu->_instructions[0x87] = &mov_87;
-  mcu->_instructions[0x73] = &jmp_73;
-  mcu->_instructions[0xB4] = &cjne_B4;
-  mcu->_instructions[0xB5] = &cjne_B5;
-  mcu->_instructions[0xB6] = &cjne_B6;
-  mcu->_instructions[0xB7] = &cjne_B7;
-  mcu->_instructions[0xB8] = &cjne_B8;
-  mcu->_instructions[0xB9] = &cjne_B9;
-  mcu->_instructions[0xBA] = &cjne_BA;
-  mcu->_instructions[0xBB] = &cjne_BB;
-  mcu->_instructions[0xBC] = &cjne_BC;
-  mcu->_instructions[0xBD] = &cjne_BD;
-  mcu->_instructions[0xBE] = &cjne_BE;
-  mcu->_instructions[0xBF] = &cjne_BF;
-  mcu->_instructions[0x32] = &reti_32;
-  mcu->_instructions[0x30] = &jnb_30;
-  mcu->_instructions[0x20] = &jb_20;
-  mcu->_instructions[0x10] = &jbc_10;
-  mcu->_instructions[0x94] = &subb_94;
-  mcu->_instructions[0x95] = &subb_95;
-  mcu->_instructions[0x96] = &subb_96;
-  mcu->_instructions[0x97] = &subb_97;
-  mcu->_instructions[0x98] = &subb_98;
-  mcu->_instructions[0x99] = &subb_99;
-  mcu->_instructions[0x9A] = &subb_9A;
-  mcu->_instructions[0x9B] = &subb_9B;
-  mcu->_instructions[0x9C] = &subb_9C;
-  mcu->_instructions[0x9D] = &subb_9D;
-  mcu->_instructions[0x9E] = &subb_9E;
-  mcu->_instructions[0x9F] = &subb_9F;
-  mcu->_instructions[0xD4] = &da_D4;
-  mcu->_instructions[0xD6] = &xchd_D6;
-  mcu->_instructions[0xD7] = &xchd_D7;
-  mcu->_instructions[0xE2] = &movx_E2;
-  mcu->_instructions[0xE3] = &movx_E3;
-  mcu->_instructions[0xF2] = &movx_F2;
-  mcu->_instructions[0xF3] = &movx_F3;
-
-  mcu->_timers = &timers8051;
-  mcu->_interrupts = &interrupts8051;
-  mcu->_additionalCode = NULL;
+  free(mcu->PCBreakpoints);
+  free(mcu->accessIntRAMPauses);
+  free(mcu->accessExtRAMPauses);
+  free(mcu->accessIntROMPauses);
+  free(mcu->accessExtROMPauses);
+  free(mcu->accessSFRPauses);
+  free(mcu->intRAMPauses);
+  free(mcu->extRAMPauses);
+  free(mcu->SFRPauses);
 
-  resetMCU(mcu);
+  mcu->numOfPCBreakpoints = 0;
+  mcu->numOfaccessIntRAMPauses = 0;
+  mcu->numOfAccessExtRAMPauses = 0;
+  mcu->numOfAccessIntROMPauses = 0;
+  mcu->numOfAccessExtROMPauses = 0;
+  mcu->numOfAccessSFRPauses = 0;
+  mcu->numOfIntRAMPauses = 0;
+  mcu->numOfExtRAMPauses = 0;
+  mcu->numOfSFRPauses = 0;
+
+  mcu->PCBreakpoints = NULL;
+  mcu->accessIntRAMPauses = NULL;
+  mcu->accessExtRAMPauses = NULL;
+  mcu->accessIntROMPauses = NULL;
+  mcu->accessExtROMPauses = NULL;
+  mcu->accessSFRPauses = NULL;
+  mcu->intRAMPauses = NULL;
+  mcu->extRAMPauses = NULL;
+  mcu->SFRPauses = NULL;
 }
 
-void init8031MCU(MCU* mcu)
+double getMCUTime(MCU* mcu)
 {
-  init8051MCU(mcu);
-
-  mcu->idataMemorySize = 0x100;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
+  return (double)mcu->cycles / ((double)mcu->oscillator / 12);
 }
 
-void init8052MCU(MCU* mcu)
+/*
+ * Common part of every execution engine. Called before instruction is
+ * fetched.
+ */
+static inline void mcuBeginInstruction(MCU* mcu)
 {
-  init8051MCU(mcu);
+  // Reset error.
+  mcu->errid = E_NOERRORS;
 
-  mcu->idataMemorySize = 0x100;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0x2000;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
+  /*
+   * Update pins.
+   */
+  if (mcu->EAconnect != 0) {
+    bool EA = mcuCheckBit(mcu, mcu->EAconnect);
 
-  mcu->_timers = &timers8052;
-  mcu->_interrupts = &interrupts8052;
-  mcu->_additionalCode = NULL;
+    // Other ROM is visible now.
+    if (EA != mcu->EA) {
+      mcu->EA = EA;
+      mapMemoryMCU(mcu);
+    }
+  }
 }
 
-void init8032MCU(MCU* mcu)
+/*
+ * Debugger information and flags refreshed after every instruction. Hot
+ * blocks call only this between instructions. Without info only write
+ * hooks are called.
+ */
+static inline void mcuTrackInstruction(MCU* mcu, bool info)
 {
-  init8052MCU(mcu);
+  /*
+   * Parity flag. ACC is mostly written through mcu->ACC, so its hook is
+   * called also when value differs.
+   */
+  if (*mcu->ACC != mcu->parityACC)
+    mcuWriteACC(mcu, mcu->parityACC);
 
-  mcu->idataMemorySize = 0x100;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
-}
+  /*
+   * Update information about last changed memory. SFR changed without
+   * mcuSetIntRAM() (bit and read-modify-write instructions) calls its
+   * write hook here.
+   */
+  if (mcu->accessedSFR >= 0x80 &&
+      mcu->_beforeAccessedSFR != mcu->sfr[mcu->accessedSFR - 0x80]) {
+    if (info)
+      mcu->changedSFR = mcu->accessedSFR;
 
-void init89S51MCU(MCU* mcu)
-{
-  init8051MCU(mcu);
-  mcu->WDTEnable = false;
-  mcu->WDTTimerValue = 0;
+    if (mcu->accessedSFR != mcu->_writtenSFR &&
+        mcu->_sfrWrite[mcu->accessedSFR - 0x80] != NULL)
+      mcu->_sfrWrite[mcu->accessedSFR - 0x80](mcu, mcu->_beforeAccessedSFR);
 
-  mcu->idataMemorySize = 0x100;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0x1000;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
+    // Next instruction looks for its own changes.
+    mcu->_beforeAccessedSFR = mcu->sfr[mcu->accessedSFR - 0x80];
+  }
+  mcu->_writtenSFR = -1;
 
-  mcu->DP1H = &mcu->sfr[0x85 - 0x80];
-  mcu->DP1L = &mcu->sfr[0x84 - 0x80];
-  mcu->DP0H = &mcu->sfr[0x83 - 0x80];
-  mcu->DP0L = &mcu->sfr[0x82 - 0x80];
-  mcu->WDTRST = &mcu->sfr[0xA6 - 0x80];
-  mcu->AUXR1 = &mcu->sfr[0xA2 - 0x80];
-  mcu->AUXR = &mcu->sfr[0x8E - 0x80];
-  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
+  if (!info)
+    return;
 
-  mcu->_additionalCode = &Mcu89S5x;
-}
+  if (mcu->_beforeAccessedIntRAM != mcu->idata[mcu->accessedIntRAM])
+    mcu->changedIntRAM = mcu->accessedIntRAM;
 
-void init89S52MCU(MCU* mcu)
-{
-  init8052MCU(mcu);
-  mcu->WDTEnable = false;
-  mcu->WDTTimerValue = 0;
+  if (mcu->_beforeAccessedExtRAM != getMemoryMCU(mcu, XDATA, mcu->accessedExtRAM))
+    mcu->changedExtRAM = mcu->accessedExtRAM;
 
-  mcu->idataMemorySize = 0x100;
-  mcu->xdataMemorySize = MAX_EXT_RAM_SIZE;
-  mcu->iromMemorySize = 0x2000;
-  mcu->xromMemorySize = MAX_ROM_SIZE;
+  /*
+   * Aktualizuje najwyższe i najniższe wartości adresów.
+   */
+  if (*mcu->SP > mcu->maxValueOfStackPointer)
+    mcu->maxValueOfStackPointer = *mcu->SP;
 
-  mcu->DP1H = &mcu->sfr[0x85 - 0x80];
-  mcu->DP1L = &mcu->sfr[0x84 - 0x80];
-  mcu->DP0H = &mcu->sfr[0x83 - 0x80];
-  mcu->DP0L = &mcu->sfr[0x82 - 0x80];
-  mcu->WDTRST = &mcu->sfr[0xA6 - 0x80];
-  mcu->AUXR1 = &mcu->sfr[0xA2 - 0x80];
-  mcu->AUXR = &mcu->sfr[0x8E - 0x80];
-  mcu->DPTR = (WORD*)&mcu->sfr[0x82 - 0x80];
+  if (mcu->accessedIntRAM > mcu->maxIntRamAddress)
+    mcu->maxIntRamAddress = mcu->accessedIntRAM;
 
-  mcu->_additionalCode = &Mcu89S5x;
-}
+  if (mcu->accessedIntRAM < mcu->minIntRamAddress || mcu->minIntRamAddress == -1)
+    mcu->minIntRamAddress = mcu->accessedIntRAM;
 
-void resetMCU(MCU* mcu)
-{
-  mcu->PC = 0;
-  mcu->cycles = 0;
-  mcu->instructions = 0;
+  if (mcu->accessedExtRAM > mcu->maxExtRamAddress)
+    mcu->maxExtRamAddress = mcu->accessedExtRAM;
 
-  mcu->OUTPUT = -1;
-  mcu->INPUT = -1;
+  if (mcu->accessedExtRAM < mcu->minExtRamAddress || mcu->minExtRamAddress == -1)
+    mcu->minExtRamAddress = mcu->accessedExtRAM;
 
-  mcu->maxValueOfStackPointer = 0x07;
-  mcu->minIntRamAddress = -1;
-  mcu->maxIntRamAddress = -1;
-  mcu->minExtRamAddress = -1;
-  mcu->maxExtRamAddress = -1;
-  mcu->maxIntRomAddress = 0;
-  mcu->maxExtRomAddress = 0;
+  if (mcu->accessedIntROM > mcu->maxIntRomAddress)
+    mcu->maxIntRomAddress = mcu->accessedIntROM;
 
-  memset(mcu->sfr, 0, SFR_SIZE);
+  if (mcu->accessedExtROM > mcu->maxExtRomAddress)
+    mcu->maxExtRomAddress = mcu->accessedExtROM;
 
-  *mcu->P0 = 0xFF;
-  *mcu->P1 = 0xFF;
-  *mcu->P2 = 0xFF;
-  *mcu->P3 = 0xFF;
-  *mcu->SP = 0x07;
+  if (!mcu->EA && mcu->PC > mcu->maxIntRomAddress)
+    mcu->maxIntRomAddress = mcu->PC;
 
-  mcu->accessedSFR = -1;
-  mcu->accessedIntRAM = -1;
-  mcu->accessedExtRAM = -1;
-  mcu->accessedIntROM = -1;
-  mcu->accessedExtROM = -1;
-  mcu->changedSFR = 0x80;
-  mcu->changedIntRAM = 0;
-  mcu->changedExtRAM = 0;
-}
+  if (mcu->EA && mcu->PC > mcu->maxExtRomAddress)
+    mcu->maxExtRomAddress = mcu->PC;
 
-void removeMCU(MCU* mcu)
-{
-  clearAllBreakpointsAndPauses(mcu);
+  /*
+   * Most instructions change registers through mcu->R, R0 of current bank
+   * is watched by next instruction.
+   */
+  mcu->_beforeAccessedIntRAM = *mcu->R;
+  mcu->accessedIntRAM = mcu->R - mcu->idata;
 }
 
-char* getError(MCU* mcu)
+/*
+ * Auto I/O of the serial port. Called after every instruction by
+ * processMCUEx() and by the batch engines.
+ */
+static inline void mcuSerial(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn)
 {
-  switch (mcu->errid) {
-  case E_NOERRORS:
-    return NULL;
-    break;
-  case E_IRAMOUTSIDE:
-    return "Using an address outside the available internal ram memory.";
-    break;
-  case E_XRAMOUTSIDE:
-    return "Using an address outside the available external ram memory.";
-    break;
-  case E_UNSUPPORTED:
-    return "Using unsupported instruction.";
-    break;
-  default:
-    return "Undefined error.";
-    break;
+  if (out != NULL)
+    *useOut = false;
+
+  if (in != NULL)
+    *needIn = false;
+
+  /*
+   * Output.
+   */
+  if (mcu->autoRead && mcu->OUTPUT != -1 && !(*mcu->SCON & 0x02)) {
+    if (out != NULL) {
+      *out = mcu->OUTPUT;
+      *useOut = true;
+    }
+
+    *mcu->SCON |= 0x02; // TI
+    mcu->pendingInterrupts |= INT_DIRTY;
+    mcu->OUTPUT = -1;
   }
-}
 
-inline BYTE* intRAM(MCU* mcu, BYTE address, bool direct)
-{
-  return _mcuIntRAM(mcu, address, direct, false);
+  /*
+   * Input, from argument or from INPUT.
+   */
+  if (mcu->autoWrite && (*mcu->SCON & 0x11) == 0x10) { // REN and not RI
+    if (in != NULL) {
+      *mcu->SBUF =  *in;
+      *needIn = true;
+      *mcu->SCON |= 0x01; // RI
+      mcu->pendingInterrupts |= INT_DIRTY;
+    } else if (mcu->INPUT != -1) {
+      *mcu->SBUF = (BYTE) mcu->INPUT;
+      *mcu->SCON |= 0x01; // RI
+      mcu->pendingInterrupts |= INT_DIRTY;
+      mcu->INPUT = -1;
+    }
+  }
 }
 
-inline BYTE* extRAM(MCU* mcu, WORD address)
+/*
+ * Checks done by batch engines between instructions. Uart works like in
+ * processMCUEx() except that byte is left in OUTPUT when caller wants it.
+ */
+static inline MCUStopReason mcuBatchStop(MCU* mcu, int stopMask)
 {
-  return _mcuExtRAM(mcu, address, false);
-}
+  bool keep = (stopMask & STOP_OUTPUT) && mcu->autoRead && mcu->OUTPUT != -1 &&
+              !(*mcu->SCON & 0x02);
 
-inline BYTE* ROM(MCU* mcu, WORD address)
-{
-  return _mcuROM(mcu, address, false);
-}
+  if (!keep)
+    mcuSerial(mcu, NULL, NULL, NULL, NULL);
 
-extern inline bool checkRegister(MCU* mcu, WORD flag)
-{
-  return (*mcuIntRAM(mcu, (BYTE) (flag >> 8), true) & (BYTE) (flag & 0x00FF)) > 0;
-}
+  if (!mcu->noDebug) {
+    if (isBreakpointOrPause(mcu))
+      return STOP_BREAKPOINT;
 
-extern inline void setRegister(MCU* mcu, WORD flag, bool state)
-{
-  if (state)
-    *mcuIntRAM(mcu, (BYTE) (flag >> 8), true) |= (BYTE) (flag & 0x00FF);
-  else
-    *mcuIntRAM(mcu, (BYTE) (flag >> 8), true) &= ~((BYTE) (flag & 0x00FF));
-}
+    if (mcu->errid != E_NOERRORS)
+      return STOP_ERROR;
+  }
 
+  if (keep)
+    return STOP_OUTPUT;
 
-bool isBreakpointOrPause(MCU* mcu)
-{
-  int i = 0;
+  if ((stopMask & STOP_INPUT) && mcu->autoWrite && mcu->INPUT == -1 &&
+      (*mcu->SCON & 0x11) == 0x10)
+    return STOP_INPUT;
 
-  /*
-   * PC Breakpoints.
-   */
-  for (i = 0; i < mcu->numOfPCBreakpoints; ++i)
-    if (mcu->PCBreakpoints[i] == mcu->PC)
-      return true;
+  if ((stopMask & STOP_POWERDOWN) && mcu->powerDown)
+    return STOP_POWERDOWN;
 
-  /*
-   * Access pauses.
-   */
-  for (i = 0; i < mcu->numOfaccessIntRAMPauses; ++i)
-    if (mcu->accessIntRAMPauses[i] == mcu->accessedIntRAM)
-      return true;
+  if ((stopMask & STOP_SELFLOOP) && (mcu->idle || *ROM(mcu, mcu->PC) == 0x80) &&
+      isHaltedMCU(mcu))
+    return STOP_SELFLOOP;
 
-  for (i = 0; i < mcu->numOfAccessExtRAMPauses; ++i) {
-    if (mcu->accessExtRAMPauses[i] == mcu->accessedExtRAM)
-      return true;
-  }
+  return STOP_NONE;
+}
 
-  for (i = 0; i < mcu->numOfAccessIntROMPauses; ++i)
-    if (mcu->accessIntROMPauses[i] == mcu->accessedIntROM)
-      return true;
+static unsigned long long mcuFastForward(MCU* mcu, unsigned long long count,
+                                         unsigned long long end);
 
-  for (i = 0; i < mcu->numOfAccessExtROMPauses; ++i)
-    if (mcu->accessExtROMPauses[i] == mcu->accessedExtROM)
-      return true;
+/*
+ * Core selected by init for current debug mode.
+ */
+static inline const MCUCore* mcuCore(MCU* mcu)
+{
+  return mcu->_cores[mcu->noDebug ? 1 : 0];
+}
+
+void processMCU(MCU* mcu)
+{
+  mcuCore(mcu)->step(mcu);
+}
+
+bool processMCUEx(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn)
+{
+  processMCU(mcu);
 
-  for (i = 0; i < mcu->numOfAccessSFRPauses; ++i)
-    if (mcu->accessSFRPauses[i] == mcu->accessedSFR)
-      return true;
+  mcuSerial(mcu, out, in, useOut, needIn);
 
   /*
-   * Conditional pauses.
+   * Disable debuging code. This speed up simulator
    */
-  for (int n = 0; n < 3; ++n) {
-
-    int num = 0;
-    BYTE val1 = 0;
-    BYTE val2 = 0;
-    BreakpointType type = 0;
-
-    if (n == 0)
-      num = mcu->numOfIntRAMPauses;
-    else if (n == 1)
-      num = mcu->numOfExtRAMPauses;
-    else if (n == 2)
-      num = mcu->numOfSFRPauses;
+  if (mcu->noDebug)
+    return true;
 
-    for (i = 0; i < num; ++i) {
-      if (n == 0) {
-        val1 = mcu->idata[mcu->intRAMPauses[i].address];
-        val2 = mcu->intRAMPauses[i].value;
-        type = mcu->intRAMPauses[i].type;
-      } else if (n == 1) {
-        val1 = mcu->xdata[mcu->extRAMPauses[i].address];
-        val2 = mcu->extRAMPauses[i].value;
-        type = mcu->extRAMPauses[i].type;
-      } else if (n == 2) {
-        val1 = mcu->sfr[mcu->SFRPauses[i].address];
-        val2 = mcu->SFRPauses[i].value;
-        type = mcu->SFRPauses[i].type;
-      }
+  /*
+   * Breakpoint.
+   */
+  if (isBreakpointOrPause(mcu))
+    return false;
 
-      switch (type) {
-      case EQUAL:
-        if (val1 == val2)
-          return true;
-        break;
-      case NOT_EQUAL:
-        if (val1 != val2)
-          return true;
-        break;
-      case LESS:
-        if (val1 < val2)
-          return true;
-        break;
-      case LESS_EQUAL:
-        if (val1 <= val2)
-          return true;
-        break;
-      case GREATER:
-        if (val1 > val2)
-          return true;
-        break;
-      case GREATER_EQUAL:
-        if (val1 >= val2)
-          return true;
-        break;
-      case AND:
-        if (val1 & val2)
-          return true;
-        break;
-      case OR:
-        if (val1 | val2)
-          return true;
-        break;
-      case XOR:
-        if (val1 ^ val2)
-          return true;
-        break;
-      }
-    }
-  }
+  /*
+   * Error.
+   */
+  if (mcu->errid != E_NOERRORS)
+    return false;
 
-  return false;
+  return true;
 }
 
-void setPCBreakpoint(MCU* mcu, WORD address)
+void beginInstructionMCU(MCU* mcu, WORD lastByte)
 {
-  /* Sprawdz, czy już nie istnieje taki. */
-  for (int i = 0; i < mcu->numOfPCBreakpoints; ++i)
-    if (mcu->PCBreakpoints[i] == address)
-      return;
+  mcuBeginInstruction(mcu);
 
-  mcu->numOfPCBreakpoints += 1;
-  mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
-                               mcu->numOfPCBreakpoints * sizeof(WORD*));
-  mcu->PCBreakpoints[mcu->numOfPCBreakpoints - 1] = address;
+  mcu->lastInstruction = *mcuROM(mcu, mcu->PC);
+  mcuROM(mcu, lastByte);
+
+  mcu->instructions += 1;
+  mcu->cycles += mcu->cycleCount[mcu->lastInstruction];
 }
 
-void setAccessPause(MCU* mcu, MemoryType memoryType, WORD address)
+/*
+ * Uart and checks of processMCUEx() done after instruction or block of
+ * recompiled module.
+ */
+static inline bool mcuEndModule(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn)
 {
-  int* num = NULL;
-  WORD** breakpoints = NULL;
+  mcuSerial(mcu, out, in, useOut, needIn);
 
-  switch (memoryType) {
-  case IDATA:
-    num = &mcu->numOfaccessIntRAMPauses;
-    breakpoints = &mcu->accessIntRAMPauses;
-    break;
-  case XDATA:
-    num = &mcu->numOfAccessExtRAMPauses;
-    breakpoints = &mcu->accessExtRAMPauses;
-    break;
-  case SFR:
-    num = &mcu->numOfAccessSFRPauses;
-    breakpoints = &mcu->accessSFRPauses;
-    break;
-  case IROM:
-    num = &mcu->numOfAccessIntROMPauses;
-    breakpoints = &mcu->accessIntROMPauses;
-    break;
-  case XROM:
-    num = &mcu->numOfAccessExtROMPauses;
-    breakpoints = &mcu->accessExtROMPauses;
-    break;
-  default:
-    return;
-  }
+  if (mcu->noDebug)
+    return true;
 
-  if (memoryType == IDATA && address > 0xFF)
-    return;
-  if (memoryType == SFR && (address < 0x80 || address > 0xFF))
-    return;
+  if (isBreakpointOrPause(mcu))
+    return false;
 
-  /* Sprawdz, czy już nie istnieje taki. */
-  for (int i = 0; i < *num; ++i)
-    if (**breakpoints == address)
-      return;
+  if (mcu->errid != E_NOERRORS)
+    return false;
 
-  *num += 1;
-  *breakpoints = realloc(*breakpoints, *num * sizeof(WORD*));
-  *breakpoints[*num - 1] = address;
+  return true;
 }
 
-void setCondPause(MCU* mcu, MemoryType memoryType,
-                  WORD address, BreakpointType breakType, BYTE value)
+bool endInstructionMCU(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn)
 {
-  int* num = NULL;
-  MCUConditionBreakpoint** breakpoints = NULL;
+  mcuCore(mcu)->endInstruction(mcu);
+  return mcuEndModule(mcu, out, in, useOut, needIn);
+}
 
-  switch (memoryType) {
-  case IDATA:
-    num = &mcu->numOfIntRAMPauses;
-    breakpoints = &mcu->intRAMPauses;
+bool endBlockMCU(MCU* mcu, unsigned instructions, unsigned cycles, BYTE* out, BYTE* in,
+                 bool* useOut, bool* needIn)
+{
+  mcu->instructions += instructions;
+  mcu->cycles += cycles;
+  return mcuEndModule(mcu, out, in, useOut, needIn);
+}
+
+void arithmeticMCU(MCU* mcu, BYTE opcode, BYTE value)
+{
+  switch (opcode & 0xF0) {
+  case 0x20:
+    mcuAdd(mcu, mcu->ACC, &value);
     break;
-  case XDATA:
-    num = &mcu->numOfExtRAMPauses;
-    breakpoints = &mcu->extRAMPauses;
+  case 0x30:
+    mcuAddc(mcu, mcu->ACC, &value);
     break;
-  case SFR:
-    num = &mcu->numOfSFRPauses;
-    breakpoints = &mcu->SFRPauses;
+  case 0x90:
+    mcuSub(mcu, mcu->ACC, &value);
     break;
-  default:
-    return;
   }
+}
 
-  if (memoryType == IDATA && address > 0xFF)
-    return;
-  if (memoryType == SFR && (address < 0x80 || address > 0xFF))
-    return;
+BYTE arithmeticFlagsMCU(bool subtract, BYTE a, BYTE b, int c)
+{
+  return mcuArithmeticFlags(subtract ? LAZY_SUB : LAZY_ADD, a, b, c);
+}
 
-  /* Sprawdz, czy już nie istnieje taki. */
-  for (int i = 0; i < *num; ++i)
-    if ((*breakpoints)->address == address)
-      return;
+void executeInstructionMCU(MCU* mcu)
+{
+  mcu->lastInstruction = *ROM(mcu, mcu->PC);
 
-  *num += 1;
-  *breakpoints = realloc(*breakpoints, *num * sizeof(MCUConditionBreakpoint*));
-  (*breakpoints)[*num - 1].address = address;
-  (*breakpoints)[*num - 1].type = breakType;
-  (*breakpoints)[*num - 1].value = value;
+  if (mcu->noDebug)
+    instructions_fast[mcu->lastInstruction](mcu);
+  else
+    instructions[mcu->lastInstruction](mcu);
 }
 
-void clearPCBreakpoint(MCU* mcu, WORD address)
+bool isHaltedMCU(MCU* mcu)
 {
-  for (int i = 0; i < mcu->numOfPCBreakpoints; ++i) {
-    if (mcu->PCBreakpoints[i] == address) {
-      if (i == mcu->numOfPCBreakpoints - 1) {
-        mcu->numOfPCBreakpoints -= 1;
-        mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
-                                     mcu->numOfPCBreakpoints * sizeof(WORD*));
-      } else {
-        memmove(&mcu->PCBreakpoints[i], &mcu->PCBreakpoints[i + 1],
-                (mcu->numOfPCBreakpoints - i - 1) * sizeof(WORD*));
-        mcu->numOfPCBreakpoints -= 1;
-        mcu->PCBreakpoints = realloc(mcu->PCBreakpoints,
-                                     mcu->numOfPCBreakpoints * sizeof(WORD*));
-      }
-      /* szukaj dalej gdyby breakpoint się powtarzał */
-      i -= 1;
-      continue;
-    }
-  }
+  bool ea = *intRAM(mcu, IE_EA >> 8, true) & (IE_EA & 0x00FF);
+
+  if (mcu->powerDown || (mcu->idle && !ea))
+    return true;
+
+  return !ea && *ROM(mcu, mcu->PC) == 0x80 && *ROM(mcu, mcu->PC + 1) == 0xFE;
 }
 
-void clearAccessPause(MCU* mcu, MemoryType memoryType, WORD address)
+/*
+ * Predecoded engine.
+ */
+void invalidatePredecodedMCU(MCU* mcu)
 {
-  int* num = NULL;
-  WORD* breakpoints = NULL;
+  mcu->decodedValid = false;
+  mcu->codeVersion += 1;
+}
 
-  switch (memoryType) {
-  case IDATA:
-    num = &mcu->numOfaccessIntRAMPauses;
-    breakpoints = mcu->accessIntRAMPauses;
-    break;
-  case XDATA:
-    num = &mcu->numOfAccessExtRAMPauses;
-    breakpoints = mcu->accessExtRAMPauses;
-    break;
-  case SFR:
-    num = &mcu->numOfAccessSFRPauses;
-    breakpoints = mcu->accessSFRPauses;
-    break;
-  case IROM:
-    num = &mcu->numOfAccessIntROMPauses;
-    breakpoints = mcu->accessIntROMPauses;
-    break;
-  case XROM:
-    num = &mcu->numOfAccessExtROMPauses;
-    breakpoints = mcu->accessExtROMPauses;
-    break;
-  default:
-    return;
-  }
+void predecodeMCU(MCU* mcu)
+{
+  mcuCore(mcu)->runDecoded(mcu, 0, MCU_NO_LIMIT, 0, NULL);
+}
 
-  for (int i = 0; i < *num; ++i) {
-    if (breakpoints[i] == address) {
-      if (i == *num - 1) {
-        *num -= 1;
-        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
-      } else {
-        memmove(&breakpoints[i], &breakpoints[i + 1], (*num - i - 1) * sizeof(WORD*));
-        *num -= 1;
-        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
-      }
-      /* szukaj dalej gdyby breakpoint się powtarzał */
-      i -= 1;
-      continue;
-    }
-  }
+unsigned long long runDecodedMCU(MCU* mcu, unsigned long long count)
+{
+  MCUStopReason reason;
+
+  return mcuCore(mcu)->runDecoded(mcu, count, MCU_NO_LIMIT,
+                                  STOP_BREAKPOINT | STOP_ERROR, &reason);
 }
 
-void clearCondPause(MCU* mcu, MemoryType memoryType, WORD address)
+unsigned long long runMCUBatch(MCU* mcu, unsigned long long maxInstr,
+                               unsigned long long maxCycles, int stopMask,
+                               MCUStopReason* reason)
 {
-  int* num = NULL;
-  MCUConditionBreakpoint* breakpoints = NULL;
+  unsigned long long end = MCU_NO_LIMIT;
 
-  switch (memoryType) {
-  case IDATA:
-    num = &mcu->numOfIntRAMPauses;
-    breakpoints = mcu->intRAMPauses;
-    break;
-  case XDATA:
-    num = &mcu->numOfExtRAMPauses;
-    breakpoints = mcu->extRAMPauses;
-    break;
-  case SFR:
-    num = &mcu->numOfSFRPauses;
-    breakpoints = mcu->SFRPauses;
-    break;
-  default:
-    return;
+  if (maxCycles != MCU_NO_LIMIT && mcu->cycles + maxCycles > mcu->cycles)
+    end = mcu->cycles + maxCycles;
+
+  *reason = STOP_BUDGET;
+
+  // Nothing would be executed.
+  if ((stopMask & STOP_POWERDOWN) && mcu->powerDown) {
+    *reason = STOP_POWERDOWN;
+    return 0;
   }
 
-  for (int i = 0; i < *num; ++i) {
-    if (breakpoints[i].address == address) {
-      if (i == *num - 1) {
-        *num -= 1;
-        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
-      } else {
-        memmove(&breakpoints[i], &breakpoints[i + 1], (*num - i - 1) * sizeof(WORD*));
-        *num -= 1;
-        breakpoints = realloc(breakpoints, *num * sizeof(WORD*));
-      }
-      /* szukaj dalej gdyby breakpoint się powtarzał */
-      i -= 1;
-      continue;
-    }
+  if ((stopMask & STOP_SELFLOOP) && (mcu->idle || *ROM(mcu, mcu->PC) == 0x80) &&
+      isHaltedMCU(mcu)) {
+    *reason = STOP_SELFLOOP;
+    return 0;
   }
+
+  if (maxInstr == 0 || mcu->cycles >= end)
+    return 0;
+
+  if (mcu->usePredecoded)
+    return mcuCore(mcu)->runDecoded(mcu, maxInstr, end, stopMask, reason);
+
+  return mcuCore(mcu)->run(mcu, maxInstr, end, stopMask, reason);
 }
 
-void clearAllBreakpointsAndPauses(MCU* mcu)
+int takeOutputMCU(MCU* mcu)
 {
-  free(mcu->PCBreakpoints);
-  free(mcu->accessIntRAMPauses);
-  free(mcu->accessExtRAMPauses);
-  free(mcu->accessIntROMPauses);
-  free(mcu->accessExtROMPauses);
-  free(mcu->accessSFRPauses);
-  free(mcu->intRAMPauses);
-  free(mcu->extRAMPauses);
-  free(mcu->SFRPauses);
+  int out = mcu->OUTPUT;
 
-  mcu->numOfPCBreakpoints = 0;
-  mcu->numOfaccessIntRAMPauses = 0;
-  mcu->numOfAccessExtRAMPauses = 0;
-  mcu->numOfAccessIntROMPauses = 0;
-  mcu->numOfAccessExtROMPauses = 0;
-  mcu->numOfAccessSFRPauses = 0;
-  mcu->numOfIntRAMPauses = 0;
-  mcu->numOfExtRAMPauses = 0;
-  mcu->numOfSFRPauses = 0;
+  if (!mcu->autoRead || out == -1 || (*mcu->SCON & 0x02))
+    return -1;
 
-  mcu->PCBreakpoints = NULL;
-  mcu->accessIntRAMPauses = NULL;
-  mcu->accessExtRAMPauses = NULL;
-  mcu->accessIntROMPauses = NULL;
-  mcu->accessExtROMPauses = NULL;
-  mcu->accessSFRPauses = NULL;
-  mcu->intRAMPauses = NULL;
-  mcu->extRAMPauses = NULL;
-  mcu->SFRPauses = NULL;
+  *mcu->SCON |= 0x02; // TI
+  mcu->pendingInterrupts |= INT_DIRTY;
+  mcu->OUTPUT = -1;
+
+  return out;
 }
 
-double getMCUTime(MCU* mcu)
+/*
+ * Fill one record. Operands are read without access tracking, the
+ * dispatcher sets accessedIntROM/accessedExtROM from romAddress instead.
+ */
+static void mcuDecode(MCU* mcu, WORD address, MCUDecoded* d, const void* handler)
 {
-  return (double)mcu->cycles / ((double)mcu->oscillator / 12);
+  d->handler = handler;
+  d->opcode = *ROM(mcu, address);
+  d->bytes = mcu->byteCount[d->opcode];
+  d->cycles = mcu->cycleCount[d->opcode];
+  d->op1 = *ROM(mcu, address + 1);
+  d->op2 = *ROM(mcu, address + 2);
+
+  d->romAddress = mcuROMAddress(mcu, address + d->bytes - 1, &d->ext);
+
+  d->hits = 0;
+  d->blockLength = 0;
+  d->blockSafe = false;
 }
 
-void processMCU(MCU* mcu)
+/*
+ * Hot blocks.
+ *
+ * Straight-line runs of code ending with a jump are executed without the
+ * timer, interrupt and uart code between instructions, cycles and
+ * instructions are accounted once per block. This is only valid while
+ * these subsystems are idle and the block can't wake them up.
+ */
+enum {
+  OP_JUMP   = 0x01, // ends a block
+  OP_DIRECT = 0x02, // first operand is direct address
+  OP_SOURCE = 0x04, // second operand is direct address (mov dir, dir)
+  OP_BIT    = 0x08, // first operand is bit address
+  OP_UNSAFE = 0x10, // never executed in a block
+  OP_MOVX   = 0x20  // XDATA access, could reach a device
+};
+
+static const BYTE g_opcodeKind[256] = {
+  [0x01] = OP_JUMP, [0x21] = OP_JUMP, [0x41] = OP_JUMP, [0x61] = OP_JUMP,
+  [0x81] = OP_JUMP, [0xA1] = OP_JUMP, [0xC1] = OP_JUMP, [0xE1] = OP_JUMP,
+  [0x11] = OP_JUMP, [0x31] = OP_JUMP, [0x51] = OP_JUMP, [0x71] = OP_JUMP,
+  [0x91] = OP_JUMP, [0xB1] = OP_JUMP, [0xD1] = OP_JUMP, [0xF1] = OP_JUMP,
+  [0x02] = OP_JUMP, [0x12] = OP_JUMP, [0x22] = OP_JUMP, [0x32] = OP_JUMP,
+  [0x73] = OP_JUMP, [0x80] = OP_JUMP,
+  [0x40] = OP_JUMP, [0x50] = OP_JUMP, [0x60] = OP_JUMP, [0x70] = OP_JUMP,
+  [0x10] = OP_JUMP | OP_BIT, [0x20] = OP_JUMP | OP_BIT, [0x30] = OP_JUMP | OP_BIT,
+  [0xB4 ... 0xBF] = OP_JUMP,
+  [0xB5] = OP_JUMP | OP_DIRECT,
+  [0xD5] = OP_JUMP | OP_DIRECT,
+  [0xD8 ... 0xDF] = OP_JUMP,
+  [0x05] = OP_DIRECT, [0x15] = OP_DIRECT, [0x25] = OP_DIRECT, [0x35] = OP_DIRECT,
+  [0x45] = OP_DIRECT, [0x55] = OP_DIRECT, [0x65] = OP_DIRECT, [0x75] = OP_DIRECT,
+  [0x95] = OP_DIRECT, [0xC5] = OP_DIRECT, [0xE5] = OP_DIRECT, [0xF5] = OP_DIRECT,
+  [0x42 ... 0x43] = OP_DIRECT, [0x52 ... 0x53] = OP_DIRECT, [0x62 ... 0x63] = OP_DIRECT,
+  [0x86 ... 0x8F] = OP_DIRECT, [0xA6 ... 0xAF] = OP_DIRECT,
+  [0xC0] = OP_DIRECT, [0xD0] = OP_DIRECT,
+  [0x85] = OP_DIRECT | OP_SOURCE,
+  [0x72] = OP_BIT, [0x82] = OP_BIT, [0x92] = OP_BIT, [0xA0] = OP_BIT,
+  [0xA2] = OP_BIT, [0xB0] = OP_BIT, [0xB2] = OP_BIT, [0xC2] = OP_BIT, [0xD2] = OP_BIT,
+  [0xE0] = OP_MOVX, [0xE2 ... 0xE3] = OP_MOVX, [0xF0] = OP_MOVX, [0xF2 ... 0xF3] = OP_MOVX,
+  [0xA5] = OP_UNSAFE,
+};
+
+/*
+ * SFRs which control timers, interrupts, uart, power and 89S5x extras.
+ */
+static inline bool mcuControlSFR(BYTE address)
+{
+  switch (address) {
+  case 0x87: // PCON
+  case 0x88: // TCON
+  case 0x89: // TMOD
+  case 0x8A: // TL0
+  case 0x8B: // TL1
+  case 0x8C: // TH0
+  case 0x8D: // TH1
+  case 0x98: // SCON
+  case 0x99: // SBUF
+  case 0xA2: // AUXR1
+  case 0xA6: // WDTRST
+  case 0xA8: // IE
+  case 0xB0: // P3
+  case 0xB8: // IP
+  case 0xC8: // T2CON
+  case 0xCC: // TL2
+  case 0xCD: // TH2
+    return true;
+  }
+
+  return false;
+}
+
+/*
+ * Instruction doesn't touch any of them. XDATA access is checked by caller.
+ */
+static inline bool mcuSafeOpcode(BYTE opcode, BYTE op1, BYTE op2)
 {
-  // Reset error.
-  mcu->errid = E_NOERRORS;
+  BYTE kind = g_opcodeKind[opcode];
 
-  // Hack!
-  mcu->INPUT = *mcu->SBUF;
+  if (kind & OP_UNSAFE)
+    return false;
 
-  /*
-   * Update pins.
-   */
-  if (mcu->EAconnect != NULL)
-    mcu->EA = mcuCheckBit(mcu, mcu->EAconnect);
+  if ((kind & OP_DIRECT) && mcuControlSFR(op1))
+    return false;
 
-  /*
-   * Actual instruction
-   */
-  mcu->lastInstruction = *mcuROM(mcu, mcu->PC);
+  if ((kind & OP_BIT) && op1 >= 0x80 && mcuControlSFR(op1 & 0xF8))
+    return false;
 
-  /*
-   * Number of executed instructions.
-   */
-  mcu->instructions += 1;
+  if ((kind & OP_SOURCE) && mcuControlSFR(op2))
+    return false;
 
-  /*
-   * Cycles.
-   */
-  mcu->cycles += mcu->cycleCount[mcu->lastInstruction];
+  return true;
+}
 
-  /*
-   * Instructions.
-   */
-  if (mcu->_instructions[mcu->lastInstruction] != NULL)
-    mcu->_instructions[mcu->lastInstruction](mcu);
-  else {
-    mcu->errid = E_UNSUPPORTED;
-    mcu->PC += 1;
+static inline bool mcuSafeInBlock(MCU* mcu, MCUDecoded* d)
+{
+  // Devices could look at time of access.
+  if ((g_opcodeKind[d->opcode] & OP_MOVX) && mcu->numOfDevices != 0)
+    return false;
+
+  return mcuSafeOpcode(d->opcode, d->op1, d->op2);
+}
+
+/*
+ * Measure block starting at address. Block ends after first jump, before
+ * first unsafe instruction or at the end of code memory.
+ */
+static void mcuFormBlock(MCU* mcu, WORD address)
+{
+  MCUDecoded* entry = &mcu->decoded[address];
+  unsigned length = 0;
+  unsigned pc = address;
+
+  while (length < MAX_BLOCK_LENGTH) {
+    MCUDecoded* d = &mcu->decoded[pc];
+
+    if (!mcuSafeInBlock(mcu, d))
+      break;
+
+    length += 1;
+    pc += d->bytes;
+
+    if (g_opcodeKind[d->opcode] & OP_JUMP || pc >= mcu->codeSize)
+      break;
   }
 
-  mcu->PC %= mcu->iromMemorySize > mcu->xromMemorySize ?
-             mcu->iromMemorySize : mcu->xromMemorySize;
+  // Length 1 marks an address which doesn't start a block.
+  entry->blockLength = length > 0 ? length : 1;
+  entry->blockSafe = length > 1;
+}
 
-  /*
-   * Update information about last changed memory
-   */
-  if (mcu->_beforeAccessedSFR != mcu->sfr[mcu->accessedSFR - 0x80])
-    mcu->changedSFR = mcu->accessedSFR;
+static inline bool mcuDebugArmed(MCU* mcu)
+{
+  return mcu->numOfPCBreakpoints || mcu->numOfaccessIntRAMPauses ||
+         mcu->numOfAccessExtRAMPauses || mcu->numOfAccessIntROMPauses ||
+         mcu->numOfAccessExtROMPauses || mcu->numOfAccessSFRPauses ||
+         mcu->numOfIntRAMPauses || mcu->numOfExtRAMPauses || mcu->numOfSFRPauses;
+}
 
-  if (mcu->_beforeAccessedIntRAM != mcu->idata[mcu->accessedIntRAM])
-    mcu->changedIntRAM = mcu->accessedIntRAM;
+/*
+ * Busy-wait loop and idle mode don't leave PC, so only breakpoint at PC
+ * and pauses stop them.
+ */
+static inline bool mcuLoopArmed(MCU* mcu)
+{
+  for (unsigned i = 0; i < mcu->numOfPCBreakpoints; ++i)
+    if (mcu->PCBreakpoints[i] == mcu->PC)
+      return true;
 
-  if (mcu->_beforeAccessedExtRAM != mcu->xdata[mcu->accessedExtRAM])
-    mcu->changedExtRAM = mcu->accessedExtRAM;
+  return mcu->numOfaccessIntRAMPauses ||
+         mcu->numOfAccessExtRAMPauses || mcu->numOfAccessIntROMPauses ||
+         mcu->numOfAccessExtROMPauses || mcu->numOfAccessSFRPauses ||
+         mcu->numOfIntRAMPauses || mcu->numOfExtRAMPauses || mcu->numOfSFRPauses;
+}
 
-  /*
-   * Aktualizuje najwyższe i najniższe wartości adresów.
-   */
-  if (*mcu->SP > mcu->maxValueOfStackPointer)
-    mcu->maxValueOfStackPointer = *mcu->SP;
+/*
+ * True when skipping timers, interrupts, uart and additional code for a
+ * whole block of at most cycles gives the same result as calling them
+ * after every instruction.
+ */
+static inline bool mcuBlockQuiet(MCU* mcu, unsigned cycles)
+{
+  if (mcu->EAconnect != 0 || (!mcu->noDebug && mcuDebugArmed(mcu)))
+    return false;
 
-  if (mcu->accessedIntRAM > mcu->maxIntRamAddress)
-    mcu->maxIntRamAddress = mcu->accessedIntRAM;
+  // Timer could overflow inside block.
+  if (mcu->_timers != NULL && (mcu->timersDirty ||
+                               mcu->cycles + cycles >= mcu->timerDeadline))
+    return false;
 
-  if (mcu->accessedIntRAM < mcu->minIntRamAddress || mcu->minIntRamAddress == -1)
-    mcu->minIntRamAddress = mcu->accessedIntRAM;
+  // Interrupt could be taken.
+  if (mcu->_interrupts != NULL && mcu->pendingInterrupts != 0)
+    return false;
 
-  if (mcu->accessedExtRAM > mcu->maxExtRamAddress)
-    mcu->maxExtRamAddress = mcu->accessedExtRAM;
+  // Watchdog would count.
+  if (mcu->_additionalCode != NULL && (mcu->_additionalCode != &Mcu89S5x ||
+                                       mcu->WDTEnable))
+    return false;
 
-  if (mcu->accessedExtRAM < mcu->minExtRamAddress || mcu->minExtRamAddress == -1)
-    mcu->minExtRamAddress = mcu->accessedExtRAM;
+  // Uart would send byte.
+  if (mcu->autoRead && mcu->OUTPUT != -1 && !(*mcu->SCON & 0x02))
+    return false;
 
-  if (mcu->accessedIntROM > mcu->maxIntRomAddress)
-    mcu->maxIntRomAddress = mcu->accessedIntROM;
+  return true;
+}
 
-  if (mcu->accessedExtROM > mcu->maxExtRomAddress)
-    mcu->maxExtRomAddress = mcu->accessedExtROM;
+/*
+ * Hot blocks of recompiled modules.
+ */
+bool blockSafeMCU(MCU* mcu, WORD address, bool* movx)
+{
+  BYTE opcode = *ROM(mcu, address);
 
-  if (!mcu->EA && mcu->PC > mcu->maxIntRomAddress)
-    mcu->maxIntRomAddress = mcu->PC;
+  *movx = (g_opcodeKind[opcode] & OP_MOVX) != 0;
+  return mcuSafeOpcode(opcode, *ROM(mcu, address + 1), *ROM(mcu, address + 2));
+}
 
-  if (mcu->EA && mcu->PC > mcu->maxExtRomAddress)
-    mcu->maxExtRomAddress = mcu->PC;
+unsigned beginBlockMCU(MCU* mcu)
+{
+  unsigned long long cycles = MAX_MODULE_BLOCK_CYCLES;
 
-  /*
-   * Parity flag.
-   */
-  if (mcu->accessedSFR == 0xE0) {
-    int i = 0;
-    int n = 0;
-    for (; i < 7; ++i)
-      if ((1 << i) & *mcu->ACC)
-        n += 1;
+  if (!mcuBlockQuiet(mcu, 0))
+    return 0;
 
-    setRegister(mcu, PSW_P, 0 == (n % 2));
-  }
+  // Up to the cycle before the next timer event.
+  if (mcu->_timers != NULL && mcu->timerDeadline - mcu->cycles - 1 < cycles)
+    cycles = mcu->timerDeadline - mcu->cycles - 1;
 
-  /*
-   * Register banks.
-   */
-  mcu->R = mcuIntRAM(mcu, (checkRegister(mcu, PSW_RS0) << 1 | checkRegister(mcu, PSW_RS1))
-                     << 3, true);
+  mcu->errid = E_NOERRORS;
+  return cycles;
+}
 
-  /*
-   * Timers.
-   */
-  if (mcu->_timers != NULL)
-    mcu->_timers(mcu);
+bool nextInstructionMCU(MCU* mcu, BYTE opcode, WORD lastByte)
+{
+  mcu->lastInstruction = opcode;
+  if (!mcu->noDebug)
+    mcuROM(mcu, lastByte);
 
-  /*
-   * Interrupts
-   */
-  if (mcu->_interrupts != NULL)
-    mcu->_interrupts(mcu);
+  if (mcu->PC >= mcu->codeSize)
+    mcu->PC %= mcu->codeSize;
 
-  /*
-   * Additional microcontroller specific code.
-   */
-  if (mcu->_additionalCode != NULL)
-    mcu->_additionalCode(mcu);
+  mcuTrackInstruction(mcu, !mcu->noDebug);
+
+  // reti lets the next interrupt in.
+  return mcu->errid == E_NOERRORS && (mcu->_interrupts == NULL || mcu->pendingInterrupts == 0);
 }
 
-bool processMCUEx(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn)
+/*
+ * Number of iterations of busy-wait loop at PC which certainly don't leave
+ * it: `sjmp $`, `jb bit,$`, `jnb bit,$` and `djnz Rn,$`. Only program and
+ * events stopped by fastForwardMCU() can change polled bit. Limit for
+ * other loops, 0 when loop is not there or ends now.
+ */
+static inline unsigned long long mcuBusyLoop(MCU* mcu, BYTE opcode, BYTE op1, BYTE op2)
+{
+  const unsigned long long forever = (unsigned long long) -1;
+
+  switch (opcode) {
+  case 0x80: // sjmp $
+    return op1 == 0xFE ? forever : 0;
+  case 0x20: // jb bit,$
+  case 0x30: // jnb bit,$
+    if (op2 != 0xFD)
+      return 0;
+    if (((*intRAM(mcu, op1 < 0x80 ? 0x20 + (op1 >> 3) : op1 & 0xF8, true) &
+          1 << (op1 & 0x07)) != 0) == (opcode == 0x20))
+      return forever;
+    return 0;
+  case 0xD8 ... 0xDF: // djnz Rn,$
+    if (op1 != 0xFE)
+      return 0;
+    // The last iteration is executed.
+    return (BYTE) (mcu->R[opcode & 0x07] - 1);
+  }
+
+  return 0;
+}
+
+/*
+ * Skip steps of idle mode or busy-wait loop which end before the next
+ * event.
+ */
+unsigned long long fastForwardMCU(MCU* mcu, unsigned long long count)
 {
-  processMCU(mcu);
+  return mcuFastForward(mcu, count, MCU_NO_LIMIT);
+}
 
-  if (out != NULL)
-    *useOut = false;
+/*
+ * The same with cycle limit, stops at the first step which reaches end like
+ * stepping does.
+ */
+static unsigned long long mcuFastForward(MCU* mcu, unsigned long long count,
+                                         unsigned long long end)
+{
+  bool timer2 = mcu->_timers == &timers8052;
+  BYTE opcode = 0x00;
+  BYTE op1 = 0x00;
+  BYTE op2 = 0x00;
+  unsigned step;
+  unsigned long long loop;
+  unsigned long long n = count;
+
+  if (count == 0 || mcu->EAconnect != 0 || (!mcu->noDebug && mcuLoopArmed(mcu)))
+    return 0;
+
+  if (mcu->idle)
+    step = 1;
+  else {
+    opcode = *ROM(mcu, mcu->PC);
+    op1 = *ROM(mcu, mcu->PC + 1);
+    op2 = *ROM(mcu, mcu->PC + 2);
 
-  if (in != NULL)
-    *needIn = false;
+    loop = mcuBusyLoop(mcu, opcode, op1, op2);
+    if (loop == 0)
+      return 0;
+    if (loop < n)
+      n = loop;
 
-  /*
-   * Output.
-   */
-  if (mcu->autoRead && mcu->OUTPUT != -1 && !checkRegister(mcu, SCON_TI)) {
-    if (out != NULL) {
-      *out = mcu->OUTPUT;
-      *useOut = true;
-    }
+    step = mcu->cycleCount[opcode];
+  }
 
-    setRegister(mcu, SCON_TI, true);
-    mcu->OUTPUT = -1;
+  // Interrupt will be taken or flags were touched.
+  if (mcu->_interrupts != NULL && mcu->pendingInterrupts != 0)
+    return 0;
+
+  // Uart will send or receive byte.
+  if (mcu->autoRead && mcu->OUTPUT != -1 && !(*mcu->SCON & 0x02))
+    return 0;
+  if (mcu->autoWrite && mcu->INPUT != -1 && (*mcu->SCON & 0x11) == 0x10)
+    return 0;
+
+  // Cycle limit.
+  if (end != MCU_NO_LIMIT) {
+    if (mcu->cycles >= end)
+      return 0;
+    if ((end - mcu->cycles + step - 1) / step < n)
+      n = (end - mcu->cycles + step - 1) / step;
   }
 
-  /*
-   * Input.
-   */
-  if (mcu->autoWrite && checkRegister(mcu, SCON_REN) && !checkRegister(mcu, SCON_RI)) {
-    if (in != NULL) {
-      *mcu->SBUF =  *in;
-      *needIn = true;
-      setRegister(mcu, SCON_RI, true);
-    }
-    mcu->INPUT = -1;
+  // Steps which end before the next overflow.
+  if (mcu->_timers != NULL) {
+    if (mcu->cycles >= mcu->timerDeadline || !mcuTimersSettled(mcu, timer2))
+      return 0;
+
+    if (mcu->timerDeadline != TIMER_NEVER &&
+        (mcu->timerDeadline - mcu->cycles - 1) / step < n)
+      n = (mcu->timerDeadline - mcu->cycles - 1) / step;
   }
 
-  /*
-   * Disable debuging code. This speed up simulator
-   */
-  if (mcu->noDebug)
-    return true;
+  // And before watchdog reset.
+  if (mcu->_additionalCode == &Mcu89S5x) {
+    if (mcu->WDTEnable) {
+      if ((0x3FFFu - mcu->WDTTimerValue) / step < n)
+        n = (0x3FFFu - mcu->WDTTimerValue) / step;
+      mcu->WDTTimerValue += n * step;
+    }
+  } else if (mcu->_additionalCode != NULL)
+    return 0;
 
-  /*
-   * Breakpoint.
-   */
-  if (isBreakpointOrPause(mcu))
-    return false;
+  if (n == 0)
+    return 0;
+
+  mcu->cycles += n * step;
+  if (mcu->idle)
+    return n;
 
   /*
-   * Error.
+   * Registers and access information like after the last skipped
+   * iteration.
    */
-  if (mcu->errid != E_NOERRORS)
-    return false;
+  mcu->instructions += n;
+  mcu->lastInstruction = opcode;
+  mcuROM(mcu, mcu->PC + mcu->byteCount[opcode] - 1);
 
-  return true;
+  if (opcode == 0x20 || opcode == 0x30)
+    mcuCheckBit(mcu, op1);
+  else if (opcode != 0x80)
+    mcu->R[opcode & 0x07] -= n;
+
+  mcuTrackInstruction(mcu, !mcu->noDebug);
+
+  return n;
+}
+
+/*
+ * Count edge of jump, call, return or branch just executed from address.
+ */
+static inline void mcuCoverEdge(MCU* mcu, WORD from)
+{
+  BYTE* counter;
+
+  if (!(g_opcodeKind[mcu->lastInstruction] & OP_JUMP))
+    return;
+
+  counter = &mcu->coverage[((from * 0x9E37u) ^ mcu->PC) & (COVERAGE_SIZE - 1)];
+  if (*counter != 0xFF)
+    *counter += 1;
 }
 
+/*
+ * Execution cores, one for every variant and debug mode.
+ */
+#define CORE_TIMERS timers8051
+#define CORE_INTERRUPTS interrupts8051
+#define CORE(name) name##8051
+#define CORE_DEBUG 1
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8051
+#define CORE_INTERRUPTS interrupts8051
+#define CORE(name) name##8051_fast
+#define CORE_DEBUG 0
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8052
+#define CORE_INTERRUPTS interrupts8052
+#define CORE(name) name##8052
+#define CORE_DEBUG 1
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8052
+#define CORE_INTERRUPTS interrupts8052
+#define CORE(name) name##8052_fast
+#define CORE_DEBUG 0
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8051
+#define CORE_INTERRUPTS interrupts8051
+#define CORE_ADDITIONAL Mcu89S5x
+#define CORE(name) name##89S51
+#define CORE_DEBUG 1
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8051
+#define CORE_INTERRUPTS interrupts8051
+#define CORE_ADDITIONAL Mcu89S5x
+#define CORE(name) name##89S51_fast
+#define CORE_DEBUG 0
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8052
+#define CORE_INTERRUPTS interrupts8052
+#define CORE_ADDITIONAL Mcu89S5x
+#define CORE(name) name##89S52
+#define CORE_DEBUG 1
+#include "MCS51Core.h"
+
+#define CORE_TIMERS timers8052
+#define CORE_INTERRUPTS interrupts8052
+#define CORE_ADDITIONAL Mcu89S5x
+#define CORE(name) name##89S52_fast
+#define CORE_DEBUG 0
+#include "MCS51Core.h"
+
 /*
  * Disassembler.
  */
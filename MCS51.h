@@ -27,8 +27,6 @@
 typedef uint8_t  BYTE;
 typedef uint16_t WORD;
 
-extern const int CYCLE_COUNT[];
-
 #define BIT0 0x01
 #define BIT1 0x02
 #define BIT2 0x04
@@ -47,12 +45,12 @@ extern const int CYCLE_COUNT[];
 #define PSW_CY  0xD080
 
 // IP
-#define IP_PX0 0xC001
-#define IP_PT0 0xC002
-#define IP_PX1 0xC004
-#define IP_PT1 0xC008
-#define IP_PS  0xC010
-#define IP_PT2 0xC020
+#define IP_PX0 0xB801
+#define IP_PT0 0xB802
+#define IP_PX1 0xB804
+#define IP_PT1 0xB808
+#define IP_PS  0xB810
+#define IP_PT2 0xB820
 
 // P3
 #define P3_RD   0xB080
@@ -135,6 +133,17 @@ extern const int CYCLE_COUNT[];
 #define INT_RAM_SIZE 0x100
 #define MAX_EXT_RAM_SIZE 0x10000
 #define MAX_ROM_SIZE 0x10000
+#define MAX_BLOCK_LENGTH 64
+#define MAX_MODULE_BLOCK_CYCLES 0x100000
+#define COVERAGE_SIZE 0x4000
+#define MCU_DEFAULT_SEED 0x8051
+
+// Flags of memory pages (see mapMemoryMCU)
+#define PAGE_SPLIT   0x01 // page doesn't map to continuous memory, slow path
+#define PAGE_OUTSIDE 0x02 // XDATA page is outside of available memory
+#define PAGE_MMIO    0x04 // XDATA page has device registers (see mapDeviceMCU)
+#define PAGE_COPY    0x08 // XDATA page is shared or not allocated, written on slow path
+#define PAGE_LAZY    0x10 // XDATA page isn't allocated yet and gets poison, read on slow path
 
 typedef enum {
   EQUAL = 1,
@@ -156,6 +165,25 @@ typedef enum {
   XROM,
 } MemoryType;
 
+/*
+ * 256 bytes of xdata or code memory. Page is allocated on first write and
+ * shared by copies made by cloneMCU(), shared page isn't changed, it is
+ * copied before write. refs is number of instances using it (atomic).
+ */
+typedef struct {
+  volatile unsigned refs;
+  BYTE data[256];
+} MCUPage;
+
+/*
+ * Power on contents of memory (see poisonMCU).
+ */
+typedef enum {
+  POISON_ZERO,
+  POISON_PATTERN, // every byte has the same value
+  POISON_RANDOM,  // seeded pseudo random bytes
+} MCUPoison;
+
 typedef enum {
   M_8031,
   M_8051,
@@ -170,27 +198,235 @@ typedef struct {
   BreakpointType type;
 } MCUConditionBreakpoint;
 
+/*
+ * Reasons why runMCUBatch() returned, also bits of its stopMask.
+ */
+typedef enum {
+  STOP_NONE       = 0x00,
+  STOP_BREAKPOINT = 0x01, // breakpoint or conditional pause
+  STOP_ERROR      = 0x02,
+  STOP_POWERDOWN  = 0x04,
+  STOP_SELFLOOP   = 0x08, // `sjmp $` or idle mode with interrupts disabled
+  STOP_OUTPUT     = 0x10, // byte written to SBUF, see takeOutputMCU()
+  STOP_INPUT      = 0x20, // receiver waits and INPUT is empty
+  STOP_BUDGET     = 0x40, // maxInstr or maxCycles reached
+} MCUStopReason;
+
+#define STOP_ALL (STOP_BREAKPOINT | STOP_ERROR | STOP_POWERDOWN | STOP_SELFLOOP | \
+                  STOP_OUTPUT | STOP_INPUT)
+#define MCU_NO_LIMIT ((unsigned long long) -1)
+
+/*
+ * Device on the MOVX bus. Callbacks get context given to mapDeviceMCU() and
+ * address in XDATA space.
+ */
+typedef BYTE (*MCUDeviceRead)(void* context, WORD address);
+typedef void (*MCUDeviceWrite)(void* context, WORD address, BYTE value);
+
+typedef struct {
+  WORD first;
+  WORD last;
+  MCUDeviceRead read;
+  MCUDeviceWrite write;
+  void* context;
+} MCUDevice;
+
+/*
+ * Predecoded instruction. One record for every code address, built once from
+ * the current ROM mapping and executed by the threaded dispatcher.
+ */
+typedef struct {
+  const void* handler; // label in the threaded dispatcher
+  BYTE opcode;
+  BYTE op1;
+  BYTE op2;
+  BYTE bytes;
+  BYTE cycles;
+  bool ext;            // last byte of the instruction lies in the external ROM
+  WORD romAddress;     // address of the last byte of the instruction
+  unsigned short hits; // dispatches to this address, until block is formed
+  BYTE blockLength;    // instructions in hot block starting here, 0 if none
+  bool blockSafe;      // block can be run without per instruction checks
+} MCUDecoded;
+
+struct _mcu;
+
+/*
+ * Execution core built for one MCU variant and debug mode (MCS51Core.h).
+ * Timers, interrupts and instructions are called directly in it.
+ */
+typedef struct _mcuCore {
+  void (*step)(struct _mcu* mcu);
+  void (*endInstruction)(struct _mcu* mcu);
+  unsigned long long (*run)(struct _mcu* mcu, unsigned long long count,
+                            unsigned long long end, int stopMask,
+                            MCUStopReason* reason);
+  unsigned long long (*runDecoded)(struct _mcu* mcu, unsigned long long count,
+                                   unsigned long long end, int stopMask,
+                                   MCUStopReason* reason);
+} MCUCore;
+
 typedef struct _mcu {
+  /*
+   * Hot state, touched by nearly every executed instruction. Kept at the
+   * beginning so it shares the first cache lines, everything used only by
+   * debugger and init goes after memory map.
+   */
   WORD PC;
   BYTE lastInstruction;
-
-  MCUType mcuType;
   bool noDebug;
 
+  /*
+   * Power saving modes, set by write hook of PCON.
+   */
+  bool idle;
+  bool powerDown;
+
+  /*
+   * Lazy flags (see syncFlagsMCU). Arithmetic remembers its operands in
+   * lazyOp, lazyA, lazyB, lazyC. Parity is refreshed when ACC differs from
+   * parityACC, with lazy flags only lazyParity is set.
+   */
+  bool lazyFlags;
+  BYTE lazyOp;
+  BYTE lazyA;
+  BYTE lazyB;
+  BYTE lazyC;
+  bool lazyParity;
+  BYTE parityACC;
+
+  /*
+   * Interrupts. Sources requesting interrupt (bits like in IE), checked
+   * only when flags or enable bits were accessed. Levels in service are
+   * cleared by reti.
+   */
+  BYTE pendingInterrupts;
+  BYTE interruptsInService;
+  BYTE interruptPins;
+
+  /*
+   * Error ID. 0 means no error.
+   */
+  int errid;
+
+  /*
+   * SFR stored by mcuSetIntRAM() in current instruction, its write hook
+   * was already called.
+   */
+  int _writtenSFR;
+
   unsigned long long cycles;
   unsigned long long instructions;
-  unsigned oscillator;
 
   /*
-   * Memory.
+   * Timers. TLx/THx are brought up to date only when accessed and at
+   * timerDeadline, the cycle of the next overflow (0 when timers have to be
+   * checked after every instruction). Counting since timerBase is done with
+   * configuration saved in timerTMOD, timerTCON and timerT2CON.
+   */
+  unsigned long long timerDeadline;
+  unsigned long long timerBase;
+  bool timersDirty;
+  BYTE timerTMOD;
+  BYTE timerTCON;
+  BYTE timerT2CON;
+  BYTE timerPins;
+
+  /*
+   * Most used registers in sfr, the rest is below.
+   * do not change this pointers!!!
+   */
+  BYTE* ACC;
+  BYTE* PSW;
+  BYTE* R;
+  BYTE* SP;
+  WORD* DPTR;
+  BYTE* DPL;
+  BYTE* DPH;
+  BYTE* B;
+
+  /*
+   * Instruction and SFR write hook tables. Both are static const tables
+   * shared by all instances of the same variant, init only points to them.
+   * Hooks are indexed by address - 0x80 and called after instruction
+   * stored value into SFR or changed it in other way, before is the old
+   * value. Hooks keep state derived from SFR (register bank, DPTR, ...).
+   */
+  void (* const* _instructions)(struct _mcu* mcu);
+  void (* const* _sfrWrite)(struct _mcu* mcu, BYTE before);
+  const BYTE* cycleCount;
+  const BYTE* byteCount;
+
+  unsigned codeSize;
+  unsigned idataMemorySize;
+
+  /*
+   * Memory. idata and sfr live in the structure, the 64 KB spaces are in
+   * pages (xdata, irom and xrom below).
    */
   BYTE idata[INT_RAM_SIZE];
-  BYTE xdata[MAX_EXT_RAM_SIZE];
-  BYTE irom[MAX_ROM_SIZE];
-  BYTE xrom[MAX_ROM_SIZE];
   BYTE sfr[SFR_SIZE];
 
-  BYTE* currentRom;
+  /*
+   * Memory map. Code and XDATA address space in 256 byte pages, rebuilt
+   * by mapMemoryMCU(). PC wraps at codeSize.
+   */
+  BYTE* romPages[256];
+  BYTE romPageFlags[256];
+  BYTE* xdataPages[256];
+  BYTE xdataPageFlags[256];
+
+  /*
+   * Cold state.
+   */
+  MCUType mcuType;
+  unsigned oscillator;
+
+  /*
+   * Pages of memories, NULL page isn't allocated yet and reads as zeros.
+   * Use getMemoryMCU() and others below, not these.
+   */
+  MCUPage* xdata[256];
+  MCUPage* irom[256];
+  MCUPage* xrom[256];
+
+  // Devices mapped into XDATA, the last mapped one wins on overlap.
+  MCUDevice* devices;
+  unsigned numOfDevices;
+
+  /*
+   * Predecoded code memory (see predecodeMCU). Rebuilt on the next run
+   * after invalidatePredecodedMCU().
+   */
+  MCUDecoded* decoded;
+  unsigned decodedSize;
+  bool decodedValid;
+  bool usePredecoded;
+  const MCUCore* decodedCore; // core which built decoded image
+
+  /*
+   * Incremented every time code memory or its mapping is changed.
+   */
+  unsigned codeVersion;
+
+  /*
+   * Hot blocks (see runDecodedMCU). Block is formed at address reached
+   * hotBlockThreshold times.
+   */
+  bool useBlocks;
+  unsigned hotBlockThreshold;
+
+  /*
+   * Edge coverage, COVERAGE_SIZE counters or NULL (see runMCUBatch). It
+   * belongs to the instance, copies don't get it.
+   */
+  BYTE* coverage;
+
+  /*
+   * Recompiled module (see Recompiler.h) or NULL. It belongs to the
+   * instance like coverage and is unloaded by its owner.
+   */
+  void* module;
 
   /*
    * Pins
@@ -205,22 +441,17 @@ typedef struct _mcu {
   /*
    * Memory size.
    */
-  unsigned idataMemorySize;
   unsigned xdataMemorySize;
   unsigned iromMemorySize;
   unsigned xromMemorySize;
 
   /*
-   * Last input and output.
+   * Uart. OUTPUT is byte written to SBUF until it is sent, INPUT is byte
+   * waiting for receiver (-1 if none).
    */
   int OUTPUT;
   int INPUT;
 
-  /*
-   * Error ID. 0 means no error.
-   */
-  int errid;
-
   /*
    * Lowest and highest used adresses.
    */
@@ -236,12 +467,7 @@ typedef struct _mcu {
    * pointers to registers in sfr
    * do not change this pointers!!!
    */
-
-  BYTE* SP;
   BYTE* P0;
-  WORD* DPTR;
-  BYTE* DPL;
-  BYTE* DPH;
   BYTE* DP0L;   // 89S5x
   BYTE* DP0H;   // 89S5x
   BYTE* DP1L;   // 89S5x
@@ -268,10 +494,6 @@ typedef struct _mcu {
   BYTE* RCAP2H; // 8052
   BYTE* TL2;    // 8052
   BYTE* TH2;    // 8052
-  BYTE* PSW;
-  BYTE* ACC;
-  BYTE* B;
-  BYTE* R;
 
   /*
    * Auto I/O.
@@ -325,6 +547,17 @@ typedef struct _mcu {
   BYTE _beforeAccessedIntRAM;
   BYTE _beforeAccessedExtRAM;
 
+  /*
+   * State of pseudo random generator of this instance (see randomMCU).
+   */
+  uint32_t randomState;
+
+  /*
+   * Power on contents of idata and xdata (see poisonMCU).
+   */
+  MCUPoison poison;
+  unsigned poisonValue;
+
   /*
    * Watchdog timer. (only for 89S5x)
    */
@@ -332,22 +565,22 @@ typedef struct _mcu {
   WORD WDTTimerValue;
 
   /*
-   * Instruction tables.
+   * Instruction tables, shared by all instances (see DeAsmTables.h).
    */
-  int cycleCount[256];
-  int byteCount[256];
-  char* mnemonicTable[256];
-  char* mnemonicParams[256];
-  char* SFRNames[256];
-  char* SFRBits[256];
+  const char* const* mnemonicTable;
+  const char* const* mnemonicParams;
+  const char* const* SFRNames;
+  const char* const* SFRBits;
 
   /*
-   * Pointers to microcontroller specific functions.
+   * Pointers to microcontroller specific functions. Execution cores call
+   * them directly, _cores is set by init together with them, [0] with
+   * debugger information and [1] used when noDebug is set.
    */
-  void (*_instructions[256])(struct _mcu* mcu);
   void (*_timers)(struct _mcu* mcu);
   void (*_interrupts)(struct _mcu* mcu);
   void (*_additionalCode)(struct _mcu* mcu);
+  const MCUCore* _cores[2];
   //BYTE* (*_intRam)(struct _mcu* mcu, BYTE address, bool direct, bool info);
   //BYTE* (*_setIntRam)(struct _mcu* mcu, BYTE address, bool direct, BYTE value, bool info);
   //BYTE* (*_extRam)(struct _mcu* mcu, WORD address, bool info);
@@ -356,6 +589,18 @@ typedef struct _mcu {
 } MCU;
 
 
+/*
+ * Thread safety. Simulator core (this file, IntelHex.h and DeAsm.h) keeps
+ * all state in the MCU it gets or in static const tables, nothing is taken
+ * from AppSettings(). Instances share only memory pages, which aren't
+ * changed while shared and whose counters are atomic. Different
+ * instances may be used from different threads at the same time without
+ * locking, one instance must not be used by two threads at once. Device
+ * callbacks are called on the thread which runs the instance. Loaded
+ * recompiled module and device plugins (Recompiler.h, Devices.h) belong to
+ * the application and aren't covered by this.
+ */
+
 void init8051MCU(MCU* mcu);
 void init8031MCU(MCU* mcu);
 void init8052MCU(MCU* mcu);
@@ -363,15 +608,143 @@ void init8032MCU(MCU* mcu);
 void init89S51MCU(MCU* mcu);
 void init89S52MCU(MCU* mcu);
 
+/*
+ * Init by type name (8031 8032 8051 8052 89S51 89S52). Returns false and
+ * leaves mcu untouched for unknown name.
+ */
+bool initNamedMCU(MCU* mcu, const char* type);
+
 void resetMCU(MCU* mcu);
+
+/*
+ * Per instance pseudo random generator, used instead of rand(). Init seeds
+ * it with MCU_DEFAULT_SEED. seedMCU() sets new seed and poisons memory with
+ * POISON_RANDOM and the same seed.
+ */
+unsigned randomMCU(MCU* mcu);
+void seedMCU(MCU* mcu, unsigned seed);
+
+/*
+ * Power on contents of idata and xdata, init uses POISON_RANDOM with
+ * MCU_DEFAULT_SEED. idata is filled at once, xdata is dropped and its pages
+ * get poison when they are touched first (random page depends only on
+ * value and page number), so the same policy always gives the same memory.
+ * Value is byte of POISON_PATTERN or seed of POISON_RANDOM.
+ */
+void poisonMCU(MCU* mcu, MCUPoison policy, unsigned value);
+
+/*
+ * Rebuild memory map. Must be called after memory sizes or EA were changed,
+ * predecoded code is invalidated too.
+ */
+void mapMemoryMCU(MCU* mcu);
+
+/*
+ * Map device registers into XDATA addresses first..last. movx there calls
+ * read or write (NULL read gives FFh, NULL write is ignored) instead of
+ * accessing memory, other pages keep the plain memory path. Debugger
+ * commands still see memory.
+ */
+void mapDeviceMCU(MCU* mcu, WORD first, WORD last, MCUDeviceRead read,
+                  MCUDeviceWrite write, void* context);
+void unmapDevicesMCU(MCU* mcu);
+
+/*
+ * Free memory allocated by init and mapDeviceMCU(). Must be called before
+ * the same structure is initialized again.
+ */
 void removeMCU(MCU* mcu);
 
+/*
+ * Make dst (not initialized) independent copy of src with its own
+ * breakpoints and predecoded code. Memory pages are shared until one of
+ * them writes there, so copy is cheap. Mapped devices are shared, their
+ * context is not copied.
+ */
+void cloneMCU(MCU* dst, MCU* src);
+
+/*
+ * Snapshot is an MCU (not initialized before) which keeps state of mcu:
+ * registers, memories, timers, interrupts, uart, breakpoints and pauses.
+ * Memory pages are shared like by cloneMCU(), so snapshot costs only pages
+ * written after it was made and repeated snapshots of mostly unchanged
+ * memory are cheap. Predecoded code isn't kept. restoreMCU() puts mcu into
+ * the state of snapshot, which can be restored again later. mcu keeps its
+ * execution settings (noDebug, usePredecoded, useBlocks, lazyFlags), coverage,
+ * module and its predecoded code when code memory is the same. State of device
+ * plugins isn't part of snapshot. Snapshot is freed by removeMCU().
+ */
+void snapshotMCU(MCU* snapshot, MCU* mcu);
+void restoreMCU(MCU* mcu, MCU* snapshot);
+
+/*
+ * restoreMCU() which keeps breakpoints and pauses of mcu.
+ */
+void rewindMCU(MCU* mcu, MCU* snapshot);
+
+/*
+ * Fills view with registers of mcu synced (syncMCU), mcu itself stays as it
+ * is. View shares memory pages and arrays of mcu without taking references,
+ * it is only for reading while mcu isn't changed and is never removed.
+ */
+void viewMCU(MCU* view, MCU* mcu);
+
+/*
+ * True when a and b are in the same state and will behave the same (for the
+ * same input). Compares registers, memories, timers, interrupts and uart,
+ * not breakpoints and access information. Both are compared synced, through
+ * viewMCU(), so lazy flags and timer deadlines of a and b are kept.
+ */
+bool sameStateMCU(MCU* a, MCU* b);
+
+/*
+ * Like sameStateMCU(), but registers kept by lanes (see Lanes.h) may
+ * differ: ACC, B, PSW, SP, DPL, DPH, SBUF and IDATA.
+ */
+bool sameSharedStateMCU(MCU* a, MCU* b);
+
 char* getError(MCU* mcu);
 
+/*
+ * XDATA, IROM and XROM by address in memory (not mapped like movx or
+ * movc address). Reading of page which isn't allocated gives its poison
+ * (xdata) or zeros without allocating it, setMemoryMCU() and others
+ * allocate it or copy it when it is shared and skip bytes which are the
+ * same. Code memory changes need
+ * invalidatePredecodedMCU(). Other memory types are ignored.
+ */
+BYTE getMemoryMCU(const MCU* mcu, MemoryType type, WORD address);
+void setMemoryMCU(MCU* mcu, MemoryType type, WORD address, BYTE value);
+void readMemoryMCU(const MCU* mcu, MemoryType type, WORD address, BYTE* buffer,
+                   unsigned size);
+void writeMemoryMCU(MCU* mcu, MemoryType type, WORD address, const BYTE* buffer,
+                    unsigned size);
+void fillMemoryMCU(MCU* mcu, MemoryType type, WORD address, BYTE value, unsigned size);
+
+/*
+ * Number of allocated pages of all memories, shared pages included.
+ */
+unsigned memoryPagesMCU(const MCU* mcu);
+
+/*
+ * Mapped memory without access tracking. Pointers given by extRAM() and
+ * ROM() are only for reading.
+ */
 BYTE* intRAM(MCU* mcu, BYTE address, bool direct);
 BYTE* extRAM(MCU* mcu, WORD address);
 BYTE* ROM(MCU* mcu, WORD address);
 
+/*
+ * Memory access as done by instructions. Updates accessed* members.
+ */
+BYTE* mcuIntRAM(MCU* mcu, BYTE address, bool direct);
+void mcuSetIntRAM(MCU* mcu, BYTE address, bool direct, BYTE value);
+BYTE mcuReadExtRAM(MCU* mcu, WORD address);
+void mcuWriteExtRAM(MCU* mcu, WORD address, BYTE value);
+BYTE mcuReadROM(MCU* mcu, WORD address);
+bool mcuCheckBit(MCU* mcu, BYTE bit);
+void mcuSetBit(MCU* mcu, BYTE bit, bool state);
+
 bool checkRegister(MCU* mcu, WORD flag);
 void setRegister(MCU* mcu, WORD flag, bool state);
 
@@ -393,7 +766,6 @@ double getMCUTime(MCU* mcu);
  * This instruction also update timers and following members of MCU structure:
  * accessedSFR, accessedIntRAM, accessedExtRAM, changedSFR, changedIntRAM,
  * changedExtRAM
- * TODO: T2 Timer.
  */
 void processMCU(MCU* mcu);
 
@@ -405,8 +777,131 @@ void processMCU(MCU* mcu);
  */
 bool processMCUEx(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn);
 
+/*
+ * processMCUEx() split in two for code executed outside of the simulator
+ * (recompiled modules). beginInstructionMCU() accounts instruction at PC
+ * which last byte is at lastByte, endInstructionMCU() finishes it after PC
+ * and registers were updated and returns the same as processMCUEx().
+ */
+void beginInstructionMCU(MCU* mcu, WORD lastByte);
+bool endInstructionMCU(MCU* mcu, BYTE* out, BYTE* in, bool* useOut, bool* needIn);
+
+/*
+ * Hot blocks of recompiled modules, like blocks of runDecodedMCU(), but
+ * they can follow jumps. blockSafeMCU() tells whether instruction at
+ * address can be a part of block, *movx is set when it accesses XDATA.
+ * beginBlockMCU() returns number of cycles which can run without timers,
+ * interrupts, uart and debugger, 0 when block can't start now. Every
+ * instruction of block is finished by nextInstructionMCU() which returns
+ * false on error or pending interrupt, and whole block by endBlockMCU()
+ * which accounts it and returns the same as processMCUEx().
+ */
+bool blockSafeMCU(MCU* mcu, WORD address, bool* movx);
+unsigned beginBlockMCU(MCU* mcu);
+bool nextInstructionMCU(MCU* mcu, BYTE opcode, WORD lastByte);
+bool endBlockMCU(MCU* mcu, unsigned instructions, unsigned cycles, BYTE* out, BYTE* in,
+                 bool* useOut, bool* needIn);
+
+/*
+ * Parts of instructions for recompiled modules. arithmeticMCU() does add,
+ * addc or subb given by opcode with value as operand, executeInstructionMCU()
+ * runs instruction at PC without anything else. arithmeticFlagsMCU() gives
+ * AC, CY and OV bits of PSW after a + b + c or a - b - c (subtract).
+ */
+void arithmeticMCU(MCU* mcu, BYTE opcode, BYTE value);
+void executeInstructionMCU(MCU* mcu);
+BYTE arithmeticFlagsMCU(bool subtract, BYTE a, BYTE b, int c);
+
+/*
+ * True when program stopped itself: power down mode, idle mode or endless
+ * `sjmp $` with interrupts disabled.
+ */
+bool isHaltedMCU(MCU* mcu);
+
+/*
+ * In idle mode or in busy-wait loop (`sjmp $`, `jb bit,$`, `jnb bit,$`,
+ * `djnz Rn,$`) move time forward to the step before the next timer
+ * overflow, watchdog reset, uart transmission or the end of djnz loop, but
+ * not more than count steps (idle cycles or instructions). Returns number
+ * of skipped steps, 0 when the next step has to be executed. Call between
+ * instructions, cycle exact like executing skipped steps.
+ */
+unsigned long long fastForwardMCU(MCU* mcu, unsigned long long count);
+
 char* disassembler(MCU* mcu, WORD ip, char* format, WORD* next);
 
+/*
+ * With lazyFlags set CY, AC, OV and P are computed only when PSW is
+ * accessed. Memory functions do it itself, call it before reading mcu->PSW
+ * or mcu->sfr directly.
+ */
+void syncFlagsMCU(MCU* mcu);
+
+/*
+ * Write current counts of running timers into TLx/THx. Like syncFlagsMCU()
+ * done by memory functions itself.
+ */
+void syncTimersMCU(MCU* mcu);
+
+/*
+ * Both of the above, additionally refreshes state kept by SFR write hooks.
+ * Call before SFR are read and after they were written directly.
+ */
+void syncMCU(MCU* mcu);
+
+/*
+ * Find the next timer event and pending interrupts again after syncMCU(),
+ * as the next instruction would do, so that beginBlockMCU() can start a
+ * block right away. Interrupt isn't taken.
+ */
+void settleMCU(MCU* mcu);
+
+/*
+ * Second execution engine. Code memory is decoded once into MCUDecoded
+ * records and run with direct-threaded dispatch. The decoded image must be
+ * invalidated every time code memory, memory sizes or EA pin are changed
+ * from outside of the simulator.
+ */
+void predecodeMCU(MCU* mcu);
+void invalidatePredecodedMCU(MCU* mcu);
+
+/*
+ * Run up to count instructions on the predecoded engine. Stops after
+ * breakpoint, conditional pause or error (unless noDebug is set). Uart is
+ * handled like processMCUEx() called without in and out buffers. Return
+ * number of executed instructions.
+ *
+ * With useBlocks set, hot straight-line code is run block at a time when
+ * timers, interrupts, watchdog and uart are idle and no breakpoint is set.
+ */
+unsigned long long runDecodedMCU(MCU* mcu, unsigned long long count);
+
+/*
+ * Run until maxInstr steps (instructions or idle cycles) or maxCycles
+ * cycles are done (MCU_NO_LIMIT for none) or one of conditions in stopMask
+ * occurs, reason is stored in *reason. Uses predecoded engine when
+ * usePredecoded is set, idle time and busy-wait loops are skipped with
+ * fastForwardMCU(). Returns number of executed steps.
+ *
+ * Uart input is taken from INPUT. Output is sent right away unless
+ * STOP_OUTPUT is in stopMask, then batch stops with byte in OUTPUT and the
+ * caller gets it with takeOutputMCU().
+ *
+ * When coverage is set, interpreter (not predecoded engine) counts every
+ * executed jump, call, return and conditional branch, taken or not, in
+ * coverage[hash of its address and address of next instruction]. Counters
+ * stop at 255.
+ */
+unsigned long long runMCUBatch(MCU* mcu, unsigned long long maxInstr,
+                               unsigned long long maxCycles, int stopMask,
+                               MCUStopReason* reason);
+
+/*
+ * Finish sending byte written to SBUF (sets TI). Returns the byte or -1
+ * when nothing is being sent.
+ */
+int takeOutputMCU(MCU* mcu);
+
 #endif /* _8051_H_ */
 
 /*
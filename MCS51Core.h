@@ -0,0 +1,629 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * Execution core. This file is a template, MCS51.c includes it once for
+ * every MCU variant and debug mode with these macros set:
+ *
+ * CORE(name)       - name of function or table in this instance
+ * CORE_TIMERS      - timers function
+ * CORE_INTERRUPTS  - interrupts function
+ * CORE_ADDITIONAL  - additional code function, not defined when none
+ * CORE_DEBUG       - 1 with debugger information, 0 for noDebug
+ *
+ * Per-instruction functions are called directly, so compiler can inline
+ * them. Core without debugging uses instructions built without access
+ * bookkeeping. The macros are undefined at the end of this file.
+ */
+
+#if CORE_DEBUG
+#define CORE_TRACK TRACK_ALL
+#define CORE_INSTRUCTIONS instructions
+#else
+#define CORE_TRACK TRACK_SFR
+#define CORE_INSTRUCTIONS instructions_fast
+#endif
+
+#define mcuIntRAM(mcu, address, direct) \
+  _mcuIntRAM(mcu, address, direct, CORE_TRACK)
+#define mcuSetIntRAM(mcu, address, direct, value) \
+  _mcuSetIntRAM(mcu, address, direct, value, CORE_TRACK)
+#define mcuROM(mcu, address) _mcuROM(mcu, address, CORE_DEBUG)
+#define mcuCheckBit(mcu, bit) _mcuCheckBit(mcu, bit, CORE_TRACK)
+#define mcuSetBit(mcu, bit, state) _mcuSetBit(mcu, bit, state, CORE_TRACK)
+
+static const MCUCore CORE(core);
+
+/*
+ * Called after instruction was executed.
+ */
+static inline void CORE(mcuEndInstruction)(MCU* mcu)
+{
+  if (mcu->PC >= mcu->codeSize)
+    mcu->PC %= mcu->codeSize;
+
+  mcuTrackInstruction(mcu, CORE_DEBUG);
+
+  CORE_TIMERS(mcu);
+  CORE_INTERRUPTS(mcu);
+
+#ifdef CORE_ADDITIONAL
+  CORE_ADDITIONAL(mcu);
+#endif
+}
+
+/*
+ * One machine cycle of idle mode. Instructions are not executed, timers,
+ * interrupts and watchdog work like after nop.
+ */
+static inline void CORE(mcuIdleStep)(MCU* mcu)
+{
+  mcuBeginInstruction(mcu);
+  mcu->lastInstruction = 0x00;
+  mcu->cycles += 1;
+  CORE(mcuEndInstruction)(mcu);
+}
+
+/*
+ * Direct-threaded dispatcher. Every record holds address of the label which
+ * executes it, so next instruction is reached with a single indirect jump.
+ * Most frequent instructions are executed here on predecoded operands,
+ * remaining ones go through instruction table. Count 0 only rebuilds
+ * decoded image. Labels differ between cores, image is rebuilt when other
+ * core runs it.
+ */
+static unsigned long long CORE(mcuExecuteDecoded)(MCU* mcu, unsigned long long count,
+                                                  unsigned long long end, int stopMask,
+                                                  MCUStopReason* reason)
+{
+  static const void* const labels[256] = {
+    [0x00 ... 0xFF] = &&op_generic,
+    [0x00] = &&op_nop,
+    [0x01] = &&op_ajmp, [0x21] = &&op_ajmp, [0x41] = &&op_ajmp, [0x61] = &&op_ajmp,
+    [0x81] = &&op_ajmp, [0xA1] = &&op_ajmp, [0xC1] = &&op_ajmp, [0xE1] = &&op_ajmp,
+    [0x11] = &&op_acall, [0x31] = &&op_acall, [0x51] = &&op_acall, [0x71] = &&op_acall,
+    [0x91] = &&op_acall, [0xB1] = &&op_acall, [0xD1] = &&op_acall, [0xF1] = &&op_acall,
+    [0x02] = &&op_ljmp,
+    [0x12] = &&op_lcall,
+    [0x22] = &&op_ret,
+    [0x80] = &&op_sjmp,
+    [0x60] = &&op_jz,
+    [0x70] = &&op_jnz,
+    [0x40] = &&op_jc,
+    [0x50] = &&op_jnc,
+    [0x20] = &&op_jb,
+    [0x30] = &&op_jnb,
+    [0x74] = &&op_mov_a_imm,
+    [0x75] = &&op_mov_dir_imm,
+    [0x78 ... 0x7F] = &&op_mov_r_imm,
+    [0xE8 ... 0xEF] = &&op_mov_a_r,
+    [0xF8 ... 0xFF] = &&op_mov_r_a,
+    [0xE5] = &&op_mov_a_dir,
+    [0xF5] = &&op_mov_dir_a,
+    [0x85] = &&op_mov_dir_dir,
+    [0xE6 ... 0xE7] = &&op_mov_a_ind,
+    [0xF6 ... 0xF7] = &&op_mov_ind_a,
+    [0x90] = &&op_mov_dptr,
+    [0x04] = &&op_inc_a,
+    [0x08 ... 0x0F] = &&op_inc_r,
+    [0x18 ... 0x1F] = &&op_dec_r,
+    [0xA3] = &&op_inc_dptr,
+    [0xE4] = &&op_clr_a,
+    [0xD8 ... 0xDF] = &&op_djnz_r,
+    [0xB4] = &&op_cjne_a_imm,
+    [0xB8 ... 0xBF] = &&op_cjne_r_imm,
+    [0x24] = &&op_add_imm,
+    [0x44] = &&op_orl_imm,
+    [0x54] = &&op_anl_imm,
+    [0x64] = &&op_xrl_imm,
+    [0xC0] = &&op_push,
+    [0xD0] = &&op_pop,
+    [0xD2] = &&op_setb,
+    [0xC2] = &&op_clr,
+  };
+
+  unsigned long long executed = 0;
+  MCUDecoded* d;
+  WORD tempW;
+  BYTE tempB;
+  MCUStopReason stop;
+
+  bool batch = reason != NULL;
+  bool blocks = batch && mcu->useBlocks;
+  bool parked = false; // after busy-wait loop
+  unsigned block = 0; // instructions left in running block
+  unsigned blockInstructions = 0;
+  unsigned long long blockCycles = 0;
+
+  /*
+   * (Re)build decoded image, also when EA pin maps other ROM while running.
+   */
+decode:
+  if (!mcu->decodedValid || mcu->decodedCore != &CORE(core)) {
+    // Whole address space, PC can be set to any value from debugger.
+    if (mcu->decoded == NULL) {
+      mcu->decoded = malloc(MAX_ROM_SIZE * sizeof(MCUDecoded));
+      mcu->decodedSize = MAX_ROM_SIZE;
+    }
+
+    for (unsigned i = 0; i < mcu->decodedSize; ++i)
+      mcuDecode(mcu, i, &mcu->decoded[i], labels[*ROM(mcu, i)]);
+
+    mcu->decodedValid = true;
+    mcu->decodedCore = &CORE(core);
+  }
+
+  if (executed == count)
+    return executed;
+
+#define FETCH() \
+  do { \
+    d = &mcu->decoded[mcu->PC]; \
+    mcu->lastInstruction = d->opcode; \
+    if (!CORE_DEBUG) \
+      break; \
+    if (d->ext) \
+      mcu->accessedExtROM = d->romAddress; \
+    else \
+      mcu->accessedIntROM = d->romAddress; \
+  } while (0)
+
+#define DISPATCH() \
+  do { \
+    if (!mcu->decodedValid) \
+      goto decode; \
+    if (blocks) \
+      goto block_check; \
+    mcuBeginInstruction(mcu); \
+    if (!mcu->decodedValid) \
+      goto decode; \
+    FETCH(); \
+    mcu->instructions += 1; \
+    mcu->cycles += d->cycles; \
+    goto *d->handler; \
+  } while (0)
+
+#define NEXT() \
+  do { \
+    if (block != 0) \
+      goto block_next; \
+    CORE(mcuEndInstruction)(mcu); \
+    executed += 1; \
+    if (batch) { \
+      stop = mcuBatchStop(mcu, stopMask); \
+      if (stop != STOP_NONE) \
+        goto stopped; \
+    } \
+    if (executed == count || mcu->cycles >= end) \
+      goto done; \
+    if (parked || mcu->idle) \
+      goto park; \
+    DISPATCH(); \
+  } while (0)
+
+#define REL(offset) ((signed char) (offset))
+
+#define PUSH_PC(address) \
+  do { \
+    *mcu->SP += 1; \
+    mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) ((address) & 0x00FF)); \
+    *mcu->SP += 1; \
+    mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) ((address) >> 8)); \
+  } while (0)
+
+  DISPATCH();
+
+op_generic:
+  CORE_INSTRUCTIONS[d->opcode](mcu);
+  NEXT();
+
+op_nop:
+  mcu->PC += 1;
+  NEXT();
+
+op_ajmp:
+  mcu->PC = (WORD) (d->opcode >> 5) << 8 | d->op1;
+  NEXT();
+
+op_acall:
+  tempW = mcu->PC + 2;
+  mcu->PC = (WORD) (d->opcode >> 5) << 8 | d->op1;
+  PUSH_PC(tempW);
+  NEXT();
+
+op_ljmp:
+  mcu->PC = (WORD) d->op1 << 8 | d->op2;
+  NEXT();
+
+op_lcall:
+  tempW = mcu->PC + 3;
+  mcu->PC = (WORD) d->op1 << 8 | d->op2;
+  PUSH_PC(tempW);
+  NEXT();
+
+op_ret:
+  mcu->PC = (WORD) *mcuIntRAM(mcu, *mcu->SP, false) << 8 | (WORD) *mcuIntRAM(mcu,
+            *mcu->SP - 1, false);
+  *mcu->SP = *mcu->SP - 2;
+  NEXT();
+
+op_sjmp:
+  mcu->PC += 2 + REL(d->op1);
+  parked = batch && d->op1 == 0xFE;
+  NEXT();
+
+op_jz:
+  mcu->PC += *mcu->ACC == 0 ? 2 + REL(d->op1) : 2;
+  NEXT();
+
+op_jnz:
+  mcu->PC += *mcu->ACC != 0 ? 2 + REL(d->op1) : 2;
+  NEXT();
+
+op_jc:
+  mcu->PC += checkRegister(mcu, PSW_CY) ? 2 + REL(d->op1) : 2;
+  NEXT();
+
+op_jnc:
+  mcu->PC += !checkRegister(mcu, PSW_CY) ? 2 + REL(d->op1) : 2;
+  NEXT();
+
+op_jb:
+  mcu->PC += mcuCheckBit(mcu, d->op1) ? 3 + REL(d->op2) : 3;
+  parked = batch && d->op2 == 0xFD;
+  NEXT();
+
+op_jnb:
+  mcu->PC += !mcuCheckBit(mcu, d->op1) ? 3 + REL(d->op2) : 3;
+  parked = batch && d->op2 == 0xFD;
+  NEXT();
+
+op_mov_a_imm:
+  *mcu->ACC = d->op1;
+  mcu->PC += 2;
+  NEXT();
+
+op_mov_dir_imm:
+  mcuSetIntRAM(mcu, d->op1, true, d->op2);
+  mcu->PC += 3;
+  NEXT();
+
+op_mov_r_imm:
+  mcu->R[d->opcode & 0x07] = d->op1;
+  mcu->PC += 2;
+  NEXT();
+
+op_mov_a_r:
+  *mcu->ACC = mcu->R[d->opcode & 0x07];
+  mcu->PC += 1;
+  NEXT();
+
+op_mov_r_a:
+  mcu->R[d->opcode & 0x07] = *mcu->ACC;
+  mcu->PC += 1;
+  NEXT();
+
+op_mov_a_dir:
+  *mcu->ACC = *mcuIntRAM(mcu, d->op1, true);
+  mcu->PC += 2;
+  NEXT();
+
+op_mov_dir_a:
+  mcuSetIntRAM(mcu, d->op1, true, *mcu->ACC);
+  mcu->PC += 2;
+  NEXT();
+
+op_mov_dir_dir:
+  mcuSetIntRAM(mcu, d->op2, true, *mcuIntRAM(mcu, d->op1, true));
+  mcu->PC += 3;
+  NEXT();
+
+op_mov_a_ind:
+  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[d->opcode & 0x01], false);
+  mcu->PC += 1;
+  NEXT();
+
+op_mov_ind_a:
+  mcuSetIntRAM(mcu, mcu->R[d->opcode & 0x01], false, *mcu->ACC);
+  mcu->PC += 1;
+  NEXT();
+
+op_mov_dptr:
+  *mcu->DPH = d->op1;
+  *mcu->DPL = d->op2;
+  mcu->PC += 3;
+  NEXT();
+
+op_inc_a:
+  (*mcu->ACC)++;
+  mcu->PC += 1;
+  NEXT();
+
+op_inc_r:
+  mcu->R[d->opcode & 0x07]++;
+  mcu->PC += 1;
+  NEXT();
+
+op_dec_r:
+  mcu->R[d->opcode & 0x07]--;
+  mcu->PC += 1;
+  NEXT();
+
+op_inc_dptr:
+  *mcu->DPTR = *mcu->DPTR + 1;
+  mcu->PC += 1;
+  NEXT();
+
+op_clr_a:
+  *mcu->ACC = 0;
+  mcu->PC += 1;
+  NEXT();
+
+op_djnz_r:
+  mcu->PC += --mcu->R[d->opcode & 0x07] != 0 ? 2 + REL(d->op1) : 2;
+  parked = batch && d->op1 == 0xFE;
+  NEXT();
+
+op_cjne_a_imm:
+  setRegister(mcu, PSW_CY, *mcu->ACC < d->op1);
+  mcu->PC += *mcu->ACC != d->op1 ? 3 + REL(d->op2) : 3;
+  NEXT();
+
+op_cjne_r_imm:
+  tempB = mcu->R[d->opcode & 0x07];
+  setRegister(mcu, PSW_CY, tempB < d->op1);
+  mcu->PC += tempB != d->op1 ? 3 + REL(d->op2) : 3;
+  NEXT();
+
+op_add_imm:
+  tempB = d->op1;
+  mcuAdd(mcu, mcu->ACC, &tempB);
+  mcu->PC += 2;
+  NEXT();
+
+op_orl_imm:
+  *mcu->ACC |= d->op1;
+  mcu->PC += 2;
+  NEXT();
+
+op_anl_imm:
+  *mcu->ACC &= d->op1;
+  mcu->PC += 2;
+  NEXT();
+
+op_xrl_imm:
+  *mcu->ACC ^= d->op1;
+  mcu->PC += 2;
+  NEXT();
+
+op_push:
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, *mcuIntRAM(mcu, d->op1, true));
+  mcu->PC += 2;
+  NEXT();
+
+op_pop:
+  mcuSetIntRAM(mcu, d->op1, true, *mcuIntRAM(mcu, *mcu->SP, false));
+  *mcu->SP = *mcu->SP - 1;
+  mcu->PC += 2;
+  NEXT();
+
+op_setb:
+  mcuSetBit(mcu, d->op1, true);
+  mcu->PC += 2;
+  NEXT();
+
+op_clr:
+  mcuSetBit(mcu, d->op1, false);
+  mcu->PC += 2;
+  NEXT();
+
+  /*
+   * Hot blocks.
+   */
+block_check:
+  d = &mcu->decoded[mcu->PC];
+
+  if (d->blockLength == 0 && ++d->hits >= mcu->hotBlockThreshold)
+    mcuFormBlock(mcu, mcu->PC);
+
+  if (!d->blockSafe || count - executed < d->blockLength ||
+      end - mcu->cycles <= d->blockLength * 4u ||
+      !mcuBlockQuiet(mcu, MAX_BLOCK_LENGTH * 4)) {
+    mcuBeginInstruction(mcu);
+    if (!mcu->decodedValid)
+      goto decode;
+    FETCH();
+    mcu->instructions += 1;
+    mcu->cycles += d->cycles;
+    goto *d->handler;
+  }
+
+  block = d->blockLength;
+  blockInstructions = 0;
+  blockCycles = 0;
+  mcu->errid = E_NOERRORS;
+  FETCH();
+  blockCycles += d->cycles;
+  goto *d->handler;
+
+block_next:
+  if (mcu->PC >= mcu->codeSize)
+    mcu->PC %= mcu->codeSize;
+  mcuTrackInstruction(mcu, CORE_DEBUG);
+  executed += 1;
+  blockInstructions += 1;
+  block -= 1;
+
+  if (block != 0 && mcu->errid == E_NOERRORS) {
+    FETCH();
+    blockCycles += d->cycles;
+    goto *d->handler;
+  }
+
+  block = 0;
+  mcu->instructions += blockInstructions;
+  mcu->cycles += blockCycles;
+
+  // Uart, like after the last instruction.
+  stop = mcuBatchStop(mcu, stopMask);
+  if (stop != STOP_NONE)
+    goto stopped;
+
+  if (executed == count || mcu->cycles >= end)
+    goto done;
+  if (parked)
+    goto park;
+  DISPATCH();
+
+  /*
+   * Idle mode and busy-wait loops, skip time to the next event.
+   */
+park:
+  parked = false;
+  executed += mcuFastForward(mcu, count - executed, end);
+
+  while (mcu->idle && executed < count && mcu->cycles < end) {
+    CORE(mcuIdleStep)(mcu);
+    executed += 1;
+
+    if (batch) {
+      stop = mcuBatchStop(mcu, stopMask);
+      if (stop != STOP_NONE)
+        goto stopped;
+    }
+
+    executed += mcuFastForward(mcu, count - executed, end);
+  }
+
+  if (executed == count || mcu->cycles >= end)
+    goto done;
+  DISPATCH();
+
+stopped:
+  *reason = stop;
+
+done:
+#undef FETCH
+#undef DISPATCH
+#undef NEXT
+#undef REL
+#undef PUSH_PC
+  return executed;
+}
+
+/*
+ * processMCU().
+ */
+static inline void CORE(mcuStep)(MCU* mcu)
+{
+  if (mcu->idle) {
+    CORE(mcuIdleStep)(mcu);
+    return;
+  }
+
+  if (mcu->usePredecoded) {
+    CORE(mcuExecuteDecoded)(mcu, 1, MCU_NO_LIMIT, 0, NULL);
+    return;
+  }
+
+  mcuBeginInstruction(mcu);
+
+  /*
+   * Actual instruction
+   */
+  mcu->lastInstruction = *mcuROM(mcu, mcu->PC);
+
+  /*
+   * Number of executed instructions.
+   */
+  mcu->instructions += 1;
+
+  /*
+   * Cycles.
+   */
+  mcu->cycles += mcu->cycleCount[mcu->lastInstruction];
+
+  /*
+   * Instructions.
+   */
+  CORE_INSTRUCTIONS[mcu->lastInstruction](mcu);
+
+  CORE(mcuEndInstruction)(mcu);
+}
+
+/*
+ * runMCUBatch() on interpreter.
+ */
+static unsigned long long CORE(mcuRun)(MCU* mcu, unsigned long long count,
+                                       unsigned long long end, int stopMask,
+                                       MCUStopReason* reason)
+{
+  unsigned long long executed = 0;
+  MCUStopReason stop;
+
+  while (executed < count && mcu->cycles < end) {
+    WORD from;
+
+    executed += mcuFastForward(mcu, count - executed, end);
+    if (executed == count || mcu->cycles >= end)
+      break;
+
+    from = mcu->PC;
+    CORE(mcuStep)(mcu);
+    executed += 1;
+
+    if (mcu->coverage != NULL)
+      mcuCoverEdge(mcu, from);
+
+    stop = mcuBatchStop(mcu, stopMask);
+    if (stop != STOP_NONE) {
+      *reason = stop;
+      break;
+    }
+  }
+
+  return executed;
+}
+
+static const MCUCore CORE(core) = {
+  &CORE(mcuStep),
+  &CORE(mcuEndInstruction),
+  &CORE(mcuRun),
+  &CORE(mcuExecuteDecoded),
+};
+
+#undef mcuIntRAM
+#undef mcuSetIntRAM
+#undef mcuROM
+#undef mcuCheckBit
+#undef mcuSetBit
+#undef CORE_TRACK
+#undef CORE_INSTRUCTIONS
+
+#undef CORE
+#undef CORE_TIMERS
+#undef CORE_INTERRUPTS
+#undef CORE_ADDITIONAL
+#undef CORE_DEBUG
+
+/*
+vi:ts=4:et:nowrap
+*/
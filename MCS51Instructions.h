@@ -0,0 +1,1119 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * Instruction handlers. This file is a template, MCS51.c includes it once
+ * with debugger information and once without it, with these macros set:
+ *
+ * INSTR(name)    - name of handler or table in this instance
+ * INSTR_TRACK    - TRACK_ALL or TRACK_SFR, access tracking of memory wrappers
+ * INSTR_COMPACT  - 1 for compact handler set, 0 for full one
+ *
+ * Opcodes are taken from MCS51Opcodes.h. Instructions which differ by
+ * register or page only are written once as family taking opcode. The
+ * macros are undefined at the end of this file.
+ */
+
+#define mcuIntRAM(mcu, address, direct) \
+  _mcuIntRAM(mcu, address, direct, INSTR_TRACK)
+#define mcuSetIntRAM(mcu, address, direct, value) \
+  _mcuSetIntRAM(mcu, address, direct, value, INSTR_TRACK)
+#define mcuReadExtRAM(mcu, address) \
+  _mcuReadExtRAM(mcu, address, INSTR_TRACK == TRACK_ALL)
+#define mcuWriteExtRAM(mcu, address, value) \
+  _mcuWriteExtRAM(mcu, address, value, INSTR_TRACK == TRACK_ALL)
+#define mcuROM(mcu, address) _mcuROM(mcu, address, INSTR_TRACK == TRACK_ALL)
+#define mcuCheckBit(mcu, bit) _mcuCheckBit(mcu, bit, INSTR_TRACK)
+#define mcuSetBit(mcu, bit, state) _mcuSetBit(mcu, bit, state, INSTR_TRACK)
+
+static void INSTR(nop_00)(MCU* mcu)
+{
+  mcu->PC += 1;
+}
+
+// mov a,#(byte)
+static void INSTR(mov_74)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// mov (adress),#(byte)
+static void INSTR(mov_75)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuROM(mcu, mcu->PC + 1));
+  mcu->PC += 2;
+}
+
+// ljmp 16bit_adres
+static void INSTR(ljmp_02)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC) << 8 | *mcuROM(mcu, mcu->PC + 1);
+}
+
+// sjmp offset
+static void INSTR(sjmp_80)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+}
+
+// mov (adress1),(ardess2)
+static void INSTR(mov_85)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC + 1), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true));
+  mcu->PC += 2;
+}
+
+// mov A,(adress)
+static void INSTR(mov_E5)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// mov (bit),C
+static void INSTR(mov_92)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY))
+    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
+  else
+    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
+  mcu->PC += 1;
+}
+
+// inc a
+static void INSTR(inc_04)(MCU* mcu)
+{
+  (*mcu->ACC)++;
+  mcu->PC += 1;
+}
+
+// inc (adress)
+static void INSTR(inc_05)(MCU* mcu)
+{
+  mcu->PC += 1;
+  (*mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))++;
+  mcu->PC += 1;
+}
+
+// inc DPTR
+static void INSTR(inc_A3)(MCU* mcu)
+{
+  *mcu->DPTR = *mcu->DPTR + 1;
+  mcu->PC += 1;
+}
+
+// inc @Ri
+static inline void INSTR(inc_ri)(MCU* mcu, BYTE opcode)
+{
+  (*mcuIntRAM(mcu, mcu->R[opcode & 0x01], false))++;
+  mcu->PC += 1;
+}
+
+// inc Rn
+static inline void INSTR(inc_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->R[opcode & 0x07]++;
+  mcu->PC += 1;
+}
+
+// dec A
+static void INSTR(dec_14)(MCU* mcu)
+{
+  *mcu->ACC = *mcu->ACC - 1;
+  mcu->PC += 1;
+}
+
+// dec (adress)
+static void INSTR(dec_15)(MCU* mcu)
+{
+  mcu->PC += 1;
+  (*mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))--;
+  mcu->PC += 1;
+}
+
+// dec @Ri
+static inline void INSTR(dec_ri)(MCU* mcu, BYTE opcode)
+{
+  (*mcuIntRAM(mcu, mcu->R[opcode & 0x01], false))--;
+  mcu->PC += 1;
+}
+
+// dec Rn
+static inline void INSTR(dec_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->R[opcode & 0x07]--;
+  mcu->PC += 1;
+}
+
+// div AB
+static void INSTR(div_84)(MCU* mcu)
+{
+  BYTE tempB;
+
+  setRegister(mcu, PSW_CY, false);
+  if (*mcu->B != 0) {
+    tempB = *mcu->ACC;
+    *mcu->ACC = tempB / *mcu->B;
+    *mcu->B = tempB % *mcu->B;
+  } else
+    setRegister(mcu, PSW_OV, true);
+  mcu->PC += 1;
+}
+
+// mul AB
+static void INSTR(mul_A4)(MCU* mcu)
+{
+  WORD tempW;
+
+  tempW = (WORD) *mcu->ACC * (WORD) *mcu->B;
+  if (tempW > 255)
+    setRegister(mcu, PSW_OV, true);
+  else
+    setRegister(mcu, PSW_OV, false);
+  *mcu->B = (BYTE) tempW >> 8;
+  *mcu->ACC = (BYTE) (tempW & 0xFF);
+  mcu->PC += 1;
+}
+
+// rl A
+static void INSTR(rl_23)(MCU* mcu)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = tempB << 1 | tempB >> 7;
+  mcu->PC += 1;
+}
+
+// rr A
+static void INSTR(rr_03)(MCU* mcu)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = tempB >> 1 | tempB << 7;
+  mcu->PC += 1;
+}
+
+// rlc A
+static void INSTR(rlc_33)(MCU* mcu)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = tempB << 1 | checkRegister(mcu, PSW_CY);
+  if (tempB & 0x80)
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// rrc A
+static void INSTR(rrc_13)(MCU* mcu)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = tempB >> 1 | checkRegister(mcu, PSW_CY) << 7;
+  if (tempB & 0x01)
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// mov DPTR,#(16-bit data)
+static void INSTR(mov_90)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->DPH = *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+  *mcu->DPL = *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// mov (adress),A
+static void INSTR(mov_F5)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// add A,#(data)
+static void INSTR(add_24)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuAdd(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
+  mcu->PC += 1;
+}
+
+// add A,(adres)
+static void INSTR(add_25)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuAdd(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
+  mcu->PC += 1;
+}
+
+// add A,@Ri
+static inline void INSTR(add_ri)(MCU* mcu, BYTE opcode)
+{
+  mcuAdd(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[opcode & 0x01], false));
+  mcu->PC += 1;
+}
+
+// add A,Rn
+static inline void INSTR(add_rn)(MCU* mcu, BYTE opcode)
+{
+  mcuAdd(mcu, mcu->ACC, &mcu->R[opcode & 0x07]);
+  mcu->PC += 1;
+}
+
+// ADDC
+// addc A,#(data)
+static void INSTR(addc_34)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuAddc(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
+  mcu->PC += 1;
+}
+
+// addc A,(adres)
+static void INSTR(addc_35)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuAddc(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
+  mcu->PC += 1;
+}
+
+// addc A,@Ri
+static inline void INSTR(addc_ri)(MCU* mcu, BYTE opcode)
+{
+  mcuAddc(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[opcode & 0x01], false));
+  mcu->PC += 1;
+}
+
+// addc A,Rn
+static inline void INSTR(addc_rn)(MCU* mcu, BYTE opcode)
+{
+  mcuAddc(mcu, mcu->ACC, &mcu->R[opcode & 0x07]);
+  mcu->PC += 1;
+}
+
+// movx A,@DPTR
+static void INSTR(movx_E0)(MCU* mcu)
+{
+  *mcu->ACC = mcuReadExtRAM(mcu, *mcu->DPTR);
+  mcu->PC += 1;
+}
+
+// movx @DPTR,A
+static void INSTR(movx_F0)(MCU* mcu)
+{
+  mcuWriteExtRAM(mcu, *mcu->DPTR, *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// push (adress)
+static void INSTR(push_C0)(MCU* mcu)
+{
+  *mcu->SP += 1;
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
+  mcu->PC += 1;
+}
+
+// pop (adress)
+static void INSTR(pop_D0)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu, *mcu->SP, false));
+  *mcu->SP = *mcu->SP - 1;
+  mcu->PC += 1;
+}
+
+// clr C
+static void INSTR(clr_C3)(MCU* mcu)
+{
+  setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// setb C
+static void INSTR(setb_D3)(MCU* mcu)
+{
+  setRegister(mcu, PSW_CY, true);
+  mcu->PC += 1;
+}
+
+// setb (bit)
+static void INSTR(setb_D2)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// clr (bit)
+static void INSTR(clr_C2)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
+  mcu->PC += 1;
+}
+
+// xrl (adress),A
+static void INSTR(xrl_62)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true) ^ (*mcu->ACC));
+  mcu->PC += 1;
+}
+
+// xrl (adress),#(data)
+static void INSTR(xrl_63)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) ^= *mcuROM(mcu, mcu->PC + 1);
+  mcu->PC += 2;
+}
+
+// xrl A,#(data)
+static void INSTR(xrl_64)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcu->ACC ^ *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// xrl A,(adress)
+static void INSTR(xrl_65)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcu->ACC ^ *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// xrl A,@Ri
+static inline void INSTR(xrl_ri)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcu->ACC ^ *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcu->PC += 1;
+}
+
+// xrl A,Rn
+static inline void INSTR(xrl_rn)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = (*mcu->ACC) ^ mcu->R[opcode & 0x07];
+  mcu->PC += 1;
+}
+
+// xch A,(adress)
+static void INSTR(xch_C5)(MCU* mcu)
+{
+  BYTE tempB;
+
+  mcu->PC += 1;
+  tempB = *mcu->ACC;
+  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, tempB);
+  mcu->PC += 1;
+}
+
+// xch A,@Ri
+static inline void INSTR(xch_ri)(MCU* mcu, BYTE opcode)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcuSetIntRAM(mcu, mcu->R[opcode & 0x01], false, tempB);
+  mcu->PC += 1;
+}
+
+// xch A,Rn
+static inline void INSTR(xch_rn)(MCU* mcu, BYTE opcode)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  *mcu->ACC = mcu->R[opcode & 0x07];
+  mcu->R[opcode & 0x07] = tempB;
+  mcu->PC += 1;
+}
+
+// lcall 16bit_adres
+static void INSTR(lcall_12)(MCU* mcu)
+{
+  WORD tempW;
+
+  tempW = mcu->PC + 3;
+  mcu->PC += 1;
+  mcu->PC = (WORD) *mcuROM(mcu, mcu->PC) << 8 | *mcuROM(mcu, mcu->PC + 1);
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+}
+
+// ret
+static void INSTR(ret_22)(MCU* mcu)
+{
+  mcu->PC = (WORD) *mcuIntRAM(mcu, *mcu->SP, false) << 8 | (WORD) *mcuIntRAM(mcu,
+            *mcu->SP - 1, false);
+  *mcu->SP = *mcu->SP - 2;
+}
+
+// jnz (offset)
+static void INSTR(jnz_70)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (*mcu->ACC != 0)
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  else
+    mcu->PC += 1;
+}
+
+// jz (offset)
+static void INSTR(jz_60)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (*mcu->ACC == 0)
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  else
+    mcu->PC += 1;
+}
+
+// jc (offset)
+static void INSTR(jc_40)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY))
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  else
+    mcu->PC += 1;
+}
+
+// jnc (offset)
+static void INSTR(jnc_50)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (!checkRegister(mcu, PSW_CY))
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  else
+    mcu->PC += 1;
+}
+
+// swap A
+static void INSTR(swap_C4)(MCU* mcu)
+{
+  BYTE tempB;
+
+  tempB = *mcu->ACC;
+  tempB = (tempB << 4) & 0xF0;
+  *mcu->ACC = (*mcu->ACC >> 4) & 0x0F;
+  *mcu->ACC = *mcu->ACC | tempB;
+  mcu->PC += 1;
+}
+
+// movc A,@DPTR+A
+static void INSTR(movc_93)(MCU* mcu)
+{
+  *mcu->ACC = *mcuROM(mcu, *mcu->ACC + *mcu->DPTR);
+  mcu->PC += 1;
+}
+
+// movc A,@mcu->PC+A
+static void INSTR(movc_83)(MCU* mcu)
+{
+  *mcu->ACC = *mcuROM(mcu, *mcu->ACC + mcu->PC);
+  mcu->PC += 1;
+}
+
+// mov A,@Ri
+static inline void INSTR(mov_a_ri)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcu->PC += 1;
+}
+
+// mov @Ri,A
+static inline void INSTR(mov_ri_a)(MCU* mcu, BYTE opcode)
+{
+  mcuSetIntRAM(mcu, mcu->R[opcode & 0x01], false, *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// mov Rn,#(data)
+static inline void INSTR(mov_rn_imm)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcu->R[opcode & 0x07] = *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// mov Rn,(adress)
+static inline void INSTR(mov_rn_dir)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcu->R[opcode & 0x07] = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// mov (adress),Rn
+static inline void INSTR(mov_dir_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, mcu->R[opcode & 0x07]);
+  mcu->PC += 1;
+}
+
+// mov Rn,A
+static inline void INSTR(mov_rn_a)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcu->R[opcode & 0x07] = *mcu->ACC;
+}
+
+// mov A,Rn
+static inline void INSTR(mov_a_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  *mcu->ACC = mcu->R[opcode & 0x07];
+}
+
+// clr A
+static void INSTR(clr_E4)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = 0;
+}
+
+// ajmp (11-bit address)
+static inline void INSTR(ajmp_page)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcu->PC = (WORD) (opcode >> 5) << 8 | *mcuROM(mcu, mcu->PC);
+}
+
+// acall (11-bit address)
+static inline void INSTR(acall_page)(MCU* mcu, BYTE opcode)
+{
+  WORD tempW;
+
+  tempW = mcu->PC + 2;
+  mcu->PC += 1;
+  mcu->PC = (WORD) (opcode >> 5) << 8 | *mcuROM(mcu, mcu->PC);
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW & 0x00FF));
+  *mcu->SP += 1;
+  mcuSetIntRAM(mcu, *mcu->SP, false, (BYTE) (tempW >> 8));
+}
+
+// djnz Rn,(offset)
+static inline void INSTR(djnz_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcu->R[opcode & 0x07]--;
+  if (mcu->R[opcode & 0x07] != 0)
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// djnz (adress),(offset)
+static void INSTR(djnz_D5)(MCU* mcu)
+{
+  BYTE tempB;
+
+  mcu->PC += 1;
+  tempB = *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+  (*mcuIntRAM(mcu, tempB, true))--;
+  if (*mcuIntRAM(mcu, tempB, true) != 0)
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// orl (adress),#(data)
+static void INSTR(orl_43)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true) | *mcuROM(mcu, mcu->PC + 1));
+  mcu->PC += 2;
+}
+
+// orl A,#(data)
+static void INSTR(orl_44)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcuROM(mcu, mcu->PC) | *mcu->ACC;
+  mcu->PC += 1;
+}
+
+// orl A,(adress)
+static void INSTR(orl_45)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) | *mcu->ACC;
+  mcu->PC += 1;
+}
+
+// orl (adress),A
+static void INSTR(orl_42)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true) | *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// orl A,Rn
+static inline void INSTR(orl_rn)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcu->ACC | mcu->R[opcode & 0x07];
+  mcu->PC += 1;
+}
+
+// orl A,@Ri
+static inline void INSTR(orl_ri)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcu->ACC | *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcu->PC += 1;
+}
+
+// anl A,#(data)
+static void INSTR(anl_54)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcu->ACC & *mcuROM(mcu, mcu->PC);
+  mcu->PC += 1;
+}
+
+// anl A,(adress)
+static void INSTR(anl_55)(MCU* mcu)
+{
+  mcu->PC += 1;
+  *mcu->ACC = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true) & *mcu->ACC;
+  mcu->PC += 1;
+}
+
+// anl (adress),A
+static void INSTR(anl_52)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true) & *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// anl (adress),#(data)
+static void INSTR(anl_53)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, *mcuROM(mcu, mcu->PC), true, *mcuIntRAM(mcu,
+               *mcuROM(mcu, mcu->PC), true) & *mcuROM(mcu, mcu->PC + 1));
+  mcu->PC += 2;
+}
+
+// anl A,Rn
+static inline void INSTR(anl_rn)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcu->ACC & mcu->R[opcode & 0x07];
+  mcu->PC += 1;
+}
+
+// anl A,@Ri
+static inline void INSTR(anl_ri)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = *mcu->ACC & *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcu->PC += 1;
+}
+
+// mov C,(bit)
+static void INSTR(mov_A2)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// cpl (bit)
+static void INSTR(cpl_B2)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
+  else
+    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// cpl C
+static void INSTR(cpl_B3)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY))
+    setRegister(mcu, PSW_CY, false);
+  else
+    setRegister(mcu, PSW_CY, true);
+}
+
+// orl C,(bit)
+static void INSTR(orl_72)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY) || mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// orl C,/(bit)
+static void INSTR(orl_A0)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY) || !mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// anl C,(bit)
+static void INSTR(anl_82)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY) && mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// anl C,/(bit)
+static void INSTR(anl_B0)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_CY) && !mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC)))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  mcu->PC += 1;
+}
+
+// cpl A
+static void INSTR(cpl_F4)(MCU* mcu)
+{
+  *mcu->ACC = *mcu->ACC ^ 0xFF;
+  mcu->PC += 1;
+}
+
+// mov @Ri,(adress)
+static inline void INSTR(mov_ri_dir)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false)
+  = *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true);
+  mcu->PC += 1;
+}
+
+// mov @Ri,#(data)
+static inline void INSTR(mov_ri_imm)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcuSetIntRAM(mcu, mcu->R[opcode & 0x01], false, *mcuROM(mcu, mcu->PC));
+  mcu->PC += 1;
+}
+
+// mov (adress),@Ri
+static inline void INSTR(mov_dir_ri)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true)
+  = *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false);
+  mcu->PC += 1;
+}
+
+// jmp @A+DPTR
+static void INSTR(jmp_73)(MCU* mcu)
+{
+  mcu->PC = (WORD) (*mcu->ACC + *mcu->DPTR);
+}
+
+// cjne A,#(byte),offset
+static void INSTR(cjne_B4)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (*mcu->ACC < *mcuROM(mcu, mcu->PC))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  if (*mcu->ACC != *mcuROM(mcu, mcu->PC)) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else {
+    mcu->PC += 2;
+  }
+}
+
+// cjne A,(adress),offset
+static void INSTR(cjne_B5)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (*mcu->ACC < *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  if (*mcu->ACC != *mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true)) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else {
+    mcu->PC += 2;
+  }
+}
+
+// cjne @Ri,#(byte),offset
+static inline void INSTR(cjne_ri)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  if (*mcuIntRAM(mcu, mcu->R[opcode & 0x01], false) < *mcuROM(mcu, mcu->PC))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  if (*mcuIntRAM(mcu, mcu->R[opcode & 0x01], false) != *mcuROM(mcu, mcu->PC)) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else {
+    mcu->PC += 2;
+  }
+}
+
+// cjne Rn,#(byte),offset
+static inline void INSTR(cjne_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  if (mcu->R[opcode & 0x07] < *mcuROM(mcu, mcu->PC))
+    setRegister(mcu, PSW_CY, true);
+  else
+    setRegister(mcu, PSW_CY, false);
+  if (mcu->R[opcode & 0x07] != *mcuROM(mcu, mcu->PC)) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else {
+    mcu->PC += 2;
+  }
+}
+
+// reti
+static void INSTR(reti_32)(MCU* mcu)
+{
+  mcu->PC = (WORD) *mcuIntRAM(mcu, *mcu->SP, false) << 8 | (WORD) *mcuIntRAM(mcu,
+            *mcu->SP - 1, false);
+  *mcu->SP = *mcu->SP - 2;
+
+  // End of the interrupt with the highest level.
+  if (mcu->interruptsInService & INT_HIGH)
+    mcu->interruptsInService &= ~INT_HIGH;
+  else
+    mcu->interruptsInService = 0;
+  mcu->pendingInterrupts |= INT_DIRTY;
+}
+
+// jnb (bit),(offset)
+static void INSTR(jnb_30)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (!mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else
+    mcu->PC += 2;
+}
+
+// jb (bit),(offset)
+static void INSTR(jb_20)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else
+    mcu->PC += 2;
+}
+
+// jbc (bit),(offset)
+static void INSTR(jbc_10)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (mcuCheckBit(mcu, *mcuROM(mcu, mcu->PC))) {
+    mcuSetBit(mcu, *mcuROM(mcu, mcu->PC), false);
+    mcu->PC += 1;
+    mcu->PC += (signed char) *mcuROM(mcu, mcu->PC) + 1;
+  } else
+    mcu->PC += 2;
+}
+
+// subb A,#(data)
+static void INSTR(subb_94)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSub(mcu, mcu->ACC, &*mcuROM(mcu, mcu->PC));
+  mcu->PC += 1;
+}
+
+// subb A,(adress)
+static void INSTR(subb_95)(MCU* mcu)
+{
+  mcu->PC += 1;
+  mcuSub(mcu, mcu->ACC, mcuIntRAM(mcu, *mcuROM(mcu, mcu->PC), true));
+  mcu->PC += 1;
+}
+
+// subb A,@Ri
+static inline void INSTR(subb_ri)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcuSub(mcu, mcu->ACC, mcuIntRAM(mcu, mcu->R[opcode & 0x01], false));
+  mcu->PC += 1;
+}
+
+// subb A,Rn
+static inline void INSTR(subb_rn)(MCU* mcu, BYTE opcode)
+{
+  mcu->PC += 1;
+  mcuSub(mcu, mcu->ACC, &mcu->R[opcode & 0x07]);
+}
+
+// da A
+static void INSTR(da_D4)(MCU* mcu)
+{
+  mcu->PC += 1;
+  if (checkRegister(mcu, PSW_AC) || ((*mcu->ACC & 0x0F) > 0x09)) {
+    *mcu->ACC += 0x06;
+    if ((*mcu->ACC & 0x0F) > 0x0F)
+      setRegister(mcu, PSW_CY, true);
+  }
+  if (checkRegister(mcu, PSW_CY) || ((*mcu->ACC & 0xF0) > 0x90)) {
+    *mcu->ACC += 0x60;
+    if ((*mcu->ACC & 0xF0) > 0xF0)
+      setRegister(mcu, PSW_CY, true);
+  }
+}
+
+// xchd A,@Ri
+static inline void INSTR(xchd_ri)(MCU* mcu, BYTE opcode)
+{
+  BYTE tempB;
+
+  mcu->PC += 1;
+  tempB = *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false) & 0xF;
+  *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false) &= 0xF;
+  *mcuIntRAM(mcu, mcu->R[opcode & 0x01], false) |= (*mcu->ACC) & 0xF;
+  (*mcu->ACC) &= 0xF;
+  (*mcu->ACC) |= tempB;
+}
+
+// movx A,@Ri
+static inline void INSTR(movx_a_ri)(MCU* mcu, BYTE opcode)
+{
+  *mcu->ACC = mcuReadExtRAM(mcu, mcu->R[opcode & 0x01]);
+  mcu->PC += 1;
+}
+
+// movx @Ri,A
+static inline void INSTR(movx_ri_a)(MCU* mcu, BYTE opcode)
+{
+  mcuWriteExtRAM(mcu, mcu->R[opcode & 0x01], *mcu->ACC);
+  mcu->PC += 1;
+}
+
+// reserved
+static void INSTR(reserved_A5)(MCU* mcu)
+{
+  mcu->errid = E_UNSUPPORTED;
+  mcu->PC += 1;
+}
+
+/*
+ * Handlers of OPCODE_REG() opcodes. Full set has one handler per opcode
+ * with constant operand. Compact set has one handler per family which
+ * takes operand from lastInstruction, it is smaller and leaves more of
+ * instruction cache for the dispatch loop.
+ */
+#if INSTR_COMPACT
+#define OPCODE_FAMILY(family) \
+  static void INSTR(family##_any)(MCU* mcu) \
+  { \
+    INSTR(family)(mcu, mcu->lastInstruction); \
+  }
+#else
+#define OPCODE_REG(code, handler, family, bytes, cycles, mnemonic, params) \
+  static void INSTR(handler)(MCU* mcu) \
+  { \
+    INSTR(family)(mcu, code); \
+  }
+#endif
+#include "MCS51Opcodes.h"
+
+/*
+ * Handlers by opcode.
+ */
+static void (* const INSTR(instructions)[256])(MCU* mcu) = {
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params) \
+  [code] = &INSTR(handler),
+#if INSTR_COMPACT
+#define OPCODE_REG(code, handler, family, bytes, cycles, mnemonic, params) \
+  [code] = &INSTR(family##_any),
+#endif
+#include "MCS51Opcodes.h"
+};
+
+#undef mcuIntRAM
+#undef mcuSetIntRAM
+#undef mcuReadExtRAM
+#undef mcuWriteExtRAM
+#undef mcuROM
+#undef mcuCheckBit
+#undef mcuSetBit
+
+#undef INSTR
+#undef INSTR_TRACK
+#undef INSTR_COMPACT
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,371 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * Instruction set of MCS-51, the only place where opcodes are described.
+ * This file is an X-macro list, including file defines some of these
+ * macros before #include:
+ *
+ * OPCODE(code, handler, bytes, cycles, mnemonic, params)
+ *   - one opcode; handler from MCS51Instructions.h, cycles in machine
+ *     cycles, mnemonic and params as printed by disassembler (params
+ *     syntax is described in DeAsmTables.h)
+ *
+ * OPCODE_REG(code, handler, family, bytes, cycles, mnemonic, params)
+ *   - opcode which differs from others only by register or page coded
+ *     in opcode; family is the shared body which takes opcode, handler
+ *     is generated from it. Defaults to OPCODE().
+ *
+ * OPCODE_FAMILY(family)
+ *   - every family once, before opcodes
+ *
+ * Macros which aren't defined expand to nothing. All of them are
+ * undefined at the end of this file.
+ */
+
+#ifndef OPCODE
+#define OPCODE(code, handler, bytes, cycles, mnemonic, params)
+#endif
+
+#ifndef OPCODE_REG
+#define OPCODE_REG(code, handler, family, bytes, cycles, mnemonic, params) \
+  OPCODE(code, handler, bytes, cycles, mnemonic, params)
+#endif
+
+#ifndef OPCODE_FAMILY
+#define OPCODE_FAMILY(family)
+#endif
+
+OPCODE_FAMILY(inc_rn)
+OPCODE_FAMILY(dec_rn)
+OPCODE_FAMILY(add_rn)
+OPCODE_FAMILY(addc_rn)
+OPCODE_FAMILY(orl_rn)
+OPCODE_FAMILY(anl_rn)
+OPCODE_FAMILY(xrl_rn)
+OPCODE_FAMILY(mov_rn_imm)
+OPCODE_FAMILY(mov_dir_rn)
+OPCODE_FAMILY(subb_rn)
+OPCODE_FAMILY(mov_rn_dir)
+OPCODE_FAMILY(cjne_rn)
+OPCODE_FAMILY(xch_rn)
+OPCODE_FAMILY(djnz_rn)
+OPCODE_FAMILY(mov_a_rn)
+OPCODE_FAMILY(mov_rn_a)
+OPCODE_FAMILY(inc_ri)
+OPCODE_FAMILY(dec_ri)
+OPCODE_FAMILY(add_ri)
+OPCODE_FAMILY(addc_ri)
+OPCODE_FAMILY(orl_ri)
+OPCODE_FAMILY(anl_ri)
+OPCODE_FAMILY(xrl_ri)
+OPCODE_FAMILY(mov_ri_imm)
+OPCODE_FAMILY(mov_dir_ri)
+OPCODE_FAMILY(subb_ri)
+OPCODE_FAMILY(mov_ri_dir)
+OPCODE_FAMILY(cjne_ri)
+OPCODE_FAMILY(xch_ri)
+OPCODE_FAMILY(xchd_ri)
+OPCODE_FAMILY(mov_a_ri)
+OPCODE_FAMILY(mov_ri_a)
+OPCODE_FAMILY(movx_a_ri)
+OPCODE_FAMILY(movx_ri_a)
+OPCODE_FAMILY(ajmp_page)
+OPCODE_FAMILY(acall_page)
+
+OPCODE(0x00, nop_00,                   1, 1, "nop  ", "")
+OPCODE_REG(0x01, ajmp_01, ajmp_page,   2, 2, "ajmp ", "00N%1")
+OPCODE(0x02, ljmp_02,                  3, 2, "ljmp ", "N%1N%2")
+OPCODE(0x03, rr_03,                    1, 1, "rr   ", "A")
+OPCODE(0x04, inc_04,                   1, 1, "inc  ", "A")
+OPCODE(0x05, inc_05,                   2, 1, "inc  ", "%1")
+OPCODE_REG(0x06, inc_06, inc_ri,       1, 1, "inc  ", "@R0")
+OPCODE_REG(0x07, inc_07, inc_ri,       1, 1, "inc  ", "@R1")
+OPCODE_REG(0x08, inc_08, inc_rn,       1, 1, "inc  ", "R0")
+OPCODE_REG(0x09, inc_09, inc_rn,       1, 1, "inc  ", "R1")
+OPCODE_REG(0x0A, inc_0A, inc_rn,       1, 1, "inc  ", "R2")
+OPCODE_REG(0x0B, inc_0B, inc_rn,       1, 1, "inc  ", "R3")
+OPCODE_REG(0x0C, inc_0C, inc_rn,       1, 1, "inc  ", "R4")
+OPCODE_REG(0x0D, inc_0D, inc_rn,       1, 1, "inc  ", "R5")
+OPCODE_REG(0x0E, inc_0E, inc_rn,       1, 1, "inc  ", "R6")
+OPCODE_REG(0x0F, inc_0F, inc_rn,       1, 1, "inc  ", "R7")
+
+OPCODE(0x10, jbc_10,                   3, 2, "jbc  ", "0%1, O%2")
+OPCODE_REG(0x11, acall_11, acall_page, 2, 2, "acall", "00N%1")
+OPCODE(0x12, lcall_12,                 3, 2, "lcall", "N%1N%2")
+OPCODE(0x13, rrc_13,                   1, 1, "rrc  ", "A")
+OPCODE(0x14, dec_14,                   1, 1, "dec  ", "A")
+OPCODE(0x15, dec_15,                   2, 1, "dec  ", "%1")
+OPCODE_REG(0x16, dec_16, dec_ri,       1, 1, "dec  ", "@R0")
+OPCODE_REG(0x17, dec_17, dec_ri,       1, 1, "dec  ", "@R1")
+OPCODE_REG(0x18, dec_18, dec_rn,       1, 1, "dec  ", "R0")
+OPCODE_REG(0x19, dec_19, dec_rn,       1, 1, "dec  ", "R1")
+OPCODE_REG(0x1A, dec_1A, dec_rn,       1, 1, "dec  ", "R2")
+OPCODE_REG(0x1B, dec_1B, dec_rn,       1, 1, "dec  ", "R3")
+OPCODE_REG(0x1C, dec_1C, dec_rn,       1, 1, "dec  ", "R4")
+OPCODE_REG(0x1D, dec_1D, dec_rn,       1, 1, "dec  ", "R5")
+OPCODE_REG(0x1E, dec_1E, dec_rn,       1, 1, "dec  ", "R6")
+OPCODE_REG(0x1F, dec_1F, dec_rn,       1, 1, "dec  ", "R7")
+
+OPCODE(0x20, jb_20,                    3, 2, "jb   ", "0%1, O%2")
+OPCODE_REG(0x21, ajmp_21, ajmp_page,   2, 2, "ajmp ", "01N%1")
+OPCODE(0x22, ret_22,                   1, 2, "ret  ", "")
+OPCODE(0x23, rl_23,                    1, 1, "rl   ", "A")
+OPCODE(0x24, add_24,                   2, 1, "add  ", "A, #%1")
+OPCODE(0x25, add_25,                   2, 1, "add  ", "A, %1")
+OPCODE_REG(0x26, add_26, add_ri,       1, 1, "add  ", "A, @R0")
+OPCODE_REG(0x27, add_27, add_ri,       1, 1, "add  ", "A, @R1")
+OPCODE_REG(0x28, add_28, add_rn,       1, 1, "add  ", "A, R0")
+OPCODE_REG(0x29, add_29, add_rn,       1, 1, "add  ", "A, R1")
+OPCODE_REG(0x2A, add_2A, add_rn,       1, 1, "add  ", "A, R2")
+OPCODE_REG(0x2B, add_2B, add_rn,       1, 1, "add  ", "A, R3")
+OPCODE_REG(0x2C, add_2C, add_rn,       1, 1, "add  ", "A, R4")
+OPCODE_REG(0x2D, add_2D, add_rn,       1, 1, "add  ", "A, R5")
+OPCODE_REG(0x2E, add_2E, add_rn,       1, 1, "add  ", "A, R6")
+OPCODE_REG(0x2F, add_2F, add_rn,       1, 1, "add  ", "A, R7")
+
+OPCODE(0x30, jnb_30,                   3, 2, "jnb  ", "0%1, O%2")
+OPCODE_REG(0x31, acall_31, acall_page, 2, 2, "acall", "01N%1")
+OPCODE(0x32, reti_32,                  1, 2, "reti ", "")
+OPCODE(0x33, rlc_33,                   1, 1, "rlc  ", "A")
+OPCODE(0x34, addc_34,                  2, 1, "addc ", "A, #%1")
+OPCODE(0x35, addc_35,                  2, 1, "addc ", "A, %1")
+OPCODE_REG(0x36, addc_36, addc_ri,     1, 1, "addc ", "A, @R0")
+OPCODE_REG(0x37, addc_37, addc_ri,     1, 1, "addc ", "A, @R1")
+OPCODE_REG(0x38, addc_38, addc_rn,     1, 1, "addc ", "A, R0")
+OPCODE_REG(0x39, addc_39, addc_rn,     1, 1, "addc ", "A, R1")
+OPCODE_REG(0x3A, addc_3A, addc_rn,     1, 1, "addc ", "A, R2")
+OPCODE_REG(0x3B, addc_3B, addc_rn,     1, 1, "addc ", "A, R3")
+OPCODE_REG(0x3C, addc_3C, addc_rn,     1, 1, "addc ", "A, R4")
+OPCODE_REG(0x3D, addc_3D, addc_rn,     1, 1, "addc ", "A, R5")
+OPCODE_REG(0x3E, addc_3E, addc_rn,     1, 1, "addc ", "A, R6")
+OPCODE_REG(0x3F, addc_3F, addc_rn,     1, 1, "addc ", "A, R7")
+
+OPCODE(0x40, jc_40,                    2, 2, "jc   ", "O%1")
+OPCODE_REG(0x41, ajmp_41, ajmp_page,   2, 2, "ajmp ", "02N%1")
+OPCODE(0x42, orl_42,                   2, 1, "orl  ", "%1, A")
+OPCODE(0x43, orl_43,                   3, 2, "orl  ", "%1, #%2")
+OPCODE(0x44, orl_44,                   2, 1, "orl  ", "A, #%1")
+OPCODE(0x45, orl_45,                   2, 1, "orl  ", "A, %1")
+OPCODE_REG(0x46, orl_46, orl_ri,       1, 1, "orl  ", "A, @R0")
+OPCODE_REG(0x47, orl_47, orl_ri,       1, 1, "orl  ", "A, @R1")
+OPCODE_REG(0x48, orl_48, orl_rn,       1, 1, "orl  ", "A, R0")
+OPCODE_REG(0x49, orl_49, orl_rn,       1, 1, "orl  ", "A, R1")
+OPCODE_REG(0x4A, orl_4A, orl_rn,       1, 1, "orl  ", "A, R2")
+OPCODE_REG(0x4B, orl_4B, orl_rn,       1, 1, "orl  ", "A, R3")
+OPCODE_REG(0x4C, orl_4C, orl_rn,       1, 1, "orl  ", "A, R4")
+OPCODE_REG(0x4D, orl_4D, orl_rn,       1, 1, "orl  ", "A, R5")
+OPCODE_REG(0x4E, orl_4E, orl_rn,       1, 1, "orl  ", "A, R6")
+OPCODE_REG(0x4F, orl_4F, orl_rn,       1, 1, "orl  ", "A, R7")
+
+OPCODE(0x50, jnc_50,                   2, 2, "jnc  ", "O%1")
+OPCODE_REG(0x51, acall_51, acall_page, 2, 2, "acall", "02N%1")
+OPCODE(0x52, anl_52,                   2, 1, "anl  ", "%1, A")
+OPCODE(0x53, anl_53,                   3, 2, "anl  ", "%1, #%2")
+OPCODE(0x54, anl_54,                   2, 1, "anl  ", "A, #%1")
+OPCODE(0x55, anl_55,                   2, 1, "anl  ", "A, %1")
+OPCODE_REG(0x56, anl_56, anl_ri,       1, 1, "anl  ", "A, @R0")
+OPCODE_REG(0x57, anl_57, anl_ri,       1, 1, "anl  ", "A, @R1")
+OPCODE_REG(0x58, anl_58, anl_rn,       1, 1, "anl  ", "A, R0")
+OPCODE_REG(0x59, anl_59, anl_rn,       1, 1, "anl  ", "A, R1")
+OPCODE_REG(0x5A, anl_5A, anl_rn,       1, 1, "anl  ", "A, R2")
+OPCODE_REG(0x5B, anl_5B, anl_rn,       1, 1, "anl  ", "A, R3")
+OPCODE_REG(0x5C, anl_5C, anl_rn,       1, 1, "anl  ", "A, R4")
+OPCODE_REG(0x5D, anl_5D, anl_rn,       1, 1, "anl  ", "A, R5")
+OPCODE_REG(0x5E, anl_5E, anl_rn,       1, 1, "anl  ", "A, R6")
+OPCODE_REG(0x5F, anl_5F, anl_rn,       1, 1, "anl  ", "A, R7")
+
+OPCODE(0x60, jz_60,                    2, 2, "jz   ", "O%1")
+OPCODE_REG(0x61, ajmp_61, ajmp_page,   2, 2, "ajmp ", "03N%1")
+OPCODE(0x62, xrl_62,                   2, 1, "xrl  ", "%1, A")
+OPCODE(0x63, xrl_63,                   3, 2, "xrl  ", "%1, #%2")
+OPCODE(0x64, xrl_64,                   2, 1, "xrl  ", "A, #%1")
+OPCODE(0x65, xrl_65,                   2, 1, "xrl  ", "A, %1")
+OPCODE_REG(0x66, xrl_66, xrl_ri,       1, 1, "xrl  ", "A, @R0")
+OPCODE_REG(0x67, xrl_67, xrl_ri,       1, 1, "xrl  ", "A, @R1")
+OPCODE_REG(0x68, xrl_68, xrl_rn,       1, 1, "xrl  ", "A, R0")
+OPCODE_REG(0x69, xrl_69, xrl_rn,       1, 1, "xrl  ", "A, R1")
+OPCODE_REG(0x6A, xrl_6A, xrl_rn,       1, 1, "xrl  ", "A, R2")
+OPCODE_REG(0x6B, xrl_6B, xrl_rn,       1, 1, "xrl  ", "A, R3")
+OPCODE_REG(0x6C, xrl_6C, xrl_rn,       1, 1, "xrl  ", "A, R4")
+OPCODE_REG(0x6D, xrl_6D, xrl_rn,       1, 1, "xrl  ", "A, R5")
+OPCODE_REG(0x6E, xrl_6E, xrl_rn,       1, 1, "xrl  ", "A, R6")
+OPCODE_REG(0x6F, xrl_6F, xrl_rn,       1, 1, "xrl  ", "A, R7")
+
+OPCODE(0x70, jnz_70,                   2, 2, "jnz  ", "O%1")
+OPCODE_REG(0x71, acall_71, acall_page, 2, 2, "acall", "03N%1")
+OPCODE(0x72, orl_72,                   2, 2, "orl  ", "C, 0%1")
+OPCODE(0x73, jmp_73,                   1, 2, "jmp  ", "@A+DPTR")
+OPCODE(0x74, mov_74,                   2, 1, "mov  ", "A, #%1")
+OPCODE(0x75, mov_75,                   3, 2, "mov  ", "%1, #%2")
+OPCODE_REG(0x76, mov_76, mov_ri_imm,   2, 1, "mov  ", "@R0, #%1")
+OPCODE_REG(0x77, mov_77, mov_ri_imm,   2, 1, "mov  ", "@R1, #%1")
+OPCODE_REG(0x78, mov_78, mov_rn_imm,   2, 1, "mov  ", "R0, #%1")
+OPCODE_REG(0x79, mov_79, mov_rn_imm,   2, 1, "mov  ", "R1, #%1")
+OPCODE_REG(0x7A, mov_7A, mov_rn_imm,   2, 1, "mov  ", "R2, #%1")
+OPCODE_REG(0x7B, mov_7B, mov_rn_imm,   2, 1, "mov  ", "R3, #%1")
+OPCODE_REG(0x7C, mov_7C, mov_rn_imm,   2, 1, "mov  ", "R4, #%1")
+OPCODE_REG(0x7D, mov_7D, mov_rn_imm,   2, 1, "mov  ", "R5, #%1")
+OPCODE_REG(0x7E, mov_7E, mov_rn_imm,   2, 1, "mov  ", "R6, #%1")
+OPCODE_REG(0x7F, mov_7F, mov_rn_imm,   2, 1, "mov  ", "R7, #%1")
+
+OPCODE(0x80, sjmp_80,                  2, 2, "sjmp ", "O%1")
+OPCODE_REG(0x81, ajmp_81, ajmp_page,   2, 2, "ajmp ", "04N%1")
+OPCODE(0x82, anl_82,                   2, 2, "anl  ", "C, 0%1")
+OPCODE(0x83, movc_83,                  1, 2, "movc ", "A, @A+PC")
+OPCODE(0x84, div_84,                   1, 4, "div  ", "AB")
+OPCODE(0x85, mov_85,                   3, 2, "mov  ", "%2, %1")
+OPCODE_REG(0x86, mov_86, mov_dir_ri,   2, 2, "mov  ", "%1, @R0")
+OPCODE_REG(0x87, mov_87, mov_dir_ri,   2, 2, "mov  ", "%1, @R1")
+OPCODE_REG(0x88, mov_88, mov_dir_rn,   2, 2, "mov  ", "%1, R0")
+OPCODE_REG(0x89, mov_89, mov_dir_rn,   2, 2, "mov  ", "%1, R1")
+OPCODE_REG(0x8A, mov_8A, mov_dir_rn,   2, 2, "mov  ", "%1, R2")
+OPCODE_REG(0x8B, mov_8B, mov_dir_rn,   2, 2, "mov  ", "%1, R3")
+OPCODE_REG(0x8C, mov_8C, mov_dir_rn,   2, 2, "mov  ", "%1, R4")
+OPCODE_REG(0x8D, mov_8D, mov_dir_rn,   2, 2, "mov  ", "%1, R5")
+OPCODE_REG(0x8E, mov_8E, mov_dir_rn,   2, 2, "mov  ", "%1, R6")
+OPCODE_REG(0x8F, mov_8F, mov_dir_rn,   2, 2, "mov  ", "%1, R7")
+
+OPCODE(0x90, mov_90,                   3, 2, "mov  ", "DPTR, #N%1N%2")
+OPCODE_REG(0x91, acall_91, acall_page, 2, 2, "acall", "04N%1")
+OPCODE(0x92, mov_92,                   2, 2, "mov  ", "0%1, C")
+OPCODE(0x93, movc_93,                  1, 2, "movc ", "A, @A+DPTR")
+OPCODE(0x94, subb_94,                  2, 1, "subb ", "A, #%1")
+OPCODE(0x95, subb_95,                  2, 1, "subb ", "A, %1")
+OPCODE_REG(0x96, subb_96, subb_ri,     1, 1, "subb ", "A, @R0")
+OPCODE_REG(0x97, subb_97, subb_ri,     1, 1, "subb ", "A, @R1")
+OPCODE_REG(0x98, subb_98, subb_rn,     1, 1, "subb ", "A, R0")
+OPCODE_REG(0x99, subb_99, subb_rn,     1, 1, "subb ", "A, R1")
+OPCODE_REG(0x9A, subb_9A, subb_rn,     1, 1, "subb ", "A, R2")
+OPCODE_REG(0x9B, subb_9B, subb_rn,     1, 1, "subb ", "A, R3")
+OPCODE_REG(0x9C, subb_9C, subb_rn,     1, 1, "subb ", "A, R4")
+OPCODE_REG(0x9D, subb_9D, subb_rn,     1, 1, "subb ", "A, R5")
+OPCODE_REG(0x9E, subb_9E, subb_rn,     1, 1, "subb ", "A, R6")
+OPCODE_REG(0x9F, subb_9F, subb_rn,     1, 1, "subb ", "A, R7")
+
+OPCODE(0xA0, orl_A0,                   2, 2, "orl  ", "C, /0%1")
+OPCODE_REG(0xA1, ajmp_A1, ajmp_page,   2, 2, "ajmp ", "05N%1")
+OPCODE(0xA2, mov_A2,                   2, 1, "mov  ", "C, 0%1")
+OPCODE(0xA3, inc_A3,                   1, 2, "inc  ", "DPTR")
+OPCODE(0xA4, mul_A4,                   1, 4, "mul  ", "AB")
+OPCODE(0xA5, reserved_A5,              1, 1, "RESVD", "")
+OPCODE_REG(0xA6, mov_A6, mov_ri_dir,   2, 2, "mov  ", "@R0, %1")
+OPCODE_REG(0xA7, mov_A7, mov_ri_dir,   2, 2, "mov  ", "@R1, %1")
+OPCODE_REG(0xA8, mov_A8, mov_rn_dir,   2, 2, "mov  ", "R0, %1")
+OPCODE_REG(0xA9, mov_A9, mov_rn_dir,   2, 2, "mov  ", "R1, %1")
+OPCODE_REG(0xAA, mov_AA, mov_rn_dir,   2, 2, "mov  ", "R2, %1")
+OPCODE_REG(0xAB, mov_AB, mov_rn_dir,   2, 2, "mov  ", "R3, %1")
+OPCODE_REG(0xAC, mov_AC, mov_rn_dir,   2, 2, "mov  ", "R4, %1")
+OPCODE_REG(0xAD, mov_AD, mov_rn_dir,   2, 2, "mov  ", "R5, %1")
+OPCODE_REG(0xAE, mov_AE, mov_rn_dir,   2, 2, "mov  ", "R6, %1")
+OPCODE_REG(0xAF, mov_AF, mov_rn_dir,   2, 2, "mov  ", "R7, %1")
+
+OPCODE(0xB0, anl_B0,                   2, 2, "anl  ", "C, /0%1")
+OPCODE_REG(0xB1, acall_B1, acall_page, 2, 2, "acall", "05N%1")
+OPCODE(0xB2, cpl_B2,                   2, 1, "cpl  ", "0%1")
+OPCODE(0xB3, cpl_B3,                   1, 1, "cpl  ", "C")
+OPCODE(0xB4, cjne_B4,                  3, 2, "cjne ", "A, #%1, O%2")
+OPCODE(0xB5, cjne_B5,                  3, 2, "cjne ", "A, %1, O%2")
+OPCODE_REG(0xB6, cjne_B6, cjne_ri,     3, 2, "cjne ", "@R0, #%1, O%2")
+OPCODE_REG(0xB7, cjne_B7, cjne_ri,     3, 2, "cjne ", "@R1, #%1, O%2")
+OPCODE_REG(0xB8, cjne_B8, cjne_rn,     3, 2, "cjne ", "R0, #%1, O%2")
+OPCODE_REG(0xB9, cjne_B9, cjne_rn,     3, 2, "cjne ", "R1, #%1, O%2")
+OPCODE_REG(0xBA, cjne_BA, cjne_rn,     3, 2, "cjne ", "R2, #%1, O%2")
+OPCODE_REG(0xBB, cjne_BB, cjne_rn,     3, 2, "cjne ", "R3, #%1, O%2")
+OPCODE_REG(0xBC, cjne_BC, cjne_rn,     3, 2, "cjne ", "R4, #%1, O%2")
+OPCODE_REG(0xBD, cjne_BD, cjne_rn,     3, 2, "cjne ", "R5, #%1, O%2")
+OPCODE_REG(0xBE, cjne_BE, cjne_rn,     3, 2, "cjne ", "R6, #%1, O%2")
+OPCODE_REG(0xBF, cjne_BF, cjne_rn,     3, 2, "cjne ", "R7, #%1, O%2")
+
+OPCODE(0xC0, push_C0,                  2, 2, "push ", "%1")
+OPCODE_REG(0xC1, ajmp_C1, ajmp_page,   2, 2, "ajmp ", "06N%1")
+OPCODE(0xC2, clr_C2,                   2, 1, "clr  ", "0%1")
+OPCODE(0xC3, clr_C3,                   1, 1, "clr  ", "C")
+OPCODE(0xC4, swap_C4,                  1, 1, "swap ", "A")
+OPCODE(0xC5, xch_C5,                   2, 1, "xch  ", "A, %1")
+OPCODE_REG(0xC6, xch_C6, xch_ri,       1, 1, "xch  ", "A, @R0")
+OPCODE_REG(0xC7, xch_C7, xch_ri,       1, 1, "xch  ", "A, @R1")
+OPCODE_REG(0xC8, xch_C8, xch_rn,       1, 1, "xch  ", "A, R0")
+OPCODE_REG(0xC9, xch_C9, xch_rn,       1, 1, "xch  ", "A, R1")
+OPCODE_REG(0xCA, xch_CA, xch_rn,       1, 1, "xch  ", "A, R2")
+OPCODE_REG(0xCB, xch_CB, xch_rn,       1, 1, "xch  ", "A, R3")
+OPCODE_REG(0xCC, xch_CC, xch_rn,       1, 1, "xch  ", "A, R4")
+OPCODE_REG(0xCD, xch_CD, xch_rn,       1, 1, "xch  ", "A, R5")
+OPCODE_REG(0xCE, xch_CE, xch_rn,       1, 1, "xch  ", "A, R6")
+OPCODE_REG(0xCF, xch_CF, xch_rn,       1, 1, "xch  ", "A, R7")
+
+OPCODE(0xD0, pop_D0,                   2, 2, "pop  ", "%1")
+OPCODE_REG(0xD1, acall_D1, acall_page, 2, 2, "acall", "06N%1")
+OPCODE(0xD2, setb_D2,                  2, 1, "setb ", "0%1")
+OPCODE(0xD3, setb_D3,                  1, 1, "setb ", "C")
+OPCODE(0xD4, da_D4,                    1, 1, "da   ", "A")
+OPCODE(0xD5, djnz_D5,                  3, 2, "djnz ", "%1, O%2")
+OPCODE_REG(0xD6, xchd_D6, xchd_ri,     1, 1, "xchd ", "A, @R0")
+OPCODE_REG(0xD7, xchd_D7, xchd_ri,     1, 1, "xchd ", "A, @R1")
+OPCODE_REG(0xD8, djnz_D8, djnz_rn,     2, 2, "djnz ", "R0, O%1")
+OPCODE_REG(0xD9, djnz_D9, djnz_rn,     2, 2, "djnz ", "R1, O%1")
+OPCODE_REG(0xDA, djnz_DA, djnz_rn,     2, 2, "djnz ", "R2, O%1")
+OPCODE_REG(0xDB, djnz_DB, djnz_rn,     2, 2, "djnz ", "R3, O%1")
+OPCODE_REG(0xDC, djnz_DC, djnz_rn,     2, 2, "djnz ", "R4, O%1")
+OPCODE_REG(0xDD, djnz_DD, djnz_rn,     2, 2, "djnz ", "R5, O%1")
+OPCODE_REG(0xDE, djnz_DE, djnz_rn,     2, 2, "djnz ", "R6, O%1")
+OPCODE_REG(0xDF, djnz_DF, djnz_rn,     2, 2, "djnz ", "R7, O%1")
+
+OPCODE(0xE0, movx_E0,                  1, 2, "movx ", "A, @DPTR")
+OPCODE_REG(0xE1, ajmp_E1, ajmp_page,   2, 2, "ajmp ", "07N%1")
+OPCODE_REG(0xE2, movx_E2, movx_a_ri,   1, 2, "movx ", "A, @R0")
+OPCODE_REG(0xE3, movx_E3, movx_a_ri,   1, 2, "movx ", "A, @R1")
+OPCODE(0xE4, clr_E4,                   1, 1, "clr  ", "A")
+OPCODE(0xE5, mov_E5,                   2, 1, "mov  ", "A, %1")
+OPCODE_REG(0xE6, mov_E6, mov_a_ri,     1, 1, "mov  ", "A, @R0")
+OPCODE_REG(0xE7, mov_E7, mov_a_ri,     1, 1, "mov  ", "A, @R1")
+OPCODE_REG(0xE8, mov_E8, mov_a_rn,     1, 1, "mov  ", "A, R0")
+OPCODE_REG(0xE9, mov_E9, mov_a_rn,     1, 1, "mov  ", "A, R1")
+OPCODE_REG(0xEA, mov_EA, mov_a_rn,     1, 1, "mov  ", "A, R2")
+OPCODE_REG(0xEB, mov_EB, mov_a_rn,     1, 1, "mov  ", "A, R3")
+OPCODE_REG(0xEC, mov_EC, mov_a_rn,     1, 1, "mov  ", "A, R4")
+OPCODE_REG(0xED, mov_ED, mov_a_rn,     1, 1, "mov  ", "A, R5")
+OPCODE_REG(0xEE, mov_EE, mov_a_rn,     1, 1, "mov  ", "A, R6")
+OPCODE_REG(0xEF, mov_EF, mov_a_rn,     1, 1, "mov  ", "A, R7")
+
+OPCODE(0xF0, movx_F0,                  1, 2, "movx ", "@DPTR, A")
+OPCODE_REG(0xF1, acall_F1, acall_page, 2, 2, "acall", "07N%1")
+OPCODE_REG(0xF2, movx_F2, movx_ri_a,   1, 2, "movx ", "@R0, A")
+OPCODE_REG(0xF3, movx_F3, movx_ri_a,   1, 2, "movx ", "@R1, A")
+OPCODE(0xF4, cpl_F4,                   1, 1, "cpl  ", "A")
+OPCODE(0xF5, mov_F5,                   2, 1, "mov  ", "%1, A")
+OPCODE_REG(0xF6, mov_F6, mov_ri_a,     1, 1, "mov  ", "@R0, A")
+OPCODE_REG(0xF7, mov_F7, mov_ri_a,     1, 1, "mov  ", "@R1, A")
+OPCODE_REG(0xF8, mov_F8, mov_rn_a,     1, 1, "mov  ", "R0, A")
+OPCODE_REG(0xF9, mov_F9, mov_rn_a,     1, 1, "mov  ", "R1, A")
+OPCODE_REG(0xFA, mov_FA, mov_rn_a,     1, 1, "mov  ", "R2, A")
+OPCODE_REG(0xFB, mov_FB, mov_rn_a,     1, 1, "mov  ", "R3, A")
+OPCODE_REG(0xFC, mov_FC, mov_rn_a,     1, 1, "mov  ", "R4, A")
+OPCODE_REG(0xFD, mov_FD, mov_rn_a,     1, 1, "mov  ", "R5, A")
+OPCODE_REG(0xFE, mov_FE, mov_rn_a,     1, 1, "mov  ", "R6, A")
+OPCODE_REG(0xFF, mov_FF, mov_rn_a,     1, 1, "mov  ", "R7, A")
+
+#undef OPCODE
+#undef OPCODE_REG
+#undef OPCODE_FAMILY
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,1312 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// fork() and waitpid() aren't part of plain C99.
+#define _POSIX_C_SOURCE 200809L
+
+#include "Global.h"
+
+#include "Recompiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "IntelHex.h"
+
+#define STRINGIFY(x) #x
+#define TO_STRING(x) STRINGIFY(x)
+
+typedef unsigned long long (*ModuleRun)(MCUModuleApi* api, unsigned long long count);
+
+/*
+ * Module loaded into MCU.
+ */
+typedef struct {
+  void* handle;
+  ModuleRun run;
+  unsigned long checksum;
+  unsigned iromSize;
+  unsigned xromSize;
+  bool EA;
+
+  // Result of the last comparison with code memory.
+  bool checked;
+  bool valid;
+  unsigned codeVersion;
+} Module;
+
+/*
+ * Context passed to callbacks.
+ */
+typedef struct {
+  MCU* mcu;
+  BYTE* out;
+  BYTE* in;
+  bool* useOut;
+  bool* needIn;
+  bool stopped;
+} ModuleContext;
+
+/*
+ * FNV-1a of code memory.
+ */
+static unsigned long codeChecksum(MCU* mcu)
+{
+  unsigned long hash = 2166136261UL;
+
+  for (unsigned i = 0; i < mcu->iromMemorySize; ++i)
+    hash = ((hash ^ getMemoryMCU(mcu, IROM, i)) * 16777619UL) & 0xFFFFFFFFUL;
+
+  for (unsigned i = 0; i < mcu->xromMemorySize; ++i)
+    hash = ((hash ^ getMemoryMCU(mcu, XROM, i)) * 16777619UL) & 0xFFFFFFFFUL;
+
+  return hash;
+}
+
+static unsigned codeSize(MCU* mcu)
+{
+  return mcu->iromMemorySize > mcu->xromMemorySize ?
+         mcu->iromMemorySize : mcu->xromMemorySize;
+}
+
+/*
+ * Static successors of instruction at address, written into next. Returns,
+ * reti and jmp @A+DPTR have none, their targets are reached through the
+ * interpreter.
+ */
+static int successors(MCU* mcu, WORD address, WORD* next)
+{
+  BYTE opcode = *ROM(mcu, address);
+  BYTE op1 = *ROM(mcu, address + 1);
+  BYTE op2 = *ROM(mcu, address + 2);
+  WORD follow = address + mcu->byteCount[opcode];
+
+  // ajmp, acall
+  if ((opcode & 0x1F) == 0x01) {
+    next[0] = (WORD) (opcode >> 5) << 8 | op1;
+    return 1;
+  }
+
+  if ((opcode & 0x1F) == 0x11) {
+    next[0] = (WORD) (opcode >> 5) << 8 | op1;
+    next[1] = follow;
+    return 2;
+  }
+
+  switch (opcode) {
+  case 0x02: // ljmp
+    next[0] = (WORD) op1 << 8 | op2;
+    return 1;
+  case 0x12: // lcall
+    next[0] = (WORD) op1 << 8 | op2;
+    next[1] = follow;
+    return 2;
+  case 0x22: // ret
+  case 0x32: // reti
+  case 0x73: // jmp @A+DPTR
+  case 0xA5: // reserved
+    return 0;
+  case 0x80: // sjmp
+    next[0] = follow + (signed char) op1;
+    return 1;
+  case 0x96: // subb A,@Ri, the interpreter skips one byte after it
+  case 0x97:
+    next[0] = follow + 1;
+    return 1;
+  case 0x40: // jc
+  case 0x50: // jnc
+  case 0x60: // jz
+  case 0x70: // jnz
+  case 0xD8: case 0xD9: case 0xDA: case 0xDB: // djnz Rn
+  case 0xDC: case 0xDD: case 0xDE: case 0xDF:
+    next[0] = follow + (signed char) op1;
+    next[1] = follow;
+    return 2;
+  case 0x10: // jbc
+  case 0x20: // jb
+  case 0x30: // jnb
+  case 0xB4: case 0xB5: case 0xB6: case 0xB7: // cjne
+  case 0xB8: case 0xB9: case 0xBA: case 0xBB:
+  case 0xBC: case 0xBD: case 0xBE: case 0xBF:
+  case 0xD5: // djnz dir
+    next[0] = follow + (signed char) op2;
+    next[1] = follow;
+    return 2;
+  }
+
+  next[0] = follow;
+  return 1;
+}
+
+/*
+ * Instruction uses only ACC, B, DPTR, R0-R7 and IDATA below 80h by direct
+ * address, without PSW and errors. Without debugger information it needs
+ * no tracking when the next instruction is quiet too, parity of ACC is
+ * updated before PSW is used.
+ */
+static bool quietInstruction(BYTE opcode, BYTE op1, BYTE op2)
+{
+  switch (opcode) {
+  case 0x00: // nop
+  case 0x03: // rr A
+  case 0x04: // inc A
+  case 0x08 ... 0x0F: // inc Rn
+  case 0x14: // dec A
+  case 0x18 ... 0x1F: // dec Rn
+  case 0x23: // rl A
+  case 0x44: // orl A,#data
+  case 0x48 ... 0x4F: // orl A,Rn
+  case 0x54: // anl A,#data
+  case 0x58 ... 0x5F: // anl A,Rn
+  case 0x64: // xrl A,#data
+  case 0x68 ... 0x6F: // xrl A,Rn
+  case 0x74: // mov A,#data
+  case 0x78 ... 0x7F: // mov Rn,#data
+  case 0x83: // movc A,@A+PC
+  case 0x90: // mov DPTR,#data
+  case 0x93: // movc A,@A+DPTR
+  case 0xA3: // inc DPTR
+  case 0xC4: // swap A
+  case 0xC8 ... 0xCF: // xch A,Rn
+  case 0xE4: // clr A
+  case 0xE8 ... 0xEF: // mov A,Rn
+  case 0xF4: // cpl A
+  case 0xF8 ... 0xFF: // mov Rn,A
+    return true;
+  case 0x05: // inc dir
+  case 0x15: // dec dir
+  case 0x42: // orl dir,A
+  case 0x43: // orl dir,#data
+  case 0x45: // orl A,dir
+  case 0x52: // anl dir,A
+  case 0x53: // anl dir,#data
+  case 0x55: // anl A,dir
+  case 0x62: // xrl dir,A
+  case 0x63: // xrl dir,#data
+  case 0x65: // xrl A,dir
+  case 0x75: // mov dir,#data
+  case 0x88 ... 0x8F: // mov dir,Rn
+  case 0xA8 ... 0xAF: // mov Rn,dir
+  case 0xB2: // cpl bit
+  case 0xC2: // clr bit
+  case 0xC5: // xch A,dir
+  case 0xD2: // setb bit
+  case 0xE5: // mov A,dir
+  case 0xF5: // mov dir,A
+    return op1 < 0x80;
+  case 0x85: // mov dir,dir
+    return op1 < 0x80 && op2 < 0x80;
+  }
+
+  return false;
+}
+
+/*
+ * C expressions of operands in generated code.
+ */
+static const char* direct(char* buffer, BYTE address)
+{
+  sprintf(buffer, "(*%s(api, 0x%.2X))", address < 0x80 ? "iram" : "sfr", address);
+  return buffer;
+}
+
+static const char* indirect(char* buffer, BYTE opcode)
+{
+  sprintf(buffer, "(*ind(api, R(%i)))", opcode & 0x01);
+  return buffer;
+}
+
+static const char* bitByte(char* buffer, BYTE bit)
+{
+  return direct(buffer, bit < 0x80 ? 0x20 + (bit >> 3) : bit & 0xF8);
+}
+
+static const char* bitValue(char* buffer, BYTE bit)
+{
+  char byte[32];
+
+  sprintf(buffer, "((%s & 0x%.2X) != 0)", bitByte(byte, bit), 1 << (bit & 0x07));
+  return buffer;
+}
+
+/*
+ * Second operand of arithmetic and logic instructions (#data, dir, @Ri, Rn
+ * by low nibble of opcode).
+ */
+static const char* source(char* buffer, BYTE opcode, BYTE op1)
+{
+  BYTE low = opcode & 0x0F;
+
+  if (low == 0x04)
+    sprintf(buffer, "0x%.2X", op1);
+  else if (low == 0x05)
+    direct(buffer, op1);
+  else if (low < 0x08)
+    indirect(buffer, opcode);
+  else
+    sprintf(buffer, "R(%i)", opcode & 0x07);
+
+  return buffer;
+}
+
+static void emitWriteDirect(FILE* file, BYTE address, const char* value)
+{
+  /*
+   * SFR write hooks are called by setIntRAM. Value is read before address
+   * is tracked, like in the interpreter.
+   */
+  if (address < 0x80)
+    fprintf(file, "    t = %s;\n    *iram(api, 0x%.2X) = t;\n", value, address);
+  else
+    fprintf(file, "    api->setIntRAM(api->context, 0x%.2X, true, %s);\n", address, value);
+}
+
+static void emitSetBit(FILE* file, const char* indent, BYTE bit, bool state)
+{
+  char byte[32];
+
+  if (state)
+    fprintf(file, "%s%s |= 0x%.2X;\n", indent, bitByte(byte, bit), 1 << (bit & 0x07));
+  else
+    fprintf(file, "%s%s &= 0x%.2X;\n", indent, bitByte(byte, bit),
+            ~(1 << (bit & 0x07)) & 0xFF);
+}
+
+/*
+ * if (condition) bit = state; else bit = !state;
+ */
+static void emitCondBit(FILE* file, const char* condition, BYTE bit, bool state)
+{
+  fprintf(file, "    if (%s)\n", condition);
+  emitSetBit(file, "      ", bit, state);
+  fprintf(file, "    else\n");
+  emitSetBit(file, "      ", bit, !state);
+}
+
+static void emitPush(FILE* file, WORD value)
+{
+  fprintf(file,
+          "    SP += 1;\n"
+          "    (*ind(api, SP)) = 0x%.2X;\n"
+          "    SP += 1;\n"
+          "    (*ind(api, SP)) = 0x%.2X;\n",
+          value & 0xFF, value >> 8);
+}
+
+/*
+ * Write C code of one instruction, without bookkeeping. It does the same
+ * as handler of the interpreter, in the same order. Jumps set PC.
+ */
+static void emitBody(FILE* file, MCU* mcu, WORD address, const WORD* next)
+{
+  BYTE opcode = *ROM(mcu, address);
+  BYTE op1 = *ROM(mcu, address + 1);
+  BYTE op2 = *ROM(mcu, address + 2);
+  WORD follow = address + mcu->byteCount[opcode];
+  char a[48], b[48], c[64];
+
+  // ajmp, acall
+  if ((opcode & 0x1F) == 0x01) {
+    fprintf(file, "    PC = 0x%.4X;\n", next[0]);
+    return;
+  }
+
+  if ((opcode & 0x1F) == 0x11) {
+    emitPush(file, follow);
+    fprintf(file, "    PC = 0x%.4X;\n", next[0]);
+    return;
+  }
+
+  switch (opcode) {
+  case 0x00: // nop
+    break;
+  case 0x02: // ljmp
+  case 0x80: // sjmp
+    fprintf(file, "    PC = 0x%.4X;\n", next[0]);
+    break;
+  case 0x12: // lcall
+    emitPush(file, follow);
+    fprintf(file, "    PC = 0x%.4X;\n", next[0]);
+    break;
+  case 0x22: // ret
+    fprintf(file,
+            "    PC = (WORD) *ind(api, SP) << 8 | (WORD) *ind(api, (BYTE) (SP - 1));\n"
+            "    SP = SP - 2;\n");
+    break;
+  case 0x32: // reti, changes interrupts in service
+  case 0xA5: // reserved
+    fprintf(file, "    api->execute(api->context);\n");
+    break;
+  case 0x73: // jmp @A+DPTR
+    fprintf(file, "    PC = (WORD) (ACC + DPTR);\n");
+    break;
+
+  /*
+   * Jumps.
+   */
+  case 0x10: // jbc
+    fprintf(file, "    if (%s) {\n", bitValue(a, op1));
+    emitSetBit(file, "      ", op1, false);
+    fprintf(file, "      PC = 0x%.4X;\n    } else\n      PC = 0x%.4X;\n", next[0], next[1]);
+    break;
+  case 0x20: // jb
+  case 0x30: // jnb
+    fprintf(file, "    PC = %s%s ? 0x%.4X : 0x%.4X;\n", opcode == 0x30 ? "!" : "",
+            bitValue(a, op1), next[0], next[1]);
+    break;
+  case 0x40: // jc
+  case 0x50: // jnc
+    fprintf(file, "    PC = %s%s ? 0x%.4X : 0x%.4X;\n", opcode == 0x50 ? "!" : "",
+            bitValue(a, 0xD7), next[0], next[1]);
+    break;
+  case 0x60: // jz
+  case 0x70: // jnz
+    fprintf(file, "    PC = ACC %s 0 ? 0x%.4X : 0x%.4X;\n", opcode == 0x60 ? "==" : "!=",
+            next[0], next[1]);
+    break;
+  case 0xB4 ... 0xBF: // cjne
+    if (opcode == 0xB4 || opcode == 0xB5)
+      strcpy(a, "ACC");
+    else if (opcode < 0xB8)
+      indirect(a, opcode);
+    else
+      sprintf(a, "R(%i)", opcode & 0x07);
+
+    if (opcode == 0xB5)
+      direct(b, op1);
+    else
+      sprintf(b, "0x%.2X", op1);
+
+    sprintf(c, "%s < %s", a, b);
+    emitCondBit(file, c, 0xD7, true);
+    fprintf(file, "    PC = %s != %s ? 0x%.4X : 0x%.4X;\n", a, b, next[0], next[1]);
+    break;
+  case 0xD5: // djnz dir
+    fprintf(file, "    %s--;\n    PC = %s != 0 ? 0x%.4X : 0x%.4X;\n", direct(a, op1), a,
+            next[0], next[1]);
+    break;
+  case 0xD8 ... 0xDF: // djnz Rn
+    fprintf(file, "    R(%i)--;\n    PC = R(%i) != 0 ? 0x%.4X : 0x%.4X;\n", opcode & 0x07,
+            opcode & 0x07, next[0], next[1]);
+    break;
+
+  /*
+   * Arithmetic and logic.
+   */
+  case 0x24 ... 0x2F: // add
+  case 0x34 ... 0x3F: // addc
+  case 0x94 ... 0x9F: // subb
+    fprintf(file, "    api->arithmetic(api->context, 0x%.2X, %s);\n", opcode,
+            source(a, opcode, op1));
+
+    // Interpreter skips one byte after subb A,@Ri.
+    if (opcode == 0x96 || opcode == 0x97)
+      fprintf(file, "    PC = 0x%.4X;\n", next[0]);
+    break;
+  case 0x44 ... 0x4F: // orl A,src
+  case 0x54 ... 0x5F: // anl A,src
+  case 0x64 ... 0x6F: // xrl A,src
+    fprintf(file, "    ACC = ACC %s %s;\n",
+            opcode < 0x50 ? "|" : opcode < 0x60 ? "&" : "^", source(a, opcode, op1));
+    break;
+  case 0x42: // orl dir,A
+  case 0x52: // anl dir,A
+  case 0x62: // xrl dir,A
+    sprintf(b, "%s %s ACC", direct(a, op1), opcode == 0x42 ? "|" : opcode == 0x52 ? "&" : "^");
+    emitWriteDirect(file, op1, b);
+    break;
+  case 0x43: // orl dir,#data
+  case 0x53: // anl dir,#data
+    sprintf(b, "%s %s 0x%.2X", direct(a, op1), opcode == 0x43 ? "|" : "&", op2);
+    emitWriteDirect(file, op1, b);
+    break;
+  case 0x63: // xrl dir,#data
+    fprintf(file, "    %s ^= 0x%.2X;\n", direct(a, op1), op2);
+    break;
+  case 0x04: // inc A
+    fprintf(file, "    ACC++;\n");
+    break;
+  case 0x05: // inc dir
+  case 0x06 ... 0x07: // inc @Ri
+  case 0x08 ... 0x0F: // inc Rn
+  case 0x15: // dec dir
+  case 0x16 ... 0x17: // dec @Ri
+  case 0x18 ... 0x1F: // dec Rn
+    fprintf(file, "    %s%s;\n", source(a, opcode, op1), opcode < 0x10 ? "++" : "--");
+    break;
+  case 0x14: // dec A
+    fprintf(file, "    ACC = ACC - 1;\n");
+    break;
+  case 0xA3: // inc DPTR
+    fprintf(file, "    DPTR = DPTR + 1;\n");
+    break;
+  case 0x84: // div AB
+    emitSetBit(file, "    ", 0xD7, false);
+    fprintf(file, "    if (B != 0) {\n"
+            "      t = ACC;\n"
+            "      ACC = t / B;\n"
+            "      B = t %% B;\n"
+            "    } else\n");
+    emitSetBit(file, "      ", 0xD2, true);
+    break;
+  case 0xA4: // mul AB
+    fprintf(file, "    w = (WORD) ACC * (WORD) B;\n");
+    emitCondBit(file, "w > 255", 0xD2, true);
+    fprintf(file, "    B = (BYTE) w >> 8;\n    ACC = (BYTE) (w & 0xFF);\n");
+    break;
+  case 0xD4: // da A
+    fprintf(file, "    if (%s || ((ACC & 0x0F) > 0x09)) {\n"
+            "      ACC += 0x06;\n"
+            "      if ((ACC & 0x0F) > 0x0F)\n", bitValue(a, 0xD6));
+    emitSetBit(file, "        ", 0xD7, true);
+    fprintf(file, "    }\n"
+            "    if (%s || ((ACC & 0xF0) > 0x90)) {\n"
+            "      ACC += 0x60;\n"
+            "      if ((ACC & 0xF0) > 0xF0)\n", bitValue(a, 0xD7));
+    emitSetBit(file, "        ", 0xD7, true);
+    fprintf(file, "    }\n");
+    break;
+
+  /*
+   * Rotations and accumulator.
+   */
+  case 0x03: // rr A
+    fprintf(file, "    t = ACC;\n    ACC = t >> 1 | t << 7;\n");
+    break;
+  case 0x23: // rl A
+    fprintf(file, "    t = ACC;\n    ACC = t << 1 | t >> 7;\n");
+    break;
+  case 0x13: // rrc A
+    fprintf(file, "    t = ACC;\n    ACC = t >> 1 | %s << 7;\n", bitValue(a, 0xD7));
+    emitCondBit(file, "t & 0x01", 0xD7, true);
+    break;
+  case 0x33: // rlc A
+    fprintf(file, "    t = ACC;\n    ACC = t << 1 | %s;\n", bitValue(a, 0xD7));
+    emitCondBit(file, "t & 0x80", 0xD7, true);
+    break;
+  case 0xC4: // swap A
+    fprintf(file, "    t = ACC;\n"
+            "    t = (t << 4) & 0xF0;\n"
+            "    ACC = (ACC >> 4) & 0x0F;\n"
+            "    ACC = ACC | t;\n");
+    break;
+  case 0xE4: // clr A
+    fprintf(file, "    ACC = 0;\n");
+    break;
+  case 0xF4: // cpl A
+    fprintf(file, "    ACC = ACC ^ 0xFF;\n");
+    break;
+
+  /*
+   * Bits.
+   */
+  case 0xC3: // clr C
+  case 0xD3: // setb C
+    emitSetBit(file, "    ", 0xD7, opcode == 0xD3);
+    break;
+  case 0xC2: // clr bit
+  case 0xD2: // setb bit
+    emitSetBit(file, "    ", op1, opcode == 0xD2);
+    break;
+  case 0xB3: // cpl C
+    emitCondBit(file, bitValue(a, 0xD7), 0xD7, false);
+    break;
+  case 0xB2: // cpl bit
+    emitCondBit(file, bitValue(a, op1), op1, false);
+    break;
+  case 0x92: // mov bit,C
+    emitCondBit(file, bitValue(a, 0xD7), op1, true);
+    break;
+  case 0xA2: // mov C,bit
+    emitCondBit(file, bitValue(a, op1), 0xD7, true);
+    break;
+  case 0x72: // orl C,bit
+  case 0xA0: // orl C,/bit
+  case 0x82: // anl C,bit
+  case 0xB0: // anl C,/bit
+    sprintf(c, "%s %s %s%s", bitValue(a, 0xD7), opcode == 0x72 || opcode == 0xA0 ? "||" : "&&",
+            opcode == 0xA0 || opcode == 0xB0 ? "!" : "", bitValue(b, op1));
+    emitCondBit(file, c, 0xD7, true);
+    break;
+
+  /*
+   * Moves.
+   */
+  case 0x74: // mov A,#data
+    fprintf(file, "    ACC = 0x%.2X;\n", op1);
+    break;
+  case 0xE5 ... 0xEF: // mov A,src
+    fprintf(file, "    ACC = %s;\n", source(a, opcode, op1));
+    break;
+  case 0x75: // mov dir,#data
+    sprintf(a, "0x%.2X", op2);
+    emitWriteDirect(file, op1, a);
+    break;
+  case 0x76 ... 0x77: // mov @Ri,#data
+    fprintf(file, "    %s = 0x%.2X;\n", indirect(a, opcode), op1);
+    break;
+  case 0x78 ... 0x7F: // mov Rn,#data
+    fprintf(file, "    R(%i) = 0x%.2X;\n", opcode & 0x07, op1);
+    break;
+  case 0x85: // mov dir,dir
+    emitWriteDirect(file, op2, direct(a, op1));
+    break;
+  case 0x86 ... 0x87: // mov dir,@Ri
+    fprintf(file, "    %s = %s;\n", direct(a, op1), indirect(b, opcode));
+    break;
+  case 0x88 ... 0x8F: // mov dir,Rn
+    sprintf(a, "R(%i)", opcode & 0x07);
+    emitWriteDirect(file, op1, a);
+    break;
+  case 0x90: // mov DPTR,#data
+    fprintf(file, "    DPH = 0x%.2X;\n    DPL = 0x%.2X;\n", op1, op2);
+    break;
+  case 0xA6 ... 0xA7: // mov @Ri,dir
+    fprintf(file, "    %s = %s;\n", indirect(a, opcode), direct(b, op1));
+    break;
+  case 0xA8 ... 0xAF: // mov Rn,dir
+    fprintf(file, "    R(%i) = %s;\n", opcode & 0x07, direct(a, op1));
+    break;
+  case 0xF5: // mov dir,A
+    emitWriteDirect(file, op1, "ACC");
+    break;
+  case 0xF6 ... 0xF7: // mov @Ri,A
+    fprintf(file, "    %s = ACC;\n", indirect(a, opcode));
+    break;
+  case 0xF8 ... 0xFF: // mov Rn,A
+    fprintf(file, "    R(%i) = ACC;\n", opcode & 0x07);
+    break;
+  case 0x83: // movc A,@A+PC
+    fprintf(file, "    w = (WORD) (ACC + 0x%.4X);\n"
+            "    ACC = api->readROM(api->context, w);\n", address);
+    break;
+  case 0x93: // movc A,@A+DPTR
+    fprintf(file, "    w = (WORD) (ACC + DPTR);\n"
+            "    ACC = api->readROM(api->context, w);\n");
+    break;
+  case 0xE0: // movx A,@DPTR
+    fprintf(file, "    ACC = api->readExtRAM(api->context, DPTR);\n");
+    break;
+  case 0xE2 ... 0xE3: // movx A,@Ri
+    fprintf(file, "    ACC = api->readExtRAM(api->context, R(%i));\n", opcode & 0x01);
+    break;
+  case 0xF0: // movx @DPTR,A
+    fprintf(file, "    api->writeExtRAM(api->context, DPTR, ACC);\n");
+    break;
+  case 0xF2 ... 0xF3: // movx @Ri,A
+    fprintf(file, "    api->writeExtRAM(api->context, R(%i), ACC);\n", opcode & 0x01);
+    break;
+
+  /*
+   * Stack and exchanges.
+   */
+  case 0xC0: // push dir
+    fprintf(file, "    SP += 1;\n    (*ind(api, SP)) = %s;\n", direct(a, op1));
+    break;
+  case 0xD0: // pop dir
+    emitWriteDirect(file, op1, "*ind(api, SP)");
+    fprintf(file, "    SP = SP - 1;\n");
+    break;
+  case 0xC5: // xch A,dir
+    fprintf(file, "    t = ACC;\n    ACC = %s;\n", direct(a, op1));
+    emitWriteDirect(file, op1, "t");
+    break;
+  case 0xC6 ... 0xC7: // xch A,@Ri
+    fprintf(file, "    t = ACC;\n    ACC = %s;\n    %s = t;\n", indirect(a, opcode), a);
+    break;
+  case 0xC8 ... 0xCF: // xch A,Rn
+    fprintf(file, "    t = ACC;\n    ACC = R(%i);\n    R(%i) = t;\n", opcode & 0x07,
+            opcode & 0x07);
+    break;
+  case 0xD6 ... 0xD7: // xchd A,@Ri
+    fprintf(file, "    t = %s & 0xF;\n"
+            "    %s &= 0xF;\n"
+            "    %s |= ACC & 0xF;\n"
+            "    ACC &= 0xF;\n"
+            "    ACC |= t;\n", indirect(a, opcode), a, a);
+    break;
+  }
+}
+
+/*
+ * Length of straight code at every address: 0 for instructions always run
+ * one by one, 1 for jumps and instructions before unsafe ones, n for an
+ * instruction with n - 1 instructions after it. Block checks its budget at
+ * the start of every such piece, inside it instructions go one after
+ * another.
+ */
+typedef struct {
+  BYTE* length;
+  unsigned* cycles;
+  bool* movx;
+} ModuleBlocks;
+
+static void findBlocks(MCU* mcu, const bool* reachable, ModuleBlocks* blocks)
+{
+  unsigned size = codeSize(mcu);
+
+  for (unsigned address = size; address-- > 0;) {
+    BYTE opcode = *ROM(mcu, address);
+    WORD follow = address + mcu->byteCount[opcode];
+    WORD next[2];
+    int numOfNext = successors(mcu, address, next);
+
+    blocks->length[address] = 0;
+
+    if (!reachable[address] || !blockSafeMCU(mcu, address, &blocks->movx[address]))
+      continue;
+
+    blocks->length[address] = 1;
+    blocks->cycles[address] = mcu->cycleCount[opcode];
+
+    if (numOfNext == 1 && next[0] == follow && follow < size && blocks->length[follow] != 0 &&
+        blocks->length[follow] < MAX_BLOCK_LENGTH) {
+      blocks->length[address] += blocks->length[follow];
+      blocks->cycles[address] += blocks->cycles[follow];
+      blocks->movx[address] |= blocks->movx[follow];
+    }
+  }
+}
+
+/*
+ * Write C code of instruction at address with its bookkeeping.
+ */
+static void emitInstruction(FILE* file, MCU* mcu, WORD address, const ModuleBlocks* blocks)
+{
+  BYTE opcode = *ROM(mcu, address);
+  BYTE op1 = *ROM(mcu, address + 1);
+  BYTE op2 = *ROM(mcu, address + 2);
+  WORD follow = address + mcu->byteCount[opcode];
+  WORD lastByte = follow - 1;
+  WORD next[2];
+  int numOfNext = successors(mcu, address, next);
+  unsigned size = codeSize(mcu);
+  BYTE length = blocks->length[address];
+  bool linear = numOfNext == 1 && next[0] == follow;
+  bool quiet = length >= 2 && quietInstruction(opcode, op1, op2) &&
+               quietInstruction(*ROM(mcu, follow), *ROM(mcu, follow + 1),
+                                *ROM(mcu, follow + 2));
+  char last[16];
+
+  if (length != 0)
+    fprintf(file, "    ENTER(%u, %u, %s, 0x%.4X);\n", length, blocks->cycles[address],
+            blocks->movx[address] ? "true" : "false", lastByte);
+  else
+    fprintf(file, "    SINGLE(0x%.4X);\n", lastByte);
+
+  fprintf(file, "  L%.4X:\n", address);
+  emitBody(file, mcu, address, next);
+
+  if (linear)
+    fprintf(file, "    PC = 0x%.4X;\n", follow);
+
+  // movc tracks byte read from code memory.
+  sprintf(last, opcode == 0x83 || opcode == 0x93 ? "w" : "0x%.4X", lastByte);
+
+  if (length >= 2) {
+    fprintf(file,
+            "    if (!block) {\n"
+            "      END();\n"
+            "      goto E%.4X;\n"
+            "    }\n"
+            "    %s(0x%.2X, %s, %u);\n"
+            "    goto L%.4X;\n",
+            follow, quiet ? "QUIET" : "NEXT", opcode, last,
+            mcu->cycleCount[opcode], follow);
+    return;
+  }
+
+  if (length == 1)
+    fprintf(file,
+            "    if (!block) {\n"
+            "      END();\n"
+            "    } else {\n"
+            "      NEXT(0x%.2X, %s, %u);\n"
+            "    }\n",
+            opcode, last, mcu->cycleCount[opcode]);
+  else
+    fprintf(file, "    END();\n");
+
+  // Return address of call is reached by ret, not from here.
+  if ((opcode & 0x1F) == 0x11 || opcode == 0x12)
+    numOfNext = 1;
+
+  for (int i = 0; i < numOfNext; ++i)
+    fprintf(file, "    if (PC == 0x%.4X)\n      goto E%.4X;\n",
+            next[i] % size, next[i] % size);
+
+  fprintf(file, "    continue;\n");
+}
+
+/*
+ * Registers, bookkeeping and memory access of generated code. Block is
+ * entered when api->enter() gives budget for the straight code at PC and
+ * goes on through jumps while the budget lasts, then timers, interrupts
+ * and uart are done once by api->leave(). Pieces which can't go on in the
+ * block share one place which leaves and enters blocks and returns to them
+ * through second switch. Without debugger information instructions which
+ * change only registers and IDATA by direct address skip api->next().
+ */
+static const char* g_modulePrelude =
+  "#define PC (*api->PC)\n"
+  "#define ACC api->sfr[0x60]\n"
+  "#define B api->sfr[0x70]\n"
+  "#define SP api->sfr[0x01]\n"
+  "#define DPTR (**api->DPTR)\n"
+  "#define DPL (**api->DPL)\n"
+  "#define DPH (**api->DPH)\n"
+  "#define R(n) (*api->R)[n]\n\n"
+  "#define BEGIN(lastByte) \\\n"
+  "  do { \\\n"
+  "    block = false; \\\n"
+  "    api->begin(api->context, lastByte); \\\n"
+  "  } while (0)\n\n"
+  "#define LEAVE() \\\n"
+  "  do { \\\n"
+  "    block = false; \\\n"
+  "    executed += n; \\\n"
+  "    if (!api->leave(api->context, n, c) || executed == count) \\\n"
+  "      goto out; \\\n"
+  "  } while (0)\n\n"
+  "#define ENTER(length, cycles, xdata, lastByte) \\\n"
+  "  do { \\\n"
+  "    if (!block || c + cycles > budget || n + length > count - executed || \\\n"
+  "        (xdata && !api->movx)) { \\\n"
+  "      l = length; \\\n"
+  "      k = cycles; \\\n"
+  "      x = xdata; \\\n"
+  "      b = lastByte; \\\n"
+  "      goto enter; \\\n"
+  "    } \\\n"
+  "  } while (0)\n\n"
+  "#define SINGLE(lastByte) \\\n"
+  "  do { \\\n"
+  "    l = 0; \\\n"
+  "    b = lastByte; \\\n"
+  "    goto enter; \\\n"
+  "  } while (0)\n\n"
+  "#define END() \\\n"
+  "  do { \\\n"
+  "    executed += 1; \\\n"
+  "    if (!api->end(api->context) || executed == count) \\\n"
+  "      goto out; \\\n"
+  "  } while (0)\n\n"
+  "#define NEXT(opcode, lastByte, cycles) \\\n"
+  "  do { \\\n"
+  "    n += 1; \\\n"
+  "    c += cycles; \\\n"
+  "    if (!api->next(api->context, opcode, lastByte)) \\\n"
+  "      goto leave; \\\n"
+  "  } while (0)\n\n"
+  "#define QUIET(opcode, lastByte, cycles) \\\n"
+  "  do { \\\n"
+  "    n += 1; \\\n"
+  "    c += cycles; \\\n"
+  "    if (api->info && !api->next(api->context, opcode, lastByte)) \\\n"
+  "      goto leave; \\\n"
+  "  } while (0)\n\n"
+  "static inline BYTE* iram(MCUModuleApi* api, BYTE address)\n"
+  "{\n"
+  "  return api->info ? api->intRAM(api->context, address, true) : &api->idata[address];\n"
+  "}\n\n"
+  "static inline BYTE* sfr(MCUModuleApi* api, BYTE address)\n"
+  "{\n"
+  "  return api->intRAM(api->context, address, true);\n"
+  "}\n\n"
+  "static inline BYTE* ind(MCUModuleApi* api, BYTE address)\n"
+  "{\n"
+  "  if (api->info || address >= api->idataSize)\n"
+  "    return api->intRAM(api->context, address, false);\n\n"
+  "  return &api->idata[address];\n"
+  "}\n\n";
+
+/*
+ * Write C source of whole module.
+ */
+static bool emitModule(MCU* mcu, const char* hexFile, const char* source)
+{
+  unsigned size = codeSize(mcu);
+  bool* reachable = malloc(size * sizeof(bool));
+  WORD* stack = malloc(size * sizeof(WORD));
+  int top = 0;
+  const WORD vectors[] = {0x0000, 0x0003, 0x000B, 0x0013, 0x001B, 0x0023, 0x002B};
+  ModuleBlocks blocks;
+
+  FILE* file = fopen(source, "w");
+
+  if (file == NULL) {
+    fprintf(AppSettings()->errorOut, "Error while trying to open '%s': %s.\n", source,
+            strerror(errno));
+    free(reachable);
+    free(stack);
+    return false;
+  }
+
+  memset(reachable, 0, size * sizeof(bool));
+
+  /*
+   * Follow control flow from reset and interrupt vectors.
+   */
+  for (int i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i) {
+    if (vectors[i] < size && !reachable[vectors[i]]) {
+      reachable[vectors[i]] = true;
+      stack[top++] = vectors[i];
+    }
+  }
+
+  while (top > 0) {
+    WORD next[2];
+    int numOfNext = successors(mcu, stack[--top], next);
+
+    for (int i = 0; i < numOfNext; ++i) {
+      WORD address = next[i] % size;
+
+      if (!reachable[address]) {
+        reachable[address] = true;
+        stack[top++] = address;
+      }
+    }
+  }
+
+  blocks.length = malloc(size * sizeof(BYTE));
+  blocks.cycles = malloc(size * sizeof(unsigned));
+  blocks.movx = malloc(size * sizeof(bool));
+  findBlocks(mcu, reachable, &blocks);
+
+  /*
+   * Source.
+   */
+  fprintf(file,
+          "/*\n"
+          " * Generated by " APP_NAME " from %s. Do not edit.\n"
+          " */\n"
+          "#if defined(__GNUC__) && !defined(__clang__)\n"
+          "// Threading jumps of the whole program takes minutes.\n"
+          "#pragma GCC optimize(\"no-thread-jumps\")\n"
+          "#endif\n\n"
+          "#include <stdint.h>\n"
+          "#include <stdbool.h>\n\n"
+          "typedef uint8_t  BYTE;\n"
+          "typedef uint16_t WORD;\n\n"
+          "%s\n\n"
+          "const unsigned s51dModuleVersion = %i;\n"
+          "const unsigned long s51dModuleChecksum = 0x%.8lXUL;\n"
+          "const unsigned s51dModuleIromSize = 0x%X;\n"
+          "const unsigned s51dModuleXromSize = 0x%X;\n"
+          "const bool s51dModuleEA = %s;\n\n"
+          "%s"
+          "unsigned long long s51dRun(MCUModuleApi* api, unsigned long long count)\n"
+          "{\n"
+          "  unsigned long long executed = 0;\n"
+          "  unsigned n = 0, c = 0; // instructions and cycles of block\n"
+          "  unsigned budget = 0;\n"
+          "  bool block = false;\n"
+          "  unsigned l = 0, k = 0; // length and cycles of piece at PC\n"
+          "  bool x = false;\n"
+          "  WORD b = 0;\n"
+          "  BYTE t;\n"
+          "  WORD w;\n\n"
+          "  (void) n;\n"
+          "  (void) c;\n"
+          "  (void) block;\n"
+          "  (void) budget;\n"
+          "  (void) t;\n"
+          "  (void) w;\n\n"
+          "  while (executed < count) {\n"
+          "    switch (PC) {\n",
+          hexFile, TO_STRING(MODULE_API), MODULE_API_VERSION, codeChecksum(mcu),
+          mcu->iromMemorySize, mcu->xromMemorySize, mcu->EA ? "true" : "false",
+          g_modulePrelude);
+
+  for (unsigned address = 0; address < size; ++address) {
+    if (!reachable[address])
+      continue;
+
+    char* asmCode = disassembler(mcu, address, "%a: %m %p", NULL);
+
+    // Disassembler pads parameters with spaces.
+    for (char* end = asmCode + strlen(asmCode) - 1; end >= asmCode && *end == ' '; --end)
+      *end = '\0';
+
+    fprintf(file, "\n  case 0x%.4X: E%.4X: // %s\n", address, address, asmCode);
+    free(asmCode);
+
+    emitInstruction(file, mcu, address, &blocks);
+  }
+
+  fprintf(file,
+          "\n"
+          "    default:\n"
+          "      if (block)\n"
+          "        goto leave;\n"
+          "      executed += 1;\n"
+          "      if (!api->step(api->context))\n"
+          "        return executed;\n"
+          "      continue;\n"
+          "    }\n\n"
+          "  enter:\n"
+          "    if (block)\n"
+          "      goto leave;\n"
+          "    if (l != 0 && count - executed >= l && (!x || api->movx) &&\n"
+          "        (budget = api->enter(api->context)) >= k) {\n"
+          "      block = true;\n"
+          "      n = 0;\n"
+          "      c = 0;\n"
+          "    } else {\n"
+          "      BEGIN(b);\n"
+          "    }\n\n"
+          "    switch (PC) {\n");
+
+  for (unsigned address = 0; address < size; ++address) {
+    if (reachable[address])
+      fprintf(file, "    case 0x%.4X: goto L%.4X;\n", address, address);
+  }
+
+  fprintf(file,
+          "    }\n"
+          "    continue;\n\n"
+          "  leave:\n"
+          "    LEAVE();\n"
+          "  }\n\n"
+          "out:\n"
+          "  return executed;\n"
+          "}\n");
+
+  fclose(file);
+  free(reachable);
+  free(stack);
+  free(blocks.length);
+  free(blocks.cycles);
+  free(blocks.movx);
+  return true;
+}
+
+/*
+ * Run compiler without shell, file names are passed as they are.
+ */
+static bool buildModule(const char* source, const char* output)
+{
+  const char* cc = getenv("CC") != NULL ? getenv("CC") : "cc";
+  // -O2 spends minutes on the switch of whole program, its code isn't faster.
+  const char* argv[] = {cc, "-O1", "-shared", "-fPIC", "-o", output, source, NULL};
+  int status;
+
+#ifdef _WIN32
+  status = _spawnvp(_P_WAIT, cc, argv);
+#else
+  fflush(NULL);
+  pid_t pid = fork();
+
+  if (pid < 0) {
+    fprintf(AppSettings()->errorOut, "Can't run '%s': %s.\n", cc, strerror(errno));
+    return false;
+  }
+
+  if (pid == 0) {
+    execvp(cc, (char* const*) argv);
+    fprintf(stderr, "Can't run '%s': %s.\n", cc, strerror(errno));
+    _exit(127);
+  }
+
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      status = -1;
+      break;
+    }
+  }
+
+  if (status != -1)
+    status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+
+  return status == 0;
+}
+
+bool recompileImage(MCU* mcu, char* hexFile, const char* output)
+{
+  bool valid = false;
+  WORD highestAddress = 0;
+
+  /*
+   * Load like `load irom`.
+   */
+  resetMCU(mcu);
+  loadIntelHexMCU(hexFile, mcu, IROM, 0, mcu->iromMemorySize - 1, &valid, &highestAddress,
+                  AppSettings()->errorOut);
+
+  if (highestAddress >= mcu->iromMemorySize)
+    loadIntelHexMCU(hexFile, mcu, XROM, mcu->iromMemorySize, mcu->xromMemorySize - 1, &valid,
+                    NULL, AppSettings()->errorOut);
+
+  if (!valid) {
+    fprintf(AppSettings()->errorOut, "File not loaded corectly!\n");
+    return false;
+  }
+
+  invalidatePredecodedMCU(mcu);
+
+  /*
+   * Generate and build.
+   */
+  char* source = malloc(strlen(output) + 3);
+  sprintf(source, "%s.c", output);
+
+  if (!emitModule(mcu, hexFile, source)) {
+    free(source);
+    return false;
+  }
+
+  bool built = buildModule(source, output);
+
+  if (!built)
+    fprintf(AppSettings()->errorOut, "Compiling '%s' failed. Source kept in '%s'.\n",
+            output, source);
+  else
+    remove(source);
+
+  free(source);
+  return built;
+}
+
+/*
+ * Loading.
+ */
+static void* moduleSymbol(Module* module, const char* name)
+{
+#ifdef _WIN32
+  return (void*) GetProcAddress((HMODULE) module->handle, name);
+#else
+  return dlsym(module->handle, name);
+#endif
+}
+
+bool loadModule(MCU* mcu, const char* file)
+{
+  Module* module = malloc(sizeof(Module));
+
+  unloadModule(mcu);
+
+#ifdef _WIN32
+  module->handle = LoadLibrary(file);
+#else
+  // Without slash dlopen searches library path only.
+  char* path = malloc(strlen(file) + 3);
+  sprintf(path, strchr(file, '/') != NULL ? "%s" : "./%s", file);
+  module->handle = dlopen(path, RTLD_NOW);
+  free(path);
+#endif
+
+  if (module->handle == NULL) {
+    fprintf(AppSettings()->errorOut, "Can't load module '%s'.\n", file);
+    free(module);
+    return false;
+  }
+
+  mcu->module = module;
+
+  const unsigned* version = moduleSymbol(module, "s51dModuleVersion");
+  const unsigned long* checksum = moduleSymbol(module, "s51dModuleChecksum");
+  const unsigned* iromSize = moduleSymbol(module, "s51dModuleIromSize");
+  const unsigned* xromSize = moduleSymbol(module, "s51dModuleXromSize");
+  const bool* EA = moduleSymbol(module, "s51dModuleEA");
+  module->run = (ModuleRun) moduleSymbol(module, "s51dRun");
+
+  if (version == NULL || checksum == NULL || iromSize == NULL || xromSize == NULL ||
+      EA == NULL || module->run == NULL || *version != MODULE_API_VERSION) {
+    fprintf(AppSettings()->errorOut, "'%s' is not valid module.\n", file);
+    unloadModule(mcu);
+    return false;
+  }
+
+  module->checksum = *checksum;
+  module->iromSize = *iromSize;
+  module->xromSize = *xromSize;
+  module->EA = *EA;
+  module->checked = false;
+  return true;
+}
+
+void unloadModule(MCU* mcu)
+{
+  Module* module = mcu->module;
+
+  if (module == NULL)
+    return;
+
+#ifdef _WIN32
+  FreeLibrary((HMODULE) module->handle);
+#else
+  dlclose(module->handle);
+#endif
+
+  free(module);
+  mcu->module = NULL;
+}
+
+bool isModuleUsable(MCU* mcu)
+{
+  Module* module = mcu->module;
+
+  if (module == NULL || mcu->EAconnect != 0 || mcu->EA != module->EA ||
+      mcu->iromMemorySize != module->iromSize || mcu->xromMemorySize != module->xromSize)
+    return false;
+
+  // Code was changed since last check.
+  if (!module->checked || module->codeVersion != mcu->codeVersion) {
+    module->valid = codeChecksum(mcu) == module->checksum;
+    module->codeVersion = mcu->codeVersion;
+    module->checked = true;
+  }
+
+  return module->valid;
+}
+
+/*
+ * Callbacks.
+ */
+static bool moduleContinue(ModuleContext* ctx, bool ret)
+{
+  if (!ret)
+    ctx->stopped = true;
+
+  if (ctx->out != NULL && *ctx->useOut)
+    return false;
+
+  if (ctx->in != NULL && *ctx->needIn)
+    return false;
+
+  return ret && !ctx->mcu->idle && !isHaltedMCU(ctx->mcu);
+}
+
+static bool moduleStep(void* context)
+{
+  ModuleContext* ctx = context;
+  return moduleContinue(ctx, processMCUEx(ctx->mcu, ctx->out, ctx->in, ctx->useOut,
+                                          ctx->needIn));
+}
+
+static void moduleBegin(void* context, WORD lastByte)
+{
+  beginInstructionMCU(((ModuleContext*) context)->mcu, lastByte);
+}
+
+static bool moduleEnd(void* context)
+{
+  ModuleContext* ctx = context;
+  return moduleContinue(ctx, endInstructionMCU(ctx->mcu, ctx->out, ctx->in, ctx->useOut,
+                                               ctx->needIn));
+}
+
+static unsigned moduleEnter(void* context)
+{
+  return beginBlockMCU(((ModuleContext*) context)->mcu);
+}
+
+static bool moduleNext(void* context, BYTE opcode, WORD lastByte)
+{
+  return nextInstructionMCU(((ModuleContext*) context)->mcu, opcode, lastByte);
+}
+
+static bool moduleLeave(void* context, unsigned instructions, unsigned cycles)
+{
+  ModuleContext* ctx = context;
+  return moduleContinue(ctx, endBlockMCU(ctx->mcu, instructions, cycles, ctx->out, ctx->in,
+                                         ctx->useOut, ctx->needIn));
+}
+
+static BYTE* moduleIntRAM(void* context, BYTE address, bool direct)
+{
+  return mcuIntRAM(((ModuleContext*) context)->mcu, address, direct);
+}
+
+static void moduleSetIntRAM(void* context, BYTE address, bool direct, BYTE value)
+{
+  mcuSetIntRAM(((ModuleContext*) context)->mcu, address, direct, value);
+}
+
+static BYTE moduleReadROM(void* context, WORD address)
+{
+  return mcuReadROM(((ModuleContext*) context)->mcu, address);
+}
+
+static BYTE moduleReadExtRAM(void* context, WORD address)
+{
+  return mcuReadExtRAM(((ModuleContext*) context)->mcu, address);
+}
+
+static void moduleWriteExtRAM(void* context, WORD address, BYTE value)
+{
+  mcuWriteExtRAM(((ModuleContext*) context)->mcu, address, value);
+}
+
+static void moduleArithmetic(void* context, BYTE opcode, BYTE value)
+{
+  arithmeticMCU(((ModuleContext*) context)->mcu, opcode, value);
+}
+
+static void moduleExecute(void* context)
+{
+  executeInstructionMCU(((ModuleContext*) context)->mcu);
+}
+
+bool runModule(MCU* mcu, unsigned long long* count, BYTE* out, BYTE* in,
+               bool* useOut, bool* needIn)
+{
+  Module* module = mcu->module;
+  ModuleContext ctx = {mcu, out, in, useOut, needIn, false};
+  MCUModuleApi api = {
+    &ctx, &mcu->PC, mcu->sfr, mcu->idata, mcu->idataMemorySize, !mcu->noDebug,
+    mcu->numOfDevices == 0, &mcu->R, &mcu->DPTR, &mcu->DPL, &mcu->DPH,
+    &moduleStep, &moduleBegin, &moduleEnd, &moduleEnter, &moduleNext, &moduleLeave,
+    &moduleIntRAM, &moduleSetIntRAM, &moduleReadROM, &moduleReadExtRAM, &moduleWriteExtRAM,
+    &moduleArithmetic, &moduleExecute
+  };
+
+  if (out != NULL)
+    *useOut = false;
+
+  if (in != NULL)
+    *needIn = false;
+
+  // Module has no idle mode, idle cycles are simulated one by one.
+  if (mcu->idle) {
+    *count = 1;
+    return processMCUEx(mcu, out, in, useOut, needIn);
+  }
+
+  *count = module->run(&api, *count);
+  return !ctx.stopped;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
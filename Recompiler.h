@@ -0,0 +1,102 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef RECOMPILER_H_
+#define RECOMPILER_H_
+
+#include "Global.h"
+
+/*
+ * Interface of recompiled module. Module gets pointers to registers and
+ * callbacks, every callback takes context as first argument. The same text
+ * is written into generated sources, so it is kept in one macro.
+ *
+ * Single instruction is wrapped in begin and end. Blocks (see
+ * beginBlockMCU) start with enter, which returns their cycle budget, every
+ * instruction is finished by next and block by leave. XDATA can be accessed
+ * in block only when movx is set. Without info IDATA is accessed through
+ * idata, except of indirect access outside of idataSize.
+ */
+#define MODULE_API_VERSION 2
+
+#define MODULE_API \
+  typedef struct { \
+    void* context; \
+    WORD* PC; \
+    BYTE* sfr; \
+    BYTE* idata; \
+    unsigned idataSize; \
+    bool info; \
+    bool movx; \
+    BYTE** R; \
+    WORD** DPTR; \
+    BYTE** DPL; \
+    BYTE** DPH; \
+    bool (*step)(void* context); \
+    void (*begin)(void* context, WORD lastByte); \
+    bool (*end)(void* context); \
+    unsigned (*enter)(void* context); \
+    bool (*next)(void* context, BYTE opcode, WORD lastByte); \
+    bool (*leave)(void* context, unsigned instructions, unsigned cycles); \
+    BYTE* (*intRAM)(void* context, BYTE address, bool direct); \
+    void (*setIntRAM)(void* context, BYTE address, bool direct, BYTE value); \
+    BYTE (*readROM)(void* context, WORD address); \
+    BYTE (*readExtRAM)(void* context, WORD address); \
+    void (*writeExtRAM)(void* context, WORD address, BYTE value); \
+    void (*arithmetic)(void* context, BYTE opcode, BYTE value); \
+    void (*execute)(void* context); \
+  } MCUModuleApi;
+
+MODULE_API
+
+/*
+ * Translate Intel HEX file into C and build shared object from it. File is
+ * loaded into mcu like `load irom file` does. Module can be used only with
+ * the same memory sizes and EA pin state.
+ */
+bool recompileImage(MCU* mcu, char* hexFile, const char* output);
+
+/*
+ * Module is loaded into mcu (MCU.module), it replaces previous one.
+ * unloadModule() has to be called before removeMCU().
+ */
+bool loadModule(MCU* mcu, const char* file);
+void unloadModule(MCU* mcu);
+
+/*
+ * True when module is loaded into mcu and was built from its current code.
+ */
+bool isModuleUsable(MCU* mcu);
+
+/*
+ * Run up to *count instructions in module of mcu, *count is set to number of
+ * executed ones. Arguments and return value like in processMCUEx().
+ * Additionally stops after byte was sent or received, when idle mode is
+ * entered and when isHaltedMCU() becomes true. In idle mode runs one idle
+ * cycle.
+ */
+bool runModule(MCU* mcu, unsigned long long* count, BYTE* out, BYTE* in,
+               bool* useOut, bool* needIn);
+
+#endif /* RECOMPILER_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
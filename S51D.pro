@@ -9,21 +9,36 @@ QMAKE_CFLAGS = -std=c99 -O0
 win32:INCLUDEPATH = H:/pthreads/Pre-built.2/include
 win32:LIBS += H:/pthreads/Pre-built.2/lib/x86/pthreadVCE2.lib
 
-unix:LIBS += -lpthread
+unix:LIBS += -lpthread -ldl
 
 HEADERS += \
     MCS51.h \
+    MCS51Instructions.h \
+    MCS51Opcodes.h \
+    MCS51Core.h \
+    DeAsmTables.h \
     Global.h \
+    Config.h \
     IntelHex.h \
     Debugger.h \
     VT100.h \
     Utils.h \
     Keyboard.h \
-    memleaks.h
+    memleaks.h \
+    Recompiler.h \
+    Devices.h \
+    Farm.h \
+    Sweep.h \
+    Lanes.h \
+    History.h \
+    Fuzz.h \
+    ForkServer.h \
+    Lockstep.h
 
 SOURCES += \
     main.c \
     MCS51.c \
+    DeAsmTables.c \
     IntelHex.c \
     Global.c \
     Debugger.c \
@@ -31,4 +46,13 @@ SOURCES += \
     CONSOLE.c \
     Utils.c \
     Keyboard.c \
-    memleaks.c
+    memleaks.c \
+    Recompiler.c \
+    Devices.c \
+    Farm.c \
+    Sweep.c \
+    Lanes.c \
+    History.c \
+    Fuzz.c \
+    ForkServer.c \
+    Lockstep.c
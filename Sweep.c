@@ -0,0 +1,453 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Config.h"
+#include "Sweep.h"
+#include "Lanes.h"
+
+#define SWEEP_SLICE 4096 // cycles, groups can be packed at its multiples
+
+/*
+ * Lanes sharing one instance. Group waits when receiver wants the next
+ * byte, its lanes are split by that byte before it runs again. Group is
+ * paused at the end of every slice.
+ *
+ * Groups paused at the same place, which differ only in registers kept by
+ * lanes (see Lanes.h), are packed into one group. It runs all of them
+ * together in rows of packed, mcu holds their shared state.
+ */
+typedef struct {
+  MCU* mcu;        // NULL when group was merged into another one
+  unsigned* lanes;
+  unsigned numOfLanes;
+  MCULanes* packed; // NULL for plain group
+  unsigned* slots;  // lane of packed for every lane of group
+  bool waiting;
+  bool paused;
+  bool done;
+} SweepGroup;
+
+typedef struct {
+  MCUSweepLane* lanes;
+  size_t* positions; // bytes of input already given to every lane
+  SweepGroup* groups;
+  unsigned numOfGroups;
+  unsigned long long end;
+  int stopMask;
+} Sweep;
+
+static int sweepNextByte(Sweep* sweep, unsigned lane)
+{
+  if (sweep->positions[lane] >= sweep->lanes[lane].inputSize)
+    return -1;
+
+  return sweep->lanes[lane].input[sweep->positions[lane]];
+}
+
+static unsigned sweepAddGroup(Sweep* sweep, MCU* mcu, unsigned numOfLanes)
+{
+  SweepGroup* group;
+
+  sweep->groups = realloc(sweep->groups, (sweep->numOfGroups + 1) * sizeof(SweepGroup));
+  group = &sweep->groups[sweep->numOfGroups];
+  group->mcu = malloc(sizeof(MCU));
+  cloneMCU(group->mcu, mcu);
+  group->lanes = malloc(numOfLanes * sizeof(unsigned));
+  group->numOfLanes = 0;
+  group->packed = NULL;
+  group->slots = NULL;
+  group->waiting = false;
+  group->paused = false;
+  group->done = false;
+
+  return sweep->numOfGroups++;
+}
+
+static void sweepRemoveGroup(SweepGroup* group)
+{
+  if (group->packed != NULL) {
+    removeLanesMCU(group->packed);
+    free(group->packed);
+    free(group->slots);
+  }
+
+  removeMCU(group->mcu);
+  free(group->mcu);
+  free(group->lanes);
+  group->mcu = NULL;
+  group->lanes = NULL;
+  group->packed = NULL;
+  group->slots = NULL;
+  group->numOfLanes = 0;
+}
+
+/*
+ * End of slice in which mcu is, or end of sweep.
+ */
+static unsigned long long sweepSliceEnd(Sweep* sweep, MCU* mcu)
+{
+  unsigned long long end = (mcu->cycles / SWEEP_SLICE + 1) * SWEEP_SLICE;
+
+  return end < sweep->end ? end : sweep->end;
+}
+
+static void sweepFinish(Sweep* sweep, SweepGroup* group, MCUStopReason reason)
+{
+  MCU* mcu = group->mcu;
+
+  group->done = true;
+
+  for (unsigned i = 0; i < group->numOfLanes; ++i) {
+    MCUSweepLane* lane = &sweep->lanes[group->lanes[i]];
+
+    lane->reason = reason;
+    lane->errid = mcu->errid;
+    lane->cycles = mcu->cycles;
+    lane->instructions = mcu->instructions;
+  }
+}
+
+/*
+ * Run plain group until its receiver waits, slice ends or it stops.
+ */
+static void sweepRun(Sweep* sweep, SweepGroup* group)
+{
+  MCU* mcu = group->mcu;
+  int stopMask = sweep->stopMask | STOP_OUTPUT;
+  MCUStopReason reason = STOP_BUDGET;
+  unsigned long long end = sweepSliceEnd(sweep, mcu);
+
+  for (unsigned i = 0; i < group->numOfLanes; ++i) {
+    if (sweepNextByte(sweep, group->lanes[i]) != -1) {
+      stopMask |= STOP_INPUT;
+      break;
+    }
+  }
+
+  while (mcu->cycles < sweep->end) {
+    unsigned long long budget = end - mcu->cycles;
+
+    // The rest runs in the next slice.
+    if (mcu->cycles >= end) {
+      group->paused = true;
+      return;
+    }
+
+    runMCUBatch(mcu, MCU_NO_LIMIT, budget, stopMask, &reason);
+
+    // Turbo engine doesn't stop on errors, but the last one can be seen.
+    if (mcu->errid != E_NOERRORS) {
+      reason = STOP_ERROR;
+      break;
+    }
+
+    if (reason == STOP_OUTPUT) {
+      BYTE out = (BYTE) takeOutputMCU(mcu);
+
+      for (unsigned i = 0; i < group->numOfLanes; ++i) {
+        MCUSweepLane* lane = &sweep->lanes[group->lanes[i]];
+        if (lane->output != NULL)
+          lane->output(lane->context, out);
+      }
+      continue;
+    }
+
+    if (reason == STOP_INPUT) {
+      group->waiting = true;
+      return;
+    }
+
+    // End of slice is checked above.
+    if (reason == STOP_BUDGET)
+      continue;
+
+    break;
+  }
+
+  sweepFinish(sweep, group, reason);
+}
+
+/*
+ * Turn plain group into packed group with one lane.
+ */
+static void sweepPackGroup(SweepGroup* group)
+{
+  unsigned slot;
+
+  group->packed = malloc(sizeof(MCULanes));
+  initLanesMCU(group->packed, group->mcu);
+  slot = addLaneMCU(group->packed, group->mcu);
+
+  group->slots = malloc(group->numOfLanes * sizeof(unsigned));
+  for (unsigned i = 0; i < group->numOfLanes; ++i)
+    group->slots[i] = slot;
+}
+
+/*
+ * Pack paused groups from index from on which are at the same place and
+ * differ only in registers of lanes.
+ */
+static void sweepPack(Sweep* sweep, unsigned from)
+{
+  for (unsigned i = from; i < sweep->numOfGroups; ++i) {
+    SweepGroup* a = &sweep->groups[i];
+
+    if (a->mcu == NULL || !a->paused)
+      continue;
+
+    for (unsigned j = i + 1; j < sweep->numOfGroups; ++j) {
+      SweepGroup* b = &sweep->groups[j];
+      unsigned slot;
+
+      if (b->mcu == NULL || !b->paused || b->packed != NULL ||
+          a->mcu->cycles != b->mcu->cycles || a->mcu->PC != b->mcu->PC ||
+          !sameSharedStateMCU(a->mcu, b->mcu))
+        continue;
+
+      if (a->packed == NULL)
+        sweepPackGroup(a);
+
+      slot = addLaneMCU(a->packed, b->mcu);
+      a->lanes = realloc(a->lanes, (a->numOfLanes + b->numOfLanes) * sizeof(unsigned));
+      a->slots = realloc(a->slots, (a->numOfLanes + b->numOfLanes) * sizeof(unsigned));
+
+      for (unsigned k = 0; k < b->numOfLanes; ++k) {
+        a->lanes[a->numOfLanes] = b->lanes[k];
+        a->slots[a->numOfLanes++] = slot;
+      }
+
+      sweepRemoveGroup(b);
+    }
+  }
+}
+
+/*
+ * Move every lane of packed into its own plain group, state is the shared
+ * one with registers of lane. When lanes split on branch, groups at the
+ * same PC are packed again.
+ */
+static void sweepUnpack(Sweep* sweep, unsigned index, bool split)
+{
+  SweepGroup* group = &sweep->groups[index];
+  unsigned first = sweep->numOfGroups;
+
+  for (unsigned slot = 0; slot < group->packed->numOfLanes; ++slot) {
+    unsigned other = sweepAddGroup(sweep, group->mcu, group->numOfLanes);
+    SweepGroup* unpacked = &sweep->groups[other];
+
+    group = &sweep->groups[index];
+    getLaneMCU(group->packed, slot, unpacked->mcu);
+    unpacked->paused = split;
+
+    for (unsigned i = 0; i < group->numOfLanes; ++i) {
+      if (group->slots[i] == slot)
+        unpacked->lanes[unpacked->numOfLanes++] = group->lanes[i];
+    }
+  }
+
+  sweepRemoveGroup(group);
+
+  if (split)
+    sweepPack(sweep, first);
+}
+
+/*
+ * Run packed group until slice ends. It is unpacked when some lane has to
+ * run alone or lanes take different branches.
+ */
+static void sweepRunPacked(Sweep* sweep, unsigned index)
+{
+  SweepGroup* group = &sweep->groups[index];
+  MCU* mcu = group->mcu;
+  MCULanesStop stop = LANES_SINGLE;
+
+  // Receiver waits, lanes can get different bytes.
+  if (!mcu->autoWrite || mcu->INPUT != -1 || (*mcu->SCON & 0x11) != 0x10)
+    stop = runLanesMCU(group->packed, sweepSliceEnd(sweep, mcu));
+
+  if (stop != LANES_BUDGET) {
+    sweepUnpack(sweep, index, stop == LANES_SPLIT);
+    return;
+  }
+
+  if (mcu->cycles < sweep->end) {
+    group->paused = true;
+    return;
+  }
+
+  // Lanes still share the result.
+  sweepFinish(sweep, group, STOP_BUDGET);
+}
+
+/*
+ * Merge waiting groups which came to the same state.
+ */
+static void sweepMerge(Sweep* sweep)
+{
+  for (unsigned i = 0; i < sweep->numOfGroups; ++i) {
+    SweepGroup* a = &sweep->groups[i];
+
+    if (a->mcu == NULL || !a->waiting)
+      continue;
+
+    for (unsigned j = i + 1; j < sweep->numOfGroups; ++j) {
+      SweepGroup* b = &sweep->groups[j];
+
+      if (b->mcu == NULL || !b->waiting || a->mcu->cycles != b->mcu->cycles ||
+          a->mcu->PC != b->mcu->PC || !sameStateMCU(a->mcu, b->mcu))
+        continue;
+
+      a->lanes = realloc(a->lanes, (a->numOfLanes + b->numOfLanes) * sizeof(unsigned));
+      memcpy(a->lanes + a->numOfLanes, b->lanes, b->numOfLanes * sizeof(unsigned));
+      a->numOfLanes += b->numOfLanes;
+      sweepRemoveGroup(b);
+    }
+  }
+}
+
+/*
+ * Give the next byte to lanes of waiting group. Lanes which get other byte
+ * than the first lane are moved into new group, it is split in turn when
+ * the loop gets to it.
+ */
+static void sweepSplit(Sweep* sweep, unsigned index)
+{
+  SweepGroup* group = &sweep->groups[index];
+  int next = sweepNextByte(sweep, group->lanes[0]);
+  unsigned other = 0;
+  unsigned kept = 0;
+
+  for (unsigned i = 0; i < group->numOfLanes; ++i) {
+    if (sweepNextByte(sweep, group->lanes[i]) == next)
+      continue;
+
+    // Clone state from before the byte is given.
+    if (other == 0) {
+      other = sweepAddGroup(sweep, group->mcu, group->numOfLanes);
+      group = &sweep->groups[index];
+      sweep->groups[other].waiting = true;
+    }
+
+    SweepGroup* moved = &sweep->groups[other];
+    moved->lanes[moved->numOfLanes++] = group->lanes[i];
+  }
+
+  for (unsigned i = 0; i < group->numOfLanes; ++i) {
+    unsigned lane = group->lanes[i];
+
+    if (sweepNextByte(sweep, lane) != next)
+      continue;
+
+    group->lanes[kept++] = lane;
+    if (next != -1)
+      sweep->positions[lane] += 1;
+  }
+
+  group->numOfLanes = kept;
+  group->waiting = false;
+
+  if (next != -1)
+    group->mcu->INPUT = next;
+}
+
+unsigned runSweepMCU(MCU* mcu, MCUSweepLane* lanes, unsigned numOfLanes,
+                     unsigned long long maxCycles, int stopMask)
+{
+  Sweep sweep;
+  unsigned maxInstances = 1;
+  bool running = true;
+
+  if (numOfLanes == 0)
+    return 0;
+
+  sweep.lanes = lanes;
+  sweep.positions = calloc(numOfLanes, sizeof(size_t));
+  sweep.groups = NULL;
+  sweep.numOfGroups = 0;
+  sweep.stopMask = stopMask & ~(STOP_INPUT | STOP_OUTPUT);
+  sweep.end = MCU_NO_LIMIT;
+
+  if (maxCycles != MCU_NO_LIMIT && mcu->cycles + maxCycles > mcu->cycles)
+    sweep.end = mcu->cycles + maxCycles;
+
+  sweepAddGroup(&sweep, mcu, numOfLanes);
+  for (unsigned i = 0; i < numOfLanes; ++i)
+    sweep.groups[0].lanes[i] = i;
+  sweep.groups[0].numOfLanes = numOfLanes;
+
+  while (running) {
+    unsigned instances = 0;
+    running = false;
+
+    // Groups unpacked from packed ones are added at the end and run too.
+    for (unsigned i = 0; i < sweep.numOfGroups; ++i) {
+      SweepGroup* group = &sweep.groups[i];
+
+      if (group->mcu == NULL || group->done)
+        continue;
+
+      group->paused = false;
+      if (group->packed != NULL)
+        sweepRunPacked(&sweep, i);
+      else
+        sweepRun(&sweep, group);
+    }
+
+    sweepMerge(&sweep);
+
+    // Groups added by split are at the end, they are split too.
+    for (unsigned i = 0; i < sweep.numOfGroups; ++i) {
+      if (sweep.groups[i].mcu != NULL && sweep.groups[i].waiting) {
+        sweepSplit(&sweep, i);
+        running = true;
+      }
+    }
+
+    sweepPack(&sweep, 0);
+
+    for (unsigned i = 0; i < sweep.numOfGroups; ++i) {
+      SweepGroup* group = &sweep.groups[i];
+
+      if (group->mcu != NULL)
+        instances += group->packed != NULL ? group->packed->numOfLanes : 1;
+
+      if (group->mcu != NULL && group->paused)
+        running = true;
+
+      // Finished instances aren't needed any more.
+      if (sweep.groups[i].mcu != NULL && sweep.groups[i].done)
+        sweepRemoveGroup(&sweep.groups[i]);
+    }
+
+    if (instances > maxInstances)
+      maxInstances = instances;
+  }
+
+  free(sweep.groups);
+  free(sweep.positions);
+
+  return maxInstances;
+}
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -0,0 +1,66 @@
+/*
+ * S51D - Simple MCS51 Debugger
+ *
+ * Copyright (C) 2011, Michał Dobaczewski / mdobak@(Google mail)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <stddef.h>
+#include "MCS51.h"
+
+/*
+ * Lane of a sweep, one run of the program with its own uart input.
+ * Callers set input and output, the rest is set by runSweepMCU().
+ */
+typedef struct {
+  const BYTE* input;  // bytes fed to uart receiver, one every time it waits
+  size_t inputSize;
+  void (*output)(void* context, BYTE byte); // every byte sent by uart
+  void* context;
+
+  MCUStopReason reason;
+  int errid;
+  unsigned long long cycles;
+  unsigned long long instructions;
+} MCUSweepLane;
+
+/*
+ * Run the same program from state of mcu once for every lane, as if every
+ * lane was run alone with runMCUBatch(), maxCycles budget and stopMask
+ * (uart input and output are handled here, STOP_INPUT and STOP_OUTPUT are
+ * ignored), lane stops with STOP_ERROR also when batch ends with errid set.
+ * mcu isn't changed.
+ *
+ * Lanes which got the same input so far share one instance. Group of lanes
+ * is split (cloneMCU) when they get different bytes and groups waiting for
+ * input at the same cycle are merged again when their state is equal
+ * (sameStateMCU). Groups which got different bytes but run the same code
+ * are packed into lanes (see Lanes.h) at the end of every slice of
+ * cycles. Lane results are the same as with separate runs, device
+ * contexts are shared by all instances. Returns the highest number of
+ * instances (or lanes of packed groups) used at once.
+ */
+unsigned runSweepMCU(MCU* mcu, MCUSweepLane* lanes, unsigned numOfLanes,
+                     unsigned long long maxCycles, int stopMask);
+
+#endif /* SWEEP_H_ */
+
+/*
+vi:ts=4:et:nowrap
+*/
@@ -22,11 +22,22 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <getopt.h>
 #include <time.h>
 #include "Utils.h"
 #include "MCS51.h"
 #include "Debugger.h"
+#include "Recompiler.h"
+#include "Devices.h"
+#include "Farm.h"
+#include "Fuzz.h"
+#include "ForkServer.h"
+#include "History.h"
+
+#define MAX_DEVICE_FILES 16 // --device
+#define MAX_FUZZ_INPUTS 256 // --fuzz-input
 
 void version(void)
 {
@@ -38,7 +49,10 @@ void version(void)
 void help(void)
 {
   version();
-  puts("Usage: s51d [-hv] [-n] [-e file] [-p prompt] [-f format]\n");
+  puts("Usage: s51d [-hv] [-n] [-e file] [-p prompt] [-f format]");
+  puts("       s51d --farm <jobs> [-j threads] [--sweep] [-o report]");
+  puts("       s51d --fuzz <hex> [--until-pc addr] [-j threads] [-o report]");
+  puts("       s51d --fork-server <socket> [-e boot script]\n");
   puts("Options:");
   puts("  -h --help                      Print out this help.");
   puts("  -v --version                   Print out version number.");
@@ -56,11 +70,57 @@ void help(void)
   puts("  --xrom-size                    Send errors to stdout instead of stderr.\n");
   puts("  --iram-size                    Send errors to stdout instead of stderr.\n");
   puts("  --xram-size                    Send errors to stdout instead of stderr.\n");
+  puts("  --predecode                    Use predecoded execution engine.\n");
+  puts("  --lazy-flags                   Compute PSW flags only when PSW is read.\n");
+  puts("  --lockstep                     Check engine of 'run n' and --farm jobs against interpreter.\n");
+  puts("  --recompile <file> -o <out>    Recompile Intel HEX file to native module and exit.\n");
+  puts("  --module <file>                Load module built with --recompile.\n");
+  puts("  --device <file>[,<args>]       Load device plugin mapped into XDATA, can be repeated.\n");
+  puts("  --farm <file>                  Run regression jobs from file, write report and exit.\n");
+  puts("  -j <n> --jobs <n>              Number of threads for --farm, default one per CPU.\n");
+  puts("  --sweep                        Run --farm jobs differing only in input together.\n");
+  puts("  --poison <policy>              Power on memory: zero, pattern:<hex> or random[:<seed>].\n");
+  puts("  --fuzz <file>                  Fuzz uart input of Intel HEX program, write findings and exit.\n");
+  puts("  --until-pc <addr>              End --fuzz execution when program reaches addr.\n");
+  puts("  --fuzz-runs <n>                Number of --fuzz executions, default no limit.\n");
+  puts("  --fuzz-cycles <n>              Cycles of one --fuzz execution before it is a hang.\n");
+  puts("  --fuzz-input <file>            Initial --fuzz input, can be repeated.\n");
+  puts("  --fork-server <socket>         Run scripts sent to Unix socket from state after -e.\n");
   puts("To display available command type help in program console.\n");
 }
 
+/*
+ * --poison zero, pattern:XX or random[:seed].
+ */
+bool parsePoison(char* arg, MCUPoison* policy, unsigned* value)
+{
+  bool valid = true;
+
+  if (0 == strcmp(arg, "zero")) {
+    *policy = POISON_ZERO;
+    *value = 0;
+  } else if (0 == strncmp(arg, "pattern:", 8)) {
+    *policy = POISON_PATTERN;
+    *value = hextoi(arg + 8, 0x00, 0xFF, 0x00, &valid);
+  } else if (0 == strcmp(arg, "random")) {
+    *policy = POISON_RANDOM;
+    *value = MCU_DEFAULT_SEED;
+  } else if (0 == strncmp(arg, "random:", 7)) {
+    *policy = POISON_RANDOM;
+    *value = strtoul(arg + 7, NULL, 0);
+  } else {
+    valid = false;
+  }
+
+  return valid;
+}
+
 void cleanUp(void)
 {
+  unloadModule(AppSettings()->mcu);
+  removeSnapshots();
+  clearHistory();
+  unloadDevices(AppSettings()->mcu);
   removeMCU(AppSettings()->mcu);
   free(AppSettings()->mcu);
 
@@ -81,8 +141,22 @@ int main(int argc, char* argv[])
   /*
    * Set default values.
    */
-  srand(time(NULL));
   bool showProlog = true;
+  char* outputFile = NULL;
+  char* recompileFile = NULL;
+  char* moduleFile = NULL;
+  char* farmFile = NULL;
+  int farmThreads = 0;
+  bool farmSweep = false;
+  bool poisonSet = false;
+  MCUPoison poison = POISON_RANDOM;
+  unsigned poisonValue = MCU_DEFAULT_SEED;
+  char* deviceFiles[MAX_DEVICE_FILES];
+  int numOfDeviceFiles = 0;
+  char* fuzzFile = NULL;
+  char* fuzzInputs[MAX_FUZZ_INPUTS];
+  FuzzSettings fuzzSettings = { -1, 1000000, 0, fuzzInputs, 0, 0 };
+  char* forkSocket = NULL;
 
   AppSettings()->mcu = malloc(sizeof(MCU));
   AppSettings()->mcu->noDebug = false;
@@ -97,6 +171,8 @@ int main(int argc, char* argv[])
   AppSettings()->noColors = false;
   AppSettings()->dontRemoveEscapeCodes = false;
   AppSettings()->pauseOnError = true;
+  AppSettings()->returnAtEnd = false;
+  AppSettings()->lockstep = false;
   AppSettings()->simTimeBeforeStop = 0;
   AppSettings()->simSyncTimeBeforeStop = 0;
   AppSettings()->mcuSec = 0;
@@ -137,11 +213,27 @@ int main(int argc, char* argv[])
       {"xrom-size",           required_argument, 0, 1005},
       {"iram-size",           required_argument, 0, 1006},
       {"xram-size",           required_argument, 0, 1007},
+      {"predecode",           no_argument,       0, 1008},
+      {"recompile",           required_argument, 0, 1009},
+      {"module",              required_argument, 0, 1010},
+      {"lazy-flags",          no_argument,       0, 1011},
+      {"device",              required_argument, 0, 1012},
+      {"farm",                required_argument, 0, 1013},
+      {"jobs",                required_argument, 0, 'j'},
+      {"sweep",               no_argument,       0, 1014},
+      {"poison",              required_argument, 0, 1015},
+      {"fuzz",                required_argument, 0, 1016},
+      {"until-pc",            required_argument, 0, 1017},
+      {"fuzz-runs",           required_argument, 0, 1018},
+      {"fuzz-cycles",         required_argument, 0, 1019},
+      {"fuzz-input",          required_argument, 0, 1020},
+      {"fork-server",         required_argument, 0, 1021},
+      {"lockstep",            no_argument,       0, 1022},
       {0, 0, 0, 0}
     };
 
     int option_index = 0;
-    c = getopt_long(argc, argv, "hve:p:f:E:o:m:", long_options, &option_index);
+    c = getopt_long(argc, argv, "hve:p:f:E:o:m:j:", long_options, &option_index);
 
     if (c == -1)
       break;
@@ -195,12 +287,7 @@ int main(int argc, char* argv[])
       break;
 
     case 'o':
-      AppSettings()->defaultOut = fopen(optarg, "r");
-      if (AppSettings()->defaultOut == NULL) {
-        fprintf(stderr, "Error while trying to open '%s': %s.\n", optarg,
-                strerror(errno));
-        AppSettings()->defaultOut = stdout;
-      }
+      outputFile = optarg;
       break;
 
     case 1002:
@@ -208,20 +295,11 @@ int main(int argc, char* argv[])
       break;
 
     case 'm':
-      if (0 == strcmp(optarg, "8031"))
-        init8031MCU(AppSettings()->mcu);
-      if (0 == strcmp(optarg, "8032"))
-        init8032MCU(AppSettings()->mcu);
-      else if (0 == strcmp(optarg, "8051"))
-        init8051MCU(AppSettings()->mcu);
-      else if (0 == strcmp(optarg, "8052"))
-        init8052MCU(AppSettings()->mcu);
-      else if (0 == strcmp(optarg, "89S51"))
-        init89S51MCU(AppSettings()->mcu);
-      else if (0 == strcmp(optarg, "89S52"))
-        init89S52MCU(AppSettings()->mcu);
-      else
+      removeMCU(AppSettings()->mcu);
+      if (!initNamedMCU(AppSettings()->mcu, optarg)) {
         fprintf(stderr, "Invalid MCU type '%s'.\n", optarg);
+        init8052MCU(AppSettings()->mcu);
+      }
       break;
 
     case 1003:
@@ -244,6 +322,78 @@ int main(int argc, char* argv[])
       AppSettings()->mcu->xdataMemorySize = hextoi(optarg, 0x0, 0x10000, 0x10000, NULL);
       break;
 
+    case 1008:
+      AppSettings()->mcu->usePredecoded = true;
+      break;
+
+    case 1009:
+      recompileFile = optarg;
+      break;
+
+    case 1010:
+      moduleFile = optarg;
+      break;
+
+    case 1011:
+      AppSettings()->mcu->lazyFlags = true;
+      break;
+
+    case 1012:
+      if (numOfDeviceFiles < MAX_DEVICE_FILES)
+        deviceFiles[numOfDeviceFiles++] = optarg;
+      else
+        fprintf(stderr, "Too many devices, '%s' ignored.\n", optarg);
+      break;
+
+    case 1013:
+      farmFile = optarg;
+      break;
+
+    case 'j':
+      farmThreads = atoi(optarg);
+      break;
+
+    case 1014:
+      farmSweep = true;
+      break;
+
+    case 1015:
+      poisonSet = parsePoison(optarg, &poison, &poisonValue);
+      if (!poisonSet)
+        fprintf(stderr, "Invalid poison policy '%s'.\n", optarg);
+      break;
+
+    case 1016:
+      fuzzFile = optarg;
+      break;
+
+    case 1017:
+      fuzzSettings.untilPC = hextoi(optarg, 0x0, 0xFFFF, -1, NULL);
+      break;
+
+    case 1018:
+      fuzzSettings.runs = strtoull(optarg, NULL, 10);
+      break;
+
+    case 1019:
+      fuzzSettings.cycles = strtoull(optarg, NULL, 10);
+      break;
+
+    case 1020:
+      if (fuzzSettings.numOfInputs < MAX_FUZZ_INPUTS)
+        fuzzInputs[fuzzSettings.numOfInputs++] = optarg;
+      else
+        fprintf(stderr, "Too many fuzz inputs, '%s' ignored.\n", optarg);
+      break;
+
+    case 1021:
+      forkSocket = optarg;
+      break;
+
+    case 1022:
+      AppSettings()->lockstep = true;
+      break;
+
     case '?':
       break;
 
@@ -252,12 +402,121 @@ int main(int argc, char* argv[])
     }
   }
 
+  // Memory sizes could be changed.
+  mapMemoryMCU(AppSettings()->mcu);
+
+  // Farm and recompiler get the same memory every run without --poison.
+  if (poisonSet)
+    poisonMCU(AppSettings()->mcu, poison, poisonValue);
+
+  /*
+   * Farm mode, -o is name of report.
+   */
+  if (farmFile != NULL) {
+    FILE* report = outputFile != NULL ? fopen(outputFile, "w") : stdout;
+    bool passed;
+
+    if (report == NULL) {
+      fprintf(stderr, "Error while trying to open '%s': %s.\n", outputFile,
+              strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+
+    passed = runFarm(farmFile, farmThreads, farmSweep, AppSettings()->lockstep,
+                     AppSettings()->mcu, report);
+
+    if (report != stdout)
+      fclose(report);
+
+    exit(passed ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  /*
+   * Fuzzer mode, -o is name of report.
+   */
+  if (fuzzFile != NULL) {
+    FILE* report = outputFile != NULL ? fopen(outputFile, "w") : stdout;
+    bool passed;
+
+    if (report == NULL) {
+      fprintf(stderr, "Error while trying to open '%s': %s.\n", outputFile,
+              strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+
+    fuzzSettings.threads = farmThreads;
+    passed = runFuzz(AppSettings()->mcu, fuzzFile, &fuzzSettings, report);
+
+    if (report != stdout)
+      fclose(report);
+
+    exit(passed ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  /*
+   * Recompiler mode, -o is name of module.
+   */
+  if (recompileFile != NULL) {
+    if (outputFile == NULL) {
+      fprintf(stderr, "Specify module file with -o.\n");
+      exit(EXIT_FAILURE);
+    }
+
+    exit(recompileImage(AppSettings()->mcu, recompileFile, outputFile) ?
+         EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  // Different power on memory contents of debugger every run.
+  if (!poisonSet)
+    seedMCU(AppSettings()->mcu, time(NULL));
+
+  // Devices are mapped into final MCU, -m would drop them.
+  for (int i = 0; i < numOfDeviceFiles; ++i) {
+    char* args = strchr(deviceFiles[i], ',');
+
+    if (args != NULL)
+      *args++ = '\0';
+
+    loadDevice(AppSettings()->mcu, deviceFiles[i], args);
+  }
+
+  // Like devices, -m would drop module.
+  if (moduleFile != NULL)
+    loadModule(AppSettings()->mcu, moduleFile);
+
+  if (outputFile != NULL) {
+    AppSettings()->defaultOut = fopen(outputFile, "r");
+    if (AppSettings()->defaultOut == NULL) {
+      fprintf(stderr, "Error while trying to open '%s': %s.\n", outputFile,
+              strerror(errno));
+      AppSettings()->defaultOut = stdout;
+    }
+  }
+
   /*
    * Prolog.
    */
   if (showProlog)
     version();
 
+  /*
+   * Fork server, -e script boots image once and every test starts from its
+   * state.
+   */
+  if (forkSocket != NULL) {
+    if (AppSettings()->in != AppSettings()->defaultIn) {
+      AppSettings()->returnAtEnd = true;
+      runDebugger();
+      AppSettings()->returnAtEnd = false;
+
+      fclose(AppSettings()->in);
+      AppSettings()->in = AppSettings()->defaultIn;
+    }
+
+    // Returns in test process.
+    runForkServer(forkSocket);
+  }
+
   /*
    * Debugger.
    */
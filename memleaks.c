@@ -21,7 +21,9 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
 
 typedef struct {
   void* memory;
@@ -47,6 +49,8 @@ size_t _maxAalloc = 0;
 size_t _totalUunreleased = 0;
 size_t _totalReleased = 0;
 
+pthread_mutex_t _memoryLock = PTHREAD_MUTEX_INITIALIZER;
+
 
 void MEMORY_STATUS()
 {
@@ -54,6 +58,8 @@ void MEMORY_STATUS()
   if (out == NULL)
     out = stdout;
 
+  pthread_mutex_lock(&_memoryLock);
+
   fprintf(out, "-------------------------------------------------\n");
   fprintf(out, "Total allocated memory: %i bytes\n", _totalAalloc);
   fprintf(out, "Total released memory: %i bytes\n", _totalReleased);
@@ -85,11 +91,14 @@ void MEMORY_STATUS()
                 _memoryAllocs[i].reallocsOnTime[j]);
     }
   }
+  pthread_mutex_unlock(&_memoryLock);
   fclose(out);
 }
 
 void* __wrapper_malloc(size_t size, int line, char* file)
 {
+  pthread_mutex_lock(&_memoryLock);
+
   _memoryAllocs = (_allocations*)realloc(_memoryAllocs, sizeof(_allocations) * (_numOfMemAllocs + 1));
 
   _memoryAllocs[_numOfMemAllocs].memory = malloc(size);
@@ -109,7 +118,20 @@ void* __wrapper_malloc(size_t size, int line, char* file)
   _numOfMemAllocs += 1;
   _totalAalloc += size;
 
-  return _memoryAllocs[_numOfMemAllocs - 1].memory;
+  void* memory = _memoryAllocs[_numOfMemAllocs - 1].memory;
+  pthread_mutex_unlock(&_memoryLock);
+
+  return memory;
+}
+
+void* __wrapper_calloc(size_t nmeb, size_t size, int line, char* file)
+{
+  void* memory = __wrapper_malloc(nmeb * size, line, file);
+
+  if (memory != NULL)
+    memset(memory, 0, nmeb * size);
+
+  return memory;
 }
 
 void  __wrapper_free(void *ptr, int line, char* file)
@@ -117,6 +139,8 @@ void  __wrapper_free(void *ptr, int line, char* file)
   if (ptr == NULL)
     return;
 
+  pthread_mutex_lock(&_memoryLock);
+
   for (int i = 0; i < _numOfMemAllocs; ++i) {
     if (_memoryAllocs[i].memory == ptr && !_memoryAllocs[i].released) {
       _memoryAllocs[i].released = 1;
@@ -130,11 +154,13 @@ void  __wrapper_free(void *ptr, int line, char* file)
       if (totalUunreleased > _maxAalloc)
         _maxAalloc = totalUunreleased;
 
+      pthread_mutex_unlock(&_memoryLock);
       free(ptr);
       return;
     }
   }
 
+  pthread_mutex_unlock(&_memoryLock);
   printf("\nWARNING! FREE USING UNDEF PTR\n%s:%i\n", file, line);
   free(ptr);
 }
@@ -144,6 +170,8 @@ void* __wrapper_realloc(void *ptr, size_t size, int line, char* file)
   if (ptr == NULL)
     return __wrapper_malloc(size, line, file);
 
+  pthread_mutex_lock(&_memoryLock);
+
   for (int i = 0; i < _numOfMemAllocs; ++i) {
     if (_memoryAllocs[i].memory == ptr && !_memoryAllocs[i].released) {
       _memoryAllocs[i].memory = realloc(ptr, size);
@@ -179,10 +207,14 @@ void* __wrapper_realloc(void *ptr, size_t size, int line, char* file)
       _totalAalloc += size - _memoryAllocs[i].memorySize;
       _memoryAllocs[i].memorySize = size;
 
-      return _memoryAllocs[i].memory;
+      void* memory = _memoryAllocs[i].memory;
+      pthread_mutex_unlock(&_memoryLock);
+
+      return memory;
     }
   }
 
+  pthread_mutex_unlock(&_memoryLock);
   printf("\nWARNING! REALLOC USING UNDEF PTR\n%s:%i\n", file, line);
   return NULL;
 }
@@ -24,13 +24,17 @@
 #include <stdlib.h>
 
 #define malloc(size) __wrapper_malloc(size, __LINE__, __FILE__)
-#define calloc(nmeb, size) __wrapper_malloc((nmeb) * (size), __LINE__, __FILE__)
+#define calloc(nmeb, size) __wrapper_calloc(nmeb, size, __LINE__, __FILE__)
 #define free(ptr) __wrapper_free(ptr, __LINE__, __FILE__)
 #define realloc(ptr, size) __wrapper_realloc(ptr, size, __LINE__, __FILE__);
 
 void MEMORY_STATUS();
 
+/*
+ * Wrappers can be called from many threads.
+ */
 void* __wrapper_malloc(size_t size, int line, char* file);
+void* __wrapper_calloc(size_t nmeb, size_t size, int line, char* file);
 void  __wrapper_free(void *ptr, int line, char* file);
 void* __wrapper_realloc(void *ptr, size_t size, int line, char* file);
 